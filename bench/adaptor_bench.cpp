@@ -0,0 +1,79 @@
+#include <functional>
+#include <queue>
+#include <stack>
+#include <vector>
+
+#include "harness.hpp"
+#include "workloads.hpp"
+#include "adaptors/priority_queue.hpp"
+#include "adaptors/queue.hpp"
+#include "adaptors/stack.hpp"
+
+namespace {
+    template<typename C>
+    void stack_push_pop(bench::State &state) {
+        for (auto _ : state) {
+            C c;
+            for (std::size_t i = 0; i < state.size(); ++i) c.push(static_cast<int>(i));
+            long long sum = 0;
+            while (!c.empty()) {
+                sum += c.top();
+                c.pop();
+            }
+            bench::do_not_optimize(sum);
+        }
+        state.set_items_per_iteration(state.size());
+    }
+
+    // A queue kept at a steady depth, as in a breadth-first traversal
+    template<typename C>
+    void queue_steady(bench::State &state) {
+        constexpr std::size_t DEPTH = 64;
+        for (auto _ : state) {
+            C c;
+            for (std::size_t i = 0; i < DEPTH; ++i) c.push(static_cast<int>(i));
+            long long sum = 0;
+            for (std::size_t i = 0; i < state.size(); ++i) {
+                sum += c.front();
+                c.pop();
+                c.push(static_cast<int>(i));
+            }
+            bench::do_not_optimize(sum);
+        }
+        state.set_items_per_iteration(state.size());
+    }
+
+    template<typename C>
+    void priority_push_pop(bench::State &state) {
+        const auto values = bench::random_ints(state.size());
+        for (auto _ : state) {
+            C c;
+            for (const int value : values) c.push(value);
+            long long sum = 0;
+            while (!c.empty()) {
+                sum += c.top();
+                c.pop();
+            }
+            bench::do_not_optimize(sum);
+        }
+        state.set_items_per_iteration(state.size());
+    }
+
+    const std::vector<std::size_t> SIZES{1 << 10, 1 << 14, 1 << 18};
+    // Priority_queue keeps its container sorted, so a push is linear
+    const std::vector<std::size_t> SORTED_INSERT_SIZES{1 << 8, 1 << 10, 1 << 12};
+
+    // Priority_queue's top is the smallest element under std::less
+    using Std_min_queue = std::priority_queue<int, std::vector<int>, std::greater<>>;
+
+    const bench::Registrar registrar([] {
+        bench::add("stack/push_pop", "Stack", stack_push_pop<Stack<int>>, SIZES);
+        bench::add("stack/push_pop", "std::stack", stack_push_pop<std::stack<int>>, SIZES);
+
+        bench::add("queue/steady_state", "Queue", queue_steady<Queue<int>>, SIZES);
+        bench::add("queue/steady_state", "std::queue", queue_steady<std::queue<int>>, SIZES);
+
+        bench::add("priority_queue/push_pop", "Priority_queue", priority_push_pop<Priority_queue<int>>, SORTED_INSERT_SIZES);
+        bench::add("priority_queue/push_pop", "std::priority_queue", priority_push_pop<Std_min_queue>, SORTED_INSERT_SIZES);
+    });
+}
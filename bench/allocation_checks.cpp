@@ -0,0 +1,282 @@
+#include <bit>
+#include <cstdio>
+#include <functional>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "allocation_tracking.hpp"
+#include "harness.hpp"
+#include "workloads.hpp"
+#include "algorithms/heap_sort.hpp"
+#include "algorithms/merge_sort.hpp"
+#include "algorithms/quick_sort.hpp"
+#include "associative/flat_map.hpp"
+#include "associative/hash_map.hpp"
+#include "associative/hash_set.hpp"
+#include "sequence/deque.hpp"
+#include "sequence/forward_list.hpp"
+#include "sequence/list.hpp"
+#include "sequence/small_vector.hpp"
+#include "sequence/vector.hpp"
+#include "tree/avl_tree.hpp"
+#include "tree/red_black_tree.hpp"
+
+// Allocation budgets for the operations that should allocate little or nothing. Each check
+// sets up outside its Allocation_scope, performs the operation inside it and compares what was
+// counted with the budget; a change that adds an allocation to one of these paths makes
+// `ds_bench --check-allocations` exit with status 1.
+namespace {
+    constexpr std::size_t N = 1 << 12;
+
+    struct Outcome {
+        std::size_t counted;
+        std::size_t budget;
+    };
+
+    struct Check {
+        const char *name;
+        std::function<Outcome()> run;
+    };
+
+    // At most one allocation per doubling of the capacity
+    std::size_t doublings(const std::size_t n) {
+        return static_cast<std::size_t>(std::bit_width(n));
+    }
+
+    Vector<int> filled_vector() {
+        Vector<int> v;
+        for (const int key : bench::shuffled_ints(N)) v.push_back(key);
+        return v;
+    }
+
+    Hash_map<int, int> filled_map() {
+        Hash_map<int, int> map;
+        for (const int key : bench::shuffled_ints(N)) map.insert(key, key);
+        return map;
+    }
+
+    Forward_list<int> filled_forward_list() {
+        Forward_list<int> list;
+        for (std::size_t i = 0; i < N; ++i) list.push_front(static_cast<int>(i));
+        return list;
+    }
+
+    template<typename Tree>
+    Tree filled_tree() {
+        Tree tree;
+        for (const int key : bench::shuffled_ints(N)) tree.insert(key);
+        return tree;
+    }
+
+    // Probes 0 .. 2N - 1 against containers holding 0 .. N - 1, so half the lookups miss
+    template<typename Lookup>
+    std::size_t probe_all(Lookup lookup) {
+        std::size_t found = 0;
+        for (int key = 0; key < static_cast<int>(2 * N); ++key) found += lookup(key);
+        return found;
+    }
+
+    const std::vector<Check> &checks() {
+        static const std::vector<Check> all{
+            {"Vector::push_back, at most one allocation per doubling", [] {
+                Vector<int> v;
+                bench::Allocation_scope scope;
+                for (std::size_t i = 0; i < N; ++i) v.push_back(static_cast<int>(i));
+                return Outcome{scope.allocations(), doublings(N)};
+            }},
+            {"Vector::push_back after reserve", [] {
+                Vector<int> v;
+                v.reserve(N);
+                bench::Allocation_scope scope;
+                for (std::size_t i = 0; i < N; ++i) v.push_back(static_cast<int>(i));
+                return Outcome{scope.allocations(), 0};
+            }},
+            {"Vector move construction", [] {
+                Vector<int> v = filled_vector();
+                bench::Allocation_scope scope;
+                Vector<int> moved(std::move(v));
+                bench::do_not_optimize(moved.data());
+                return Outcome{scope.allocations(), 0};
+            }},
+            {"Small_vector::push_back within the inline capacity", [] {
+                Small_vector<int, 16> v;
+                bench::Allocation_scope scope;
+                for (int i = 0; i < 16; ++i) v.push_back(i);
+                bench::do_not_optimize(v.data());
+                return Outcome{scope.allocations(), 0};
+            }},
+            {"Deque::operator[]", [] {
+                Deque<int> deque;
+                for (std::size_t i = 0; i < N; ++i) deque.push_back(static_cast<int>(i));
+                bench::Allocation_scope scope;
+                long sum = 0;
+                for (std::size_t i = 0; i < deque.size(); ++i) sum += deque[i];
+                bench::do_not_optimize(sum);
+                return Outcome{scope.allocations(), 0};
+            }},
+            {"Hash_map::find", [] {
+                const Hash_map<int, int> map = filled_map();
+                bench::Allocation_scope scope;
+                bench::do_not_optimize(probe_all([&map](const int key) { return map.find(key) != nullptr; }));
+                return Outcome{scope.allocations(), 0};
+            }},
+            {"Hash_map::contains on an empty map", [] {
+                const Hash_map<int, int> map;
+                bench::Allocation_scope scope;
+                bench::do_not_optimize(probe_all([&map](const int key) { return map.contains(key); }));
+                return Outcome{scope.allocations(), 0};
+            }},
+            {"Hash_map::operator[] on existing keys", [] {
+                Hash_map<int, int> map = filled_map();
+                bench::Allocation_scope scope;
+                for (int key = 0; key < static_cast<int>(N); ++key) ++map[key];
+                return Outcome{scope.allocations(), 0};
+            }},
+            {"Hash_map::insert on existing keys", [] {
+                Hash_map<int, int> map = filled_map();
+                bench::Allocation_scope scope;
+                for (int key = 0; key < static_cast<int>(N); ++key) map.insert(key, -key);
+                return Outcome{scope.allocations(), 0};
+            }},
+            {"Hash_map::operator[] on new keys, a node each plus bucket arrays", [] {
+                const auto keys = bench::shuffled_ints(N);
+                Hash_map<int, int> map;
+                bench::Allocation_scope scope;
+                for (const int key : keys) map[key] = key;
+                return Outcome{scope.allocations(), N + doublings(N)};
+            }},
+            {"Hash_set::insert, a node each plus bucket arrays", [] {
+                const auto keys = bench::shuffled_ints(N);
+                Hash_set<int> set;
+                bench::Allocation_scope scope;
+                for (const int key : keys) set.insert(key);
+                for (const int key : keys) set.insert(key);
+                return Outcome{scope.allocations(), N + doublings(N)};
+            }},
+            {"Flat_map::find", [] {
+                Flat_map<int, int> map;
+                for (const int key : bench::shuffled_ints(N)) map.insert(key, key);
+                bench::Allocation_scope scope;
+                bench::do_not_optimize(probe_all([&map](const int key) { return map.find(key) != nullptr; }));
+                return Outcome{scope.allocations(), 0};
+            }},
+            {"Forward_list move construction", [] {
+                Forward_list<int> list = filled_forward_list();
+                bench::Allocation_scope scope;
+                Forward_list<int> moved(std::move(list));
+                bench::do_not_optimize(moved.front());
+                return Outcome{scope.allocations(), 0};
+            }},
+            {"Forward_list moved-from, used and destroyed", [] {
+                std::optional<Forward_list<int>> list(filled_forward_list());
+                Forward_list<int> moved(std::move(*list));
+                bench::Allocation_scope scope;
+                bench::do_not_optimize(list->empty());
+                for (const int value : *list) bench::do_not_optimize(value);
+                list->clear();
+                list.reset();
+                return Outcome{scope.allocations() + scope.deallocations(), 0};
+            }},
+            {"List move construction", [] {
+                List<int> list;
+                for (std::size_t i = 0; i < N; ++i) list.push_back(static_cast<int>(i));
+                bench::Allocation_scope scope;
+                List<int> moved(std::move(list));
+                bench::do_not_optimize(moved.size());
+                return Outcome{scope.allocations(), 0};
+            }},
+            {"Red_black_tree::contains", [] {
+                const auto tree = filled_tree<Red_black_tree<int>>();
+                bench::Allocation_scope scope;
+                bench::do_not_optimize(probe_all([&tree](const int key) { return tree.contains(key); }));
+                return Outcome{scope.allocations(), 0};
+            }},
+            {"Red_black_tree::insert, a node each", [] {
+                const auto keys = bench::shuffled_ints(N);
+                Red_black_tree<int> tree;
+                bench::Allocation_scope scope;
+                for (const int key : keys) tree.insert(key);
+                return Outcome{scope.allocations(), N};
+            }},
+            {"AVL_tree::contains", [] {
+                const auto tree = filled_tree<AVL_tree<int>>();
+                bench::Allocation_scope scope;
+                bench::do_not_optimize(probe_all([&tree](const int key) { return tree.contains(key); }));
+                return Outcome{scope.allocations(), 0};
+            }},
+            {"st::merge, one buffer", [] {
+                Vector<int> v(N);
+                for (std::size_t i = 0; i < N / 2; ++i) {
+                    v[i] = static_cast<int>(2 * i);
+                    v[N / 2 + i] = static_cast<int>(2 * i + 1);
+                }
+                bench::Allocation_scope scope;
+                st::merge(v, 0, N / 2 - 1, N - 1);
+                return Outcome{scope.allocations(), 1};
+            }},
+            {"st::merge_sort, one buffer for every merge", [] {
+                Vector<int> v = filled_vector();
+                bench::Allocation_scope scope;
+                st::merge_sort(v);
+                return Outcome{scope.allocations(), 1};
+            }},
+            {"st::merge_tail, one buffer", [] {
+                Vector<int> v(N);
+                for (std::size_t i = 0; i < N - 16; ++i) v[i] = static_cast<int>(i);
+                for (std::size_t i = N - 16; i < N; ++i) v[i] = static_cast<int>(i - N / 2);
+                bench::Allocation_scope scope;
+                st::merge_tail(v, N - 16);
+                return Outcome{scope.allocations(), 1};
+            }},
+            {"st::quick_sort and st::heap_sort, in place", [] {
+                Vector<int> a = filled_vector();
+                Vector<int> b = filled_vector();
+                bench::Allocation_scope scope;
+                st::quick_sort(a);
+                st::heap_sort(b);
+                return Outcome{scope.allocations(), 0};
+            }},
+            {"default construction", [] {
+                bench::Allocation_scope scope;
+                {
+                    Vector<int> vector;
+                    Deque<int> deque;
+                    List<int> list;
+                    Forward_list<int> forward_list;
+                    Hash_map<int, int> map;
+                    Hash_set<int> set;
+                    Red_black_tree<int> tree;
+                    bench::do_not_optimize(vector.size() + deque.size() + list.size() + map.size() + set.size());
+                    bench::do_not_optimize(forward_list.empty() && tree.empty());
+                }
+                return Outcome{scope.allocations(), 0};
+            }},
+        };
+        return all;
+    }
+}
+
+namespace bench {
+    int check_allocations(const std::string_view filter) {
+        if (!TRACKING_ALLOCATIONS) {
+            std::fprintf(stderr, "ds_bench: built without allocation tracking; configure with -DDS_TRACK_ALLOCATIONS=ON\n");
+            return 2;
+        }
+
+        std::size_t run = 0;
+        std::size_t failed = 0;
+        for (const Check &check : checks()) {
+            if (std::string_view(check.name).find(filter) == std::string_view::npos) continue;
+            const Outcome outcome = check.run();
+            const bool passed = outcome.counted <= outcome.budget;
+            std::printf("%-4s %-64s %8zu allocations, budget %zu\n", passed ? "ok" : "FAIL", check.name,
+                        outcome.counted, outcome.budget);
+            ++run;
+            failed += !passed;
+        }
+        std::printf("%zu of %zu allocation checks passed\n", run - failed, run);
+        return failed ? 1 : 0;
+    }
+}
@@ -0,0 +1,105 @@
+#include "allocation_tracking.hpp"
+
+#ifdef DS_TRACK_ALLOCATIONS
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace bench {
+    namespace {
+        // Constant-initialized, so they are ready before the first static constructor allocates
+        std::atomic<bool> counting{false};
+        std::atomic<std::size_t> allocations{0};
+        std::atomic<std::size_t> deallocations{0};
+        std::atomic<std::size_t> bytes{0};
+    }
+
+    Allocation_counts allocation_counts() noexcept {
+        return {allocations.load(std::memory_order_relaxed), deallocations.load(std::memory_order_relaxed),
+                bytes.load(std::memory_order_relaxed)};
+    }
+
+    void count_allocations(const bool enabled) noexcept {
+        counting.store(enabled, std::memory_order_relaxed);
+    }
+
+    namespace {
+        void *allocate(std::size_t size, const std::size_t alignment) noexcept {
+            if (size == 0) size = 1;
+            void *p = alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__
+                          ? std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment)
+                          : std::malloc(size);
+            if (p && counting.load(std::memory_order_relaxed)) {
+                allocations.fetch_add(1, std::memory_order_relaxed);
+                bytes.fetch_add(size, std::memory_order_relaxed);
+            }
+            return p;
+        }
+
+        // Retries through the new-handler the way the standard operator new does, then throws
+        void *allocate_or_throw(const std::size_t size, const std::size_t alignment) {
+            while (true) {
+                if (void *p = allocate(size, alignment)) return p;
+                const std::new_handler handler = std::get_new_handler();
+                if (!handler) throw std::bad_alloc();
+                handler();
+            }
+        }
+
+        void *allocate_or_null(const std::size_t size, const std::size_t alignment) noexcept {
+            try {
+                return allocate_or_throw(size, alignment);
+            } catch (...) {
+                return nullptr;
+            }
+        }
+
+        void deallocate(void *p) noexcept {
+            if (!p) return;
+            if (counting.load(std::memory_order_relaxed)) deallocations.fetch_add(1, std::memory_order_relaxed);
+            std::free(p);
+        }
+
+        constexpr std::size_t DEFAULT = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+        constexpr std::size_t to_size(const std::align_val_t alignment) noexcept {
+            return static_cast<std::size_t>(alignment);
+        }
+    }
+}
+
+// Every replaceable form, so no path through the library's defaults escapes the count
+void *operator new(const std::size_t size) { return bench::allocate_or_throw(size, bench::DEFAULT); }
+void *operator new[](const std::size_t size) { return bench::allocate_or_throw(size, bench::DEFAULT); }
+void *operator new(const std::size_t size, const std::nothrow_t &) noexcept { return bench::allocate_or_null(size, bench::DEFAULT); }
+void *operator new[](const std::size_t size, const std::nothrow_t &) noexcept { return bench::allocate_or_null(size, bench::DEFAULT); }
+void *operator new(const std::size_t size, const std::align_val_t al) { return bench::allocate_or_throw(size, bench::to_size(al)); }
+void *operator new[](const std::size_t size, const std::align_val_t al) { return bench::allocate_or_throw(size, bench::to_size(al)); }
+void *operator new(const std::size_t size, const std::align_val_t al, const std::nothrow_t &) noexcept {
+    return bench::allocate_or_null(size, bench::to_size(al));
+}
+void *operator new[](const std::size_t size, const std::align_val_t al, const std::nothrow_t &) noexcept {
+    return bench::allocate_or_null(size, bench::to_size(al));
+}
+
+void operator delete(void *p) noexcept { bench::deallocate(p); }
+void operator delete[](void *p) noexcept { bench::deallocate(p); }
+void operator delete(void *p, std::size_t) noexcept { bench::deallocate(p); }
+void operator delete[](void *p, std::size_t) noexcept { bench::deallocate(p); }
+void operator delete(void *p, const std::nothrow_t &) noexcept { bench::deallocate(p); }
+void operator delete[](void *p, const std::nothrow_t &) noexcept { bench::deallocate(p); }
+void operator delete(void *p, std::align_val_t) noexcept { bench::deallocate(p); }
+void operator delete[](void *p, std::align_val_t) noexcept { bench::deallocate(p); }
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept { bench::deallocate(p); }
+void operator delete[](void *p, std::size_t, std::align_val_t) noexcept { bench::deallocate(p); }
+void operator delete(void *p, std::align_val_t, const std::nothrow_t &) noexcept { bench::deallocate(p); }
+void operator delete[](void *p, std::align_val_t, const std::nothrow_t &) noexcept { bench::deallocate(p); }
+#else
+namespace bench {
+    Allocation_counts allocation_counts() noexcept {
+        return {};
+    }
+
+    void count_allocations(bool) noexcept {}
+}
+#endif
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+// Counts of calls to the global operator new and delete. When ds_bench is built with
+// DS_TRACK_ALLOCATIONS, allocation_tracking.cpp replaces every form of the global operators
+// with versions that count while counting is switched on: the harness switches it on for the
+// measured part of each benchmark and reports allocations per operation, and
+// `ds_bench --check-allocations` asserts allocation budgets for the hot paths of the containers.
+// Without the option the counts read as zero and the checks refuse to run.
+namespace bench {
+#ifdef DS_TRACK_ALLOCATIONS
+    inline constexpr bool TRACKING_ALLOCATIONS = true;
+#else
+    inline constexpr bool TRACKING_ALLOCATIONS = false;
+#endif
+
+    struct Allocation_counts {
+        std::size_t allocations = 0;
+        std::size_t deallocations = 0;
+        std::size_t bytes = 0;
+    };
+
+    // Totals since the program started, across all threads
+    Allocation_counts allocation_counts() noexcept;
+
+    // Switches counting on or off; off at startup, so static initialization isn't counted
+    void count_allocations(bool enabled) noexcept;
+
+    // Counts what happens during its lifetime; scopes don't nest
+    class Allocation_scope {
+    public:
+        Allocation_scope() noexcept : m_start(allocation_counts()) { count_allocations(true); }
+        ~Allocation_scope() { count_allocations(false); }
+
+        Allocation_scope(const Allocation_scope &) = delete;
+        Allocation_scope &operator=(const Allocation_scope &) = delete;
+
+        [[nodiscard]] std::size_t allocations() const noexcept {
+            return allocation_counts().allocations - m_start.allocations;
+        }
+
+        [[nodiscard]] std::size_t deallocations() const noexcept {
+            return allocation_counts().deallocations - m_start.deallocations;
+        }
+
+    private:
+        Allocation_counts m_start;
+    };
+
+    // Runs the allocation budgets whose names contain `filter`; returns the exit status
+    int check_allocations(std::string_view filter);
+}
@@ -0,0 +1,230 @@
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "harness.hpp"
+#include "workloads.hpp"
+#include "associative/flat_map.hpp"
+#include "associative/flat_set.hpp"
+#include "associative/frozen_map.hpp"
+#include "associative/hash_map.hpp"
+#include "associative/hash_set.hpp"
+#include "tree/red_black_tree.hpp"
+
+namespace {
+    // One spelling of insert, lookup and erase across the library and std containers
+    void insert(Hash_map<int, int> &c, const int key) { c.insert(key, key); }
+    void insert(std::unordered_map<int, int> &c, const int key) { c.emplace(key, key); }
+    void insert(Hash_set<int> &c, const int key) { c.insert(key); }
+    void insert(std::unordered_set<int> &c, const int key) { c.insert(key); }
+    void insert(Flat_map<int, int> &c, const int key) { c.insert(key, key); }
+    void insert(std::map<int, int> &c, const int key) { c.emplace(key, key); }
+    void insert(Flat_set<int> &c, const int key) { c.insert(key); }
+    void insert(std::set<int> &c, const int key) { c.insert(key); }
+    void insert(Red_black_tree<int> &c, const int key) { c.insert(key); }
+
+    bool lookup(Hash_map<int, int> &c, const int key) { return c.find(key) != nullptr; }
+    bool lookup(std::unordered_map<int, int> &c, const int key) { return c.find(key) != c.end(); }
+    bool lookup(Hash_set<int> &c, const int key) { return c.contains(key); }
+    bool lookup(std::unordered_set<int> &c, const int key) { return c.contains(key); }
+    bool lookup(Flat_map<int, int> &c, const int key) { return c.find(key) != nullptr; }
+    bool lookup(std::map<int, int> &c, const int key) { return c.find(key) != c.end(); }
+    bool lookup(Flat_set<int> &c, const int key) { return c.contains(key); }
+    bool lookup(std::set<int> &c, const int key) { return c.contains(key); }
+    bool lookup(Red_black_tree<int> &c, const int key) { return c.contains(key); }
+
+    void erase(Hash_map<int, int> &c, const int key) { c.remove(key); }
+    void erase(std::unordered_map<int, int> &c, const int key) { c.erase(key); }
+    void erase(Hash_set<int> &c, const int key) { c.remove(key); }
+    void erase(std::unordered_set<int> &c, const int key) { c.erase(key); }
+
+    template<typename C>
+    void insert_random(bench::State &state) {
+        const auto keys = bench::shuffled_ints(state.size());
+        for (auto _ : state) {
+            C c;
+            for (const int key : keys) insert(c, key);
+            bench::do_not_optimize(c);
+        }
+        state.set_items_per_iteration(state.size());
+    }
+
+    // Keys 0 .. n - 1 are present; a miss looks up n .. 2n - 1
+    template<typename C>
+    void find(bench::State &state, const bool hit) {
+        C c;
+        for (const int key : bench::shuffled_ints(state.size())) insert(c, key);
+        auto probes = bench::shuffled_ints(state.size(), bench::SEED + 1);
+        if (!hit) {
+            for (auto &probe : probes) probe += static_cast<int>(state.size());
+        }
+        for (auto _ : state) {
+            std::size_t found = 0;
+            for (const int key : probes) found += lookup(c, key);
+            bench::do_not_optimize(found);
+        }
+        state.set_items_per_iteration(state.size());
+    }
+
+    template<typename C>
+    void find_hit(bench::State &state) {
+        find<C>(state, true);
+    }
+
+    template<typename C>
+    void find_miss(bench::State &state) {
+        find<C>(state, false);
+    }
+
+    template<typename C>
+    void erase_all(bench::State &state) {
+        const auto keys = bench::shuffled_ints(state.size());
+        const auto order = bench::shuffled_ints(state.size(), bench::SEED + 1);
+        for (auto _ : state) {
+            state.pause_timing();
+            C c;
+            for (const int key : keys) insert(c, key);
+            state.resume_timing();
+            for (const int key : order) erase(c, key);
+            bench::do_not_optimize(c);
+        }
+        state.set_items_per_iteration(state.size());
+    }
+
+    template<typename C>
+    void construct_empty(bench::State &state) {
+        for (auto _ : state) {
+            C c;
+            bench::do_not_optimize(c);
+        }
+    }
+
+    // The C++ keywords: the kind of fixed table a Frozen_map replaces a startup-filled Hash_map for
+    constexpr Array<std::string_view, 84> KEYWORDS{
+        "alignas", "alignof", "and", "and_eq", "asm", "auto", "bitand", "bitor", "bool", "break",
+        "case", "catch", "char", "char8_t", "char16_t", "char32_t", "class", "compl", "concept",
+        "const", "consteval", "constexpr", "constinit", "const_cast", "continue", "co_await",
+        "co_return", "co_yield", "decltype", "default", "delete", "do", "double", "dynamic_cast",
+        "else", "enum", "explicit", "export", "extern", "false", "float", "for", "friend", "goto",
+        "if", "inline", "int", "long", "mutable", "namespace", "new", "noexcept", "not", "not_eq",
+        "nullptr", "operator", "or", "or_eq", "private", "protected", "public", "register",
+        "reinterpret_cast", "requires", "return", "short", "signed", "sizeof", "static",
+        "static_assert", "static_cast", "struct", "switch", "template", "this", "thread_local",
+        "throw", "true", "try", "typedef", "typeid", "typename", "union", "unsigned"};
+
+    constexpr auto KEYWORD_IDS = [] {
+        Array<Pair<std::string_view, int>, KEYWORDS.size()> pairs;
+        for (std::size_t i = 0; i < KEYWORDS.size(); ++i) pairs[i] = {KEYWORDS[i], static_cast<int>(i)};
+        return pairs;
+    }();
+
+    // Built by the compiler; the Hash_map and std::unordered_map are filled at startup
+    constexpr Frozen_map<std::string_view, int, KEYWORDS.size()> FROZEN_KEYWORDS(KEYWORD_IDS);
+
+    // Probes for the keyword tables: keywords for hits, identifiers of the same lengths with one
+    // letter changed for misses
+    std::vector<std::string> keyword_probes(const std::size_t count, const bool hit) {
+        std::mt19937_64 rng(bench::SEED);
+        std::vector<std::string> probes(count);
+        for (auto &probe : probes) {
+            probe = KEYWORDS[rng() % KEYWORDS.size()];
+            if (!hit) probe[rng() % probe.size()] = 'Q';
+        }
+        return probes;
+    }
+
+    void fill_keywords(Hash_map<std::string, int> &c) {
+        for (const auto &kv : KEYWORD_IDS) c.insert(std::string(kv.first()), kv.second());
+    }
+
+    void fill_keywords(std::unordered_map<std::string, int> &c) {
+        for (const auto &kv : KEYWORD_IDS) c.emplace(kv.first(), kv.second());
+    }
+
+    bool lookup_keyword(const Frozen_map<std::string_view, int, KEYWORDS.size()> &c, const std::string &key) {
+        return c.find(key) != nullptr;
+    }
+
+    bool lookup_keyword(const Hash_map<std::string, int> &c, const std::string &key) { return c.find(key) != nullptr; }
+
+    bool lookup_keyword(const std::unordered_map<std::string, int> &c, const std::string &key) {
+        return c.find(key) != c.end();
+    }
+
+    template<typename C>
+    void probe_keywords(bench::State &state, const C &c, const bool hit) {
+        const auto probes = keyword_probes(state.size(), hit);
+        for (auto _ : state) {
+            std::size_t found = 0;
+            for (const auto &key : probes) found += lookup_keyword(c, key);
+            bench::do_not_optimize(found);
+        }
+        state.set_items_per_iteration(state.size());
+    }
+
+    template<typename C>
+    void find_keyword(bench::State &state, const bool hit) {
+        C c;
+        fill_keywords(c);
+        probe_keywords(state, c, hit);
+    }
+
+    const std::vector<std::size_t> SIZES{1 << 10, 1 << 14, 1 << 18};
+    // Sorted-vector inserts shift the tail, so building one key at a time is quadratic
+    const std::vector<std::size_t> FLAT_INSERT_SIZES{1 << 10, 1 << 14};
+
+    const bench::Registrar registrar([] {
+        bench::add("hash_map/insert", "Hash_map", insert_random<Hash_map<int, int>>, SIZES);
+        bench::add("hash_map/insert", "std::unordered_map", insert_random<std::unordered_map<int, int>>, SIZES);
+        bench::add("hash_map/find_hit", "Hash_map", find_hit<Hash_map<int, int>>, SIZES);
+        bench::add("hash_map/find_hit", "std::unordered_map", find_hit<std::unordered_map<int, int>>, SIZES);
+        bench::add("hash_map/find_miss", "Hash_map", find_miss<Hash_map<int, int>>, SIZES);
+        bench::add("hash_map/find_miss", "std::unordered_map", find_miss<std::unordered_map<int, int>>, SIZES);
+        bench::add("hash_map/erase", "Hash_map", erase_all<Hash_map<int, int>>, SIZES);
+        bench::add("hash_map/erase", "std::unordered_map", erase_all<std::unordered_map<int, int>>, SIZES);
+        bench::add("hash_map/construct_empty", "Hash_map", construct_empty<Hash_map<int, int>>, {0});
+        bench::add("hash_map/construct_empty", "std::unordered_map", construct_empty<std::unordered_map<int, int>>, {0});
+
+        bench::add("hash_set/insert", "Hash_set", insert_random<Hash_set<int>>, SIZES);
+        bench::add("hash_set/insert", "std::unordered_set", insert_random<std::unordered_set<int>>, SIZES);
+        bench::add("hash_set/contains_hit", "Hash_set", find_hit<Hash_set<int>>, SIZES);
+        bench::add("hash_set/contains_hit", "std::unordered_set", find_hit<std::unordered_set<int>>, SIZES);
+        bench::add("hash_set/contains_miss", "Hash_set", find_miss<Hash_set<int>>, SIZES);
+        bench::add("hash_set/contains_miss", "std::unordered_set", find_miss<std::unordered_set<int>>, SIZES);
+        bench::add("hash_set/erase", "Hash_set", erase_all<Hash_set<int>>, SIZES);
+        bench::add("hash_set/erase", "std::unordered_set", erase_all<std::unordered_set<int>>, SIZES);
+        bench::add("hash_set/construct_empty", "Hash_set", construct_empty<Hash_set<int>>, {0});
+        bench::add("hash_set/construct_empty", "std::unordered_set", construct_empty<std::unordered_set<int>>, {0});
+
+        bench::add("flat_map/find_hit", "Flat_map", find_hit<Flat_map<int, int>>, SIZES);
+        bench::add("flat_map/find_hit", "Red_black_tree", find_hit<Red_black_tree<int>>, SIZES);
+        bench::add("flat_map/find_hit", "std::map", find_hit<std::map<int, int>>, SIZES);
+        bench::add("flat_map/insert", "Flat_map", insert_random<Flat_map<int, int>>, FLAT_INSERT_SIZES);
+        bench::add("flat_map/insert", "Red_black_tree", insert_random<Red_black_tree<int>>, FLAT_INSERT_SIZES);
+        bench::add("flat_map/insert", "std::map", insert_random<std::map<int, int>>, FLAT_INSERT_SIZES);
+
+        const std::vector<std::size_t> probes{1 << 12};
+        bench::add("frozen_map/find_hit", "Frozen_map",
+                   [](bench::State &state) { probe_keywords(state, FROZEN_KEYWORDS, true); }, probes);
+        bench::add("frozen_map/find_hit", "Hash_map",
+                   [](bench::State &state) { find_keyword<Hash_map<std::string, int>>(state, true); }, probes);
+        bench::add("frozen_map/find_hit", "std::unordered_map",
+                   [](bench::State &state) { find_keyword<std::unordered_map<std::string, int>>(state, true); }, probes);
+        bench::add("frozen_map/find_miss", "Frozen_map",
+                   [](bench::State &state) { probe_keywords(state, FROZEN_KEYWORDS, false); }, probes);
+        bench::add("frozen_map/find_miss", "Hash_map",
+                   [](bench::State &state) { find_keyword<Hash_map<std::string, int>>(state, false); }, probes);
+        bench::add("frozen_map/find_miss", "std::unordered_map",
+                   [](bench::State &state) { find_keyword<std::unordered_map<std::string, int>>(state, false); }, probes);
+
+        bench::add("flat_set/contains_hit", "Flat_set", find_hit<Flat_set<int>>, SIZES);
+        bench::add("flat_set/contains_hit", "std::set", find_hit<std::set<int>>, SIZES);
+        bench::add("flat_set/insert", "Flat_set", insert_random<Flat_set<int>>, FLAT_INSERT_SIZES);
+        bench::add("flat_set/insert", "std::set", insert_random<std::set<int>>, FLAT_INSERT_SIZES);
+    });
+}
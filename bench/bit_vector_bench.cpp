@@ -0,0 +1,156 @@
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "harness.hpp"
+#include "workloads.hpp"
+#include "sequence/bit_vector.hpp"
+#include "sequence/rank_select.hpp"
+
+namespace {
+    // Each bit is set with probability `percent` / 100
+    std::vector<bool> random_bits(const std::size_t count, const unsigned percent) {
+        std::mt19937_64 rng(bench::SEED);
+        std::vector<bool> bits(count);
+        for (std::size_t i = 0; i < count; ++i) bits[i] = rng() % 100 < percent;
+        return bits;
+    }
+
+    Bit_vector<> to_bit_vector(const std::vector<bool> &bits) {
+        Bit_vector<> out(bits.size());
+        for (std::size_t i = 0; i < bits.size(); ++i) {
+            if (bits[i]) out.set(i);
+        }
+        return out;
+    }
+
+    void count(bench::State &state) {
+        const auto bits = to_bit_vector(random_bits(state.size(), 50));
+        for (auto _ : state) bench::do_not_optimize(bits.count());
+        state.set_items_per_iteration(state.size());
+    }
+
+    void std_count(bench::State &state) {
+        const auto bits = random_bits(state.size(), 50);
+        for (auto _ : state) bench::do_not_optimize(std::count(bits.begin(), bits.end(), true));
+        state.set_items_per_iteration(state.size());
+    }
+
+    // Visits the positions of a sparse vector's ones
+    void iterate(bench::State &state) {
+        const auto bits = to_bit_vector(random_bits(state.size(), 10));
+        for (auto _ : state) {
+            std::size_t sum = 0;
+            for (const std::size_t pos : bits.set_bits()) sum += pos;
+            bench::do_not_optimize(sum);
+        }
+        state.set_items_per_iteration(state.size());
+    }
+
+    void std_iterate(bench::State &state) {
+        const auto bits = random_bits(state.size(), 10);
+        for (auto _ : state) {
+            std::size_t sum = 0;
+            for (std::size_t pos = 0; pos < bits.size(); ++pos) {
+                if (bits[pos]) sum += pos;
+            }
+            bench::do_not_optimize(sum);
+        }
+        state.set_items_per_iteration(state.size());
+    }
+
+    void and_assign(bench::State &state) {
+        auto lhs = to_bit_vector(random_bits(state.size(), 50));
+        const auto rhs = to_bit_vector(random_bits(state.size(), 90));
+        for (auto _ : state) {
+            lhs &= rhs;
+            bench::do_not_optimize(lhs.data());
+        }
+        state.set_items_per_iteration(state.size());
+    }
+
+    void std_and_assign(bench::State &state) {
+        auto lhs = random_bits(state.size(), 50);
+        const auto rhs = random_bits(state.size(), 90);
+        for (auto _ : state) {
+            for (std::size_t i = 0; i < lhs.size(); ++i) lhs[i] = lhs[i] && rhs[i];
+            bench::clobber_memory();
+        }
+        state.set_items_per_iteration(state.size());
+    }
+
+    // The naive index: the rank before every bit, 32 times the size of the vector
+    std::vector<std::uint32_t> prefix_counts(const std::vector<bool> &bits) {
+        std::vector<std::uint32_t> prefix(bits.size() + 1, 0);
+        for (std::size_t i = 0; i < bits.size(); ++i) prefix[i + 1] = prefix[i] + bits[i];
+        return prefix;
+    }
+
+    void rank(bench::State &state) {
+        const auto bits = to_bit_vector(random_bits(state.size(), 50));
+        const Rank_select<> index(bits);
+        const auto positions = bench::random_ints(1 << 12, state.size(), bench::SEED + 1);
+        for (auto _ : state) {
+            std::size_t sum = 0;
+            for (const int pos : positions) sum += index.rank1(static_cast<std::size_t>(pos));
+            bench::do_not_optimize(sum);
+        }
+        state.set_counter("index_bits_per_bit", 0.25);
+        state.set_items_per_iteration(positions.size());
+    }
+
+    void std_rank(bench::State &state) {
+        const auto prefix = prefix_counts(random_bits(state.size(), 50));
+        const auto positions = bench::random_ints(1 << 12, state.size(), bench::SEED + 1);
+        for (auto _ : state) {
+            std::size_t sum = 0;
+            for (const int pos : positions) sum += prefix[static_cast<std::size_t>(pos)];
+            bench::do_not_optimize(sum);
+        }
+        state.set_counter("index_bits_per_bit", 32);
+        state.set_items_per_iteration(positions.size());
+    }
+
+    void select(bench::State &state) {
+        const auto bits = to_bit_vector(random_bits(state.size(), 50));
+        const Rank_select<> index(bits);
+        const auto ranks = bench::random_ints(1 << 12, index.ones(), bench::SEED + 1);
+        for (auto _ : state) {
+            std::size_t sum = 0;
+            for (const int r : ranks) sum += index.select1(static_cast<std::size_t>(r));
+            bench::do_not_optimize(sum);
+        }
+        state.set_items_per_iteration(ranks.size());
+    }
+
+    // The position of the one with r ones before it is the last whose prefix count is r
+    void std_select(bench::State &state) {
+        const auto prefix = prefix_counts(random_bits(state.size(), 50));
+        const auto ranks = bench::random_ints(1 << 12, prefix.back(), bench::SEED + 1);
+        for (auto _ : state) {
+            std::size_t sum = 0;
+            for (const int r : ranks) {
+                const auto found = std::upper_bound(prefix.begin(), prefix.end(), static_cast<std::uint32_t>(r));
+                sum += static_cast<std::size_t>(found - prefix.begin()) - 1;
+            }
+            bench::do_not_optimize(sum);
+        }
+        state.set_items_per_iteration(ranks.size());
+    }
+
+    const std::vector<std::size_t> SIZES{1 << 12, 1 << 18, 1 << 24};
+
+    const bench::Registrar registrar([] {
+        bench::add("bit_vector/count", "Bit_vector", count, SIZES);
+        bench::add("bit_vector/count", "std::vector<bool>", std_count, SIZES);
+        bench::add("bit_vector/iterate_set_bits", "Bit_vector", iterate, SIZES);
+        bench::add("bit_vector/iterate_set_bits", "std::vector<bool>", std_iterate, SIZES);
+        bench::add("bit_vector/and_assign", "Bit_vector", and_assign, SIZES);
+        bench::add("bit_vector/and_assign", "std::vector<bool>", std_and_assign, SIZES);
+        bench::add("bit_vector/rank", "Rank_select", rank, SIZES);
+        bench::add("bit_vector/rank", "std::vector<uint32_t> prefix counts", std_rank, SIZES);
+        bench::add("bit_vector/select", "Rank_select", select, SIZES);
+        bench::add("bit_vector/select", "std::vector<uint32_t> prefix counts", std_select, SIZES);
+    });
+}
@@ -0,0 +1,192 @@
+#!/usr/bin/env python3
+"""Measures what the library's headers cost to compile, on a synthetic project.
+
+Generates --tus translation units, each including the commonly used headers and instantiating
+a couple of containers the way application code would, and compiles them in up to three
+variants:
+
+  headers       #include the headers of this tree
+  headers@REF   #include the headers of git revision REF, with --baseline REF
+  module        import datastructures, compiled once from modules/datastructures.cppm
+
+Each variant is timed from scratch, module compilation included, and reported as wall time
+with --jobs parallel compiles and as the summed compile time of its units. Needs GCC 11 or
+Clang 16; GCC before 14 additionally has the module units include <memory> first to get
+around an import bug, which the report notes.
+
+    bench/build_time.py --tus=200 --baseline=HEAD~1
+"""
+
+import argparse
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+from concurrent.futures import ThreadPoolExecutor
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+HEADERS = [
+    "sequence/vector.hpp",
+    "sequence/deque.hpp",
+    "sequence/list.hpp",
+    "sequence/array.hpp",
+    "associative/hash_map.hpp",
+    "tree/red_black_tree.hpp",
+    "tree/avl_tree.hpp",
+    "algorithms/merge_sort.hpp",
+]
+
+# Every unit includes all of HEADERS, as a typical source file includes more than it uses, and
+# instantiates two containers with its own element type; the pairs rotate across the units
+USES = [
+    """    Vector<Item_{n}> items;
+    for (int i = 0; i < count; ++i) items.push_back(Item_{n}{{(i * {n} + 7) % count}});
+    st::merge_sort(items);
+    Hash_map<int, Item_{n}> index;
+    for (int i = 0; i < count; ++i) index[i] = items[i];
+    return items[0].key + index.find(1)->key;
+""",
+    """    Deque<Item_{n}> pending;
+    for (int i = 0; i < count; ++i) pending.push_front(Item_{n}{{i}});
+    Red_black_tree<Item_{n}> sorted;
+    for (int i = 0; i < count; ++i) sorted.insert(pending[i]);
+    return pending.front().key + static_cast<int>(sorted.size());
+""",
+    """    List<Item_{n}> order;
+    for (int i = 0; i < count; ++i) order.push_back(Item_{n}{{count - i}});
+    order.sort();
+    Array<Item_{n}, 8> small{{}};
+    for (int i = 0; i < 8; ++i) small[i] = order.front();
+    return order.back().key + small[7].key;
+""",
+    """    AVL_tree<Item_{n}> balanced;
+    for (int i = 0; i < count; ++i) balanced.insert(Item_{n}{{i}});
+    Vector<int> keys;
+    balanced.for_each_inorder([&keys](const Item_{n} &item) {{ keys.push_back(item.key); }});
+    return balanced.max().key + keys[0];
+""",
+]
+
+BODY = """
+struct Item_{n} {{
+    int key;
+    auto operator<=>(const Item_{n} &) const = default;
+}};
+
+int unit_{n}(const int count) {{
+{uses}}}
+"""
+
+
+def compiler_info(compiler):
+    version = subprocess.run([compiler, "--version"], capture_output=True, text=True, check=True).stdout
+    kind = "clang" if "clang" in version else "gcc"
+    match = re.search(r"(\d+)\.\d+\.\d+", version)
+    return kind, int(match.group(1)) if match else 0
+
+
+def write_units(directory, tus, prelude):
+    os.makedirs(directory, exist_ok=True)
+    paths = []
+    for n in range(tus):
+        path = os.path.join(directory, f"unit_{n}.cpp")
+        with open(path, "w") as file:
+            file.write(prelude + BODY.format(n=n, uses=USES[n % len(USES)].format(n=n)))
+        paths.append(path)
+    return paths
+
+
+def compile_all(commands, jobs):
+    def run(command):
+        start = time.perf_counter()
+        result = subprocess.run(command, capture_output=True, text=True)
+        if result.returncode != 0:
+            sys.exit(f"build_time: compile failed:\n{' '.join(command)}\n{result.stderr}")
+        return time.perf_counter() - start
+
+    start = time.perf_counter()
+    with ThreadPoolExecutor(max_workers=jobs) as pool:
+        cpu = sum(pool.map(run, commands))
+    return time.perf_counter() - start, cpu
+
+
+def header_variant(work, name, include_dir, args):
+    directory = os.path.join(work, name)
+    prelude = "".join(f'#include "{header}"\n' for header in HEADERS)
+    units = write_units(directory, args.tus, prelude)
+    base = [args.compiler, f"-std={args.std}", *args.flags.split(), f"-I{include_dir}", "-c"]
+    return compile_all([base + [unit, "-o", unit + ".o"] for unit in units], args.jobs)
+
+
+def module_variant(work, args, kind, major):
+    directory = os.path.join(work, "module")
+    os.makedirs(directory, exist_ok=True)
+    source = os.path.join(ROOT, "modules", "datastructures.cppm")
+    common = [args.compiler, f"-std={args.std}", *args.flags.split(), f"-I{os.path.join(ROOT, 'include')}"]
+    prelude = "import datastructures;\n"
+    if kind == "gcc":
+        if major < 14:
+            prelude = "#include <memory>\n" + prelude
+        interface = [common + ["-fmodules-ts", "-x", "c++", "-c", source, "-o", "datastructures.o"]]
+        unit_flags = ["-fmodules-ts"]
+    else:
+        pcm = os.path.join(directory, "datastructures.pcm")
+        interface = [common + ["-x", "c++-module", "--precompile", source, "-o", pcm]]
+        unit_flags = [f"-fmodule-file=datastructures={pcm}"]
+
+    units = write_units(directory, args.tus, prelude)
+    cwd = os.getcwd()
+    os.chdir(directory)  # GCC keeps compiled module interfaces in ./gcm.cache
+    try:
+        interface_wall, interface_cpu = compile_all(interface, 1)
+        wall, cpu = compile_all([common + unit_flags + ["-c", unit, "-o", unit + ".o"] for unit in units], args.jobs)
+    finally:
+        os.chdir(cwd)
+    return interface_wall + wall, interface_cpu + cpu
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--tus", type=int, default=200, help="translation units to generate (default 200)")
+    parser.add_argument("--jobs", type=int, default=os.cpu_count(), help="parallel compiles (default: all cores)")
+    parser.add_argument("--compiler", default=os.environ.get("CXX", "c++"), help="C++ compiler (default $CXX or c++)")
+    parser.add_argument("--flags", default="-O2", help="extra compile flags (default -O2)")
+    parser.add_argument("--std", default="c++23", help="language standard (default c++23)")
+    parser.add_argument("--baseline", help="also time the headers of this git revision")
+    parser.add_argument("--no-module", action="store_true", help="skip the module variant")
+    parser.add_argument("--keep", action="store_true", help="keep the generated project")
+    args = parser.parse_args()
+
+    kind, major = compiler_info(args.compiler)
+    work = tempfile.mkdtemp(prefix="ds_build_time-")
+    results = []
+    try:
+        if args.baseline:
+            baseline = os.path.join(work, "baseline")
+            os.makedirs(baseline)
+            archive = subprocess.run(["git", "-C", ROOT, "archive", args.baseline, "include"],
+                                     capture_output=True, check=True).stdout
+            subprocess.run(["tar", "-x", "-C", baseline], input=archive, check=True)
+            results.append((f"headers@{args.baseline}", *header_variant(work, "baseline_units", os.path.join(baseline, "include"), args)))
+        results.append(("headers", *header_variant(work, "headers", os.path.join(ROOT, "include"), args)))
+        if not args.no_module:
+            name = "module" + (" (+<memory>)" if kind == "gcc" and major < 14 else "")
+            results.append((name, *module_variant(work, args, kind, major)))
+    finally:
+        if args.keep:
+            print(f"generated project kept in {work}")
+        else:
+            shutil.rmtree(work, ignore_errors=True)
+
+    print(f"{args.tus} translation units, {args.compiler} {args.flags}, {args.jobs} jobs")
+    print(f"{'variant':<28} {'wall s':>10} {'compile s':>12} {'per unit ms':>12} {'vs first':>9}")
+    for name, wall, cpu in results:
+        print(f"{name:<28} {wall:>10.1f} {cpu:>12.1f} {1000 * cpu / args.tus:>12.0f} {results[0][2] / cpu:>8.2f}x")
+
+
+if __name__ == "__main__":
+    main()
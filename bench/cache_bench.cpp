@@ -0,0 +1,133 @@
+#include <cstdint>
+#include <list>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "harness.hpp"
+#include "workloads.hpp"
+#include "cache/cache.hpp"
+#include "concurrent/sharded_cache.hpp"
+
+namespace {
+    using Key = std::uint64_t;
+
+    constexpr double SKEW = 0.9;
+    constexpr std::size_t TRACE_LENGTH = 1 << 18;
+    constexpr std::size_t UNIVERSE_PER_SLOT = 16;
+
+    // The textbook LRU every cache gets compared against
+    class Std_lru {
+    public:
+        explicit Std_lru(const std::size_t capacity) : m_capacity(capacity) {}
+
+        Key *get(const Key key) {
+            const auto found = m_index.find(key);
+            if (found == m_index.end()) return nullptr;
+            m_order.splice(m_order.begin(), m_order, found->second);
+            return &found->second->second;
+        }
+
+        void put(const Key key, const Key value) {
+            if (m_index.size() == m_capacity) {
+                m_index.erase(m_order.back().first);
+                m_order.pop_back();
+            }
+            m_order.emplace_front(key, value);
+            m_index.emplace(key, m_order.begin());
+        }
+
+    private:
+        std::size_t m_capacity;
+        std::list<std::pair<Key, Key>> m_order;
+        std::unordered_map<Key, std::list<std::pair<Key, Key>>::iterator> m_index;
+    };
+
+    // Zipf trace over 16 keys per cache slot, generated once per capacity
+    const std::vector<Key> &trace(const std::size_t capacity) {
+        static std::map<std::size_t, std::vector<Key>> traces;
+        auto found = traces.find(capacity);
+        if (found == traces.end()) {
+            found = traces.emplace(capacity, bench::zipf_trace(TRACE_LENGTH, capacity * UNIVERSE_PER_SLOT, SKEW)).first;
+        }
+        return found->second;
+    }
+
+    // Read-through: look the key up and load it on a miss
+    template<typename C>
+    void replay(bench::State &state) {
+        const auto &keys = trace(state.size());
+        std::size_t hits = 0;
+        for (auto _ : state) {
+            C cache(state.size());
+            hits = 0;
+            for (const Key key : keys) {
+                if (cache.get(key)) ++hits;
+                else cache.put(key, key);
+            }
+            bench::do_not_optimize(hits);
+        }
+        state.set_counter("hit_ratio", static_cast<double>(hits) / static_cast<double>(keys.size()));
+        state.set_items_per_iteration(keys.size());
+    }
+
+    constexpr std::size_t SHARED_CAPACITY = 1 << 14;
+    constexpr std::size_t OPS_PER_THREAD = 1 << 16;
+
+    // Each thread replays its own trace over the same key space
+    std::vector<std::vector<Key>> thread_traces(const std::size_t threads) {
+        std::vector<std::vector<Key>> traces;
+        for (std::size_t t = 0; t < threads; ++t) {
+            traces.push_back(bench::zipf_trace(OPS_PER_THREAD, SHARED_CAPACITY * UNIVERSE_PER_SLOT, SKEW, bench::SEED + t));
+        }
+        return traces;
+    }
+
+    template<template<typename, typename> class Policy>
+    void sharded(bench::State &state) {
+        const auto traces = thread_traces(state.size());
+        for (auto _ : state) {
+            Sharded_cache<Key, Key, Policy> cache(SHARED_CAPACITY);
+            bench::run_threads(state.size(), [&](const std::size_t t) {
+                Key value = 0;
+                for (const Key key : traces[t]) {
+                    if (!cache.get(key, value)) cache.put(key, key);
+                }
+                bench::do_not_optimize(value);
+            });
+        }
+        state.set_items_per_iteration(state.size() * OPS_PER_THREAD);
+    }
+
+    void std_locked(bench::State &state) {
+        const auto traces = thread_traces(state.size());
+        for (auto _ : state) {
+            Std_lru cache(SHARED_CAPACITY);
+            std::mutex mutex;
+            bench::run_threads(state.size(), [&](const std::size_t t) {
+                for (const Key key : traces[t]) {
+                    std::lock_guard lock(mutex);
+                    if (!cache.get(key)) cache.put(key, key);
+                }
+            });
+        }
+        state.set_items_per_iteration(state.size() * OPS_PER_THREAD);
+    }
+
+    const std::vector<std::size_t> CAPACITIES{1 << 10, 1 << 14, 1 << 16};
+    const std::vector<std::size_t> THREADS{1, 2, 4, 8};
+
+    const bench::Registrar registrar([] {
+        bench::add("cache/zipf_read_through", "Lru_cache", replay<Lru_cache<Key, Key>>, CAPACITIES);
+        bench::add("cache/zipf_read_through", "Lfu_cache", replay<Lfu_cache<Key, Key>>, CAPACITIES);
+        bench::add("cache/zipf_read_through", "Arc_cache", replay<Arc_cache<Key, Key>>, CAPACITIES);
+        bench::add("cache/zipf_read_through", "Tiny_lfu_cache", replay<Tiny_lfu_cache<Key, Key>>, CAPACITIES);
+        bench::add("cache/zipf_read_through", "std::unordered_map+std::list", replay<Std_lru>, CAPACITIES);
+
+        // Sizes are thread counts here
+        bench::add("cache/sharded_threads", "Sharded_cache<Lru_policy>", sharded<Lru_policy>, THREADS);
+        bench::add("cache/sharded_threads", "Sharded_cache<Tiny_lfu_policy>", sharded<Tiny_lfu_policy>, THREADS);
+        bench::add("cache/sharded_threads", "std::mutex, std::unordered_map+std::list", std_locked, THREADS);
+    });
+}
@@ -0,0 +1,74 @@
+#include <map>
+#include <mutex>
+#include <random>
+#include <shared_mutex>
+#include <vector>
+
+#include "harness.hpp"
+#include "workloads.hpp"
+#include "concurrent/concurrent_skip_list.hpp"
+
+namespace {
+    constexpr int KEY_RANGE = 1 << 16;
+    constexpr std::size_t OPS_PER_THREAD = 1 << 16;
+
+    // 80% lookups, 10% inserts and 10% removals over a key range that starts half full
+    template<typename Map>
+    void mixed(bench::State &state) {
+        for (auto _ : state) {
+            state.pause_timing();
+            Map map;
+            for (int key = 0; key < KEY_RANGE; key += 2) map.insert(key, key);
+            state.resume_timing();
+            bench::run_threads(state.size(), [&map](const std::size_t t) {
+                std::mt19937_64 rng(bench::SEED + t);
+                int value = 0;
+                std::size_t found = 0;
+                for (std::size_t i = 0; i < OPS_PER_THREAD; ++i) {
+                    const auto draw = rng();
+                    const int key = static_cast<int>(draw % KEY_RANGE);
+                    const auto op = (draw >> 32) % 10;
+                    if (op == 0) map.insert(key, key);
+                    else if (op == 1) map.remove(key);
+                    else found += map.find(key, value);
+                }
+                bench::do_not_optimize(found);
+            });
+        }
+        state.set_items_per_iteration(state.size() * OPS_PER_THREAD);
+    }
+
+    // std::map behind a reader-writer lock, with the skip list's interface
+    class Locked_map {
+    public:
+        bool insert(const int key, const int value) {
+            std::unique_lock lock(m_mutex);
+            return m_map.emplace(key, value).second;
+        }
+
+        bool remove(const int key) {
+            std::unique_lock lock(m_mutex);
+            return m_map.erase(key) != 0;
+        }
+
+        bool find(const int key, int &value) const {
+            std::shared_lock lock(m_mutex);
+            const auto found = m_map.find(key);
+            if (found == m_map.end()) return false;
+            value = found->second;
+            return true;
+        }
+
+    private:
+        mutable std::shared_mutex m_mutex;
+        std::map<int, int> m_map;
+    };
+
+    // Sizes are thread counts
+    const std::vector<std::size_t> THREADS{1, 2, 4, 8};
+
+    const bench::Registrar registrar([] {
+        bench::add("concurrent/ordered_map_mixed", "Concurrent_skip_list", mixed<Concurrent_skip_list<int, int>>, THREADS);
+        bench::add("concurrent/ordered_map_mixed", "std::map+std::shared_mutex", mixed<Locked_map>, THREADS);
+    });
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+// Allocator that tallies what a container asks for, for the memory-footprint benchmarks.
+// All copies and rebinds share one tally, so it covers node, bucket and map allocations alike.
+namespace bench {
+    struct Allocation_tally {
+        std::size_t allocations = 0;
+        std::size_t bytes = 0;
+        std::size_t live_bytes = 0;
+        std::size_t peak_bytes = 0;
+    };
+
+    template<typename T>
+    class Counting_allocator {
+    public:
+        using value_type = T;
+
+        explicit Counting_allocator(Allocation_tally &tally) noexcept : m_tally(&tally) {}
+
+        template<typename U>
+        Counting_allocator(const Counting_allocator<U> &other) noexcept : m_tally(other.tally()) {}
+
+        T *allocate(const std::size_t count) {
+            ++m_tally->allocations;
+            m_tally->bytes += count * sizeof(T);
+            m_tally->live_bytes += count * sizeof(T);
+            if (m_tally->live_bytes > m_tally->peak_bytes) m_tally->peak_bytes = m_tally->live_bytes;
+            return std::allocator<T>().allocate(count);
+        }
+
+        void deallocate(T *pointer, const std::size_t count) noexcept {
+            m_tally->live_bytes -= count * sizeof(T);
+            std::allocator<T>().deallocate(pointer, count);
+        }
+
+        [[nodiscard]] Allocation_tally *tally() const noexcept { return m_tally; }
+
+        template<typename U>
+        bool operator==(const Counting_allocator<U> &other) const noexcept { return m_tally == other.tally(); }
+
+    private:
+        Allocation_tally *m_tally;
+    };
+}
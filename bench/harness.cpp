@@ -0,0 +1,350 @@
+#include "harness.hpp"
+#include "workloads.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string_view>
+
+#include <sys/utsname.h>
+#include <unistd.h>
+
+namespace bench {
+    namespace {
+        struct Options {
+            std::string filter;
+            std::string json_path;
+            double min_time = 0.05;
+            size_type repetitions = 3;
+            size_type max_size = static_cast<size_type>(-1);
+            bool list = false;
+            bool perf = true;
+            bool check_allocations = false;
+        };
+
+        struct Result {
+            const Benchmark *benchmark;
+            size_type size;
+            size_type iterations;
+            double ns_per_op;
+            double ns_per_op_min;
+            double ns_per_op_max;
+            std::vector<std::pair<std::string, double>> counters;
+            std::vector<std::pair<std::string, double>> perf; // hardware events per operation, when counted
+            std::vector<std::pair<std::string, double>> allocations; // operator new calls and bytes per operation, when tracked
+            double ratio = 0; // against the group's std:: implementation at the same size, 0 if none
+        };
+
+        constexpr size_type MAX_ITERATIONS = 1'000'000'000;
+
+        void usage() {
+            std::cout << "usage: ds_bench [--filter=TEXT] [--json=FILE] [--min-time=SECONDS] [--repetitions=N]\n"
+                         "                [--max-size=N] [--no-perf] [--list] [--check-allocations]\n"
+                         "  --filter       run only benchmarks whose group/implementation contains TEXT\n"
+                         "  --json         also write the results to FILE as JSON\n"
+                         "  --min-time     minimum measured time per repetition (default 0.05)\n"
+                         "  --repetitions  measurements per benchmark and size; the median is kept (default 3)\n"
+                         "  --max-size     skip sizes above N\n"
+                         "  --no-perf      don't read hardware performance counters\n"
+                         "  --list         print the benchmarks and exit\n"
+                         "  --check-allocations\n"
+                         "                 run the allocation budgets matching --filter instead, exiting 1 if\n"
+                         "                 any is exceeded (needs a DS_TRACK_ALLOCATIONS build)\n";
+        }
+
+        bool parse(const int argc, char **argv, Options &options) {
+            for (int i = 1; i < argc; ++i) {
+                const std::string_view arg = argv[i];
+                const auto value = [&arg](const std::string_view prefix) { return arg.substr(prefix.size()); };
+                if (arg.starts_with("--filter=")) options.filter = value("--filter=");
+                else if (arg.starts_with("--json=")) options.json_path = value("--json=");
+                else if (arg.starts_with("--min-time=")) options.min_time = std::atof(value("--min-time=").data());
+                else if (arg.starts_with("--repetitions=")) options.repetitions = std::max(1L, std::atol(value("--repetitions=").data()));
+                else if (arg.starts_with("--max-size=")) options.max_size = std::strtoull(value("--max-size=").data(), nullptr, 10);
+                else if (arg == "--no-perf") options.perf = false;
+                else if (arg == "--list") options.list = true;
+                else if (arg == "--check-allocations") options.check_allocations = true;
+                else {
+                    usage();
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        bool is_baseline(const Benchmark &benchmark) {
+            return benchmark.implementation.starts_with("std::");
+        }
+
+        std::string full_name(const Benchmark &benchmark) {
+            return benchmark.group + "/" + benchmark.implementation;
+        }
+
+        double run_once(const Benchmark &benchmark, const size_type size, const size_type iterations, State &state,
+                        Perf_counters *perf = nullptr) {
+            state = State(size, iterations, perf);
+            if (perf) perf->reset();
+            benchmark.function(state);
+            return state.elapsed_ns();
+        }
+
+        // Doubles the iterations, or jumps straight to the estimate, until one run fills min_time
+        size_type calibrate(const Benchmark &benchmark, const size_type size, const double min_time_ns) {
+            size_type iterations = 1;
+            State state(size, iterations);
+            while (true) {
+                const double elapsed = run_once(benchmark, size, iterations, state);
+                if (elapsed >= min_time_ns || iterations >= MAX_ITERATIONS) return iterations;
+                const double estimate = elapsed > 0 ? min_time_ns * 1.2 / elapsed * static_cast<double>(iterations) : 0;
+                iterations = std::min(MAX_ITERATIONS, std::max(iterations * 2, static_cast<size_type>(estimate)));
+            }
+        }
+
+        // Event counts summed over all repetitions, divided by all their operations
+        std::vector<std::pair<std::string, double>> per_operation(const Perf_counters &perf,
+                                                                  const Perf_counters::Values &totals,
+                                                                  const double ops) {
+            std::vector<std::pair<std::string, double>> out;
+            for (int event = 0; event < Perf_counters::EVENT_COUNT; ++event) {
+                const auto e = static_cast<Perf_counters::Event>(event);
+                if (perf.has(e)) out.emplace_back(Perf_counters::name(e), totals[event] / ops);
+            }
+            if (perf.has(Perf_counters::cycles) && perf.has(Perf_counters::instructions) && totals[Perf_counters::cycles] > 0) {
+                out.emplace_back("ipc", totals[Perf_counters::instructions] / totals[Perf_counters::cycles]);
+            }
+            return out;
+        }
+
+        Result measure(const Benchmark &benchmark, const size_type size, const Options &options, Perf_counters *perf) {
+            const size_type iterations = calibrate(benchmark, size, options.min_time * 1e9);
+            std::vector<double> samples;
+            Perf_counters::Values totals{};
+            double total_ops = 0;
+            const Allocation_counts allocations_before = allocation_counts();
+            State state(size, iterations);
+            for (size_type i = 0; i < options.repetitions; ++i) {
+                const double elapsed = run_once(benchmark, size, iterations, state, perf);
+                const double ops = static_cast<double>(iterations) * static_cast<double>(std::max<size_type>(1, state.items_per_iteration()));
+                samples.push_back(elapsed / ops);
+                total_ops += ops;
+                if (perf) {
+                    const auto values = perf->read();
+                    for (int event = 0; event < Perf_counters::EVENT_COUNT; ++event) totals[event] += values[event];
+                }
+            }
+            std::sort(samples.begin(), samples.end());
+            Result result{&benchmark, size, iterations, samples[samples.size() / 2], samples.front(), samples.back(),
+                          state.counters(), {}, {}};
+            if (perf) result.perf = per_operation(*perf, totals, total_ops);
+            if constexpr (TRACKING_ALLOCATIONS) {
+                const Allocation_counts after = allocation_counts();
+                result.allocations = {
+                    {"allocations", static_cast<double>(after.allocations - allocations_before.allocations) / total_ops},
+                    {"bytes", static_cast<double>(after.bytes - allocations_before.bytes) / total_ops},
+                };
+            }
+            return result;
+        }
+
+        void compare_to_baselines(std::vector<Result> &results) {
+            std::map<std::pair<std::string, size_type>, double> baselines;
+            for (const auto &result : results) {
+                if (is_baseline(*result.benchmark)) {
+                    baselines.emplace(std::pair(result.benchmark->group, result.size), result.ns_per_op);
+                }
+            }
+            for (auto &result : results) {
+                const auto found = baselines.find({result.benchmark->group, result.size});
+                if (found != baselines.end() && found->second > 0) result.ratio = result.ns_per_op / found->second;
+            }
+        }
+
+        void print(const Result &result) {
+            std::printf("%-36s %-40s %10zu %14.2f", result.benchmark->group.c_str(),
+                        result.benchmark->implementation.c_str(), result.size, result.ns_per_op);
+            if (result.ratio > 0) std::printf(" %8.2fx", result.ratio);
+            else std::printf(" %9s", "");
+            for (const auto &[name, value] : result.counters) std::printf("  %s=%g", name.c_str(), value);
+            for (const auto &[name, value] : result.perf) std::printf("  %s=%.3g", name.c_str(), value);
+            for (const auto &[name, value] : result.allocations) std::printf("  %s=%.3g", name.c_str(), value);
+            std::printf("\n");
+        }
+
+        std::string escape(const std::string_view text) {
+            std::string out;
+            for (const char c : text) {
+                if (c == '"' || c == '\\') {
+                    out += '\\';
+                    out += c;
+                } else if (static_cast<unsigned char>(c) < 0x20) {
+                    char buffer[8];
+                    std::snprintf(buffer, sizeof buffer, "\\u%04x", c);
+                    out += buffer;
+                } else {
+                    out += c;
+                }
+            }
+            return out;
+        }
+
+        std::string cpu_model() {
+            std::ifstream cpuinfo("/proc/cpuinfo");
+            std::string line;
+            while (std::getline(cpuinfo, line)) {
+                if (line.starts_with("model name")) {
+                    const auto colon = line.find(':');
+                    if (colon != std::string::npos) return line.substr(line.find_first_not_of(' ', colon + 1));
+                }
+            }
+            return "unknown";
+        }
+
+        std::string timestamp() {
+            const std::time_t now = std::time(nullptr);
+            char buffer[32];
+            std::strftime(buffer, sizeof buffer, "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+            return buffer;
+        }
+
+        void write_pairs(std::ostringstream &out, const std::vector<std::pair<std::string, double>> &pairs) {
+            out << "{";
+            for (size_type i = 0; i < pairs.size(); ++i) {
+                out << (i ? ", " : "") << "\"" << escape(pairs[i].first) << "\": " << pairs[i].second;
+            }
+            out << "}";
+        }
+
+        void write_json(const std::string &path, const std::vector<Result> &results, const Options &options,
+                        const Perf_counters *perf) {
+            utsname host{};
+            uname(&host);
+
+            std::ostringstream out;
+            out << "{\n  \"context\": {\n";
+            out << "    \"date\": \"" << timestamp() << "\",\n";
+            out << "    \"host\": \"" << escape(host.nodename) << "\",\n";
+            out << "    \"system\": \"" << escape(host.sysname) << " " << escape(host.release) << "\",\n";
+            out << "    \"cpu\": \"" << escape(cpu_model()) << "\",\n";
+            out << "    \"compiler\": \"" << escape(__VERSION__) << "\",\n";
+#ifdef NDEBUG
+            out << "    \"assertions\": false,\n";
+#else
+            out << "    \"assertions\": true,\n";
+#endif
+            out << "    \"min_time\": " << options.min_time << ",\n";
+            out << "    \"repetitions\": " << options.repetitions << ",\n";
+            out << "    \"perf_counters\": " << (perf ? "true" : "false") << ",\n";
+            out << "    \"allocation_tracking\": " << (TRACKING_ALLOCATIONS ? "true" : "false") << "\n  },\n";
+            out << "  \"benchmarks\": [";
+            for (size_type i = 0; i < results.size(); ++i) {
+                const Result &result = results[i];
+                out << (i ? ",\n" : "\n");
+                out << "    {\"group\": \"" << escape(result.benchmark->group) << "\", \"implementation\": \""
+                    << escape(result.benchmark->implementation) << "\", \"size\": " << result.size
+                    << ", \"iterations\": " << result.iterations << ", \"ns_per_op\": " << result.ns_per_op
+                    << ", \"ns_per_op_min\": " << result.ns_per_op_min << ", \"ns_per_op_max\": " << result.ns_per_op_max;
+                if (result.ratio > 0) out << ", \"ratio_to_std\": " << result.ratio;
+                out << ", \"counters\": ";
+                write_pairs(out, result.counters);
+                if (perf) {
+                    out << ", \"perf\": ";
+                    write_pairs(out, result.perf);
+                }
+                if (TRACKING_ALLOCATIONS) {
+                    out << ", \"allocations_per_op\": ";
+                    write_pairs(out, result.allocations);
+                }
+                out << "}";
+            }
+            out << "\n  ]\n}\n";
+
+            std::ofstream file(path);
+            file << out.str();
+            if (!file) std::cerr << "ds_bench: cannot write " << path << "\n";
+        }
+    }
+
+    void State::set_counter(std::string name, const double value) {
+        for (auto &[existing, current] : m_counters) {
+            if (existing == name) {
+                current = value;
+                return;
+            }
+        }
+        m_counters.emplace_back(std::move(name), value);
+    }
+
+    std::size_t resident_bytes() {
+        std::ifstream statm("/proc/self/statm");
+        std::size_t pages = 0;
+        std::size_t resident = 0;
+        if (!(statm >> pages >> resident)) return 0;
+        return resident * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    }
+
+    std::vector<Benchmark> &registry() {
+        static std::vector<Benchmark> benchmarks;
+        return benchmarks;
+    }
+
+    void add(std::string group, std::string implementation, Function function, std::vector<size_type> sizes) {
+        registry().push_back({std::move(group), std::move(implementation), std::move(function), std::move(sizes)});
+    }
+
+    int run(const int argc, char **argv) {
+        Options options;
+        if (!parse(argc, argv, options)) return 2;
+        if (options.check_allocations) return check_allocations(options.filter);
+
+        // Groups stay together in registration order, each led by its std:: baseline
+        std::vector<const Benchmark *> selected;
+        for (const auto &benchmark : registry()) {
+            if (full_name(benchmark).find(options.filter) != std::string::npos) selected.push_back(&benchmark);
+        }
+        std::stable_sort(selected.begin(), selected.end(), [](const Benchmark *lhs, const Benchmark *rhs) {
+            if (lhs->group != rhs->group) return lhs->group < rhs->group;
+            return is_baseline(*lhs) && !is_baseline(*rhs);
+        });
+
+        if (options.list) {
+            for (const Benchmark *benchmark : selected) std::cout << full_name(*benchmark) << "\n";
+            return 0;
+        }
+
+        // Without perf the numbers are wall-clock only; say so once instead of failing
+        std::unique_ptr<Perf_counters> perf;
+        if (options.perf) {
+            perf = std::make_unique<Perf_counters>();
+            if (!perf->available()) {
+                std::cerr << "ds_bench: hardware counters unavailable: " << perf->error() << "\n";
+                perf.reset();
+            } else {
+                for (int event = 0; event < Perf_counters::EVENT_COUNT; ++event) {
+                    const auto e = static_cast<Perf_counters::Event>(event);
+                    if (!perf->has(e)) std::cerr << "ds_bench: counter " << Perf_counters::name(e) << " unavailable\n";
+                }
+            }
+        }
+
+        std::printf("%-36s %-40s %10s %14s %9s\n", "group", "implementation", "size", "ns/op", "vs std");
+        std::vector<Result> results;
+        for (const Benchmark *benchmark : selected) {
+            for (const size_type size : benchmark->sizes) {
+                if (size > options.max_size) continue;
+                results.push_back(measure(*benchmark, size, options, perf.get()));
+                compare_to_baselines(results);
+                print(results.back());
+            }
+        }
+
+        if (!options.json_path.empty()) write_json(options.json_path, results, options, perf.get());
+        return 0;
+    }
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "allocation_tracking.hpp"
+#include "perf_counters.hpp"
+
+// Minimal microbenchmark harness behind ds_bench. A benchmark is a function of a State that
+// does its setup, then repeats the measured work once per pass of `for (auto _ : state)`:
+//
+//     void vector_push_back(bench::State &state) {
+//         for (auto _ : state) {
+//             Vector<int> v;
+//             for (std::size_t i = 0; i < state.size(); ++i) v.push_back(i);
+//             bench::do_not_optimize(v.data());
+//         }
+//         state.set_items_per_iteration(state.size());
+//     }
+//
+// Benchmarks are registered under a group ("vector/push_back") and an implementation
+// ("Vector", "std::vector"). Within a group, the implementation whose name starts with "std::"
+// is the baseline that the others are compared against. The runner picks an iteration count
+// that fills the minimum time, repeats the measurement and keeps the median. Where Linux perf
+// counters are available, the measured runs also count cycles, instructions, cache, branch and
+// TLB misses, reported per operation next to the time; in a DS_TRACK_ALLOCATIONS build, so are
+// calls to operator new.
+namespace bench {
+    using size_type = std::size_t;
+    using clock = std::chrono::steady_clock;
+
+    class State {
+    public:
+        State(size_type size, size_type iterations, Perf_counters *perf = nullptr)
+            : m_size(size), m_iterations(iterations), m_perf(perf) {}
+
+        // The benchmark's argument: an element count, or a thread count where the group says so
+        [[nodiscard]] size_type size() const noexcept { return m_size; }
+        [[nodiscard]] size_type iterations() const noexcept { return m_iterations; }
+
+        // How many operations one iteration performs; times are reported per operation
+        void set_items_per_iteration(const size_type items) noexcept { m_items = items; }
+        [[nodiscard]] size_type items_per_iteration() const noexcept { return m_items; }
+
+        // Extra per-run figures such as a hit ratio, written out as given
+        void set_counter(std::string name, double value);
+        [[nodiscard]] const std::vector<std::pair<std::string, double>> &counters() const noexcept { return m_counters; }
+
+        // Excludes per-iteration setup from the measurement, counters included
+        void pause_timing() noexcept {
+            m_elapsed += clock::now() - m_start;
+            if (m_perf) m_perf->stop();
+            if constexpr (TRACKING_ALLOCATIONS) count_allocations(false);
+        }
+
+        void resume_timing() noexcept {
+            if constexpr (TRACKING_ALLOCATIONS) count_allocations(true);
+            if (m_perf) m_perf->start();
+            m_start = clock::now();
+        }
+
+        [[nodiscard]] double elapsed_ns() const noexcept {
+            return std::chrono::duration<double, std::nano>(m_elapsed).count();
+        }
+
+        // Not trivially destructible, so `for (auto _ : state)` doesn't warn about an unused variable
+        struct Value {
+            ~Value() {}
+        };
+
+        class Iterator {
+        public:
+            Iterator(State *state, const size_type remaining) : m_state(state), m_remaining(remaining) {}
+
+            Value operator*() const noexcept { return {}; }
+            Iterator &operator++() noexcept {
+                --m_remaining;
+                return *this;
+            }
+
+            // The loop ends here, so this is where the clock stops
+            bool operator!=(const Iterator &) const noexcept {
+                if (m_remaining) return true;
+                m_state->pause_timing();
+                return false;
+            }
+
+        private:
+            State *m_state;
+            size_type m_remaining;
+        };
+
+        Iterator begin() noexcept {
+            resume_timing();
+            return Iterator(this, m_iterations);
+        }
+
+        Iterator end() noexcept { return Iterator(this, 0); }
+
+    private:
+        size_type m_size;
+        size_type m_iterations;
+        size_type m_items = 1;
+        Perf_counters *m_perf;
+        clock::time_point m_start{};
+        clock::duration m_elapsed{};
+        std::vector<std::pair<std::string, double>> m_counters;
+    };
+
+    using Function = std::function<void(State &)>;
+
+    struct Benchmark {
+        std::string group;
+        std::string implementation;
+        Function function;
+        std::vector<size_type> sizes;
+    };
+
+    void add(std::string group, std::string implementation, Function function, std::vector<size_type> sizes);
+
+    std::vector<Benchmark> &registry();
+
+    // Runs `registration` during static initialization, so each benchmark file registers itself
+    struct Registrar {
+        explicit Registrar(const std::function<void()> &registration) { registration(); }
+    };
+
+    int run(int argc, char **argv);
+
+    // Keeps the compiler from discarding a result or hoisting work out of the loop
+    template<typename T>
+    inline void do_not_optimize(const T &value) {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    inline void clobber_memory() {
+        asm volatile("" : : : "memory");
+    }
+}
@@ -0,0 +1,119 @@
+#include <list>
+#include <memory_resource>
+#include <set>
+#include <vector>
+
+#include "harness.hpp"
+#include "workloads.hpp"
+#include "memory/monotonic_arena.hpp"
+#include "memory/slab_allocator.hpp"
+#include "sequence/list.hpp"
+#include "tree/red_black_tree.hpp"
+
+// Node-based containers on each memory resource, against the same containers on plain new/delete
+namespace {
+    enum class Resource { new_delete, arena, slab, pool };
+
+    // Owns the resource a benchmark run allocates from; `recycle` runs once the containers are gone
+    template<Resource R>
+    class Upstream {
+    public:
+        std::pmr::memory_resource *get() {
+            if constexpr (R == Resource::new_delete) return std::pmr::new_delete_resource();
+            else if constexpr (R == Resource::arena) return &m_arena;
+            else if constexpr (R == Resource::slab) return &m_slab;
+            else return &m_pool;
+        }
+
+        void recycle() {
+            if constexpr (R == Resource::arena) m_arena.reset();
+        }
+
+    private:
+        Monotonic_arena m_arena{1 << 16};
+        Slab_allocator m_slab;
+        std::pmr::unsynchronized_pool_resource m_pool;
+    };
+
+    void insert(std::pmr::list<int> &c, const int key) { c.push_back(key); }
+    void insert(pmr::List<int> &c, const int key) { c.push_back(key); }
+    void insert(std::pmr::set<int> &c, const int key) { c.insert(key); }
+    void insert(pmr::Red_black_tree<int> &c, const int key) { c.insert(key); }
+
+    // FIFO for the lists, an ordered replacement for the trees: either way one node dies and one is born
+    void replace(std::pmr::list<int> &c, const int, const int key) {
+        c.pop_front();
+        c.push_back(key);
+    }
+
+    void replace(pmr::List<int> &c, const int, const int key) {
+        c.pop_front();
+        c.push_back(key);
+    }
+
+    void replace(std::pmr::set<int> &c, const int old_key, const int key) {
+        c.erase(old_key);
+        c.insert(key);
+    }
+
+    void replace(pmr::Red_black_tree<int> &c, const int old_key, const int key) {
+        c.remove(old_key);
+        c.insert(key);
+    }
+
+    template<typename C, Resource R>
+    void build_destroy(bench::State &state) {
+        const auto keys = bench::shuffled_ints(state.size());
+        Upstream<R> upstream;
+        for (auto _ : state) {
+            {
+                C c(upstream.get());
+                for (const int key : keys) insert(c, key);
+                bench::do_not_optimize(c);
+            }
+            upstream.recycle();
+        }
+        state.set_items_per_iteration(state.size());
+    }
+
+    template<typename C, Resource R>
+    void churn(bench::State &state) {
+        const auto keys = bench::shuffled_ints(state.size());
+        const int n = static_cast<int>(state.size());
+        Upstream<R> upstream;
+        for (auto _ : state) {
+            {
+                state.pause_timing();
+                C c(upstream.get());
+                for (const int key : keys) insert(c, key);
+                state.resume_timing();
+                for (const int key : keys) replace(c, key, key + n);
+                bench::do_not_optimize(c);
+            }
+            upstream.recycle();
+        }
+        state.set_items_per_iteration(state.size());
+    }
+
+    const std::vector<std::size_t> SIZES{1 << 10, 1 << 14, 1 << 18};
+
+    template<typename C, typename Std>
+    void add_container(const std::string &group, const std::string &name, const std::string &std_name) {
+        bench::add(group + "/build_destroy", name + " + new/delete", build_destroy<C, Resource::new_delete>, SIZES);
+        bench::add(group + "/build_destroy", name + " + Monotonic_arena", build_destroy<C, Resource::arena>, SIZES);
+        bench::add(group + "/build_destroy", name + " + Slab_allocator", build_destroy<C, Resource::slab>, SIZES);
+        bench::add(group + "/build_destroy", name + " + pool_resource", build_destroy<C, Resource::pool>, SIZES);
+        bench::add(group + "/build_destroy", std_name, build_destroy<Std, Resource::new_delete>, SIZES);
+
+        bench::add(group + "/churn", name + " + new/delete", churn<C, Resource::new_delete>, SIZES);
+        bench::add(group + "/churn", name + " + Monotonic_arena", churn<C, Resource::arena>, SIZES);
+        bench::add(group + "/churn", name + " + Slab_allocator", churn<C, Resource::slab>, SIZES);
+        bench::add(group + "/churn", name + " + pool_resource", churn<C, Resource::pool>, SIZES);
+        bench::add(group + "/churn", std_name, churn<Std, Resource::new_delete>, SIZES);
+    }
+
+    const bench::Registrar registrar([] {
+        add_container<pmr::List<int>, std::pmr::list<int>>("memory/list", "List", "std::list");
+        add_container<pmr::Red_black_tree<int>, std::pmr::set<int>>("memory/red_black_tree", "Red_black_tree", "std::set");
+    });
+}
@@ -0,0 +1,131 @@
+#include "perf_counters.hpp"
+
+#include <cerrno>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace bench {
+#ifdef __linux__
+    namespace {
+        struct Event_config {
+            std::uint32_t type;
+            std::uint64_t config;
+        };
+
+        constexpr std::uint64_t cache_event(const std::uint64_t cache, const std::uint64_t op, const std::uint64_t result) {
+            return cache | op << 8 | result << 16;
+        }
+
+        constexpr std::array<Event_config, Perf_counters::EVENT_COUNT> EVENTS{{
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+            {PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ,
+                                             PERF_COUNT_HW_CACHE_RESULT_MISS)},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+            {PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_READ,
+                                             PERF_COUNT_HW_CACHE_RESULT_MISS)},
+        }};
+
+        // User-space only, so unprivileged runs work at perf_event_paranoid 2; inherited by new threads
+        int open_event(const Event_config &event) {
+            perf_event_attr attr{};
+            attr.size = sizeof attr;
+            attr.type = event.type;
+            attr.config = event.config;
+            attr.disabled = 1;
+            attr.inherit = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        }
+    }
+
+    Perf_counters::Perf_counters() {
+        m_fds.fill(-1);
+        int first_errno = 0;
+        for (int event = 0; event < EVENT_COUNT; ++event) {
+            m_fds[event] = open_event(EVENTS[event]);
+            if (m_fds[event] >= 0) ++m_open;
+            else if (!first_errno) first_errno = errno;
+        }
+        if (!m_open) {
+            m_error = std::strerror(first_errno);
+            if (first_errno == EACCES || first_errno == EPERM) m_error += " (see /proc/sys/kernel/perf_event_paranoid)";
+        }
+    }
+
+    Perf_counters::~Perf_counters() {
+        for (const int fd : m_fds) {
+            if (fd >= 0) close(fd);
+        }
+    }
+
+    // PERF_EVENT_IOC_RESET leaves the counts folded in from exited threads alone, so a
+    // reset records where the counters stand instead
+    void Perf_counters::reset() noexcept {
+        m_base = read_totals();
+    }
+
+    void Perf_counters::start() noexcept {
+        for (const int fd : m_fds) {
+            if (fd >= 0) ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+
+    void Perf_counters::stop() noexcept {
+        for (const int fd : m_fds) {
+            if (fd >= 0) ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+
+    Perf_counters::Values Perf_counters::read() const noexcept {
+        Values values = read_totals();
+        for (int event = 0; event < EVENT_COUNT; ++event) values[event] -= m_base[event];
+        return values;
+    }
+
+    Perf_counters::Values Perf_counters::read_totals() const noexcept {
+        Values values{};
+        for (int event = 0; event < EVENT_COUNT; ++event) {
+            std::uint64_t data[3]; // value, time enabled, time running
+            if (m_fds[event] < 0 || ::read(m_fds[event], data, sizeof data) != sizeof data) continue;
+            // Scale a multiplexed count up to the whole time the event was enabled
+            values[event] = data[2] ? static_cast<double>(data[0]) * static_cast<double>(data[1]) / static_cast<double>(data[2]) : 0;
+        }
+        return values;
+    }
+#else
+    Perf_counters::Perf_counters() : m_error("perf_event_open is Linux-only") {
+        m_fds.fill(-1);
+    }
+
+    Perf_counters::~Perf_counters() = default;
+
+    void Perf_counters::reset() noexcept {}
+    void Perf_counters::start() noexcept {}
+    void Perf_counters::stop() noexcept {}
+
+    Perf_counters::Values Perf_counters::read() const noexcept {
+        return {};
+    }
+
+    Perf_counters::Values Perf_counters::read_totals() const noexcept {
+        return {};
+    }
+#endif
+
+    const char *Perf_counters::name(const Event event) noexcept {
+        static constexpr const char *NAMES[EVENT_COUNT] = {
+            "cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses", "dtlb_misses"
+        };
+        return NAMES[event];
+    }
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+// Hardware event counters for the calling thread and the threads it starts, read through Linux
+// perf_event_open. Each event is opened on its own, so a counter the CPU or the hypervisor
+// doesn't offer is skipped rather than taking the others with it; counts are scaled up when
+// the kernel had to multiplex more events than there are hardware counters. Where perf is
+// unavailable altogether (no kernel support, perf_event_paranoid too high, not Linux),
+// available() is false and every call is a no-op.
+namespace bench {
+    class Perf_counters {
+    public:
+        enum Event { cycles, instructions, l1d_misses, llc_misses, branch_misses, dtlb_misses, EVENT_COUNT };
+
+        using Values = std::array<double, EVENT_COUNT>;
+
+        Perf_counters();
+        ~Perf_counters();
+
+        Perf_counters(const Perf_counters &) = delete;
+        Perf_counters &operator=(const Perf_counters &) = delete;
+
+        [[nodiscard]] bool available() const noexcept { return m_open > 0; }
+        [[nodiscard]] bool has(const Event event) const noexcept { return m_fds[event] >= 0; }
+
+        // Why nothing could be opened, for the one-line notice the runner prints
+        [[nodiscard]] const std::string &error() const noexcept { return m_error; }
+
+        // Zeroes the counts; start and stop then bracket what gets counted, any number of times
+        void reset() noexcept;
+        void start() noexcept;
+        void stop() noexcept;
+
+        // Counts since the last reset; an event that isn't open reads as 0
+        [[nodiscard]] Values read() const noexcept;
+
+        // Short names used in the output, such as "llc_misses"
+        static const char *name(Event event) noexcept;
+
+    private:
+        Values read_totals() const noexcept;
+
+        std::array<int, EVENT_COUNT> m_fds;
+        Values m_base{};
+        int m_open = 0;
+        std::string m_error;
+    };
+}
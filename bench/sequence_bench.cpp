@@ -0,0 +1,211 @@
+#include <deque>
+#include <forward_list>
+#include <list>
+#include <vector>
+
+#include "counting_allocator.hpp"
+#include "harness.hpp"
+#include "workloads.hpp"
+#include "sequence/deque.hpp"
+#include "sequence/forward_list.hpp"
+#include "sequence/list.hpp"
+#include "sequence/small_vector.hpp"
+#include "sequence/unrolled_list.hpp"
+#include "sequence/vector.hpp"
+
+namespace {
+    template<typename C>
+    void push_back(bench::State &state) {
+        for (auto _ : state) {
+            C c;
+            for (std::size_t i = 0; i < state.size(); ++i) c.push_back(static_cast<int>(i));
+            bench::do_not_optimize(c);
+        }
+        state.set_items_per_iteration(state.size());
+    }
+
+    template<typename C>
+    void push_front(bench::State &state) {
+        for (auto _ : state) {
+            C c;
+            for (std::size_t i = 0; i < state.size(); ++i) c.push_front(static_cast<int>(i));
+            bench::do_not_optimize(c);
+        }
+        state.set_items_per_iteration(state.size());
+    }
+
+    template<typename C>
+    void pop_front(bench::State &state) {
+        C c;
+        for (auto _ : state) {
+            state.pause_timing();
+            for (std::size_t i = 0; i < state.size(); ++i) c.push_back(static_cast<int>(i));
+            state.resume_timing();
+            while (!c.empty()) c.pop_front();
+            bench::clobber_memory();
+        }
+        state.set_items_per_iteration(state.size());
+    }
+
+    template<typename C>
+    C filled(const std::size_t count) {
+        C c;
+        for (const int value : bench::random_ints(count)) c.push_back(value);
+        return c;
+    }
+
+    template<typename C>
+    C filled_front(const std::size_t count) {
+        C c;
+        for (const int value : bench::random_ints(count)) c.push_front(value);
+        return c;
+    }
+
+    template<typename C>
+    void sum_all(const C &c) {
+        long long sum = 0;
+        for (const int value : c) sum += value;
+        bench::do_not_optimize(sum);
+    }
+
+    template<typename C>
+    void iterate_sum(bench::State &state) {
+        const C c = filled<C>(state.size());
+        for (auto _ : state) sum_all(c);
+        state.set_items_per_iteration(state.size());
+    }
+
+    template<typename C>
+    void iterate_sum_front(bench::State &state) {
+        const C c = filled_front<C>(state.size());
+        for (auto _ : state) sum_all(c);
+        state.set_items_per_iteration(state.size());
+    }
+
+    template<typename C>
+    void random_access(bench::State &state) {
+        C c = filled<C>(state.size());
+        const auto indices = bench::random_ints(state.size(), state.size(), bench::SEED + 1);
+        for (auto _ : state) {
+            long long sum = 0;
+            for (const int index : indices) sum += c[static_cast<std::size_t>(index)];
+            bench::do_not_optimize(sum);
+        }
+        state.set_items_per_iteration(state.size());
+    }
+
+    template<typename C>
+    void sort(bench::State &state) {
+        const auto values = bench::random_ints(state.size());
+        for (auto _ : state) {
+            state.pause_timing();
+            C c;
+            for (const int value : values) c.push_front(value);
+            state.resume_timing();
+            c.sort();
+            bench::do_not_optimize(c);
+        }
+        state.set_items_per_iteration(state.size());
+    }
+
+    template<typename C>
+    void construct_empty(bench::State &state) {
+        for (auto _ : state) {
+            C c;
+            bench::do_not_optimize(c);
+        }
+    }
+
+    // Many short vectors: what inline storage saves in allocations and bytes per vector
+    template<template<typename> class Make>
+    void build_short(bench::State &state) {
+        constexpr std::size_t ELEMENTS = 4;
+        bench::Allocation_tally tally;
+        using container = typename Make<bench::Counting_allocator<int>>::type;
+        for (auto _ : state) {
+            {
+                std::vector<container> all;
+                all.reserve(state.size());
+                for (std::size_t i = 0; i < state.size(); ++i) {
+                    all.emplace_back(bench::Counting_allocator<int>(tally));
+                    for (std::size_t j = 0; j < ELEMENTS; ++j) all.back().push_back(static_cast<int>(j));
+                }
+                bench::do_not_optimize(all.data());
+            }
+            state.pause_timing();
+            state.set_counter("allocations_per_vector", static_cast<double>(tally.allocations) / state.size());
+            state.set_counter("bytes_per_vector", sizeof(container) + static_cast<double>(tally.peak_bytes) / state.size());
+            tally = {};
+            state.resume_timing();
+        }
+        state.set_items_per_iteration(state.size());
+    }
+
+    template<typename Allocator>
+    struct Make_small_vector {
+        using type = Small_vector<int, 8, Allocator>;
+    };
+
+    template<typename Allocator>
+    struct Make_vector {
+        using type = Vector<int, Allocator>;
+    };
+
+    template<typename Allocator>
+    struct Make_std_vector {
+        using type = std::vector<int, Allocator>;
+    };
+
+    const std::vector<std::size_t> SIZES{1 << 10, 1 << 14, 1 << 18};
+
+    const bench::Registrar registrar([] {
+        bench::add("vector/push_back", "Vector", push_back<Vector<int>>, SIZES);
+        bench::add("vector/push_back", "std::vector", push_back<std::vector<int>>, SIZES);
+        bench::add("vector/iterate_sum", "Vector", iterate_sum<Vector<int>>, SIZES);
+        bench::add("vector/iterate_sum", "std::vector", iterate_sum<std::vector<int>>, SIZES);
+        bench::add("vector/random_access", "Vector", random_access<Vector<int>>, SIZES);
+        bench::add("vector/random_access", "std::vector", random_access<std::vector<int>>, SIZES);
+        bench::add("vector/construct_empty", "Vector", construct_empty<Vector<int>>, {0});
+        bench::add("vector/construct_empty", "std::vector", construct_empty<std::vector<int>>, {0});
+
+        bench::add("small_vector/build_4_elements", "Small_vector<int,8>", build_short<Make_small_vector>, SIZES);
+        bench::add("small_vector/build_4_elements", "Vector", build_short<Make_vector>, SIZES);
+        bench::add("small_vector/build_4_elements", "std::vector", build_short<Make_std_vector>, SIZES);
+        bench::add("small_vector/construct_empty", "Small_vector<int,8>", construct_empty<Small_vector<int, 8>>, {0});
+        bench::add("small_vector/construct_empty", "std::vector", construct_empty<std::vector<int>>, {0});
+
+        bench::add("deque/push_back", "Deque", push_back<Deque<int>>, SIZES);
+        bench::add("deque/push_back", "std::deque", push_back<std::deque<int>>, SIZES);
+        bench::add("deque/push_front", "Deque", push_front<Deque<int>>, SIZES);
+        bench::add("deque/push_front", "std::deque", push_front<std::deque<int>>, SIZES);
+        bench::add("deque/pop_front", "Deque", pop_front<Deque<int>>, SIZES);
+        bench::add("deque/pop_front", "std::deque", pop_front<std::deque<int>>, SIZES);
+        bench::add("deque/random_access", "Deque", random_access<Deque<int>>, SIZES);
+        bench::add("deque/random_access", "std::deque", random_access<std::deque<int>>, SIZES);
+        bench::add("deque/construct_empty", "Deque", construct_empty<Deque<int>>, {0});
+        bench::add("deque/construct_empty", "std::deque", construct_empty<std::deque<int>>, {0});
+
+        bench::add("list/push_back", "List", push_back<List<int>>, SIZES);
+        bench::add("list/push_back", "Unrolled_list", push_back<Unrolled_list<int>>, SIZES);
+        bench::add("list/push_back", "std::list", push_back<std::list<int>>, SIZES);
+        bench::add("list/pop_front", "List", pop_front<List<int>>, SIZES);
+        bench::add("list/pop_front", "Unrolled_list", pop_front<Unrolled_list<int>>, SIZES);
+        bench::add("list/pop_front", "std::list", pop_front<std::list<int>>, SIZES);
+        bench::add("list/iterate_sum", "List", iterate_sum<List<int>>, SIZES);
+        bench::add("list/iterate_sum", "Unrolled_list", iterate_sum<Unrolled_list<int>>, SIZES);
+        bench::add("list/iterate_sum", "std::list", iterate_sum<std::list<int>>, SIZES);
+        bench::add("list/sort", "List", sort<List<int>>, SIZES);
+        bench::add("list/sort", "std::list", sort<std::list<int>>, SIZES);
+        bench::add("list/construct_empty", "List", construct_empty<List<int>>, {0});
+        bench::add("list/construct_empty", "std::list", construct_empty<std::list<int>>, {0});
+
+        bench::add("forward_list/push_front", "Forward_list", push_front<Forward_list<int>>, SIZES);
+        bench::add("forward_list/push_front", "std::forward_list", push_front<std::forward_list<int>>, SIZES);
+        bench::add("forward_list/iterate_sum", "Forward_list", iterate_sum_front<Forward_list<int>>, SIZES);
+        bench::add("forward_list/iterate_sum", "std::forward_list", iterate_sum_front<std::forward_list<int>>, SIZES);
+        bench::add("forward_list/sort", "Forward_list", sort<Forward_list<int>>, SIZES);
+        bench::add("forward_list/sort", "std::forward_list", sort<std::forward_list<int>>, SIZES);
+        bench::add("forward_list/construct_empty", "Forward_list", construct_empty<Forward_list<int>>, {0});
+        bench::add("forward_list/construct_empty", "std::forward_list", construct_empty<std::forward_list<int>>, {0});
+    });
+}
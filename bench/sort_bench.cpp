@@ -0,0 +1,132 @@
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+#include "harness.hpp"
+#include "workloads.hpp"
+#include "algorithms/bubble_sort.hpp"
+#include "algorithms/heap_sort.hpp"
+#include "algorithms/insertion_sort.hpp"
+#include "algorithms/merge_sort.hpp"
+#include "algorithms/quick_sort.hpp"
+#include "algorithms/selection_sort.hpp"
+#include "algorithms/sort.hpp"
+#include "sequence/array.hpp"
+#include "sequence/vector.hpp"
+
+namespace {
+    enum class Order { random, sorted, reversed };
+
+    std::vector<int> input(const std::size_t count, const Order order) {
+        auto values = bench::random_ints(count);
+        if (order == Order::sorted) std::sort(values.begin(), values.end());
+        if (order == Order::reversed) std::sort(values.begin(), values.end(), std::greater<>());
+        return values;
+    }
+
+    // Copying the input back in is excluded, so only the sort itself is timed
+    template<typename C, typename Sort>
+    void sort(bench::State &state, const Order order, Sort sort_fn) {
+        const auto values = input(state.size(), order);
+        C c;
+        for (const int value : values) c.push_back(value);
+        for (auto _ : state) {
+            state.pause_timing();
+            for (std::size_t i = 0; i < values.size(); ++i) c[i] = values[i];
+            state.resume_timing();
+            sort_fn(c);
+            bench::do_not_optimize(c.data());
+        }
+        state.set_items_per_iteration(state.size());
+    }
+
+    template<Order O>
+    void bubble(bench::State &state) { sort<Vector<int>>(state, O, [](auto &c) { st::bubble_sort(c); }); }
+
+    template<Order O>
+    void selection(bench::State &state) { sort<Vector<int>>(state, O, [](auto &c) { st::selection_sort(c); }); }
+
+    template<Order O>
+    void insertion(bench::State &state) { sort<Vector<int>>(state, O, [](auto &c) { st::insertion_sort(c); }); }
+
+    template<Order O>
+    void heap(bench::State &state) { sort<Vector<int>>(state, O, [](auto &c) { st::heap_sort(c); }); }
+
+    template<Order O>
+    void merge(bench::State &state) { sort<Vector<int>>(state, O, [](auto &c) { st::merge_sort(c); }); }
+
+    template<Order O>
+    void quick(bench::State &state) { sort<Vector<int>>(state, O, [](auto &c) { st::quick_sort(c); }); }
+
+    template<Order O>
+    void introsort(bench::State &state) { sort<Vector<int>>(state, O, [](auto &c) { st::sort(c); }); }
+
+    template<Order O>
+    void std_sort(bench::State &state) {
+        sort<std::vector<int>>(state, O, [](auto &c) { std::sort(c.begin(), c.end()); });
+    }
+
+    template<Order O>
+    void std_stable_sort(bench::State &state) {
+        sort<std::vector<int>>(state, O, [](auto &c) { std::stable_sort(c.begin(), c.end()); });
+    }
+
+    // Sorts state.size() independent Arrays of N random ints each: the many-tiny-tuples case the
+    // sorting networks are for. Reported per Array.
+    template<std::size_t N, typename Sort>
+    void sort_arrays(bench::State &state, Sort sort_fn) {
+        const auto values = bench::random_ints(state.size() * N);
+        std::vector<Array<int, N>> arrays(state.size());
+        for (auto _ : state) {
+            state.pause_timing();
+            for (std::size_t a = 0; a < arrays.size(); ++a) {
+                for (std::size_t i = 0; i < N; ++i) arrays[a][i] = values[a * N + i];
+            }
+            state.resume_timing();
+            for (auto &array : arrays) sort_fn(array);
+            bench::do_not_optimize(arrays.data());
+        }
+        state.set_items_per_iteration(state.size());
+    }
+
+    template<std::size_t N>
+    void add_arrays(const std::string &group) {
+        const std::vector<std::size_t> counts{1 << 12};
+        bench::add(group, "st::sort", [](bench::State &state) { sort_arrays<N>(state, [](auto &a) { st::sort(a); }); }, counts);
+        bench::add(group, "st::insertion_sort", [](bench::State &state) {
+            sort_arrays<N>(state, [](auto &a) { st::insertion_sort_range(a, 0, N, std::less<>()); });
+        }, counts);
+        bench::add(group, "std::sort", [](bench::State &state) {
+            sort_arrays<N>(state, [](auto &a) { std::sort(a.data(), a.data() + N); });
+        }, counts);
+    }
+
+    const std::vector<std::size_t> SIZES{1 << 10, 1 << 14, 1 << 18};
+    const std::vector<std::size_t> QUADRATIC_SIZES{1 << 8, 1 << 10, 1 << 12};
+    // The baselines cover every size some implementation runs at
+    const std::vector<std::size_t> BASELINE_SIZES{1 << 8, 1 << 10, 1 << 12, 1 << 14, 1 << 18};
+
+    template<Order O>
+    void add_order(const std::string &group, const std::vector<std::size_t> &quick_sizes) {
+        bench::add(group, "st::bubble_sort", bubble<O>, QUADRATIC_SIZES);
+        bench::add(group, "st::selection_sort", selection<O>, QUADRATIC_SIZES);
+        bench::add(group, "st::insertion_sort", insertion<O>, QUADRATIC_SIZES);
+        bench::add(group, "st::heap_sort", heap<O>, SIZES);
+        bench::add(group, "st::merge_sort", merge<O>, SIZES);
+        bench::add(group, "st::quick_sort", quick<O>, quick_sizes);
+        bench::add(group, "st::sort", introsort<O>, SIZES);
+        bench::add(group, "std::sort", std_sort<O>, BASELINE_SIZES);
+        bench::add(group, "std::stable_sort", std_stable_sort<O>, BASELINE_SIZES);
+    }
+
+    const bench::Registrar registrar([] {
+        add_order<Order::random>("sort/random", SIZES);
+        // A last-element pivot makes presorted input the worst case
+        add_order<Order::sorted>("sort/sorted", QUADRATIC_SIZES);
+        add_order<Order::reversed>("sort/reversed", QUADRATIC_SIZES);
+        add_arrays<4>("sort/array_4");
+        add_arrays<8>("sort/array_8");
+        add_arrays<16>("sort/array_16");
+        add_arrays<32>("sort/array_32");
+    });
+}
@@ -0,0 +1,194 @@
+#include <algorithm>
+#include <set>
+#include <vector>
+
+#include "counting_allocator.hpp"
+#include "harness.hpp"
+#include "workloads.hpp"
+#include "algorithms/binary_search.hpp"
+#include "sequence/vector.hpp"
+#include "tree/avl_tree.hpp"
+#include "tree/binary_search_tree.hpp"
+#include "tree/binary_tree.hpp"
+#include "tree/red_black_tree.hpp"
+#include "tree/static_search_tree.hpp"
+
+namespace {
+    using Index_tree = Red_black_tree<int, Index_links>;
+
+    template<typename C>
+    void insert(C &c, const int key) { c.insert(key); }
+
+    void erase(std::set<int> &c, const int key) { c.erase(key); }
+    template<typename C>
+    void erase(C &c, const int key) { c.remove(key); }
+
+    template<typename C>
+    C filled(const std::vector<int> &keys) {
+        C c;
+        for (const int key : keys) insert(c, key);
+        return c;
+    }
+
+    template<typename C>
+    void insert_random(bench::State &state) {
+        const auto keys = bench::shuffled_ints(state.size());
+        for (auto _ : state) {
+            C c = filled<C>(keys);
+            bench::do_not_optimize(c);
+        }
+        state.set_items_per_iteration(state.size());
+    }
+
+    // Every other probe misses: keys are 0, 2, 4, ... and probes any value in [0, 2n)
+    template<typename C>
+    void contains(bench::State &state) {
+        auto keys = bench::shuffled_ints(state.size());
+        for (auto &key : keys) key *= 2;
+        const C c = filled<C>(keys);
+        const auto probes = bench::random_ints(state.size(), 2 * state.size(), bench::SEED + 1);
+        for (auto _ : state) {
+            std::size_t found = 0;
+            for (const int probe : probes) found += c.contains(probe);
+            bench::do_not_optimize(found);
+        }
+        state.set_items_per_iteration(state.size());
+    }
+
+    Vector<int> sorted_evens(const std::size_t count) {
+        Vector<int> sorted;
+        sorted.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) sorted.push_back(static_cast<int>(2 * i));
+        return sorted;
+    }
+
+    template<typename Search>
+    void sorted_contains(bench::State &state, Search search) {
+        const auto probes = bench::random_ints(state.size(), 2 * state.size(), bench::SEED + 1);
+        for (auto _ : state) {
+            std::size_t found = 0;
+            for (const int probe : probes) found += search(probe);
+            bench::do_not_optimize(found);
+        }
+        state.set_items_per_iteration(state.size());
+    }
+
+    template<Search_layout Layout>
+    void static_contains(bench::State &state) {
+        const Static_search_tree<int, Layout> tree(sorted_evens(state.size()));
+        sorted_contains(state, [&tree](const int probe) {
+            const int *found = tree.lower_bound(probe);
+            return found && *found == probe;
+        });
+    }
+
+    void st_lower_bound_contains(bench::State &state) {
+        const Vector<int> sorted = sorted_evens(state.size());
+        sorted_contains(state, [&sorted](const int probe) {
+            const std::size_t index = st::lower_bound(sorted.data(), sorted.size(), probe);
+            return index < sorted.size() && sorted[index] == probe;
+        });
+    }
+
+    void std_lower_bound_contains(bench::State &state) {
+        const Vector<int> sorted = sorted_evens(state.size());
+        sorted_contains(state, [&sorted](const int probe) {
+            const int *found = std::lower_bound(sorted.data(), sorted.data() + sorted.size(), probe);
+            return found != sorted.data() + sorted.size() && *found == probe;
+        });
+    }
+
+    template<typename C>
+    void remove_all(bench::State &state) {
+        const auto keys = bench::shuffled_ints(state.size());
+        const auto order = bench::shuffled_ints(state.size(), bench::SEED + 1);
+        for (auto _ : state) {
+            state.pause_timing();
+            C c = filled<C>(keys);
+            state.resume_timing();
+            for (const int key : order) erase(c, key);
+            bench::do_not_optimize(c);
+        }
+        state.set_items_per_iteration(state.size());
+    }
+
+    template<typename C>
+    void inorder_sum(bench::State &state) {
+        const C c = filled<C>(bench::shuffled_ints(state.size()));
+        for (auto _ : state) {
+            long long sum = 0;
+            if constexpr (requires { c.for_each_inorder([](int) {}); }) {
+                c.for_each_inorder([&sum](const int value) { sum += value; });
+            } else {
+                for (const int value : c) sum += value;
+            }
+            bench::do_not_optimize(sum);
+        }
+        state.set_items_per_iteration(state.size());
+    }
+
+    // Node footprint of each red-black layout, from what its allocator handed out
+    template<typename C>
+    void layout(bench::State &state) {
+        const auto keys = bench::shuffled_ints(state.size());
+        bench::Allocation_tally tally;
+        for (auto _ : state) {
+            {
+                C c{bench::Counting_allocator<int>(tally)};
+                for (const int key : keys) insert(c, key);
+                bench::do_not_optimize(c);
+            }
+            state.pause_timing();
+            state.set_counter("bytes_per_element", static_cast<double>(tally.peak_bytes) / state.size());
+            state.set_counter("allocations_per_element", static_cast<double>(tally.allocations) / state.size());
+            tally = {};
+            state.resume_timing();
+        }
+        state.set_items_per_iteration(state.size());
+    }
+
+    const std::vector<std::size_t> SIZES{1 << 10, 1 << 14, 1 << 18};
+    // Binary_tree fills level by level and searches exhaustively, so every operation is linear
+    const std::vector<std::size_t> LINEAR_SIZES{1 << 8, 1 << 10};
+
+    const bench::Registrar registrar([] {
+        bench::add("tree/insert", "Binary_search_tree", insert_random<Binary_search_tree<int>>, SIZES);
+        bench::add("tree/insert", "AVL_tree", insert_random<AVL_tree<int>>, SIZES);
+        bench::add("tree/insert", "Red_black_tree", insert_random<Red_black_tree<int>>, SIZES);
+        bench::add("tree/insert", "Red_black_tree<Index_links>", insert_random<Index_tree>, SIZES);
+        bench::add("tree/insert", "std::set", insert_random<std::set<int>>, SIZES);
+
+        bench::add("tree/contains", "Binary_search_tree", contains<Binary_search_tree<int>>, SIZES);
+        bench::add("tree/contains", "AVL_tree", contains<AVL_tree<int>>, SIZES);
+        bench::add("tree/contains", "Red_black_tree", contains<Red_black_tree<int>>, SIZES);
+        bench::add("tree/contains", "Red_black_tree<Index_links>", contains<Index_tree>, SIZES);
+        bench::add("tree/contains", "Static_search_tree<eytzinger>", static_contains<Search_layout::eytzinger>, SIZES);
+        bench::add("tree/contains", "Static_search_tree<veb>", static_contains<Search_layout::veb>, SIZES);
+        bench::add("tree/contains", "st::lower_bound", st_lower_bound_contains, SIZES);
+        bench::add("tree/contains", "sorted Vector, std::lower_bound", std_lower_bound_contains, SIZES);
+        bench::add("tree/contains", "std::set", contains<std::set<int>>, SIZES);
+
+        bench::add("tree/remove", "AVL_tree", remove_all<AVL_tree<int>>, SIZES);
+        bench::add("tree/remove", "Red_black_tree", remove_all<Red_black_tree<int>>, SIZES);
+        bench::add("tree/remove", "Red_black_tree<Index_links>", remove_all<Index_tree>, SIZES);
+        bench::add("tree/remove", "std::set", remove_all<std::set<int>>, SIZES);
+
+        bench::add("tree/inorder_sum", "Binary_search_tree", inorder_sum<Binary_search_tree<int>>, SIZES);
+        bench::add("tree/inorder_sum", "AVL_tree", inorder_sum<AVL_tree<int>>, SIZES);
+        bench::add("tree/inorder_sum", "Red_black_tree", inorder_sum<Red_black_tree<int>>, SIZES);
+        bench::add("tree/inorder_sum", "Red_black_tree<Index_links>", inorder_sum<Index_tree>, SIZES);
+        bench::add("tree/inorder_sum", "std::set", inorder_sum<std::set<int>>, SIZES);
+
+        bench::add("red_black_tree/layout", "Red_black_tree",
+                   layout<Red_black_tree<int, Pointer_links, bench::Counting_allocator<int>>>, SIZES);
+        bench::add("red_black_tree/layout", "Red_black_tree<Index_links>",
+                   layout<Red_black_tree<int, Index_links, bench::Counting_allocator<int>>>, SIZES);
+        bench::add("red_black_tree/layout", "std::set",
+                   layout<std::set<int, std::less<>, bench::Counting_allocator<int>>>, SIZES);
+
+        bench::add("binary_tree/insert", "Binary_tree", insert_random<Binary_tree<int>>, LINEAR_SIZES);
+        bench::add("binary_tree/insert", "std::set", insert_random<std::set<int>>, LINEAR_SIZES);
+        bench::add("binary_tree/contains", "Binary_tree", contains<Binary_tree<int>>, LINEAR_SIZES);
+        bench::add("binary_tree/contains", "std::set", contains<std::set<int>>, LINEAR_SIZES);
+    });
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <vector>
+
+// Input data shared by the benchmarks; every generator is seeded, so runs are comparable
+namespace bench {
+    constexpr std::uint64_t SEED = 0x5eed;
+
+    // `count` values drawn uniformly from [0, range), or from the whole int range when range is 0
+    inline std::vector<int> random_ints(const std::size_t count, const std::size_t range = 0,
+                                        const std::uint64_t seed = SEED) {
+        std::mt19937_64 rng(seed);
+        std::vector<int> values(count);
+        for (auto &value : values) {
+            value = range ? static_cast<int>(rng() % range) : static_cast<int>(rng());
+        }
+        return values;
+    }
+
+    // 0 .. count - 1 in random order: distinct keys
+    inline std::vector<int> shuffled_ints(const std::size_t count, const std::uint64_t seed = SEED) {
+        std::vector<int> values(count);
+        std::iota(values.begin(), values.end(), 0);
+        std::shuffle(values.begin(), values.end(), std::mt19937_64(seed));
+        return values;
+    }
+
+    // Keys 0 .. universe - 1 where key k is drawn with probability proportional to 1 / (k + 1)^skew
+    class Zipf_generator {
+    public:
+        Zipf_generator(const std::size_t universe, const double skew, const std::uint64_t seed = SEED) : m_rng(seed) {
+            m_cdf.resize(universe);
+            double sum = 0;
+            for (std::size_t k = 0; k < universe; ++k) {
+                sum += 1.0 / std::pow(static_cast<double>(k + 1), skew);
+                m_cdf[k] = sum;
+            }
+            for (auto &p : m_cdf) p /= sum;
+        }
+
+        std::size_t operator()() {
+            const double u = std::uniform_real_distribution<double>(0.0, 1.0)(m_rng);
+            const auto found = std::lower_bound(m_cdf.begin(), m_cdf.end(), u);
+            return static_cast<std::size_t>(std::min<std::ptrdiff_t>(found - m_cdf.begin(), m_cdf.size() - 1));
+        }
+
+    private:
+        std::vector<double> m_cdf;
+        std::mt19937_64 m_rng;
+    };
+
+    // `count` Zipf-distributed keys, scrambled so that popular keys are not also the small ones
+    inline std::vector<std::uint64_t> zipf_trace(const std::size_t count, const std::size_t universe, const double skew,
+                                                 const std::uint64_t seed = SEED) {
+        Zipf_generator zipf(universe, skew, seed);
+        std::vector<std::uint64_t> trace(count);
+        for (auto &key : trace) key = (zipf() + 1) * 0x9e3779b97f4a7c15ULL;
+        return trace;
+    }
+
+    // Runs body(thread_index) on `threads` threads at once and waits for all of them
+    template<typename F>
+    void run_threads(const std::size_t threads, F body) {
+        std::vector<std::thread> workers;
+        workers.reserve(threads);
+        for (std::size_t t = 0; t < threads; ++t) workers.emplace_back(body, t);
+        for (auto &worker : workers) worker.join();
+    }
+
+    // Resident set size of the process in bytes, 0 where /proc is unavailable
+    std::size_t resident_bytes();
+}
@@ -0,0 +1,147 @@
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+#include "fuzz.hpp"
+#include "associative/hash_map.hpp"
+#include "associative/hash_set.hpp"
+
+namespace {
+    void compare_map(const Hash_map<int, int> &map, const std::unordered_map<int, int> &ref) {
+        fuzz::check(map.size() == ref.size(), "size differs");
+        std::size_t visited = 0;
+        for (const auto &kv : map) {
+            const auto found = ref.find(kv.first());
+            fuzz::check(found != ref.end() && found->second == kv.second(), "iteration yields an entry the reference lacks");
+            ++visited;
+        }
+        fuzz::check(visited == ref.size(), "iteration visits the wrong number of entries");
+        for (const auto &[key, value] : ref) {
+            const int *found = map.find(key);
+            fuzz::check(found && *found == value, "entry missing or wrong");
+        }
+    }
+
+    std::size_t hash_map_target(fuzz::Input &in) {
+        Hash_map<int, int> map;
+        std::unordered_map<int, int> ref;
+        const auto full_check = [&] { compare_map(map, ref); };
+        return fuzz::drive(in, [&](const std::uint8_t op) {
+            const bool room = ref.size() < fuzz::MAX_ELEMENTS;
+            switch (op % 10) {
+            case 0:
+                if (room) {
+                    const int key = in.key();
+                    const int value = in.key();
+                    map.insert(key, value);
+                    ref.insert_or_assign(key, value);
+                }
+                break;
+            case 1:
+                if (room) {
+                    const int key = in.key();
+                    ++map[key];
+                    ++ref[key];
+                }
+                break;
+            case 2: {
+                const int key = in.key();
+                fuzz::check(map.remove(key) == (ref.erase(key) != 0), "remove result differs");
+                break;
+            }
+            case 3: {
+                const int key = in.key();
+                const int *found = map.find(key);
+                const auto expected = ref.find(key);
+                fuzz::check(expected == ref.end() ? !found : found && *found == expected->second, "find differs");
+                break;
+            }
+            case 4: {
+                const int key = in.key();
+                fuzz::check(map.contains(key) == ref.contains(key), "contains differs");
+                break;
+            }
+            case 5: {
+                const int key = in.key();
+                bool thrown = false;
+                try {
+                    fuzz::check(map.at(key) == ref.at(key), "at differs");
+                } catch (const std::out_of_range &) {
+                    thrown = true;
+                }
+                fuzz::check(thrown == !ref.contains(key), "at throws on the wrong keys");
+                break;
+            }
+            case 6:
+                map.clear();
+                ref.clear();
+                break;
+            case 7: {
+                // Long runs of new keys force rehashes
+                const int base = in.key();
+                for (int i = in.byte(); i > 0 && ref.size() < fuzz::MAX_ELEMENTS; --i) {
+                    map[base + i * fuzz::Input::KEY_RANGE] = i;
+                    ref[base + i * fuzz::Input::KEY_RANGE] = i;
+                }
+                break;
+            }
+            case 8: {
+                Hash_map<int, int> copy(map);
+                compare_map(copy, ref);
+                map = std::move(copy);
+                fuzz::check(copy.empty(), "moved-from map not empty");
+                break;
+            }
+            default: {
+                Hash_map<int, int> copy;
+                copy = map;
+                map.swap(copy);
+                break;
+            }
+            }
+        }, full_check);
+    }
+
+    std::size_t hash_set_target(fuzz::Input &in) {
+        Hash_set<int> set;
+        std::unordered_set<int> ref;
+        const auto full_check = [&] {
+            fuzz::check(set.size() == ref.size(), "size differs");
+            std::size_t visited = 0;
+            for (const int key : set) {
+                fuzz::check(ref.contains(key), "iteration yields a key the reference lacks");
+                ++visited;
+            }
+            fuzz::check(visited == ref.size(), "iteration visits the wrong number of keys");
+        };
+        return fuzz::drive(in, [&](const std::uint8_t op) {
+            const int key = in.key();
+            switch (op % 4) {
+            case 0:
+                if (ref.size() < fuzz::MAX_ELEMENTS) {
+                    set.insert(key);
+                    ref.insert(key);
+                }
+                break;
+            case 1:
+                fuzz::check(set.remove(key) == (ref.erase(key) != 0), "remove result differs");
+                break;
+            case 2:
+                fuzz::check(set.contains(key) == ref.contains(key), "contains differs");
+                break;
+            default:
+                if (op % 64 == 3) {
+                    set.clear();
+                    ref.clear();
+                }
+                break;
+            }
+        }, full_check);
+    }
+
+    const fuzz::Registrar registrar([] {
+        fuzz::add("Hash_map", hash_map_target);
+        fuzz::add("Hash_set", hash_set_target);
+    });
+}
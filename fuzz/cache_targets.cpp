@@ -0,0 +1,96 @@
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include "fuzz.hpp"
+#include "cache/cache.hpp"
+
+namespace {
+    // Capacity in bytes of value; empty strings weigh 0, which the policies must cope with
+    struct Byte_weigher {
+        std::size_t operator()(const int, const std::string &value) const noexcept { return value.size(); }
+    };
+
+    template<template<typename, typename> class Policy>
+    using Byte_cache = Cache<int, std::string, Policy, std::hash<int>, std::equal_to<int>, Byte_weigher>;
+
+    // A cache may drop any entry, so the reference only holds the last value put under each key:
+    // whatever the cache still has must match it, and its weight and size must add up
+    template<typename C>
+    void compare_cache(C &cache, const std::unordered_map<int, std::string> &ref) {
+        std::size_t weight = 0;
+        std::size_t size = 0;
+        for (const auto &[key, value] : ref) {
+            const std::string *cached = cache.peek(key);
+            if (!cached) continue;
+            fuzz::check(*cached == value, "cached value differs");
+            weight += value.size();
+            ++size;
+        }
+        fuzz::check(cache.size() == size, "size differs from the entries found");
+        fuzz::check(cache.weight() == weight, "weight differs from the entries found");
+        fuzz::check(cache.weight() <= cache.capacity(), "weight above capacity");
+    }
+
+    template<typename C>
+    std::size_t cache_target(fuzz::Input &in) {
+        C cache(in.byte() % 64);
+        std::unordered_map<int, std::string> ref;
+        // Few keys and short values, a fifth of them empty, so hits, evictions and ghost hits are common
+        const auto key = [&in] { return in.key() % 128; };
+        const auto value = [&in] { return std::string(in.byte() % 5, 'v'); };
+        const auto full_check = [&] { compare_cache(cache, ref); };
+        return fuzz::drive(in, [&](const std::uint8_t op) {
+            switch (op % 6) {
+            case 0:
+            case 1: {
+                const int k = key();
+                std::string v = value();
+                ref[k] = v;
+                cache.put(k, std::move(v));
+                fuzz::check(cache.weight() <= cache.capacity(), "weight above capacity after put");
+                break;
+            }
+            case 2: {
+                const int k = key();
+                const std::string *cached = cache.get(k);
+                const auto found = ref.find(k);
+                fuzz::check(!cached || (found != ref.end() && *cached == found->second), "get differs");
+                break;
+            }
+            case 3: {
+                const int k = key();
+                const bool erased = cache.erase(k);
+                fuzz::check(!erased || ref.contains(k), "erased a key never put");
+                ref.erase(k);
+                break;
+            }
+            case 4:
+                cache.set_capacity(in.byte() % 64);
+                break;
+            default:
+                if (op % 64 == 5) {
+                    cache.clear();
+                    ref.clear();
+                } else {
+                    // A run of puts over a few keys: the pattern that produces ghost hits
+                    const int first = key();
+                    for (int i = in.byte() % 32; i > 0; --i) {
+                        const int k = first + i % 8;
+                        std::string v = value();
+                        ref[k] = v;
+                        cache.put(k, std::move(v));
+                    }
+                }
+                break;
+            }
+        }, full_check);
+    }
+
+    const fuzz::Registrar registrar([] {
+        fuzz::add("Lru_cache", cache_target<Byte_cache<Lru_policy>>);
+        fuzz::add("Lfu_cache", cache_target<Byte_cache<Lfu_policy>>);
+        fuzz::add("Arc_cache", cache_target<Byte_cache<Arc_policy>>);
+        fuzz::add("Tiny_lfu_cache", cache_target<Byte_cache<Tiny_lfu_policy>>);
+    });
+}
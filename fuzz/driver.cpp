@@ -0,0 +1,101 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "fuzz.hpp"
+
+// Standalone driver for builds without libFuzzer: replays the files named on the command line,
+// or feeds each target random inputs for a while and reports its throughput. A failing input
+// is saved to ds_fuzz-crash.bin, which replays with `ds_fuzz ds_fuzz-crash.bin`.
+namespace {
+    using clock = std::chrono::steady_clock;
+
+    struct Options {
+        std::string target;
+        double seconds = 1;
+        std::uint64_t seed = 1;
+        std::size_t max_len = 4096;
+        std::vector<std::string> files;
+    };
+
+    void usage() {
+        std::cout << "usage: ds_fuzz [--target=TEXT] [--seconds=S] [--seed=N] [--max-len=N] [FILE...]\n"
+                     "  --target   fuzz only targets whose name contains TEXT\n"
+                     "  --seconds  time spent on each target (default 1)\n"
+                     "  --seed     seed of the random inputs (default 1)\n"
+                     "  --max-len  longest input in bytes (default 4096)\n"
+                     "  FILE       replay these inputs instead of fuzzing\n";
+    }
+
+    bool parse(const int argc, char **argv, Options &options) {
+        for (int i = 1; i < argc; ++i) {
+            const std::string_view arg = argv[i];
+            const auto value = [&arg](const std::string_view prefix) { return arg.substr(prefix.size()); };
+            if (arg.starts_with("--target=")) options.target = value("--target=");
+            else if (arg.starts_with("--seconds=")) options.seconds = std::atof(value("--seconds=").data());
+            else if (arg.starts_with("--seed=")) options.seed = std::strtoull(value("--seed=").data(), nullptr, 10);
+            else if (arg.starts_with("--max-len=")) options.max_len = std::max(2ULL, std::strtoull(value("--max-len=").data(), nullptr, 10));
+            else if (arg.starts_with("--")) {
+                usage();
+                return false;
+            } else {
+                options.files.emplace_back(arg);
+            }
+        }
+        return true;
+    }
+
+    int replay(const std::vector<std::string> &files) {
+        for (const auto &path : files) {
+            std::ifstream file(path, std::ios::binary);
+            if (!file) {
+                std::cerr << "ds_fuzz: cannot read " << path << "\n";
+                return 2;
+            }
+            const std::vector<std::uint8_t> data{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+            const std::size_t ops = fuzz::run(data.data(), data.size());
+            std::printf("%s: %zu operations, ok\n", path.c_str(), ops);
+        }
+        return 0;
+    }
+}
+
+int main(int argc, char **argv) {
+    Options options;
+    if (!parse(argc, argv, options)) return 2;
+    if (!options.files.empty()) return replay(options.files);
+
+    fuzz::set_crash_path("ds_fuzz-crash.bin");
+    const auto &targets = fuzz::registry();
+    std::mt19937_64 rng(options.seed);
+    std::vector<std::uint8_t> input;
+
+    std::printf("%-32s %10s %12s %14s\n", "target", "inputs", "operations", "ops/s");
+    for (std::size_t t = 0; t < targets.size(); ++t) {
+        if (targets[t].name.find(options.target) == std::string::npos) continue;
+
+        std::size_t inputs = 0;
+        std::size_t ops = 0;
+        const auto start = clock::now();
+        const auto deadline = start + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(options.seconds));
+        do {
+            input.resize(2 + rng() % (options.max_len - 1));
+            for (auto &byte : input) byte = static_cast<std::uint8_t>(rng());
+            input[0] = static_cast<std::uint8_t>(t);
+            ops += fuzz::run(input.data(), input.size());
+            ++inputs;
+        } while (clock::now() < deadline);
+
+        const double elapsed = std::chrono::duration<double>(clock::now() - start).count();
+        std::printf("%-32s %10zu %12zu %14.0f\n", targets[t].name.c_str(), inputs, ops, static_cast<double>(ops) / elapsed);
+    }
+    return 0;
+}
@@ -0,0 +1,69 @@
+#include "fuzz.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+
+// Provided by the sanitizer runtimes; null when none is linked in
+extern "C" __attribute__((weak)) void __sanitizer_set_death_callback(void (*callback)());
+
+namespace fuzz {
+    namespace {
+        struct Current {
+            const Target *target = nullptr;
+            const std::uint8_t *data = nullptr;
+            std::size_t size = 0;
+        };
+
+        Current current;
+        std::string crash_path;
+
+        void save_input() {
+            if (crash_path.empty() || !current.data) return;
+            std::ofstream file(crash_path, std::ios::binary);
+            file.write(reinterpret_cast<const char *>(current.data), static_cast<std::streamsize>(current.size));
+            if (file) std::fprintf(stderr, "ds_fuzz: input saved to %s\n", crash_path.c_str());
+        }
+    }
+
+    void fail(const std::string &what) {
+        std::fprintf(stderr, "ds_fuzz: %s: %s\n", current.target ? current.target->name.c_str() : "?", what.c_str());
+        save_input();
+        std::abort();
+    }
+
+    std::vector<Target> &registry() {
+        static std::vector<Target> targets;
+        return targets;
+    }
+
+    // Kept sorted by name, so which first byte picks which target doesn't depend on link order
+    void add(std::string name, Function function) {
+        auto &targets = registry();
+        const auto pos = std::lower_bound(targets.begin(), targets.end(), name,
+                                          [](const Target &target, const std::string &key) { return target.name < key; });
+        targets.insert(pos, {std::move(name), std::move(function)});
+    }
+
+    std::size_t run(const std::uint8_t *data, const std::size_t size) {
+        if (size == 0 || registry().empty()) return 0;
+        const Target &target = registry()[data[0] % registry().size()];
+        current = {&target, data, size};
+        Input in(data + 1, size - 1);
+        const std::size_t ops = target.function(in);
+        current = {};
+        return ops;
+    }
+
+    void set_crash_path(std::string path) {
+        crash_path = std::move(path);
+        // In a sanitizer build, a memory error found mid-input saves the input too
+        if (__sanitizer_set_death_callback) __sanitizer_set_death_callback(save_input);
+    }
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t *data, const std::size_t size) {
+    fuzz::run(data, size);
+    return 0;
+}
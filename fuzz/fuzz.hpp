@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Differential fuzzing behind ds_fuzz. A target decodes the fuzzer's bytes into a sequence of
+// operations, applies each one to a container of this library and to its std:: counterpart, and
+// checks that the two agree: return values after every operation, the full contents and the
+// container's structural invariants every few operations and at the end. The first byte of an
+// input picks the target, so one corpus covers them all and any saved input replays as is.
+//
+// Built with DS_LIBFUZZER, ds_fuzz is a libFuzzer binary; otherwise driver.cpp supplies a
+// standalone main that feeds random inputs and reports each target's throughput.
+namespace fuzz {
+    // Consumes the input from the front; reads past the end return zeros
+    class Input {
+    public:
+        Input(const std::uint8_t *data, const std::size_t size) : m_data(data), m_size(size) {}
+
+        [[nodiscard]] bool done() const noexcept { return m_pos >= m_size; }
+
+        std::uint8_t byte() noexcept { return m_pos < m_size ? m_data[m_pos++] : 0; }
+
+        std::uint16_t u16() noexcept {
+            const std::uint16_t low = byte();
+            return static_cast<std::uint16_t>(low | byte() << 8);
+        }
+
+        // A key in [0, KEY_RANGE): small enough that lookups hit and inserts collide often
+        int key() noexcept { return u16() % KEY_RANGE; }
+
+        // A position in [0, count]; 0 when count is 0
+        std::size_t index(const std::size_t count) noexcept { return u16() % (count + 1); }
+
+        static constexpr int KEY_RANGE = 1 << 10;
+
+    private:
+        const std::uint8_t *m_data;
+        std::size_t m_size;
+        std::size_t m_pos = 0;
+    };
+
+    // Containers stop growing past this many elements, which keeps one input fast and the
+    // unbalanced Binary_search_tree's recursion shallow
+    constexpr std::size_t MAX_ELEMENTS = 1 << 13;
+
+    // Full comparisons and invariant checks run after every this many operations
+    constexpr std::size_t FULL_CHECK_INTERVAL = 32;
+
+    // Reports a mismatch, saves the input when a crash path is set, and aborts
+    [[noreturn]] void fail(const std::string &what);
+
+    inline void check(const bool condition, const char *what) {
+        if (!condition) fail(what);
+    }
+
+    // Element-wise equality of two ranges; std::equal's four-iterator form would need
+    // std::distance, which doesn't know this library's iterator tags
+    template<typename It1, typename It2>
+    bool same_sequence(It1 first1, const It1 last1, It2 first2, const It2 last2) {
+        for (; first1 != last1 && first2 != last2; ++first1, ++first2) {
+            if (!(*first1 == *first2)) return false;
+        }
+        return first1 == last1 && first2 == last2;
+    }
+
+    // Runs `operation` once per opcode byte until the input is used up, with `full_check`
+    // at the interval and at the end; returns the number of operations
+    template<typename Operation, typename Full_check>
+    std::size_t drive(Input &in, Operation operation, Full_check full_check) {
+        std::size_t ops = 0;
+        while (!in.done()) {
+            operation(in.byte());
+            if (++ops % FULL_CHECK_INTERVAL == 0) full_check();
+        }
+        full_check();
+        return ops;
+    }
+
+    using Function = std::function<std::size_t(Input &)>;
+
+    struct Target {
+        std::string name;
+        Function function;
+    };
+
+    void add(std::string name, Function function);
+
+    std::vector<Target> &registry();
+
+    // Runs `registration` during static initialization, so each target file registers itself
+    struct Registrar {
+        explicit Registrar(const std::function<void()> &registration) { registration(); }
+    };
+
+    // Runs one input: its first byte picks the target, the rest drives it. Returns the number of
+    // operations performed.
+    std::size_t run(const std::uint8_t *data, std::size_t size);
+
+    // Where fail(), or a sanitizer error, writes the offending input; empty, the default, writes nothing
+    void set_crash_path(std::string path);
+}
@@ -0,0 +1,331 @@
+#include <algorithm>
+#include <deque>
+#include <iterator>
+#include <list>
+#include <utility>
+#include <vector>
+
+#include "fuzz.hpp"
+#include "sequence/deque.hpp"
+#include "sequence/list.hpp"
+#include "sequence/vector.hpp"
+
+namespace {
+    // Contents through indexing, forward iteration and reverse iteration
+    template<typename Container, typename Reference>
+    void compare_indexed(const Container &c, const Reference &ref) {
+        fuzz::check(c.size() == ref.size(), "size differs");
+        for (std::size_t i = 0; i < ref.size(); ++i) fuzz::check(c[i] == ref[i], "element differs");
+        fuzz::check(fuzz::same_sequence(c.begin(), c.end(), ref.begin(), ref.end()), "iteration differs");
+        fuzz::check(fuzz::same_sequence(c.rbegin(), c.rend(), ref.rbegin(), ref.rend()), "reverse iteration differs");
+    }
+
+    std::size_t vector_target(fuzz::Input &in) {
+        Vector<int> v;
+        std::vector<int> ref;
+        const auto full_check = [&] {
+            compare_indexed(v, ref);
+            fuzz::check(v.capacity() >= v.size(), "capacity below size");
+        };
+        return fuzz::drive(in, [&](const std::uint8_t op) {
+            const bool room = ref.size() < fuzz::MAX_ELEMENTS;
+            switch (op % 11) {
+            case 0:
+                if (room) {
+                    const int key = in.key();
+                    v.push_back(key);
+                    ref.push_back(key);
+                }
+                break;
+            case 1:
+                if (!ref.empty()) {
+                    fuzz::check(v.back() == ref.back(), "back differs");
+                    v.pop_back();
+                    ref.pop_back();
+                }
+                break;
+            case 2:
+                if (room) {
+                    const std::size_t pos = in.index(ref.size());
+                    const int key = in.key();
+                    v.insert(v.cbegin() + pos, key);
+                    ref.insert(ref.begin() + pos, key);
+                }
+                break;
+            case 3:
+                if (!ref.empty()) {
+                    const std::size_t pos = in.index(ref.size() - 1);
+                    v.erase(v.cbegin() + pos);
+                    ref.erase(ref.begin() + pos);
+                }
+                break;
+            case 4: {
+                const std::size_t first = in.index(ref.size());
+                const std::size_t last = first + in.index(ref.size() - first);
+                v.erase(v.cbegin() + first, v.cbegin() + last);
+                ref.erase(ref.begin() + first, ref.begin() + last);
+                break;
+            }
+            case 5: {
+                const std::size_t count = in.index(fuzz::MAX_ELEMENTS / 8);
+                const int key = in.key();
+                v.resize(count, key);
+                ref.resize(count, key);
+                break;
+            }
+            case 6:
+                if (!ref.empty()) {
+                    const std::size_t pos = in.index(ref.size() - 1);
+                    const int key = in.key();
+                    v[pos] = key;
+                    ref[pos] = key;
+                }
+                break;
+            case 7:
+                if (in.byte() % 2) v.reserve(in.index(fuzz::MAX_ELEMENTS));
+                else v.shrink_to_fit();
+                break;
+            case 8:
+                v.clear();
+                ref.clear();
+                break;
+            case 9:
+                for (int i = in.byte(); i > 0 && ref.size() < fuzz::MAX_ELEMENTS; --i) {
+                    v.push_back(i);
+                    ref.push_back(i);
+                }
+                break;
+            default: {
+                // Round trip through a copy and a move
+                Vector<int> copy(v);
+                fuzz::check(copy == v, "copy differs");
+                v = std::move(copy);
+                fuzz::check(copy.empty(), "moved-from vector not empty");
+                break;
+            }
+            }
+        }, full_check);
+    }
+
+    std::size_t deque_target(fuzz::Input &in) {
+        Deque<int> d;
+        std::deque<int> ref;
+        const auto full_check = [&] { compare_indexed(d, ref); };
+        return fuzz::drive(in, [&](const std::uint8_t op) {
+            const bool room = ref.size() < fuzz::MAX_ELEMENTS;
+            switch (op % 11) {
+            case 0:
+                if (room) {
+                    const int key = in.key();
+                    d.push_back(key);
+                    ref.push_back(key);
+                }
+                break;
+            case 1:
+                if (room) {
+                    const int key = in.key();
+                    d.push_front(key);
+                    ref.push_front(key);
+                }
+                break;
+            case 2:
+                if (!ref.empty()) {
+                    fuzz::check(d.back() == ref.back(), "back differs");
+                    d.pop_back();
+                    ref.pop_back();
+                }
+                break;
+            case 3:
+                if (!ref.empty()) {
+                    fuzz::check(d.front() == ref.front(), "front differs");
+                    d.pop_front();
+                    ref.pop_front();
+                }
+                break;
+            case 4:
+                if (room) {
+                    const std::size_t pos = in.index(ref.size());
+                    const int key = in.key();
+                    d.insert(d.begin() + pos, key);
+                    ref.insert(ref.begin() + pos, key);
+                }
+                break;
+            case 5: {
+                const std::size_t count = in.index(fuzz::MAX_ELEMENTS / 8);
+                const int key = in.key();
+                d.resize(count, key);
+                ref.resize(count, key);
+                break;
+            }
+            case 6:
+                if (!ref.empty()) {
+                    const std::size_t pos = in.index(ref.size() - 1);
+                    const int key = in.key();
+                    d.at(pos) = key;
+                    ref.at(pos) = key;
+                }
+                break;
+            case 7:
+                d.shrink_to_fit();
+                break;
+            case 8:
+                d.clear();
+                ref.clear();
+                break;
+            case 9: {
+                // A run at either end, long enough to cross blocks and grow the map
+                const bool front = in.byte() % 2;
+                for (int i = in.byte(); i > 0 && ref.size() < fuzz::MAX_ELEMENTS; --i) {
+                    if (front) {
+                        d.push_front(i);
+                        ref.push_front(i);
+                    } else {
+                        d.push_back(i);
+                        ref.push_back(i);
+                    }
+                }
+                break;
+            }
+            default: {
+                Deque<int> copy(d);
+                fuzz::check(copy == d, "copy differs");
+                d = std::move(copy);
+                fuzz::check(copy.empty(), "moved-from deque not empty");
+                break;
+            }
+            }
+        }, full_check);
+    }
+
+    // List has no indexing, so positions are reached by walking from the front
+    template<typename It>
+    It nth(It it, std::size_t n) {
+        while (n--) ++it;
+        return it;
+    }
+
+    template<typename Container, typename Reference>
+    void compare_sequence(const Container &c, const Reference &ref) {
+        fuzz::check(c.size() == ref.size(), "size differs");
+        fuzz::check(fuzz::same_sequence(c.begin(), c.end(), ref.begin(), ref.end()), "iteration differs");
+        fuzz::check(fuzz::same_sequence(c.rbegin(), c.rend(), ref.rbegin(), ref.rend()), "reverse iteration differs");
+        if (!ref.empty()) {
+            fuzz::check(c.front() == ref.front() && c.back() == ref.back(), "front or back differs");
+        }
+    }
+
+    // Two lists, so that splice and merge have a source
+    std::size_t list_target(fuzz::Input &in) {
+        List<int> lists[2];
+        std::list<int> refs[2];
+        const auto full_check = [&] {
+            compare_sequence(lists[0], refs[0]);
+            compare_sequence(lists[1], refs[1]);
+        };
+        return fuzz::drive(in, [&](const std::uint8_t op) {
+            const int which = op >> 7;
+            List<int> &l = lists[which];
+            std::list<int> &ref = refs[which];
+            List<int> &other = lists[1 - which];
+            std::list<int> &other_ref = refs[1 - which];
+            const bool room = ref.size() + other_ref.size() < fuzz::MAX_ELEMENTS;
+
+            switch (op % 14) {
+            case 0:
+                if (room) {
+                    const int key = in.key();
+                    l.push_back(key);
+                    ref.push_back(key);
+                }
+                break;
+            case 1:
+                if (room) {
+                    const int key = in.key();
+                    l.push_front(key);
+                    ref.push_front(key);
+                }
+                break;
+            case 2:
+                if (!ref.empty()) {
+                    l.pop_back();
+                    ref.pop_back();
+                }
+                break;
+            case 3:
+                if (!ref.empty()) {
+                    l.pop_front();
+                    ref.pop_front();
+                }
+                break;
+            case 4:
+                if (room) {
+                    const std::size_t pos = in.index(ref.size());
+                    const std::size_t count = in.byte() % 4;
+                    const int key = in.key();
+                    l.insert(nth(l.begin(), pos), count, key);
+                    ref.insert(nth(ref.begin(), pos), count, key);
+                }
+                break;
+            case 5: {
+                const int key = in.key();
+                fuzz::check(l.remove(key) == static_cast<std::size_t>(std::erase(ref, key)), "remove count differs");
+                break;
+            }
+            case 6: {
+                const int modulus = in.byte() % 7 + 2;
+                const auto odd = [modulus](const int value) { return value % modulus == 1; };
+                fuzz::check(l.remove_if(odd) == static_cast<std::size_t>(std::erase_if(ref, odd)), "remove_if count differs");
+                break;
+            }
+            case 7:
+                l.unique();
+                ref.unique();
+                break;
+            case 8:
+                l.sort();
+                ref.sort();
+                break;
+            case 9:
+                l.reverse();
+                ref.reverse();
+                break;
+            case 10:
+                if (!other_ref.empty()) {
+                    const std::size_t pos = in.index(ref.size());
+                    const std::size_t from = in.index(other_ref.size() - 1);
+                    l.splice(nth(l.begin(), pos), other, nth(other.begin(), from));
+                    ref.splice(nth(ref.begin(), pos), other_ref, nth(other_ref.begin(), from));
+                }
+                break;
+            case 11: {
+                const std::size_t pos = in.index(ref.size());
+                const std::size_t first = in.index(other_ref.size());
+                const std::size_t last = first + in.index(other_ref.size() - first);
+                l.splice(nth(l.begin(), pos), other, nth(other.begin(), first), nth(other.begin(), last));
+                ref.splice(nth(ref.begin(), pos), other_ref, nth(other_ref.begin(), first), nth(other_ref.begin(), last));
+                break;
+            }
+            case 12:
+                l.sort();
+                ref.sort();
+                other.sort();
+                other_ref.sort();
+                l.merge(other);
+                ref.merge(other_ref);
+                break;
+            default:
+                for (int i = in.byte(); i > 0 && ref.size() + other_ref.size() < fuzz::MAX_ELEMENTS; --i) {
+                    l.push_back(i);
+                    ref.push_back(i);
+                }
+                break;
+            }
+        }, full_check);
+    }
+
+    const fuzz::Registrar registrar([] {
+        fuzz::add("Vector", vector_target);
+        fuzz::add("Deque", deque_target);
+        fuzz::add("List", list_target);
+    });
+}
@@ -0,0 +1,113 @@
+#include <algorithm>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "fuzz.hpp"
+#include "tree/avl_tree.hpp"
+#include "tree/binary_search_tree.hpp"
+#include "tree/red_black_tree.hpp"
+
+namespace {
+    template<typename Tree>
+    concept Validated = requires(const Tree &tree) { tree.validate(); };
+
+    // Contents in order, then the tree's own invariants where it can check them
+    template<typename Tree, typename Reference>
+    void compare_tree(const Tree &tree, const Reference &ref) {
+        fuzz::check(tree.size() == ref.size(), "size differs");
+        std::vector<int> values;
+        values.reserve(ref.size());
+        tree.for_each_inorder([&values](const int value) { values.push_back(value); });
+        fuzz::check(fuzz::same_sequence(values.begin(), values.end(), ref.begin(), ref.end()), "in-order traversal differs");
+        if (!ref.empty()) fuzz::check(tree.min() == *ref.begin() && tree.max() == *ref.rbegin(), "min or max differs");
+
+        if constexpr (Validated<Tree>) {
+            try {
+                tree.validate();
+            } catch (const std::logic_error &error) {
+                fuzz::fail(error.what());
+            }
+        }
+    }
+
+    // Red_black_tree and Binary_search_tree keep duplicates, so they are checked against a
+    // multiset; AVL_tree ignores them like a set. Removals remove one copy.
+    template<typename Tree, typename Reference>
+    std::size_t tree_target(fuzz::Input &in) {
+        Tree tree;
+        Reference ref;
+        const auto full_check = [&] { compare_tree(tree, ref); };
+        const auto remove = [&](const int key) {
+            tree.remove(key);
+            const auto found = ref.find(key);
+            if (found != ref.end()) ref.erase(found);
+        };
+        return fuzz::drive(in, [&](const std::uint8_t op) {
+            const bool room = ref.size() < fuzz::MAX_ELEMENTS;
+            switch (op % 9) {
+            case 0:
+            case 1:
+                if (room) {
+                    const int key = in.key();
+                    tree.insert(key);
+                    ref.insert(key);
+                }
+                break;
+            case 2:
+            case 3:
+                remove(in.key());
+                break;
+            case 4: {
+                const int key = in.key();
+                fuzz::check(tree.contains(key) == ref.contains(key), "contains differs");
+                break;
+            }
+            case 5: {
+                // A strided run, ascending or descending: the inputs that drive the most rotations
+                const int start = in.key();
+                const int stride = in.byte() % 8 + 1;
+                const int direction = in.byte() % 2 ? 1 : -1;
+                for (int i = in.byte(); i > 0 && ref.size() < fuzz::MAX_ELEMENTS; --i) {
+                    const int key = start + direction * stride * i;
+                    tree.insert(key);
+                    ref.insert(key);
+                }
+                break;
+            }
+            case 6: {
+                // Removes every key in a range, taking out whole subtrees through delete_fixup
+                const int first = in.key();
+                const int last = first + in.byte();
+                for (int key = first; key <= last; ++key) {
+                    while (ref.contains(key)) remove(key);
+                    tree.remove(key);
+                }
+                break;
+            }
+            case 7:
+                if (!ref.empty()) remove(in.byte() % 2 ? *ref.begin() : *ref.rbegin());
+                break;
+            default:
+                if (op % 64 == 8) {
+                    tree.clear();
+                    ref.clear();
+                } else {
+                    Tree copy(tree);
+                    compare_tree(copy, ref);
+                    tree = std::move(copy);
+                }
+                break;
+            }
+        }, full_check);
+    }
+
+    const fuzz::Registrar registrar([] {
+        fuzz::add("Red_black_tree", tree_target<Red_black_tree<int>, std::multiset<int>>);
+        fuzz::add("Red_black_tree<Index_links>", tree_target<Red_black_tree<int, Index_links>, std::multiset<int>>);
+        fuzz::add("AVL_tree", tree_target<AVL_tree<int>, std::set<int>>);
+        fuzz::add("Binary_search_tree", tree_target<Binary_search_tree<int>, std::multiset<int>>);
+    });
+}
@@ -27,15 +27,15 @@ public:
     // Modifiers
     template<typename U>
     void push(U&& value) {
-        auto it = m_container.begin();
-        while (it != m_container.end() && !m_compare(value, *it)) {
+        auto it = m_container.cbegin();
+        while (it != m_container.cend() && !m_compare(value, *it)) {
             ++it;
         }
         m_container.insert(it, std::forward<U>(value));
     }
 
     void pop() noexcept {
-        m_container.erase(m_container.begin());
+        m_container.erase(m_container.cbegin());
     }
 
     void clear() noexcept { m_container.clear(); }
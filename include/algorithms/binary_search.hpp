@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+namespace st {
+    // Index of the first element in [first, first + count) for which comp(element, value) is false.
+    // Every step halves the range with a conditional move instead of a branch, so the loop runs
+    // exactly log2(count) times and never mispredicts.
+    template <typename T, typename U, typename Compare = std::less<>>
+    constexpr std::size_t lower_bound(const T *first, std::size_t count, const U &value, Compare comp = Compare{}) {
+        if (count == 0) return 0;
+
+        const T *base = first;
+        while (count > 1) {
+            const std::size_t half = count / 2;
+            base = comp(base[half - 1], value) ? base + half : base;
+            count -= half;
+        }
+        return static_cast<std::size_t>(base - first) + comp(*base, value);
+    }
+}
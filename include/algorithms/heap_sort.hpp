@@ -4,7 +4,7 @@
 
 namespace st {
     template <typename Container, typename Compare>
-    void heapify(Container &c, size_t i, size_t size, Compare comp) {
+    constexpr void heapify(Container &c, size_t i, size_t size, Compare comp) {
         size_t largest = i;
         size_t left = 2 * i + 1;
         size_t right = 2 * i + 2;
@@ -24,14 +24,14 @@ namespace st {
     }
 
     template <typename Container, typename Compare>
-    void build_heap(Container &c, Compare comp) {
+    constexpr void build_heap(Container &c, Compare comp) {
         for (int i = c.size() / 2 - 1; i >= 0; --i) {
             heapify(c, i, c.size(), comp);
         }
     }
 
     template <typename Container, typename Compare = std::less<>>
-    void heap_sort(Container &c, Compare comp = Compare{}) {
+    constexpr void heap_sort(Container &c, Compare comp = Compare{}) {
         build_heap(c, comp);
 
         for (int i = c.size() - 1; i > 0; --i) {
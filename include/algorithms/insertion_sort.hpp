@@ -4,7 +4,7 @@
 
 namespace st {
     template <typename Container, typename Compare = std::less<>>
-    void insertion_sort(Container &c, Compare comp = Compare{}) {
+    constexpr void insertion_sort(Container &c, Compare comp = Compare{}) {
         for (size_t i = 1; i < c.size(); ++i) {
             auto key = c[i];
             size_t j = i;
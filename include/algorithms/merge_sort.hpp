@@ -1,41 +1,107 @@
 #pragma once
 
+#include <cstddef>
 #include <functional>
+#include <type_traits>
+#include <utility>
+
+#include "algorithms/sorting_network.hpp"
 
 namespace st {
+    // Scratch buffer drawing from the same allocator as c
+    template <typename Container>
+    constexpr Container make_buffer(const Container &c) {
+        if constexpr (requires { c.get_allocator(); }) return Container(c.get_allocator());
+        else return Container();
+    }
+
+    // Indices of the closed ranges below. Signed, so that right == left - 1 still spells an empty
+    // range, and as wide as any container index, so sizes are never narrowed.
+    using sort_index = std::ptrdiff_t;
+
+    // Merges the sorted ranges [left, mid] and [mid + 1, right] of c. Only the left run is moved
+    // out, into `buffer`, whose capacity is reused; the right run is merged from where it lies,
+    // since the output never overtakes it.
     template <typename Container, typename Compare = std::less<>>
-    void merge(Container &c, const int left, const int mid, const int right, Compare comp = Compare{}) {
-        const int L_size = mid - left + 1;
-        const int R_size = right - mid;
-
-        Container L, R;
-        for (int i = 0; i < L_size; ++i) L.push_back(c[left + i]);
-        for (int i = 0; i < R_size; ++i) R.push_back(c[mid + 1 + i]);
-
-        int L_index = 0;
-        int R_index = 0;
-        int c_index = left;
-        while (L_index < L_size && R_index < R_size) {
-            if (comp(L[L_index], R[R_index])) c[c_index++] = L[L_index++];
-            else c[c_index++] = R[R_index++];
+    constexpr void merge_with_buffer(Container &c, const sort_index left, const sort_index mid, const sort_index right, Container &buffer,
+                           Compare comp = Compare{}) {
+        const sort_index L_size = mid - left + 1;
+
+        buffer.clear();
+        for (sort_index i = 0; i < L_size; ++i) buffer.push_back(std::move(c[left + i]));
+
+        sort_index L_index = 0;
+        sort_index R_index = mid + 1;
+        sort_index c_index = left;
+        // Taking from the buffer on ties keeps equal elements in their original order
+        while (L_index < L_size && R_index <= right) {
+            if (!comp(c[R_index], buffer[L_index])) c[c_index++] = std::move(buffer[L_index++]);
+            else c[c_index++] = std::move(c[R_index++]);
         }
 
-        while (L_index < L_size) c[c_index++] = L[L_index++];
-        while (R_index < R_size) c[c_index++] = R[R_index++];
+        while (L_index < L_size) c[c_index++] = std::move(buffer[L_index++]);
     }
 
+    // One allocation, for the buffer; merge_sort shares a single buffer across all its merges
     template <typename Container, typename Compare = std::less<>>
-    void merge_sort(Container &c, int left, int right, Compare comp = Compare{}) {
+    constexpr void merge(Container &c, const sort_index left, const sort_index mid, const sort_index right, Compare comp = Compare{}) {
+        Container buffer = make_buffer(c);
+        buffer.reserve(mid - left + 1);
+        merge_with_buffer(c, left, mid, right, buffer, comp);
+    }
+
+    // Merges the sorted ranges [0, mid) and [mid, size) of c in place, buffering only the tail,
+    // so appending a small sorted batch to a large sorted container costs one backward pass.
+    // Stable: of equal elements, those from the front range stay first.
+    template <typename Container, typename Compare = std::less<>>
+    constexpr void merge_tail(Container &c, const std::size_t mid, Compare comp = Compare{}) {
+        const std::size_t size = c.size();
+        if (mid == 0 || mid >= size || !comp(c[mid], c[mid - 1])) return;
+
+        Container tail = make_buffer(c);
+        tail.reserve(size - mid);
+        for (std::size_t i = mid; i < size; ++i) tail.push_back(std::move(c[i]));
+
+        std::size_t front = mid;
+        std::size_t back = size - mid;
+        std::size_t out = size;
+        while (back > 0) {
+            if (front > 0 && comp(tail[back - 1], c[front - 1])) c[--out] = std::move(c[--front]);
+            else c[--out] = std::move(tail[--back]);
+        }
+    }
+
+    // Sorts [left, right] of c, with `buffer` as scratch space for the merges. Short ranges of
+    // integers under the standard orders go to a sorting network, which is unstable, but equal
+    // integers can't be told apart.
+    template <typename Container, typename Compare = std::less<>>
+    constexpr void merge_sort(Container &c, sort_index left, sort_index right, Container &buffer, Compare comp = Compare{}) {
+        using value_type = std::remove_cvref_t<decltype(c[0])>;
+        if constexpr (equal_means_identical<value_type, Compare>) {
+            if (right - left < static_cast<sort_index>(NETWORK_THRESHOLD)) {
+                if (left < right) network_sort(c, static_cast<std::size_t>(left), static_cast<std::size_t>(right - left + 1), comp);
+                return;
+            }
+        }
         if (left < right) {
-            int mid = left + (right - left) / 2;
-            merge_sort(c, left, mid, comp);
-            merge_sort(c, mid + 1, right, comp);
-            merge(c, left, mid, right, comp);
+            sort_index mid = left + (right - left) / 2;
+            merge_sort(c, left, mid, buffer, comp);
+            merge_sort(c, mid + 1, right, buffer, comp);
+            merge_with_buffer(c, left, mid, right, buffer, comp);
         }
     }
 
+    // The largest left run is half the range, so the buffer is reserved once up front
+    template <typename Container, typename Compare = std::less<>>
+    constexpr void merge_sort(Container &c, sort_index left, sort_index right, Compare comp = Compare{}) {
+        if (left >= right) return;
+        Container buffer = make_buffer(c);
+        buffer.reserve((right - left) / 2 + 1);
+        merge_sort(c, left, right, buffer, comp);
+    }
+
     template <typename Container, typename Compare = std::less<>>
-    void merge_sort(Container &c, Compare comp = Compare{}) {
-        if (!c.empty()) merge_sort(c, 0, c.size() - 1, comp);
+    constexpr void merge_sort(Container &c, Compare comp = Compare{}) {
+        if (!c.empty()) merge_sort(c, 0, static_cast<sort_index>(c.size()) - 1, comp);
     }
-}
\ No newline at end of file
+}
@@ -1,10 +1,13 @@
 #pragma once
 
+#include <cstddef>
 #include <functional>
 
+#include "algorithms/sorting_network.hpp"
+
 namespace st {
     template <typename Container, typename Compare = std::less<> >
-    int partition(Container &c, const int left, const int right, Compare comp = Compare{}) {
+    constexpr int partition(Container &c, const int left, const int right, Compare comp = Compare{}) {
         auto pivot = c[right];
         int i = left - 1;
 
@@ -19,17 +22,20 @@ namespace st {
     }
 
     template <typename Container, typename Compare = std::less<> >
-    void quick_sort(Container &c, const int left, const int right, Compare comp = Compare{}) {
-        if (left < right) {
-            const int pivot = partition(c, left, right, comp);
-            quick_sort(c, left, pivot - 1, comp);
-            quick_sort(c, pivot + 1, right, comp);
+    constexpr void quick_sort(Container &c, const int left, const int right, Compare comp = Compare{}) {
+        // Short ranges go to a sorting network: no partitioning passes, and on scalars no branches
+        if (right - left < static_cast<int>(NETWORK_THRESHOLD)) {
+            if (left < right) network_sort(c, static_cast<std::size_t>(left), static_cast<std::size_t>(right - left + 1), comp);
+            return;
         }
+        const int pivot = partition(c, left, right, comp);
+        quick_sort(c, left, pivot - 1, comp);
+        quick_sort(c, pivot + 1, right, comp);
     }
 
     // Wrapper function for simple call
     template <typename Container, typename Compare = std::less<> >
-    void quick_sort(Container &c, Compare comp = Compare{}) {
+    constexpr void quick_sort(Container &c, Compare comp = Compare{}) {
         if (!c.empty()) {
             quick_sort(c, 0, c.size() - 1, comp);
         }
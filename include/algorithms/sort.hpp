@@ -0,0 +1,112 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <functional>
+#include <utility>
+
+#include "algorithms/sorting_network.hpp"
+#include "sequence/array.hpp"
+
+namespace st {
+    // Ranges this short are left to insertion sort
+    inline constexpr std::size_t SORT_THRESHOLD = 16;
+
+    // Sorts [first, last) of c by insertion; the base case of sort
+    template <typename Container, typename Compare>
+    constexpr void insertion_sort_range(Container &c, const std::size_t first, const std::size_t last, Compare comp) {
+        for (std::size_t i = first + 1; i < last; ++i) {
+            auto key = std::move(c[i]);
+            std::size_t j = i;
+            for (; j > first && comp(key, c[j - 1]); --j) c[j] = std::move(c[j - 1]);
+            c[j] = std::move(key);
+        }
+    }
+
+    // Restores the max-heap below `root` in the heap of `size` elements stored from c[first]
+    template <typename Container, typename Compare>
+    constexpr void sift_down(Container &c, const std::size_t first, std::size_t root, const std::size_t size, Compare comp) {
+        using std::swap;
+        for (std::size_t child = 2 * root + 1; child < size; child = 2 * root + 1) {
+            if (child + 1 < size && comp(c[first + child], c[first + child + 1])) ++child;
+            if (!comp(c[first + root], c[first + child])) return;
+            swap(c[first + root], c[first + child]);
+            root = child;
+        }
+    }
+
+    // Sorts [first, last) of c by heap sort: sort's fallback once partitioning keeps going badly
+    template <typename Container, typename Compare>
+    constexpr void heap_sort_range(Container &c, const std::size_t first, const std::size_t last, Compare comp) {
+        using std::swap;
+        const std::size_t size = last - first;
+        for (std::size_t i = size / 2; i-- > 0;) sift_down(c, first, i, size, comp);
+        for (std::size_t end = size - 1; end > 0; --end) {
+            swap(c[first], c[first + end]);
+            sift_down(c, first, 0, end, comp);
+        }
+    }
+
+    // Introsort of [first, last): quicksort around a median-of-three pivot, heap sort for ranges
+    // that exhaust `depth`, insertion sort for short ones. Recurses into the smaller side only,
+    // so the stack stays logarithmic.
+    template <typename Container, typename Compare>
+    constexpr void introsort(Container &c, std::size_t first, std::size_t last, int depth, Compare comp) {
+        using std::swap;
+        while (last - first > SORT_THRESHOLD) {
+            if (depth-- == 0) {
+                heap_sort_range(c, first, last, comp);
+                return;
+            }
+
+            // Orders c[first] <= c[mid] <= c[last - 1], then makes the median the pivot at c[first]
+            const std::size_t mid = first + (last - first) / 2;
+            if (comp(c[mid], c[first])) swap(c[mid], c[first]);
+            if (comp(c[last - 1], c[mid])) {
+                swap(c[last - 1], c[mid]);
+                if (comp(c[mid], c[first])) swap(c[mid], c[first]);
+            }
+            swap(c[first], c[mid]);
+
+            // Hoare partition; both scans stop on keys equal to the pivot, which keeps runs of
+            // duplicates split evenly
+            std::size_t i = first;
+            std::size_t j = last;
+            while (true) {
+                while (comp(c[++i], c[first])) {
+                    if (i == last - 1) break;
+                }
+                while (comp(c[first], c[--j])) {}
+                if (i >= j) break;
+                swap(c[i], c[j]);
+            }
+            swap(c[first], c[j]);
+
+            if (j - first < last - j - 1) {
+                introsort(c, first, j, depth, comp);
+                first = j + 1;
+            } else {
+                introsort(c, j + 1, last, depth, comp);
+                last = j;
+            }
+        }
+        insertion_sort_range(c, first, last, comp);
+    }
+
+    // Unstable O(n log n) sort of any container with size() and operator[], and usable in
+    // constant expressions; prefer it to quick_sort, whose last-element pivot goes quadratic on
+    // sorted input
+    template <typename Container, typename Compare = std::less<>>
+    constexpr void sort(Container &c, Compare comp = Compare{}) {
+        const std::size_t size = c.size();
+        if (size > 1) introsort(c, 0, size, 2 * static_cast<int>(std::bit_width(size)), comp);
+    }
+
+    // An Array's size is known at compile time: up to NETWORK_MAX elements it is sorted by the
+    // network for that size, fully unrolled
+    template <typename T, std::size_t N, typename Compare = std::less<>>
+    constexpr void sort(Array<T, N> &a, Compare comp = Compare{}) {
+        if constexpr (N <= NETWORK_MAX) network_sort<N>(a, 0, comp);
+        else introsort(a, 0, N, 2 * static_cast<int>(std::bit_width(N)), comp);
+    }
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+
+#include "algorithms/binary_search.hpp"
+#include "algorithms/sort.hpp"
+#include "sequence/array.hpp"
+#include "utils/pair.hpp"
+
+// Immutable ordered map of exactly N key/value pairs, held sorted by key in an Array; the map
+// counterpart of Fixed_flat_set. Built in a constant expression, a lookup table costs nothing
+// at startup:
+//
+//     constexpr Fixed_flat_map http_status(Array<Pair<int, std::string_view>, 3>{
+//         {404, "Not Found"}, {200, "OK"}, {500, "Internal Server Error"}});
+//     static_assert(*http_status.find(200) == "OK");
+//
+// The pairs may be given in any order; a duplicate key throws std::invalid_argument, which in a
+// constant expression is a compile error.
+template <typename Key, typename Value, std::size_t N, typename Compare = std::less<>>
+class Fixed_flat_map {
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using value_type = Pair<Key, Value>;
+    using key_compare = Compare;
+    using size_type = std::size_t;
+    using iterator = Random_access_iterator<const value_type>;
+    using const_iterator = Random_access_iterator<const value_type>;
+
+    // Constructors
+    constexpr explicit Fixed_flat_map(const Array<value_type, N> &pairs, const Compare &comp = Compare{})
+        : m_data(pairs), m_comp(comp) {
+        st::sort(m_data, [this](const value_type &lhs, const value_type &rhs) {
+            return m_comp(lhs.first(), rhs.first());
+        });
+        for (size_type i = 1; i < N; ++i) {
+            if (!m_comp(m_data[i - 1].first(), m_data[i].first())) throw std::invalid_argument("Duplicate key");
+        }
+    }
+
+    // Element access
+    template <typename K>
+    constexpr const mapped_type &at(const K &key) const {
+        const mapped_type *value = find(key);
+        if (!value) throw std::out_of_range("Key not found");
+        return *value;
+    }
+
+    // Capacity
+    [[nodiscard]] constexpr size_type size() const noexcept {
+        return N;
+    }
+
+    [[nodiscard]] constexpr bool empty() const noexcept {
+        return N == 0;
+    }
+
+    // Lookup
+    template <typename K>
+    constexpr const mapped_type *find(const K &key) const {
+        const size_type index = lower_bound_index(key);
+        return index < N && !m_comp(key, m_data[index].first()) ? &m_data[index].second() : nullptr;
+    }
+
+    template <typename K>
+    constexpr bool contains(const K &key) const {
+        return find(key) != nullptr;
+    }
+
+    // Position of `key` in sorted order, or size() when absent: a dense id for each key
+    template <typename K>
+    constexpr size_type index_of(const K &key) const {
+        const size_type index = lower_bound_index(key);
+        return index < N && !m_comp(key, m_data[index].first()) ? index : N;
+    }
+
+    template <typename K>
+    constexpr const_iterator lower_bound(const K &key) const {
+        return begin() + static_cast<std::ptrdiff_t>(lower_bound_index(key));
+    }
+
+    // Iterators
+    constexpr const_iterator begin() const noexcept {
+        return m_data.begin();
+    }
+
+    constexpr const_iterator end() const noexcept {
+        return m_data.end();
+    }
+
+private:
+    Array<value_type, N> m_data;
+    [[no_unique_address]] Compare m_comp;
+
+    template <typename K>
+    constexpr size_type lower_bound_index(const K &key) const {
+        return st::lower_bound(m_data.data(), N, key, [this](const value_type &kv, const K &k) {
+            return m_comp(kv.first(), k);
+        });
+    }
+};
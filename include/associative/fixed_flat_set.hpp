@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+
+#include "algorithms/binary_search.hpp"
+#include "algorithms/sort.hpp"
+#include "sequence/array.hpp"
+
+// Immutable ordered set of exactly N keys, held sorted in an Array. Everything is constexpr, so
+// a table that never changes can be built by the compiler instead of at startup:
+//
+//     constexpr Fixed_flat_set keywords(Array<std::string_view, 3>{"while", "if", "else"});
+//     static_assert(keywords.contains("if") && keywords.index_of("while") == 2);
+//
+// The keys may be given in any order; a duplicate throws std::invalid_argument, which in a
+// constant expression is a compile error. Lookups are Flat_set's branchless binary searches and
+// accept any key type the comparator does.
+template <typename Key, std::size_t N, typename Compare = std::less<>>
+class Fixed_flat_set {
+public:
+    using key_type = Key;
+    using value_type = Key;
+    using key_compare = Compare;
+    using size_type = std::size_t;
+    using const_pointer = const Key *;
+    using iterator = Random_access_iterator<const Key>;
+    using const_iterator = Random_access_iterator<const Key>;
+
+    // Constructors
+    constexpr explicit Fixed_flat_set(const Array<Key, N> &keys, const Compare &comp = Compare{})
+        : m_keys(keys), m_comp(comp) {
+        st::sort(m_keys, m_comp);
+        for (size_type i = 1; i < N; ++i) {
+            if (!m_comp(m_keys[i - 1], m_keys[i])) throw std::invalid_argument("Duplicate key");
+        }
+    }
+
+    // Capacity
+    [[nodiscard]] constexpr size_type size() const noexcept {
+        return N;
+    }
+
+    [[nodiscard]] constexpr bool empty() const noexcept {
+        return N == 0;
+    }
+
+    // Lookup
+    template <typename K>
+    constexpr const_pointer find(const K &key) const {
+        const size_type index = lower_bound_index(key);
+        return index < N && !m_comp(key, m_keys[index]) ? &m_keys[index] : nullptr;
+    }
+
+    template <typename K>
+    constexpr bool contains(const K &key) const {
+        return find(key) != nullptr;
+    }
+
+    // Position of `key` in sorted order, or size() when absent: a dense id for each key
+    template <typename K>
+    constexpr size_type index_of(const K &key) const {
+        const size_type index = lower_bound_index(key);
+        return index < N && !m_comp(key, m_keys[index]) ? index : N;
+    }
+
+    template <typename K>
+    constexpr const_iterator lower_bound(const K &key) const {
+        return begin() + static_cast<std::ptrdiff_t>(lower_bound_index(key));
+    }
+
+    constexpr const Key &operator[](const size_type index) const {
+        return m_keys[index];
+    }
+
+    // Iterators
+    constexpr const_iterator begin() const noexcept {
+        return m_keys.begin();
+    }
+
+    constexpr const_iterator end() const noexcept {
+        return m_keys.end();
+    }
+
+private:
+    Array<Key, N> m_keys;
+    [[no_unique_address]] Compare m_comp;
+
+    template <typename K>
+    constexpr size_type lower_bound_index(const K &key) const {
+        return st::lower_bound(m_keys.data(), N, key, m_comp);
+    }
+};
@@ -0,0 +1,216 @@
+#pragma once
+
+#include <functional>
+#include <initializer_list>
+#include <stdexcept>
+
+#include "algorithms/binary_search.hpp"
+#include "algorithms/merge_sort.hpp"
+#include "sequence/vector.hpp"
+#include "utils/pair.hpp"
+#include "utils/stats.hpp"
+
+// Ordered map stored as a Vector of key/value pairs sorted by key.
+// Like Hash_map, inserting an existing key overwrites its value. Lookups are branchless binary
+// searches; batches should go through insert_range. Iteration is read-only, since a key changed
+// in place would break the order; values are changed through find, at and operator[].
+template <typename Key, typename Value, typename Compare = std::less<>,
+          typename Allocator = std::allocator<Pair<Key, Value>>, typename Stats = No_stats>
+class Flat_map {
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using value_type = Pair<Key, Value>;
+    using key_compare = Compare;
+    using allocator_type = Allocator;
+    using size_type = std::size_t;
+    using iterator = Random_access_iterator<const value_type>;
+    using const_iterator = Random_access_iterator<const value_type>;
+
+    // Constructors
+    Flat_map() = default;
+
+    explicit Flat_map(const Compare &comp, const allocator_type &alloc = allocator_type())
+        : m_data(alloc), m_comp(comp) {}
+
+    explicit Flat_map(const allocator_type &alloc) : m_data(alloc) {}
+
+    Flat_map(std::initializer_list<value_type> i_list, const Compare &comp = Compare{},
+             const allocator_type &alloc = allocator_type())
+        : m_data(alloc), m_comp(comp) {
+        insert_range(i_list);
+    }
+
+    Flat_map &operator=(std::initializer_list<value_type> i_list) {
+        clear();
+        insert_range(i_list);
+        return *this;
+    }
+
+    // Element access
+    mapped_type &operator[](const key_type &key) {
+        const size_type index = lower_bound_index(key);
+        if (index == m_data.size() || m_comp(key, m_data[index].first())) {
+            m_data.insert(m_data.cbegin() + static_cast<std::ptrdiff_t>(index), value_type(key, mapped_type{}));
+        }
+        return m_data[index].second();
+    }
+
+    mapped_type &at(const key_type &key) {
+        mapped_type *value = find(key);
+        if (!value) throw std::out_of_range("Key not found");
+        return *value;
+    }
+
+    const mapped_type &at(const key_type &key) const {
+        const mapped_type *value = find(key);
+        if (!value) throw std::out_of_range("Key not found");
+        return *value;
+    }
+
+    // Capacity
+    [[nodiscard]] size_type size() const {
+        return m_data.size();
+    }
+
+    [[nodiscard]] bool empty() const {
+        return m_data.empty();
+    }
+
+    [[nodiscard]] size_type capacity() const {
+        return m_data.capacity();
+    }
+
+    void reserve(const size_type count) {
+        m_data.reserve(count);
+    }
+
+    // Statistics, those of the underlying Vector
+    [[nodiscard]] Sequence_stats stats() const requires Stats::enabled {
+        return m_data.stats();
+    }
+
+    // Lookup
+    mapped_type *find(const key_type &key) {
+        const size_type index = lower_bound_index(key);
+        return index < m_data.size() && !m_comp(key, m_data[index].first()) ? &m_data[index].second() : nullptr;
+    }
+
+    const mapped_type *find(const key_type &key) const {
+        const size_type index = lower_bound_index(key);
+        return index < m_data.size() && !m_comp(key, m_data[index].first()) ? &m_data[index].second() : nullptr;
+    }
+
+    bool contains(const key_type &key) const {
+        return find(key) != nullptr;
+    }
+
+    const_iterator lower_bound(const key_type &key) const {
+        return begin() + static_cast<std::ptrdiff_t>(lower_bound_index(key));
+    }
+
+    [[nodiscard]] allocator_type get_allocator() const noexcept {
+        return m_data.get_allocator();
+    }
+
+    // Modifiers
+    void insert(const key_type &key, const mapped_type &value) {
+        const size_type index = lower_bound_index(key);
+        if (index < m_data.size() && !m_comp(key, m_data[index].first())) {
+            m_data[index].second() = value;
+            return;
+        }
+        m_data.insert(m_data.cbegin() + static_cast<std::ptrdiff_t>(index), value_type(key, value));
+    }
+
+    // Appends the batch, stable-sorts only the new tail and merges it into place in one pass.
+    // Later pairs win over earlier ones and over stored values, as with repeated insert calls.
+    template <typename Range>
+    void insert_range(const Range &range) {
+        const size_type old_size = m_data.size();
+        for (const auto &kv : range) m_data.push_back(kv);
+        if (m_data.size() == old_size) return;
+
+        const auto by_key = [this](const value_type &lhs, const value_type &rhs) {
+            return m_comp(lhs.first(), rhs.first());
+        };
+        const auto key_less = [this](const value_type &kv, const key_type &key) {
+            return m_comp(kv.first(), key);
+        };
+        st::merge_sort(m_data, static_cast<st::sort_index>(old_size), static_cast<st::sort_index>(m_data.size()) - 1, by_key);
+
+        size_type kept = old_size;
+        for (size_type i = old_size; i < m_data.size(); ++i) {
+            const key_type &key = m_data[i].first();
+            if (kept > old_size && !m_comp(m_data[kept - 1].first(), key)) {
+                m_data[kept - 1] = std::move(m_data[i]);
+                continue;
+            }
+            const size_type found = st::lower_bound(m_data.data(), old_size, key, key_less);
+            if (found < old_size && !m_comp(key, m_data[found].first())) {
+                m_data[found].second() = std::move(m_data[i].second());
+                continue;
+            }
+            if (kept != i) m_data[kept] = std::move(m_data[i]);
+            ++kept;
+        }
+        m_data.resize(kept);
+
+        st::merge_tail(m_data, old_size, by_key);
+    }
+
+    bool remove(const key_type &key) {
+        const size_type index = lower_bound_index(key);
+        if (index == m_data.size() || m_comp(key, m_data[index].first())) return false;
+        m_data.erase(m_data.cbegin() + static_cast<std::ptrdiff_t>(index));
+        return true;
+    }
+
+    void clear() {
+        m_data.clear();
+    }
+
+    void swap(Flat_map &other) noexcept {
+        using std::swap;
+        m_data.swap(other.m_data);
+        swap(m_comp, other.m_comp);
+    }
+
+    // Iterators
+    const_iterator begin() const noexcept {
+        return m_data.begin();
+    }
+
+    const_iterator end() const noexcept {
+        return m_data.end();
+    }
+
+    // Relational operators
+    bool operator==(const Flat_map &other) const {
+        return m_data == other.m_data;
+    }
+
+    bool operator!=(const Flat_map &other) const {
+        return !(*this == other);
+    }
+
+private:
+    Vector<value_type, Allocator, Stats> m_data;
+    [[no_unique_address]] Compare m_comp{};
+
+    size_type lower_bound_index(const key_type &key) const {
+        return st::lower_bound(m_data.data(), m_data.size(), key, [this](const value_type &kv, const key_type &k) {
+            return m_comp(kv.first(), k);
+        });
+    }
+};
+
+template <typename Key, typename Value, typename Compare, typename Allocator, typename Stats>
+void swap(Flat_map<Key, Value, Compare, Allocator, Stats> &lhs, Flat_map<Key, Value, Compare, Allocator, Stats> &rhs) noexcept {
+    lhs.swap(rhs);
+}
+
+namespace pmr {
+    template <typename Key, typename Value, typename Compare = std::less<>>
+    using Flat_map = ::Flat_map<Key, Value, Compare, std::pmr::polymorphic_allocator<Pair<Key, Value>>>;
+}
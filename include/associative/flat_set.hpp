@@ -0,0 +1,182 @@
+#pragma once
+
+#include <functional>
+#include <initializer_list>
+
+#include "algorithms/binary_search.hpp"
+#include "algorithms/merge_sort.hpp"
+#include "sequence/vector.hpp"
+#include "utils/stats.hpp"
+
+// Ordered set stored as a sorted Vector: one contiguous block, no per-element nodes.
+// Lookups are branchless binary searches; single inserts and removals shift the tail, so
+// batches should go through insert_range.
+template <typename Key, typename Compare = std::less<>, typename Allocator = std::allocator<Key>, typename Stats = No_stats>
+class Flat_set {
+public:
+    using key_type = Key;
+    using value_type = Key;
+    using key_compare = Compare;
+    using allocator_type = Allocator;
+    using container_type = Vector<Key, Allocator, Stats>;
+    using size_type = std::size_t;
+    using const_pointer = const Key *;
+    using iterator = Random_access_iterator<const Key>;
+    using const_iterator = Random_access_iterator<const Key>;
+
+    // Constructors
+    Flat_set() = default;
+
+    explicit Flat_set(const Compare &comp, const allocator_type &alloc = allocator_type())
+        : m_keys(alloc), m_comp(comp) {}
+
+    explicit Flat_set(const allocator_type &alloc) : m_keys(alloc) {}
+
+    // `keys` may be in any order and contain duplicates
+    explicit Flat_set(const container_type &keys, const Compare &comp = Compare{})
+        : m_keys(keys.get_allocator()), m_comp(comp) {
+        insert_range(keys);
+    }
+
+    Flat_set(std::initializer_list<key_type> i_list, const Compare &comp = Compare{},
+             const allocator_type &alloc = allocator_type())
+        : m_keys(alloc), m_comp(comp) {
+        insert_range(i_list);
+    }
+
+    Flat_set &operator=(std::initializer_list<key_type> i_list) {
+        clear();
+        insert_range(i_list);
+        return *this;
+    }
+
+    // Capacity
+    [[nodiscard]] size_type size() const {
+        return m_keys.size();
+    }
+
+    [[nodiscard]] bool empty() const {
+        return m_keys.empty();
+    }
+
+    [[nodiscard]] size_type capacity() const {
+        return m_keys.capacity();
+    }
+
+    void reserve(const size_type count) {
+        m_keys.reserve(count);
+    }
+
+    // Statistics, those of the underlying Vector
+    [[nodiscard]] Sequence_stats stats() const requires Stats::enabled {
+        return m_keys.stats();
+    }
+
+    // Lookup
+    const_iterator lower_bound(const key_type &key) const {
+        return begin() + static_cast<std::ptrdiff_t>(lower_bound_index(key));
+    }
+
+    const_pointer find(const key_type &key) const {
+        const size_type index = lower_bound_index(key);
+        return index < m_keys.size() && !m_comp(key, m_keys[index]) ? m_keys.data() + index : nullptr;
+    }
+
+    bool contains(const key_type &key) const {
+        return find(key) != nullptr;
+    }
+
+    // The underlying sorted storage
+    const container_type &keys() const {
+        return m_keys;
+    }
+
+    [[nodiscard]] allocator_type get_allocator() const noexcept {
+        return m_keys.get_allocator();
+    }
+
+    // Modifiers
+    // Returns false if the key was already present
+    bool insert(const key_type &key) {
+        const size_type index = lower_bound_index(key);
+        if (index < m_keys.size() && !m_comp(key, m_keys[index])) return false;
+        m_keys.insert(m_keys.cbegin() + static_cast<std::ptrdiff_t>(index), key);
+        return true;
+    }
+
+    // Appends the batch, sorts only the new tail, drops keys that are already present and merges
+    // the tail into place in one pass: O(n + k log k) instead of k shifting inserts.
+    template <typename Range>
+    void insert_range(const Range &range) {
+        const size_type old_size = m_keys.size();
+        for (const auto &key : range) m_keys.push_back(key);
+        if (m_keys.size() == old_size) return;
+
+        st::merge_sort(m_keys, static_cast<st::sort_index>(old_size), static_cast<st::sort_index>(m_keys.size()) - 1, m_comp);
+
+        size_type kept = old_size;
+        for (size_type i = old_size; i < m_keys.size(); ++i) {
+            if (kept > old_size && !m_comp(m_keys[kept - 1], m_keys[i])) continue;
+            const size_type found = st::lower_bound(m_keys.data(), old_size, m_keys[i], m_comp);
+            if (found < old_size && !m_comp(m_keys[i], m_keys[found])) continue;
+            if (kept != i) m_keys[kept] = std::move(m_keys[i]);
+            ++kept;
+        }
+        m_keys.resize(kept);
+
+        st::merge_tail(m_keys, old_size, m_comp);
+    }
+
+    bool remove(const key_type &key) {
+        const size_type index = lower_bound_index(key);
+        if (index == m_keys.size() || m_comp(key, m_keys[index])) return false;
+        m_keys.erase(m_keys.cbegin() + static_cast<std::ptrdiff_t>(index));
+        return true;
+    }
+
+    void clear() {
+        m_keys.clear();
+    }
+
+    void swap(Flat_set &other) noexcept {
+        using std::swap;
+        m_keys.swap(other.m_keys);
+        swap(m_comp, other.m_comp);
+    }
+
+    // Iterators
+    const_iterator begin() const noexcept {
+        return m_keys.begin();
+    }
+
+    const_iterator end() const noexcept {
+        return m_keys.end();
+    }
+
+    // Relational operators
+    bool operator==(const Flat_set &other) const {
+        return m_keys == other.m_keys;
+    }
+
+    bool operator!=(const Flat_set &other) const {
+        return !(*this == other);
+    }
+
+private:
+    container_type m_keys;
+    [[no_unique_address]] Compare m_comp{};
+
+    size_type lower_bound_index(const key_type &key) const {
+        return st::lower_bound(m_keys.data(), m_keys.size(), key, m_comp);
+    }
+};
+
+template <typename Key, typename Compare, typename Allocator, typename Stats>
+void swap(Flat_set<Key, Compare, Allocator, Stats> &lhs, Flat_set<Key, Compare, Allocator, Stats> &rhs) noexcept {
+    lhs.swap(rhs);
+}
+
+namespace pmr {
+    template <typename Key, typename Compare = std::less<>>
+    using Flat_set = ::Flat_set<Key, Compare, std::pmr::polymorphic_allocator<Key>>;
+}
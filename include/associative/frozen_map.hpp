@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+
+#include "associative/internal/perfect_hash.hpp"
+#include "sequence/array.hpp"
+#include "utils/pair.hpp"
+
+// Immutable hash map of exactly N key/value pairs over a minimal perfect hash: the pairs fill a
+// table of exactly N slots, one key per slot, so a lookup hashes once, reads one slot and
+// compares one key, hit or miss. The hash is searched for by the constructor, which runs in a
+// constant expression, so a table known at compile time is built by the compiler:
+//
+//     constexpr Frozen_map tokens(Array<Pair<std::string_view, int>, 3>{
+//         {"if", 1}, {"else", 2}, {"while", 3}});
+//     static_assert(tokens.at("while") == 3 && !tokens.contains("for"));
+//
+// For the tables of keywords and codes that Hash_map would otherwise be filled with at startup
+// and never changed; Fixed_flat_map is the ordered alternative. A duplicate key throws
+// std::invalid_argument, which in a constant expression is a compile error. Keys are hashed with
+// Frozen_hash by default. Construction takes O(N log N) hash evaluations; GCC's default constexpr
+// budget covers a few thousand keys, and a larger table can still be built at run time.
+template <typename Key, typename Value, std::size_t N, typename Hash = Frozen_hash<Key>, typename KeyEqual = std::equal_to<>>
+class Frozen_map {
+    static_assert(N > 0, "Frozen_map needs at least one key");
+
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using value_type = Pair<Key, Value>;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using size_type = std::size_t;
+    using iterator = Random_access_iterator<const value_type>;
+    using const_iterator = Random_access_iterator<const value_type>;
+
+    // Constructors
+    constexpr explicit Frozen_map(const Array<value_type, N> &pairs, const Hash &hash = Hash{},
+                                  const KeyEqual &equal = KeyEqual{})
+        : m_data(pairs), m_hash(hash), m_equal(equal) {
+        Array<std::uint32_t, N> slots;
+        m_table = phf::build<N>([&pairs](const size_type i) -> const Key & { return pairs[i].first(); },
+                                m_hash, m_equal, slots);
+        // Moves each pair to its slot by following the permutation's cycles
+        for (size_type i = 0; i < N; ++i) {
+            while (slots[i] != i) {
+                const size_type target = slots[i];
+                std::swap(m_data[i], m_data[target]);
+                std::swap(slots[i], slots[target]);
+            }
+        }
+    }
+
+    // Element access
+    template <typename K>
+    constexpr const mapped_type &at(const K &key) const {
+        const mapped_type *value = find(key);
+        if (!value) throw std::out_of_range("Key not found");
+        return *value;
+    }
+
+    // Capacity
+    [[nodiscard]] constexpr size_type size() const noexcept {
+        return N;
+    }
+
+    [[nodiscard]] constexpr bool empty() const noexcept {
+        return false;
+    }
+
+    // Lookup
+    template <typename K>
+    constexpr const mapped_type *find(const K &key) const {
+        const value_type &candidate = m_data[slot(key)];
+        return m_equal(candidate.first(), key) ? &candidate.second() : nullptr;
+    }
+
+    template <typename K>
+    constexpr bool contains(const K &key) const {
+        return find(key) != nullptr;
+    }
+
+    // Slot of `key`, or size() when absent: a dense id for each key, in no particular order
+    template <typename K>
+    constexpr size_type index_of(const K &key) const {
+        const size_type index = slot(key);
+        return m_equal(m_data[index].first(), key) ? index : N;
+    }
+
+    // Iterators, in slot order
+    constexpr const_iterator begin() const noexcept {
+        return m_data.begin();
+    }
+
+    constexpr const_iterator end() const noexcept {
+        return m_data.end();
+    }
+
+private:
+    Array<value_type, N> m_data;
+    phf::Table<N> m_table;
+    [[no_unique_address]] Hash m_hash;
+    [[no_unique_address]] KeyEqual m_equal;
+
+    template <typename K>
+    constexpr size_type slot(const K &key) const {
+        return m_table.slot(m_hash(key, m_table.seed));
+    }
+};
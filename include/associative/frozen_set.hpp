@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+#include "associative/internal/perfect_hash.hpp"
+#include "sequence/array.hpp"
+
+// Immutable hash set of exactly N keys over a minimal perfect hash; the set counterpart of
+// Frozen_map. Built in a constant expression, membership in a fixed keyword list costs one hash
+// and one comparison and nothing at startup:
+//
+//     constexpr Frozen_set keywords(Array<std::string_view, 3>{"while", "if", "else"});
+//     static_assert(keywords.contains("if") && !keywords.contains("for"));
+//
+// A duplicate key throws std::invalid_argument, which in a constant expression is a compile
+// error. Keys are hashed with Frozen_hash by default.
+template <typename Key, std::size_t N, typename Hash = Frozen_hash<Key>, typename KeyEqual = std::equal_to<>>
+class Frozen_set {
+    static_assert(N > 0, "Frozen_set needs at least one key");
+
+public:
+    using key_type = Key;
+    using value_type = Key;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using size_type = std::size_t;
+    using const_pointer = const Key *;
+    using iterator = Random_access_iterator<const Key>;
+    using const_iterator = Random_access_iterator<const Key>;
+
+    // Constructors
+    constexpr explicit Frozen_set(const Array<Key, N> &keys, const Hash &hash = Hash{},
+                                  const KeyEqual &equal = KeyEqual{})
+        : m_keys(keys), m_hash(hash), m_equal(equal) {
+        Array<std::uint32_t, N> slots;
+        m_table = phf::build<N>([&keys](const size_type i) -> const Key & { return keys[i]; }, m_hash, m_equal, slots);
+        for (size_type i = 0; i < N; ++i) {
+            while (slots[i] != i) {
+                const size_type target = slots[i];
+                std::swap(m_keys[i], m_keys[target]);
+                std::swap(slots[i], slots[target]);
+            }
+        }
+    }
+
+    // Capacity
+    [[nodiscard]] constexpr size_type size() const noexcept {
+        return N;
+    }
+
+    [[nodiscard]] constexpr bool empty() const noexcept {
+        return false;
+    }
+
+    // Lookup
+    template <typename K>
+    constexpr const_pointer find(const K &key) const {
+        const Key &candidate = m_keys[slot(key)];
+        return m_equal(candidate, key) ? &candidate : nullptr;
+    }
+
+    template <typename K>
+    constexpr bool contains(const K &key) const {
+        return find(key) != nullptr;
+    }
+
+    // Slot of `key`, or size() when absent: a dense id for each key, in no particular order
+    template <typename K>
+    constexpr size_type index_of(const K &key) const {
+        const size_type index = slot(key);
+        return m_equal(m_keys[index], key) ? index : N;
+    }
+
+    constexpr const Key &operator[](const size_type index) const {
+        return m_keys[index];
+    }
+
+    // Iterators, in slot order
+    constexpr const_iterator begin() const noexcept {
+        return m_keys.begin();
+    }
+
+    constexpr const_iterator end() const noexcept {
+        return m_keys.end();
+    }
+
+private:
+    Array<Key, N> m_keys;
+    phf::Table<N> m_table;
+    [[no_unique_address]] Hash m_hash;
+    [[no_unique_address]] KeyEqual m_equal;
+
+    template <typename K>
+    constexpr size_type slot(const K &key) const {
+        return m_table.slot(m_hash(key, m_table.seed));
+    }
+};
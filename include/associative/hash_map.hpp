@@ -1,74 +1,144 @@
 #pragma once
 
+#include <algorithm>
+
 #include "sequence/vector.hpp"
-#include "sequence/forward_list.hpp"
+#include "sequence/internal/node.hpp"
 #include "utils/pair.hpp"
+#include "utils/stats.hpp"
 #include "internal/hash_map_iterator.hpp"
 
-template <typename Key, typename Value>
+// Separate chaining over a flat array of chain heads: a bucket is one pointer, and the entries
+// are singly linked nodes from the map's allocator.
+template <typename Key, typename Value, typename Allocator = std::allocator<Pair<Key, Value>>, typename Stats = No_stats>
 class Hash_map {
+    using alloc_traits = std::allocator_traits<Allocator>;
+    using node_type = Node<Pair<Key, Value>>;
+    using node_allocator_type = mem::rebind<Allocator, node_type>;
+
 public:
     using key_type = Key;
     using mapped_type = Value;
     using value_type = Pair<Key, Value>;
+    using allocator_type = Allocator;
     using size_type = size_t;
-    using bucket_type = Forward_list<Pair<Key, Value>>;
+    using bucket_type = Node_base *;
+    using bucket_vector = Vector<bucket_type, mem::rebind<Allocator, bucket_type>>;
     using iterator = HashMapIterator<Hash_map>;
     using const_iterator = HashMapIterator<const Hash_map>;
 
     // Constructors
-    Hash_map() : m_buckets(4) ,m_bucket_count(4) {}
+    // Buckets are allocated on the first insertion
+    Hash_map() noexcept(noexcept(allocator_type())) : Hash_map(allocator_type()) {}
+
+    explicit Hash_map(const allocator_type &alloc) noexcept : m_buckets(alloc), m_bucket_count(0), m_size(0) {}
+
+    Hash_map(const Hash_map &other)
+        : Hash_map(other, alloc_traits::select_on_container_copy_construction(other.get_allocator())) {}
 
-    Hash_map(const Hash_map &other) : m_buckets(other.m_buckets),m_bucket_count(other.m_bucket_count) {}
+    Hash_map(const Hash_map &other, const allocator_type &alloc)
+        : m_buckets(other.m_buckets, alloc), m_bucket_count(other.m_bucket_count), m_size(0),
+          m_max_load_factor(other.m_max_load_factor) {
+        assign_entries(other);
+    }
+
+    Hash_map(Hash_map &&other) noexcept
+        : m_buckets(std::move(other.m_buckets)), m_bucket_count(other.m_bucket_count), m_size(other.m_size),
+          m_max_load_factor(other.m_max_load_factor) {
+        other.m_bucket_count = 0;
+        other.m_size = 0;
+    }
 
-    Hash_map(Hash_map &&other) noexcept : m_buckets(std::move(other.m_buckets)),m_bucket_count(other.m_bucket_count) {}
+    // Nodes from an unequal allocator cannot be adopted, so the entries are moved one by one
+    Hash_map(Hash_map &&other, const allocator_type &alloc)
+        : m_buckets(alloc), m_bucket_count(0), m_size(0), m_max_load_factor(other.m_max_load_factor) {
+        if (mem::equal(get_allocator(), other.get_allocator())) {
+            m_buckets = std::move(other.m_buckets);
+            m_bucket_count = other.m_bucket_count;
+            m_size = other.m_size;
+        } else {
+            m_buckets = bucket_vector(other.m_buckets, m_buckets.get_allocator());
+            m_bucket_count = other.m_bucket_count;
+            assign_entries(other);
+            other.clear();
+        }
+        other.m_bucket_count = 0;
+        other.m_size = 0;
+    }
 
-    explicit Hash_map(size_type num_buckets) : m_buckets(num_buckets), m_bucket_count(num_buckets) {}
+    explicit Hash_map(size_type num_buckets, const allocator_type &alloc = allocator_type())
+        : m_buckets(num_buckets, alloc), m_bucket_count(num_buckets), m_size(0) {}
 
-    Hash_map(std::initializer_list<value_type> i_list, const size_type bucket_count = 4)
-        : m_buckets(bucket_count), m_bucket_count(bucket_count) {
-        for (const auto &i : i_list) {
-            insert(i.first(), i.second());
+    Hash_map(std::initializer_list<value_type> i_list, const size_type bucket_count = 4,
+             const allocator_type &alloc = allocator_type())
+        : m_buckets(bucket_count, alloc), m_bucket_count(bucket_count), m_size(0) {
+        try {
+            for (const auto &i : i_list) {
+                insert(i.first(), i.second());
+            }
+        } catch (...) {
+            clear();
+            throw;
         }
     }
 
+    ~Hash_map() {
+        clear();
+    }
+
     // Assignment operator
     Hash_map &operator=(const Hash_map &other) {
         if (this != &other) {
+            clear();
+            m_bucket_count = 0;
             m_buckets = other.m_buckets;
             m_bucket_count = other.m_bucket_count;
+            m_max_load_factor = other.m_max_load_factor;
+            assign_entries(other);
         }
         return *this;
     }
 
-    Hash_map &operator=(Hash_map &&other) noexcept {
+    Hash_map &operator=(Hash_map &&other) noexcept(mem::nothrow_move_assign<Allocator>) {
         if (this != &other) {
-            m_buckets = std::move(other.m_buckets);
-            m_bucket_count = other.m_bucket_count;
+            clear();
+            if (mem::can_steal(get_allocator(), other.get_allocator())) {
+                m_buckets = std::move(other.m_buckets);
+                m_bucket_count = other.m_bucket_count;
+                m_size = other.m_size;
+            } else {
+                m_bucket_count = 0;
+                m_buckets = bucket_vector(other.m_buckets, m_buckets.get_allocator());
+                m_bucket_count = other.m_bucket_count;
+                assign_entries(other);
+                other.clear();
+            }
+            m_max_load_factor = other.m_max_load_factor;
+            other.m_bucket_count = 0;
+            other.m_size = 0;
         }
         return *this;
     }
 
     Hash_map &operator=(std::initializer_list<std::pair<key_type, mapped_type>> i_list) {
-        for (auto &bucket : m_buckets) bucket.clear();
+        clear();
         for (const auto &i : i_list) insert(i.first(), i.second());
 
         return *this;
     }
 
     // Element access
+    // A hit allocates nothing; a miss allocates the one node, building the entry in place
     mapped_type& operator[](const key_type &key) {
         mapped_type* value = find(key);
         if (value) return *value;
-        insert(key, mapped_type{});
-        return *find(key);
+        return insert_new(key, mapped_type{}).second();
     }
 
     mapped_type& operator[](key_type &&key) {
         mapped_type* value = find(key);
         if (value) return *value;
-        insert(key, mapped_type{});
-        return *find(key);
+        return insert_new(std::move(key), mapped_type{}).second();
     }
 
     mapped_type& at(const key_type &key) {
@@ -83,14 +153,13 @@ public:
         return *value;
     }
 
+    [[nodiscard]] allocator_type get_allocator() const noexcept {
+        return allocator_type(m_buckets.get_allocator());
+    }
+
     // Capacity
     [[nodiscard]] size_type size() const {
-        size_type count = 0;
-        for (auto &bucket : m_buckets) {
-            count += bucket.size();
-        }
-
-        return count;
+        return m_size;
     }
 
     [[nodiscard]] bool empty() const {
@@ -110,14 +179,14 @@ public:
     }
 
     [[nodiscard]] double load_factor() const {
-        return static_cast<double>(size()) / m_bucket_count;
+        return m_bucket_count ? static_cast<double>(size()) / m_bucket_count : 0.0;
     }
 
-    Vector<bucket_type>& get_buckets() {
+    bucket_vector& get_buckets() {
         return m_buckets;
     }
 
-    const Vector<bucket_type>& get_buckets() const {
+    const bucket_vector& get_buckets() const {
         return m_buckets;
     }
 
@@ -125,91 +194,99 @@ public:
         return m_bucket_count;
     }
 
-    // Modifiers and lookup
-    void insert(const key_type& key, const mapped_type& value) {
-        if (size() + 1 > m_bucket_count * m_max_load_factor) {
-            rehash(m_bucket_count * 2);
+    // Statistics; walks every bucket
+    [[nodiscard]] Hash_stats stats() const requires Stats::enabled {
+        Hash_stats out;
+        out.size = m_size;
+        out.bucket_count = m_bucket_count;
+        out.rehashes = m_stats.get(Stat::rehash);
+        out.bytes_allocated = m_buckets.capacity() * sizeof(bucket_type) + m_size * sizeof(node_type);
+        for (size_type i = 0; i < m_bucket_count; ++i) {
+            size_type length = 0;
+            for (const Node_base *link = m_buckets[i]; link; link = link->next) ++length;
+            out.add_chain(length);
         }
+        return out;
+    }
 
-        const size_type index = std::hash<key_type>{}(key) % m_bucket_count;
-        for (auto &kv : m_buckets[index]) {
-            if (kv.first() == key) {
-                kv.second() = value;
-                return;
-            }
+    // Modifiers and lookup
+    // Updating an existing key neither allocates nor triggers a rehash
+    void insert(const key_type& key, const mapped_type& value) {
+        mapped_type* existing = find(key);
+        if (existing) {
+            *existing = value;
+            return;
         }
-        m_buckets[index].push_front(Pair<Key,Value>(key,value));
+        insert_new(key, value);
     }
 
     mapped_type* find(const key_type &key) {
-        const size_type index = std::hash<key_type>{}(key) % m_bucket_count;
-        for (auto &kv : m_buckets[index]) {
-            if (kv.first() == key) {
-                return &kv.second();
-            }
-        }
-        return nullptr;
+        node_type *node = find_node(key);
+        return node ? &node->value.second() : nullptr;
     }
 
     const mapped_type* find(const key_type &key) const {
-        const size_type index = std::hash<key_type>{}(key) % m_bucket_count;
-        for (auto &kv : m_buckets[index]) {
-            if (kv.first() == key) {
-                return &kv.second();
-            }
-        }
-        return nullptr;
+        const node_type *node = find_node(key);
+        return node ? &node->value.second() : nullptr;
     }
 
     bool contains(const key_type &key) const {
-        return find(key) != nullptr;
+        return find_node(key) != nullptr;
     }
 
     bool remove(const key_type &key) {
+        if (m_bucket_count == 0) return false;
         const size_type index = std::hash<key_type>{}(key) % m_bucket_count;
-        auto &bucket = m_buckets[index];
 
-        auto prev = bucket.before_begin();
-        for (auto it = bucket.begin(); it != bucket.end(); ++it) {
-            if (it->first() == key) {
-                bucket.erase_after(prev);
+        for (Node_base **link = &m_buckets[index]; *link; link = &(*link)->next) {
+            if (to_node(*link)->value.first() == key) {
+                Node_base *node = *link;
+                *link = node->next;
+                destroy_node(node);
+                --m_size;
                 return true;
             }
-            prev = it;
         }
         return false;
     }
 
     void clear() {
-        for (auto &bucket : m_buckets) {
-            bucket.clear();
+        for (size_type i = 0; i < m_bucket_count; ++i) {
+            for (Node_base *link = m_buckets[i]; link;) {
+                Node_base *next = link->next;
+                destroy_node(link);
+                link = next;
+            }
+            m_buckets[i] = nullptr;
         }
+        m_size = 0;
     }
 
     void swap(Hash_map &other) noexcept {
         using std::swap;
         swap(m_buckets, other.m_buckets);
         swap(m_bucket_count, other.m_bucket_count);
+        swap(m_size, other.m_size);
         swap(m_max_load_factor, other.m_max_load_factor);
     }
 
     iterator begin() {
         for (size_type i = 0; i < m_bucket_count; ++i) {
-            if (!m_buckets[i].empty()) {
-                return iterator(this, i, m_buckets[i].begin());
+            if (m_buckets[i]) {
+                return iterator(this, i, typename iterator::bucket_iterator(m_buckets[i]));
             }
         }
         return end();
     }
 
     iterator end() {
-        return iterator(this, iterator::end_bucket_index(), typename bucket_type::iterator{});
+        return iterator(this, iterator::end_bucket_index(), typename iterator::bucket_iterator{});
     }
 
     const_iterator begin() const {
         for (size_type i = 0; i < m_bucket_count; ++i) {
-            if (!m_buckets[i].empty()) {
-                return const_iterator(this, i, m_buckets[i].begin());
+            if (m_buckets[i]) {
+                return const_iterator(this, i, typename const_iterator::bucket_iterator(m_buckets[i]));
             }
         }
         return end();
@@ -218,21 +295,91 @@ public:
     const_iterator end() const {
         return const_iterator(this,
                               iterator::end_bucket_index(),
-                              typename bucket_type::const_iterator{});
+                              typename const_iterator::bucket_iterator{});
     }
 
 private:
-    Vector<bucket_type> m_buckets;
+    bucket_vector m_buckets;
     size_type m_bucket_count;
+    size_type m_size; // kept here so size() does not walk every bucket
     double m_max_load_factor = 0.75;
+    [[no_unique_address]] Stats m_stats;
+
+    static constexpr size_type MIN_BUCKETS = 4;
+
+    static node_type *to_node(Node_base *link) {
+        return static_cast<node_type *>(link);
+    }
+
+    template <typename... Args>
+    Node_base *create_node(Args &&... args) {
+        node_allocator_type alloc(m_buckets.get_allocator());
+        return mem::create(alloc, std::forward<Args>(args)...);
+    }
+
+    void destroy_node(Node_base *link) noexcept {
+        node_allocator_type alloc(m_buckets.get_allocator());
+        mem::destroy(alloc, to_node(link));
+    }
 
+    node_type *find_node(const key_type &key) const {
+        if (m_bucket_count == 0) return nullptr;
+        const size_type index = std::hash<key_type>{}(key) % m_bucket_count;
+        for (Node_base *link = m_buckets[index]; link; link = link->next) {
+            if (to_node(link)->value.first() == key) return to_node(link);
+        }
+        return nullptr;
+    }
+
+    // Rebuilds other's chains in this map's nodes, copying the entries from a const map and moving
+    // them otherwise. The bucket array is a copy of other's, so its heads still point into other's
+    // chains until they are rebuilt; each chain keeps its order so the result iterates the same
+    // way, and whatever was built is freed if an entry throws.
+    template <typename Source>
+    void assign_entries(Source &other) {
+        for (size_type i = 0; i < m_bucket_count; ++i) m_buckets[i] = nullptr;
+        try {
+            for (size_type i = 0; i < m_bucket_count; ++i) {
+                Node_base **tail = &m_buckets[i];
+                for (Node_base *link = other.m_buckets[i]; link; link = link->next) {
+                    if constexpr (std::is_const_v<Source>) *tail = create_node(to_node(link)->value);
+                    else *tail = create_node(std::move(to_node(link)->value));
+                    tail = &(*tail)->next;
+                    ++m_size;
+                }
+            }
+        } catch (...) {
+            clear();
+            throw;
+        }
+    }
+
+    // Adds an entry for a key that is known to be absent, growing first if needed
+    template <typename K, typename V>
+    value_type &insert_new(K &&key, V &&value) {
+        if (size() + 1 > m_bucket_count * m_max_load_factor) {
+            rehash(std::max(m_bucket_count * 2, MIN_BUCKETS));
+        }
+
+        Node_base *&head = m_buckets[std::hash<key_type>{}(key) % m_bucket_count];
+        Node_base *node = create_node(std::forward<K>(key), std::forward<V>(value));
+        node->next = head;
+        head = node;
+        ++m_size;
+        return to_node(node)->value;
+    }
+
+    // Relinks the existing nodes into the new buckets, so growing allocates only the bucket array
     void rehash(size_type new_bucket_count) {
-        Vector<bucket_type> new_buckets(new_bucket_count);
+        m_stats.count(Stat::rehash);
+        bucket_vector new_buckets(new_bucket_count, m_buckets.get_allocator());
 
-        for (auto &bucket : m_buckets) {
-            for (auto &kv : bucket) {
-                size_type new_index = std::hash<key_type>{}(kv.first()) % new_bucket_count;
-                new_buckets[new_index].emplace_front(kv);
+        for (size_type i = 0; i < m_bucket_count; ++i) {
+            while (Node_base *node = m_buckets[i]) {
+                m_buckets[i] = node->next;
+                Node_base *&target = new_buckets[std::hash<key_type>{}(to_node(node)->value.first()) % new_bucket_count];
+                node->next = target;
+                target = node;
             }
         }
         m_buckets = std::move(new_buckets);
@@ -240,7 +387,12 @@ private:
     }
 };
 
-template <typename Key, typename Value>
-void swap(Hash_map<Key, Value> &lhs, Hash_map<Key, Value> &rhs) noexcept {
+template <typename Key, typename Value, typename Allocator, typename Stats>
+void swap(Hash_map<Key, Value, Allocator, Stats> &lhs, Hash_map<Key, Value, Allocator, Stats> &rhs) noexcept {
     lhs.swap(rhs);
+}
+
+namespace pmr {
+    template<typename Key, typename Value>
+    using Hash_map = ::Hash_map<Key, Value, std::pmr::polymorphic_allocator<Pair<Key, Value>>>;
 }
\ No newline at end of file
@@ -1,48 +1,117 @@
 #pragma once
 
+#include <algorithm>
 #include <functional>
 #include "sequence/vector.hpp"
-#include "sequence/forward_list.hpp"
+#include "sequence/internal/node.hpp"
+#include "utils/stats.hpp"
 #include "internal/hash_set_iterator.hpp"
 
-template <typename Key>
+// Separate chaining over a flat array of chain heads, laid out like Hash_map
+template <typename Key, typename Allocator = std::allocator<Key>, typename Stats = No_stats>
 class Hash_set {
+    using alloc_traits = std::allocator_traits<Allocator>;
+    using node_type = Node<Key>;
+    using node_allocator_type = mem::rebind<Allocator, node_type>;
+
 public:
     using key_type = Key;
+    using allocator_type = Allocator;
     using size_type = size_t;
-    using bucket_type = Forward_list<Key>;
+    using bucket_type = Node_base *;
+    using bucket_vector = Vector<bucket_type, mem::rebind<Allocator, bucket_type>>;
     using iterator = HashSetIterator<Hash_set>;
     using const_iterator = HashSetIterator<const Hash_set>;
 
     // Constructors
-    Hash_set() : m_buckets(4), m_bucket_count(4) {}
+    // Buckets are allocated on the first insertion
+    Hash_set() noexcept(noexcept(allocator_type())) : Hash_set(allocator_type()) {}
+
+    explicit Hash_set(const allocator_type &alloc) noexcept : m_buckets(alloc), m_bucket_count(0), m_size(0) {}
+
+    Hash_set(const Hash_set &other)
+        : Hash_set(other, alloc_traits::select_on_container_copy_construction(other.get_allocator())) {}
 
-    Hash_set(const Hash_set &other) : m_buckets(other.m_buckets), m_bucket_count(other.m_bucket_count) {}
+    Hash_set(const Hash_set &other, const allocator_type &alloc)
+        : m_buckets(other.m_buckets, alloc), m_bucket_count(other.m_bucket_count), m_size(0),
+          m_max_load_factor(other.m_max_load_factor) {
+        assign_entries(other);
+    }
+
+    Hash_set(Hash_set &&other) noexcept
+        : m_buckets(std::move(other.m_buckets)), m_bucket_count(other.m_bucket_count), m_size(other.m_size),
+          m_max_load_factor(other.m_max_load_factor) {
+        other.m_bucket_count = 0;
+        other.m_size = 0;
+    }
 
-    Hash_set(Hash_set &&other) noexcept : m_buckets(std::move(other.m_buckets)), m_bucket_count(other.m_bucket_count) {}
+    // Nodes from an unequal allocator cannot be adopted, so the keys are moved one by one
+    Hash_set(Hash_set &&other, const allocator_type &alloc)
+        : m_buckets(alloc), m_bucket_count(0), m_size(0), m_max_load_factor(other.m_max_load_factor) {
+        if (mem::equal(get_allocator(), other.get_allocator())) {
+            m_buckets = std::move(other.m_buckets);
+            m_bucket_count = other.m_bucket_count;
+            m_size = other.m_size;
+        } else {
+            m_buckets = bucket_vector(other.m_buckets, m_buckets.get_allocator());
+            m_bucket_count = other.m_bucket_count;
+            assign_entries(other);
+            other.clear();
+        }
+        other.m_bucket_count = 0;
+        other.m_size = 0;
+    }
 
-    explicit Hash_set(size_type num_buckets) : m_buckets(num_buckets), m_bucket_count(num_buckets) {}
+    explicit Hash_set(size_type num_buckets, const allocator_type &alloc = allocator_type())
+        : m_buckets(num_buckets, alloc), m_bucket_count(num_buckets), m_size(0) {}
 
-    Hash_set(std::initializer_list<key_type> i_list, const size_type bucket_count = 4)
-        : m_buckets(bucket_count), m_bucket_count(bucket_count) {
-        for (const auto &key : i_list) {
-            insert(key);
+    Hash_set(std::initializer_list<key_type> i_list, const size_type bucket_count = 4,
+             const allocator_type &alloc = allocator_type())
+        : m_buckets(bucket_count, alloc), m_bucket_count(bucket_count), m_size(0) {
+        try {
+            for (const auto &key : i_list) {
+                insert(key);
+            }
+        } catch (...) {
+            clear();
+            throw;
         }
     }
 
+    ~Hash_set() {
+        clear();
+    }
+
     // Assignment
     Hash_set &operator=(const Hash_set &other) {
         if (this != &other) {
+            clear();
+            m_bucket_count = 0;
             m_buckets = other.m_buckets;
             m_bucket_count = other.m_bucket_count;
+            m_max_load_factor = other.m_max_load_factor;
+            assign_entries(other);
         }
         return *this;
     }
 
-    Hash_set &operator=(Hash_set &&other) noexcept {
+    Hash_set &operator=(Hash_set &&other) noexcept(mem::nothrow_move_assign<Allocator>) {
         if (this != &other) {
-            m_buckets = std::move(other.m_buckets);
-            m_bucket_count = other.m_bucket_count;
+            clear();
+            if (mem::can_steal(get_allocator(), other.get_allocator())) {
+                m_buckets = std::move(other.m_buckets);
+                m_bucket_count = other.m_bucket_count;
+                m_size = other.m_size;
+            } else {
+                m_bucket_count = 0;
+                m_buckets = bucket_vector(other.m_buckets, m_buckets.get_allocator());
+                m_bucket_count = other.m_bucket_count;
+                assign_entries(other);
+                other.clear();
+            }
+            m_max_load_factor = other.m_max_load_factor;
+            other.m_bucket_count = 0;
+            other.m_size = 0;
         }
         return *this;
     }
@@ -53,24 +122,28 @@ public:
         return *this;
     }
 
+    [[nodiscard]] allocator_type get_allocator() const noexcept {
+        return allocator_type(m_buckets.get_allocator());
+    }
+
     // Capacity
     [[nodiscard]] size_type size() const {
-        size_type count = 0;
-        for (auto &bucket : m_buckets) count += bucket.size();
-        return count;
+        return m_size;
     }
 
     [[nodiscard]] bool empty() const { return size() == 0; }
 
     void set_max_load_factor(double factor) { m_max_load_factor = factor; }
     [[nodiscard]] double max_load_factor() const { return m_max_load_factor; }
-    [[nodiscard]] double load_factor() const { return static_cast<double>(size()) / m_bucket_count; }
+    [[nodiscard]] double load_factor() const {
+        return m_bucket_count ? static_cast<double>(size()) / m_bucket_count : 0.0;
+    }
 
-    Vector<bucket_type>& get_buckets() {
+    bucket_vector& get_buckets() {
         return m_buckets;
     }
 
-    const Vector<bucket_type>& get_buckets() const {
+    const bucket_vector& get_buckets() const {
         return m_buckets;
     }
 
@@ -78,66 +151,96 @@ public:
         return m_bucket_count;
     }
 
+    // Statistics; walks every bucket
+    [[nodiscard]] Hash_stats stats() const requires Stats::enabled {
+        Hash_stats out;
+        out.size = m_size;
+        out.bucket_count = m_bucket_count;
+        out.rehashes = m_stats.get(Stat::rehash);
+        out.bytes_allocated = m_buckets.capacity() * sizeof(bucket_type) + m_size * sizeof(node_type);
+        for (size_type i = 0; i < m_bucket_count; ++i) {
+            size_type length = 0;
+            for (const Node_base *link = m_buckets[i]; link; link = link->next) ++length;
+            out.add_chain(length);
+        }
+        return out;
+    }
+
 
     // Modifiers
+    // Inserting a key that is already present neither allocates nor triggers a rehash
     void insert(const key_type &key) {
+        if (contains(key)) return;
         if (size() + 1 > m_bucket_count * m_max_load_factor) {
-            rehash(m_bucket_count * 2);
+            rehash(std::max(m_bucket_count * 2, MIN_BUCKETS));
         }
 
-        size_type index = std::hash<key_type>{}(key) % m_bucket_count;
-        for (const auto &k : m_buckets[index]) {
-            if (k == key) return; // already exists
-        }
-        m_buckets[index].push_front(key);
+        Node_base *&head = m_buckets[std::hash<key_type>{}(key) % m_bucket_count];
+        Node_base *node = create_node(key);
+        node->next = head;
+        head = node;
+        ++m_size;
     }
 
     bool contains(const key_type &key) const {
+        if (m_bucket_count == 0) return false;
         size_type index = std::hash<key_type>{}(key) % m_bucket_count;
-        for (const auto &k : m_buckets[index]) if (k == key) return true;
+        for (const Node_base *link = m_buckets[index]; link; link = link->next) {
+            if (to_node(link)->value == key) return true;
+        }
         return false;
     }
 
     bool remove(const key_type &key) {
+        if (m_bucket_count == 0) return false;
         size_type index = std::hash<key_type>{}(key) % m_bucket_count;
-        auto &bucket = m_buckets[index];
-        auto prev = bucket.before_begin();
-        for (auto it = bucket.begin(); it != bucket.end(); ++it) {
-            if (*it == key) {
-                bucket.erase_after(prev);
+        for (Node_base **link = &m_buckets[index]; *link; link = &(*link)->next) {
+            if (to_node(*link)->value == key) {
+                Node_base *node = *link;
+                *link = node->next;
+                destroy_node(node);
+                --m_size;
                 return true;
             }
-            prev = it;
         }
         return false;
     }
 
     void clear() {
-        for (auto &bucket : m_buckets) bucket.clear();
+        for (size_type i = 0; i < m_bucket_count; ++i) {
+            for (Node_base *link = m_buckets[i]; link;) {
+                Node_base *next = link->next;
+                destroy_node(link);
+                link = next;
+            }
+            m_buckets[i] = nullptr;
+        }
+        m_size = 0;
     }
 
     void swap(Hash_set &other) noexcept {
         using std::swap;
         swap(m_buckets, other.m_buckets);
         swap(m_bucket_count, other.m_bucket_count);
+        swap(m_size, other.m_size);
         swap(m_max_load_factor, other.m_max_load_factor);
     }
 
     // Iterators
     iterator begin() {
         for (size_type i = 0; i < m_bucket_count; ++i) {
-            if (!m_buckets[i].empty()) return iterator(this, i, m_buckets[i].begin());
+            if (m_buckets[i]) return iterator(this, i, typename iterator::bucket_iterator(m_buckets[i]));
         }
         return end();
     }
 
     iterator end() {
-        return iterator(this, iterator::end_bucket_index(), typename bucket_type::iterator{});
+        return iterator(this, iterator::end_bucket_index(), typename iterator::bucket_iterator{});
     }
 
     const_iterator begin() const {
         for (size_type i = 0; i < m_bucket_count; ++i) {
-            if (!m_buckets[i].empty()) return const_iterator(this, i, m_buckets[i].begin());
+            if (m_buckets[i]) return const_iterator(this, i, typename const_iterator::bucket_iterator(m_buckets[i]));
         }
         return end();
     }
@@ -146,22 +249,70 @@ public:
         return const_iterator(
             this,
             iterator::end_bucket_index(),
-            typename bucket_type::const_iterator{}
+            typename const_iterator::bucket_iterator{}
         );
     }
 
 
 private:
-    Vector<bucket_type> m_buckets;
+    bucket_vector m_buckets;
     size_type m_bucket_count;
+    size_type m_size; // kept here so size() does not walk every bucket
     double m_max_load_factor = 0.75;
+    [[no_unique_address]] Stats m_stats;
+
+    static constexpr size_type MIN_BUCKETS = 4;
+
+    static node_type *to_node(Node_base *link) {
+        return static_cast<node_type *>(link);
+    }
+
+    static const node_type *to_node(const Node_base *link) {
+        return static_cast<const node_type *>(link);
+    }
 
+    template <typename... Args>
+    Node_base *create_node(Args &&... args) {
+        node_allocator_type alloc(m_buckets.get_allocator());
+        return mem::create(alloc, std::forward<Args>(args)...);
+    }
+
+    void destroy_node(Node_base *link) noexcept {
+        node_allocator_type alloc(m_buckets.get_allocator());
+        mem::destroy(alloc, to_node(link));
+    }
+
+    // Rebuilds other's chains in this set's nodes, as Hash_map::assign_entries does
+    template <typename Source>
+    void assign_entries(Source &other) {
+        for (size_type i = 0; i < m_bucket_count; ++i) m_buckets[i] = nullptr;
+        try {
+            for (size_type i = 0; i < m_bucket_count; ++i) {
+                Node_base **tail = &m_buckets[i];
+                for (Node_base *link = other.m_buckets[i]; link; link = link->next) {
+                    if constexpr (std::is_const_v<Source>) *tail = create_node(to_node(link)->value);
+                    else *tail = create_node(std::move(to_node(link)->value));
+                    tail = &(*tail)->next;
+                    ++m_size;
+                }
+            }
+        } catch (...) {
+            clear();
+            throw;
+        }
+    }
+
+    // The nodes are relinked rather than copied, so growing allocates only the bucket array
     void rehash(size_type new_bucket_count) {
-        Vector<bucket_type> new_buckets(new_bucket_count);
-        for (auto &bucket : m_buckets) {
-            for (auto &key : bucket) {
-                size_type new_index = std::hash<key_type>{}(key) % new_bucket_count;
-                new_buckets[new_index].push_front(key);
+        m_stats.count(Stat::rehash);
+        bucket_vector new_buckets(new_bucket_count, m_buckets.get_allocator());
+
+        for (size_type i = 0; i < m_bucket_count; ++i) {
+            while (Node_base *node = m_buckets[i]) {
+                m_buckets[i] = node->next;
+                Node_base *&target = new_buckets[std::hash<key_type>{}(to_node(node)->value) % new_bucket_count];
+                node->next = target;
+                target = node;
             }
         }
         m_buckets = std::move(new_buckets);
@@ -170,7 +321,12 @@ private:
 };
 
 // Swap utility
-template <typename Key>
-void swap(Hash_set<Key> &lhs, Hash_set<Key> &rhs) noexcept {
+template <typename Key, typename Allocator, typename Stats>
+void swap(Hash_set<Key, Allocator, Stats> &lhs, Hash_set<Key, Allocator, Stats> &rhs) noexcept {
     lhs.swap(rhs);
+}
+
+namespace pmr {
+    template<typename Key>
+    using Hash_set = ::Hash_set<Key, std::pmr::polymorphic_allocator<Key>>;
 }
\ No newline at end of file
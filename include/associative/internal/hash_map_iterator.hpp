@@ -1,6 +1,8 @@
 #pragma once
 #include <type_traits>
 
+#include "iterator/iterator.hpp"
+
 template <typename Map>
 class HashMapIterator {
 public:
@@ -8,38 +10,33 @@ public:
     using bucket_type = map_type::bucket_type;
     using value_type = map_type::value_type;
     using size_type = map_type::size_type;
+    using reference = std::conditional_t<std::is_const_v<Map>, const value_type &, value_type &>;
+    using pointer = std::conditional_t<std::is_const_v<Map>, const value_type *, value_type *>;
+    // Walks one bucket's chain of nodes; the default-constructed iterator is the chain's end
     using bucket_iterator = std::conditional_t<
         std::is_const_v<Map>,
-        typename bucket_type::const_iterator,
-        typename bucket_type::iterator
+        Forward_iterator<const value_type>,
+        Forward_iterator<value_type>
     >;
 
     // Constructor
     HashMapIterator(map_type* map, size_type bucket_index, bucket_iterator it)
         : m_map(map), m_bucket_index(bucket_index), m_it(it)
     {
-        if (m_map && m_bucket_index < m_map->get_bucket_count() &&
-            m_it == m_map->get_buckets()[m_bucket_index].end()) {
+        if (m_map && m_bucket_index < m_map->get_bucket_count() && m_it == bucket_iterator{}) {
             advance_to_next_bucket();
         }
     }
 
     // Dereference
-    value_type& operator*() const { return *m_it; }
+    reference operator*() const { return *m_it; }
 
-    auto operator->() const -> std::conditional_t<
-        std::is_const_v<Map>,
-        const value_type*,
-        value_type*
-    > {
-        return &(*m_it);
-    }
+    pointer operator->() const { return &(*m_it); }
 
     // Pre-increment
     HashMapIterator& operator++() {
         ++m_it;
-        if (m_map && (m_bucket_index < m_map->get_bucket_count()) &&
-            m_it == m_map->get_buckets()[m_bucket_index].end()) {
+        if (m_map && (m_bucket_index < m_map->get_bucket_count()) && m_it == bucket_iterator{}) {
             advance_to_next_bucket();
         }
         return *this;
@@ -74,9 +71,8 @@ private:
         if (!m_map) return;
         ++m_bucket_index;
         while (m_bucket_index < m_map->get_bucket_count()) {
-            auto& bucket = m_map->get_buckets()[m_bucket_index];
-            if (!bucket.empty()) {
-                m_it = bucket.begin();
+            if (auto head = m_map->get_buckets()[m_bucket_index]) {
+                m_it = bucket_iterator(head);
                 return;
             }
             ++m_bucket_index;
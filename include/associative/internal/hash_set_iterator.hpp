@@ -1,5 +1,9 @@
 #pragma once
 
+#include <type_traits>
+
+#include "iterator/iterator.hpp"
+
 template <typename Set>
 class HashSetIterator {
 public:
@@ -19,11 +23,12 @@ public:
         const value_type *,
         value_type *>;
 
+    // Walks one bucket's chain of nodes; the default-constructed iterator is the chain's end
     using bucket_iterator =
     std::conditional_t<
         std::is_const_v<set_type>,
-        typename bucket_type::const_iterator,
-        typename bucket_type::iterator
+        Forward_iterator<const value_type>,
+        Forward_iterator<value_type>
     >;
 
     // Constructor
@@ -31,7 +36,7 @@ public:
         : m_set(set), m_bucket_index(bucket_index), m_it(it) {
         if (m_set &&
             m_bucket_index < m_set->get_bucket_count() &&
-            m_it == m_set->get_buckets()[m_bucket_index].end()) {
+            m_it == bucket_iterator{}) {
             advance_to_next_bucket();
         }
     }
@@ -46,7 +51,7 @@ public:
         ++m_it;
         if (m_set &&
             m_bucket_index < m_set->get_bucket_count() &&
-            m_it == m_set->get_buckets()[m_bucket_index].end()) {
+            m_it == bucket_iterator{}) {
             advance_to_next_bucket();
         }
         return *this;
@@ -84,9 +89,8 @@ private:
 
         ++m_bucket_index;
         while (m_bucket_index < m_set->get_bucket_count()) {
-            auto &bucket = m_set->get_buckets()[m_bucket_index];
-            if (!bucket.empty()) {
-                m_it = bucket.begin();
+            if (auto head = m_set->get_buckets()[m_bucket_index]) {
+                m_it = bucket_iterator(head);
                 return;
             }
             ++m_bucket_index;
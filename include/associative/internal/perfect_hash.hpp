@@ -0,0 +1,225 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+#include "sequence/array.hpp"
+#include "sequence/vector.hpp"
+
+// Minimal perfect hashing for Frozen_map and Frozen_set, in the style of PTHash. The N keys are
+// hashed once and split into about N / BUCKET_SIZE buckets; each bucket, largest first, gets the
+// first pilot value whose displacement sends all of its keys to slots still free in a table of
+// exactly N. A lookup is then one hash, one displacement load and one key comparison, and every
+// step of the construction runs in a constant expression.
+namespace phf {
+    // Average number of keys per bucket: larger buckets mean fewer displacements to store but
+    // longer pilot searches for the buckets placed last
+    inline constexpr std::size_t BUCKET_SIZE = 2;
+
+    // Seeds tried before the construction gives up; a seed fails only when two distinct keys hash
+    // alike or a pilot search runs past its limit, both rare
+    inline constexpr std::uint64_t MAX_SEEDS = 64;
+
+    inline constexpr std::uint64_t MULTIPLIER = 0x9e3779b97f4a7c15;
+
+    // Bijective 64-bit finalizer: every input bit affects every output bit
+    constexpr std::uint64_t mix(std::uint64_t x) noexcept {
+        x ^= x >> 32;
+        x *= 0xd6e8feb86659fd93;
+        x ^= x >> 32;
+        x *= 0xd6e8feb86659fd93;
+        x ^= x >> 32;
+        return x;
+    }
+
+    // Maps the high 32 bits of x onto [0, n) without a division; n must be below 2^32
+    constexpr std::size_t reduce(const std::uint64_t x, const std::size_t n) noexcept {
+        return static_cast<std::size_t>(((x >> 32) * n) >> 32);
+    }
+
+    // The `Bytes` bytes at p as a little-endian integer, so the compiler and the running program agree
+    template <std::size_t Bytes>
+    constexpr std::uint64_t load(const char *p) noexcept {
+        if !consteval {
+            if constexpr (std::endian::native == std::endian::little) {
+                std::conditional_t<Bytes == 8, std::uint64_t, std::uint32_t> word;
+                std::memcpy(&word, p, Bytes);
+                return word;
+            }
+        }
+        std::uint64_t word = 0;
+        for (std::size_t i = 0; i < Bytes; ++i) word |= std::uint64_t{static_cast<unsigned char>(p[i])} << (8 * i);
+        return word;
+    }
+
+    // The last count < 8 bytes of a string in one word, without a loop: two overlapping 4-byte
+    // reads, or the first, middle and last byte, as wyhash does. Strings of different lengths may
+    // agree here; the hash mixes in the length separately.
+    constexpr std::uint64_t load_tail(const char *p, const std::size_t count) noexcept {
+        if (count >= 4) return load<4>(p) << 32 | load<4>(p + count - 4);
+        if (count == 0) return 0;
+        return std::uint64_t{static_cast<unsigned char>(p[0])} << 16 |
+               std::uint64_t{static_cast<unsigned char>(p[count / 2])} << 8 |
+               static_cast<unsigned char>(p[count - 1]);
+    }
+
+    // The hash parameters of a table of N slots: a seed for the key hash and, per bucket, the
+    // displacement its pilot search settled on
+    template <std::size_t N>
+    struct Table {
+        static constexpr std::size_t BUCKETS = N / BUCKET_SIZE + 1;
+
+        std::uint64_t seed = 0;
+        Array<std::uint64_t, BUCKETS> displacements{};
+
+        static constexpr std::size_t bucket(const std::uint64_t hash) noexcept {
+            return reduce(hash, BUCKETS);
+        }
+
+        static constexpr std::uint64_t displacement(const std::uint64_t pilot) noexcept {
+            return mix(pilot * MULTIPLIER + MULTIPLIER);
+        }
+
+        static constexpr std::size_t slot(const std::uint64_t hash, const std::uint64_t displacement) noexcept {
+            return reduce(mix(hash ^ displacement), N);
+        }
+
+        constexpr std::size_t slot(const std::uint64_t hash) const noexcept {
+            return slot(hash, displacements[bucket(hash)]);
+        }
+    };
+
+    // Builds the table for keys key_of(0) .. key_of(N - 1) and stores the slot of key i in
+    // slots[i]. Two keys that compare equal throw std::invalid_argument.
+    template <std::size_t N, typename KeyOf, typename Hash, typename KeyEqual>
+    constexpr Table<N> build(KeyOf key_of, const Hash &hash, const KeyEqual &equal, Array<std::uint32_t, N> &slots) {
+        static_assert(N < (std::size_t{1} << 32), "Frozen tables hold fewer than 2^32 keys");
+        using Bucket_table = Table<N>;
+        constexpr std::size_t BUCKETS = Bucket_table::BUCKETS;
+        // Placing the last free slot takes N tries on average; a search this long means bad luck
+        // with the seed
+        constexpr std::uint64_t MAX_PILOT = 16 * std::uint64_t{N} + 1024;
+
+        for (std::uint64_t attempt = 0; attempt < MAX_SEEDS; ++attempt) {
+            Bucket_table table;
+            table.seed = mix(attempt * MULTIPLIER + 1);
+            for (std::size_t b = 0; b < BUCKETS; ++b) table.displacements[b] = Bucket_table::displacement(0);
+
+            Vector<std::uint64_t> hashes(N);
+            for (std::size_t i = 0; i < N; ++i) hashes[i] = hash(key_of(i), table.seed);
+
+            // Keys grouped by bucket: members[first[b] .. first[b + 1]) belong to bucket b
+            Vector<std::size_t> first(BUCKETS + 1, 0);
+            for (std::size_t i = 0; i < N; ++i) ++first[Bucket_table::bucket(hashes[i]) + 1];
+            std::size_t largest = 0;
+            for (std::size_t b = 0; b < BUCKETS; ++b) {
+                largest = std::max(largest, first[b + 1]);
+                first[b + 1] += first[b];
+            }
+            Vector<std::size_t> members(N);
+            {
+                Vector<std::size_t> fill(first);
+                for (std::size_t i = 0; i < N; ++i) members[fill[Bucket_table::bucket(hashes[i])]++] = i;
+            }
+
+            // Bucket ids by descending size, counting-sorted
+            Vector<std::size_t> by_size(largest + 2, 0);
+            for (std::size_t b = 0; b < BUCKETS; ++b) ++by_size[largest - (first[b + 1] - first[b]) + 1];
+            for (std::size_t s = 0; s <= largest; ++s) by_size[s + 1] += by_size[s];
+            Vector<std::size_t> order(BUCKETS);
+            for (std::size_t b = 0; b < BUCKETS; ++b) order[by_size[largest - (first[b + 1] - first[b])]++] = b;
+
+            // The pilot searches below are most of the construction's work, and of the
+            // constant-evaluation budget, so they run on raw pointers into these
+            Vector<unsigned char> taken(N, 0);
+            Vector<std::uint64_t> bucket_hashes(largest);
+            Vector<std::size_t> positions(largest);
+            unsigned char *const is_taken = taken.data();
+            const std::uint64_t *const keys = bucket_hashes.data();
+            std::size_t *const slot_of = positions.data();
+
+            bool placed = true;
+            for (std::size_t k = 0; k < BUCKETS && placed; ++k) {
+                const std::size_t b = order[k];
+                const std::size_t begin = first[b];
+                const std::size_t size = first[b + 1] - begin;
+                if (size == 0) break;
+
+                // Equal hashes share a bucket, so this finds every duplicate key
+                for (std::size_t i = 0; i < size; ++i) {
+                    bucket_hashes[i] = hashes[members[begin + i]];
+                    for (std::size_t j = 0; j < i; ++j) {
+                        if (bucket_hashes[i] != bucket_hashes[j]) continue;
+                        if (equal(key_of(members[begin + i]), key_of(members[begin + j]))) throw std::invalid_argument("Duplicate key");
+                        placed = false;
+                    }
+                }
+
+                // Whether `displacement` sends every key of the bucket to a distinct free slot,
+                // collected in positions
+                const auto fits = [=](const std::uint64_t displacement) {
+                    for (std::size_t i = 0; i < size; ++i) {
+                        const std::size_t slot = Bucket_table::slot(keys[i], displacement);
+                        if (is_taken[slot]) return false;
+                        for (std::size_t j = 0; j < i; ++j) {
+                            if (slot_of[j] == slot) return false;
+                        }
+                        slot_of[i] = slot;
+                    }
+                    return true;
+                };
+                std::uint64_t pilot = 0;
+                while (placed && pilot < MAX_PILOT && !fits(Bucket_table::displacement(pilot))) ++pilot;
+                if (pilot == MAX_PILOT) placed = false;
+                if (!placed) break;
+
+                table.displacements[b] = Bucket_table::displacement(pilot);
+                for (std::size_t i = 0; i < size; ++i) {
+                    taken[positions[i]] = 1;
+                    slots[members[begin + i]] = static_cast<std::uint32_t>(positions[i]);
+                }
+            }
+            if (placed) return table;
+        }
+        throw std::logic_error("No perfect hash found");
+    }
+}
+
+// The hash Frozen_map and Frozen_set use by default: seeded, and usable in constant
+// expressions, which std::hash is not. Provided for integers, enumerations and string_view; a
+// custom key type supplies a callable with the same signature.
+template <typename Key>
+struct Frozen_hash;
+
+template <typename Key>
+    requires std::integral<Key> || std::is_enum_v<Key>
+struct Frozen_hash<Key> {
+    constexpr std::uint64_t operator()(const Key key, const std::uint64_t seed) const noexcept {
+        if constexpr (std::is_enum_v<Key>) {
+            return phf::mix(static_cast<std::uint64_t>(static_cast<std::underlying_type_t<Key>>(key)) ^ seed);
+        } else {
+            return phf::mix(static_cast<std::uint64_t>(key) ^ seed);
+        }
+    }
+};
+
+// Eight bytes per step and the rest in one, so keyword-sized strings hash in two or three
+// multiplies
+template <>
+struct Frozen_hash<std::string_view> {
+    constexpr std::uint64_t operator()(const std::string_view key, const std::uint64_t seed) const noexcept {
+        const char *p = key.data();
+        std::size_t remaining = key.size();
+        std::uint64_t h = seed ^ (remaining * phf::MULTIPLIER);
+        for (; remaining >= 8; p += 8, remaining -= 8) h = (std::rotl(h, 23) ^ phf::load<8>(p)) * phf::MULTIPLIER;
+        h = (std::rotl(h, 23) ^ phf::load_tail(p, remaining)) * phf::MULTIPLIER;
+        return phf::mix(h);
+    }
+};
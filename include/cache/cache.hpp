@@ -0,0 +1,236 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <utility>
+
+#include "internal/cache_entry.hpp"
+#include "intrusive/hash_set.hpp"
+#include "policies.hpp"
+#include "utils/allocator.hpp"
+
+// Every entry weighs 1, so the capacity counts entries
+struct Unit_weigher {
+    template<typename Key, typename Value>
+    std::size_t operator()(const Key &, const Value &) const noexcept {
+        return 1;
+    }
+};
+
+// Bounded map that evicts entries as Policy decides once their total weight exceeds the
+// capacity. Each entry is one allocation holding the key, the value and the links of both the
+// index and the policy, so get, put and erase are O(1) and never allocate besides the entry
+// and the occasional growth of the index. With a weigher returning byte sizes the capacity is
+// a byte budget. The eviction callback sees each evicted entry just before it is destroyed;
+// it must not call back into the cache.
+template<typename Key, typename Value, template<typename, typename> class Policy = Lru_policy,
+         typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>, typename Weigher = Unit_weigher,
+         typename Allocator = std::allocator<Cache_entry<Key, Value>>>
+class Cache {
+    using entry_type = Cache_entry<Key, Value>;
+    using entry_allocator = mem::rebind<Allocator, entry_type>;
+
+    // The index only ever hashes entries, whose hash is cached; keys are hashed by the cache
+    struct Entry_hash {
+        std::size_t operator()(const entry_type &entry) const noexcept { return entry.hash; }
+    };
+
+    struct Entry_equal {
+        [[no_unique_address]] KeyEqual equal;
+
+        bool operator()(const Key &key, const entry_type &entry) const { return equal(key, entry.key); }
+        bool operator()(const entry_type &lhs, const entry_type &rhs) const { return equal(lhs.key, rhs.key); }
+    };
+
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using allocator_type = Allocator;
+    using size_type = std::size_t;
+    using policy_type = Policy<entry_type, entry_allocator>;
+    using eviction_callback = std::function<void(const key_type &, mapped_type &)>;
+
+    // Constructors
+    explicit Cache(const size_type capacity, const Hash &hash = Hash(), const KeyEqual &equal = KeyEqual(),
+                   const Weigher &weigher = Weigher(), const allocator_type &alloc = allocator_type())
+        : m_alloc(alloc), m_index(0, Entry_hash(), Entry_equal{equal}, alloc), m_policy(capacity, m_alloc),
+          m_capacity(capacity), m_hash(hash), m_weigher(weigher) {}
+
+    Cache(const Cache &) = delete;
+    Cache &operator=(const Cache &) = delete;
+
+    ~Cache() {
+        clear();
+    }
+
+    [[nodiscard]] allocator_type get_allocator() const noexcept {
+        return allocator_type(m_alloc);
+    }
+
+    // Capacity
+    [[nodiscard]] size_type size() const noexcept {
+        return m_index.size();
+    }
+
+    [[nodiscard]] bool empty() const noexcept {
+        return size() == 0;
+    }
+
+    // Total weight of the entries
+    [[nodiscard]] size_type weight() const noexcept {
+        return m_weight;
+    }
+
+    [[nodiscard]] size_type capacity() const noexcept {
+        return m_capacity;
+    }
+
+    // Evicts right away if the entries no longer fit
+    void set_capacity(const size_type capacity) {
+        m_capacity = capacity;
+        m_policy.set_capacity(capacity);
+        evict_over_capacity(nullptr);
+    }
+
+    void set_eviction_callback(eviction_callback callback) {
+        m_on_evict = std::move(callback);
+    }
+
+    // Lookup
+    // The value stored under `key`, or null; a hit counts as a use of the entry
+    mapped_type *get(const key_type &key) {
+        const size_type hash = m_hash(key);
+        const auto found = m_index.find(key, hash);
+        if (found == m_index.end()) {
+            m_policy.on_miss(hash);
+            return nullptr;
+        }
+        m_policy.on_access(*found);
+        return &found->value;
+    }
+
+    // Same, without telling the policy
+    mapped_type *peek(const key_type &key) {
+        const auto found = m_index.find(key, m_hash(key));
+        return found == m_index.end() ? nullptr : &found->value;
+    }
+
+    const mapped_type *peek(const key_type &key) const {
+        const auto found = m_index.find(key, m_hash(key));
+        return found == m_index.end() ? nullptr : &found->value;
+    }
+
+    bool contains(const key_type &key) const {
+        return peek(key) != nullptr;
+    }
+
+    // Modifiers
+    // Stores `value` under `key`, replacing any previous value; returns false if the entry was
+    // evicted straight away, e.g. because it alone outweighs the capacity
+    bool put(key_type key, mapped_type value) {
+        const size_type hash = m_hash(key);
+        const auto found = m_index.find(key, hash);
+        if (found != m_index.end()) {
+            entry_type &entry = *found;
+            const size_type old_weight = entry.weight;
+            entry.value = std::move(value);
+            entry.weight = m_weigher(entry.key, entry.value);
+            m_weight = m_weight - old_weight + entry.weight;
+            m_policy.on_update(entry, old_weight);
+            return evict_over_capacity(&entry);
+        }
+
+        entry_type *entry = mem::create(m_alloc, std::move(key), std::move(value), hash);
+        try {
+            entry->weight = m_weigher(entry->key, entry->value);
+            m_index.insert(*entry);
+        } catch (...) {
+            mem::destroy(m_alloc, entry);
+            throw;
+        }
+        try {
+            m_policy.on_insert(*entry);
+        } catch (...) {
+            m_index.erase(*entry);
+            mem::destroy(m_alloc, entry);
+            throw;
+        }
+        m_weight += entry->weight;
+        return evict_over_capacity(entry);
+    }
+
+    bool erase(const key_type &key) {
+        const auto found = m_index.find(key, m_hash(key));
+        if (found == m_index.end()) return false;
+        entry_type &entry = *found;
+        m_policy.on_erase(entry);
+        m_index.erase(entry);
+        m_weight -= entry.weight;
+        mem::destroy(m_alloc, &entry);
+        return true;
+    }
+
+    // Destroys every entry without calling the eviction callback
+    void clear() noexcept {
+        m_policy.clear();
+        m_index.clear_and_dispose([this](entry_type &entry) { mem::destroy(m_alloc, &entry); });
+        m_weight = 0;
+    }
+
+private:
+    [[no_unique_address]] entry_allocator m_alloc;
+    Intrusive_hash_set<entry_type, Hash_hook<>, Entry_hash, Entry_equal, mem::rebind<Allocator, Hash_links *>> m_index;
+    policy_type m_policy;
+    size_type m_capacity;
+    size_type m_weight = 0;
+    [[no_unique_address]] Hash m_hash;
+    [[no_unique_address]] Weigher m_weigher;
+    eviction_callback m_on_evict;
+
+    // Evicts until the entries fit; returns false if `keep` was among the evicted
+    bool evict_over_capacity(const entry_type *keep) {
+        bool kept = true;
+        while (m_weight > m_capacity) {
+            entry_type *victim = m_policy.victim();
+            if (!victim) break;
+            m_policy.on_evict(*victim);
+            m_index.erase(*victim);
+            m_weight -= victim->weight;
+            if (victim == keep) kept = false;
+            try {
+                if (m_on_evict) m_on_evict(victim->key, victim->value);
+            } catch (...) {
+                mem::destroy(m_alloc, victim);
+                throw;
+            }
+            mem::destroy(m_alloc, victim);
+        }
+        return kept;
+    }
+};
+
+template<typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>,
+         typename Weigher = Unit_weigher, typename Allocator = std::allocator<Cache_entry<Key, Value>>>
+using Lru_cache = Cache<Key, Value, Lru_policy, Hash, KeyEqual, Weigher, Allocator>;
+
+template<typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>,
+         typename Weigher = Unit_weigher, typename Allocator = std::allocator<Cache_entry<Key, Value>>>
+using Lfu_cache = Cache<Key, Value, Lfu_policy, Hash, KeyEqual, Weigher, Allocator>;
+
+template<typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>,
+         typename Weigher = Unit_weigher, typename Allocator = std::allocator<Cache_entry<Key, Value>>>
+using Arc_cache = Cache<Key, Value, Arc_policy, Hash, KeyEqual, Weigher, Allocator>;
+
+template<typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>,
+         typename Weigher = Unit_weigher, typename Allocator = std::allocator<Cache_entry<Key, Value>>>
+using Tiny_lfu_cache = Cache<Key, Value, Tiny_lfu_policy, Hash, KeyEqual, Weigher, Allocator>;
+
+namespace pmr {
+    template<typename Key, typename Value, template<typename, typename> class Policy = Lru_policy>
+    using Cache = ::Cache<Key, Value, Policy, std::hash<Key>, std::equal_to<Key>, Unit_weigher,
+                          std::pmr::polymorphic_allocator<Cache_entry<Key, Value>>>;
+}
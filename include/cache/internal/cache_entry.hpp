@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "intrusive/hooks.hpp"
+
+// One cached key and value in a single allocation. The hash hook links the entry into the
+// cache's index and caches the key's hash, which the index and the eviction policy read back as
+// `hash`; the list hook belongs to the policy, which also owns `segment` and `frequency`.
+template<typename Key, typename Value>
+struct Cache_entry : List_hook<>, Hash_hook<> {
+    Key key;
+    Value value;
+    std::size_t weight = 1;
+    std::uint8_t segment = 0;
+    std::uint8_t frequency = 0;
+
+    template<typename K, typename V>
+    Cache_entry(K &&key, V &&value, const std::size_t key_hash)
+        : key(std::forward<K>(key)), value(std::forward<V>(value)) {
+        Hash_links::hash = key_hash;
+    }
+};
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "sequence/vector.hpp"
+
+// Count-min sketch of 4-bit counters estimating how often each hash was seen recently
+// (Einziger, Friedman & Manes, TinyLFU). Every hash owns one counter in each of four rows, each
+// counter sitting in a different 64-bit word; the estimate is the smallest of the four. Once
+// ten times as many increments as the table has words have been made, every counter is halved,
+// so old popularity fades.
+template<typename Allocator = std::allocator<std::uint64_t>>
+class Frequency_sketch {
+public:
+    using size_type = std::size_t;
+    using allocator_type = Allocator;
+
+    static constexpr unsigned MAX_FREQUENCY = 15;
+
+    explicit Frequency_sketch(const allocator_type &alloc = allocator_type()) : m_table(alloc) {}
+
+    // Widens the table to track about `count` distinct hashes; widening forgets all counts
+    void ensure_capacity(const size_type count) {
+        const size_type width = std::bit_ceil(std::max(count, MIN_WIDTH));
+        if (width <= m_table.size()) return;
+        table_type table(width, m_table.get_allocator());
+        m_table.swap(table);
+        m_additions = 0;
+    }
+
+    [[nodiscard]] unsigned frequency(const std::size_t hash) const noexcept {
+        if (m_table.empty()) return 0;
+        unsigned result = MAX_FREQUENCY;
+        for (unsigned row = 0; row < ROWS; ++row) {
+            const auto [word, shift] = slot(hash, row);
+            result = std::min(result, static_cast<unsigned>((m_table[word] >> shift) & MAX_FREQUENCY));
+        }
+        return result;
+    }
+
+    void increment(const std::size_t hash) noexcept {
+        if (m_table.empty()) return;
+        bool added = false;
+        for (unsigned row = 0; row < ROWS; ++row) {
+            const auto [word, shift] = slot(hash, row);
+            if (((m_table[word] >> shift) & MAX_FREQUENCY) != MAX_FREQUENCY) {
+                m_table[word] += std::uint64_t{1} << shift;
+                added = true;
+            }
+        }
+        if (added && ++m_additions == SAMPLE_FACTOR * m_table.size()) age();
+    }
+
+    void clear() noexcept {
+        for (auto &word : m_table) word = 0;
+        m_additions = 0;
+    }
+
+private:
+    using table_type = Vector<std::uint64_t, Allocator>;
+
+    struct Slot {
+        size_type word;
+        unsigned shift;
+    };
+
+    static constexpr unsigned ROWS = 4;
+    static constexpr size_type MIN_WIDTH = 16;
+    static constexpr size_type SAMPLE_FACTOR = 10;
+    static constexpr std::uint64_t SEEDS[ROWS] = {0x97cb3127d4a1f6c5ULL, 0xc2b2ae3d27d4eb4fULL,
+                                                  0x9e3779b97f4a7c15ULL, 0xff51afd7ed558ccdULL};
+
+    table_type m_table;
+    size_type m_additions = 0;
+
+    // Row `row` picks its word from the middle bits of a seeded product and its counter from
+    // the top four, so the rows of one hash rarely collide with each other
+    Slot slot(std::uint64_t hash, const unsigned row) const noexcept {
+        hash ^= hash >> 33;
+        const std::uint64_t mixed = (hash + row) * SEEDS[row];
+        return {static_cast<size_type>(mixed >> 20) & (m_table.size() - 1), static_cast<unsigned>(mixed >> 60) * 4};
+    }
+
+    void age() noexcept {
+        for (auto &word : m_table) word = (word >> 1) & 0x7777777777777777ULL;
+        m_additions /= 2;
+    }
+};
@@ -0,0 +1,433 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "internal/frequency_sketch.hpp"
+#include "intrusive/hash_set.hpp"
+#include "intrusive/list.hpp"
+#include "utils/allocator.hpp"
+
+// Eviction policies for Cache. A policy orders the resident entries through their list hook and
+// is told about every event; all weights are whatever the cache's weigher returns:
+//
+//     Policy(capacity, alloc)      set_capacity(capacity)
+//     on_insert(entry)             a new entry became resident
+//     on_access(entry)             a lookup hit it
+//     on_update(entry, old_weight) its value was replaced, which counts as an access
+//     on_miss(hash)                a lookup for a key with this hash missed
+//     on_erase(entry)              it was erased by the user
+//     on_evict(entry)              it was chosen by victim() and is about to be destroyed
+//     victim()                     the entry to evict next, or null when there is none
+//     clear()                      every entry is about to be destroyed
+//
+// victim() may reorganize the policy's lists but must leave the entry it returns linked.
+
+// Least recently used: one list, oldest first
+template<typename Entry, typename Allocator>
+class Lru_policy {
+public:
+    explicit Lru_policy(std::size_t, const Allocator &) noexcept {}
+
+    void set_capacity(std::size_t) noexcept {}
+
+    void on_insert(Entry &entry) noexcept {
+        m_order.push_back(entry);
+    }
+
+    void on_access(Entry &entry) noexcept {
+        m_order.splice(m_order.end(), m_order, m_order.iterator_to(entry));
+    }
+
+    void on_update(Entry &entry, std::size_t) noexcept {
+        on_access(entry);
+    }
+
+    void on_miss(std::size_t) noexcept {}
+
+    void on_erase(Entry &entry) noexcept {
+        m_order.erase(entry);
+    }
+
+    void on_evict(Entry &entry) noexcept {
+        m_order.erase(entry);
+    }
+
+    Entry *victim() noexcept {
+        return m_order.empty() ? nullptr : &m_order.front();
+    }
+
+    void clear() noexcept {
+        m_order.clear();
+    }
+
+private:
+    Intrusive_list<Entry> m_order;
+};
+
+// Least frequently used, ties broken by recency. Each entry's count saturates at LEVELS - 1 and
+// picks one of LEVELS lists, so eviction takes the oldest entry of the lowest non-empty level in
+// O(1). Once the accesses reach AGING_PERIOD times the entry count, every count is halved so
+// that entries which were popular long ago can leave; that pass is O(n) but amortizes to O(1).
+template<typename Entry, typename Allocator>
+class Lfu_policy {
+public:
+    explicit Lfu_policy(std::size_t, const Allocator &) noexcept {}
+
+    void set_capacity(std::size_t) noexcept {}
+
+    void on_insert(Entry &entry) noexcept {
+        entry.frequency = 0;
+        link(entry);
+        ++m_count;
+    }
+
+    void on_access(Entry &entry) noexcept {
+        unlink(entry);
+        if (entry.frequency < LEVELS - 1) ++entry.frequency;
+        link(entry);
+        if (++m_accesses >= AGING_PERIOD * m_count) age();
+    }
+
+    void on_update(Entry &entry, std::size_t) noexcept {
+        on_access(entry);
+    }
+
+    void on_miss(std::size_t) noexcept {}
+
+    void on_erase(Entry &entry) noexcept {
+        unlink(entry);
+        --m_count;
+    }
+
+    void on_evict(Entry &entry) noexcept {
+        on_erase(entry);
+    }
+
+    Entry *victim() noexcept {
+        if (!m_occupied) return nullptr;
+        return &m_levels[std::countr_zero(m_occupied)].front();
+    }
+
+    void clear() noexcept {
+        for (auto &level : m_levels) level.clear();
+        m_occupied = 0;
+        m_count = m_accesses = 0;
+    }
+
+private:
+    static constexpr unsigned LEVELS = 16;
+    static constexpr std::size_t AGING_PERIOD = 8;
+
+    Intrusive_list<Entry> m_levels[LEVELS];
+    std::uint32_t m_occupied = 0; // bit i is set while level i is not empty
+    std::size_t m_count = 0;
+    std::size_t m_accesses = 0;
+
+    void link(Entry &entry) noexcept {
+        m_levels[entry.frequency].push_back(entry);
+        m_occupied |= 1u << entry.frequency;
+    }
+
+    void unlink(Entry &entry) noexcept {
+        auto &level = m_levels[entry.frequency];
+        level.erase(entry);
+        if (level.empty()) m_occupied &= ~(1u << entry.frequency);
+    }
+
+    // Level i moves behind level i / 2; going upwards, every target has been halved already
+    void age() noexcept {
+        m_accesses = 0;
+        for (unsigned i = 1; i < LEVELS; ++i) {
+            for (auto &entry : m_levels[i]) entry.frequency = static_cast<std::uint8_t>(i / 2);
+            m_levels[i / 2].splice(m_levels[i / 2].end(), m_levels[i]);
+        }
+        m_occupied = 0;
+        for (unsigned i = 0; i < LEVELS; ++i) {
+            if (!m_levels[i].empty()) m_occupied |= 1u << i;
+        }
+    }
+};
+
+// Adaptive replacement cache (Megiddo & Modha). Entries seen once live in T1 and entries seen
+// again in T2; the ghost lists B1 and B2 remember the hashes and weights of entries recently
+// evicted from each. A miss that hits a ghost moves the target weight of T1 towards the list
+// that would have kept the entry, so the cache tunes itself between recency and frequency.
+// Ghosts are the only thing the policy allocates; their nodes are recycled, and they are
+// bounded by the capacity just like the resident lists.
+template<typename Entry, typename Allocator>
+class Arc_policy {
+public:
+    explicit Arc_policy(const std::size_t capacity, const Allocator &alloc)
+        : m_ghost_alloc(alloc), m_ghost_index(0, Ghost_hash(), Ghost_equal(), alloc), m_capacity(capacity) {}
+
+    Arc_policy(const Arc_policy &) = delete;
+    Arc_policy &operator=(const Arc_policy &) = delete;
+
+    ~Arc_policy() {
+        clear();
+        m_spare.clear_and_dispose([this](Ghost &ghost) { mem::destroy(m_ghost_alloc, &ghost); });
+    }
+
+    void set_capacity(const std::size_t capacity) noexcept {
+        m_capacity = capacity;
+        m_target = std::min(m_target, capacity);
+        trim_ghosts();
+    }
+
+    void on_insert(Entry &entry) noexcept {
+        const auto found = m_ghost_index.find(entry.hash, entry.hash);
+        if (found == m_ghost_index.end()) {
+            link(entry, RECENT);
+            trim_ghosts();
+            return;
+        }
+
+        // The ghost lists weigh 0 when a weigher returns 0 for their entries, hence the clamped divisors
+        Ghost &ghost = *found;
+        if (ghost.frequent) {
+            const std::size_t ratio = m_ghost_weight[RECENT] / std::max<std::size_t>(1, m_ghost_weight[FREQUENT]);
+            const std::size_t delta = ghost.weight * std::max<std::size_t>(1, ratio);
+            m_target = m_target > delta ? m_target - delta : 0;
+        } else {
+            const std::size_t ratio = m_ghost_weight[FREQUENT] / std::max<std::size_t>(1, m_ghost_weight[RECENT]);
+            const std::size_t delta = ghost.weight * std::max<std::size_t>(1, ratio);
+            m_target = std::min(m_capacity, m_target + delta);
+        }
+        drop(ghost);
+        link(entry, FREQUENT);
+    }
+
+    void on_access(Entry &entry) noexcept {
+        unlink(entry);
+        link(entry, FREQUENT);
+    }
+
+    void on_update(Entry &entry, const std::size_t old_weight) noexcept {
+        m_weight[entry.segment] = m_weight[entry.segment] - old_weight + entry.weight;
+        on_access(entry);
+    }
+
+    void on_miss(std::size_t) noexcept {}
+
+    void on_erase(Entry &entry) noexcept {
+        unlink(entry);
+    }
+
+    // Remembers the entry as a ghost of the list it leaves; if that throws, nothing has changed
+    void on_evict(Entry &entry) {
+        m_ghost_index.reserve(m_ghost_index.size() + 1);
+        Ghost *ghost = m_spare.empty() ? mem::create(m_ghost_alloc) : &m_spare.front();
+        if (!m_spare.empty()) m_spare.pop_front();
+
+        const auto found = m_ghost_index.find(entry.hash, entry.hash);
+        if (found != m_ghost_index.end()) drop(*found);
+
+        const bool frequent = entry.segment == FREQUENT;
+        unlink(entry);
+        ghost->hash = entry.hash;
+        ghost->weight = entry.weight;
+        ghost->frequent = frequent;
+        m_ghosts[frequent].push_back(*ghost);
+        m_ghost_weight[frequent] += ghost->weight;
+        m_ghost_index.insert(*ghost);
+        trim_ghosts();
+    }
+
+    // T1 gives up its oldest entry while it is over its target weight
+    Entry *victim() noexcept {
+        if (!m_lists[RECENT].empty() && (m_weight[RECENT] > m_target || m_lists[FREQUENT].empty())) {
+            return &m_lists[RECENT].front();
+        }
+        return m_lists[FREQUENT].empty() ? nullptr : &m_lists[FREQUENT].front();
+    }
+
+    void clear() noexcept {
+        for (auto &list : m_lists) list.clear();
+        while (!m_ghosts[RECENT].empty()) drop(m_ghosts[RECENT].front());
+        while (!m_ghosts[FREQUENT].empty()) drop(m_ghosts[FREQUENT].front());
+        m_weight[RECENT] = m_weight[FREQUENT] = 0;
+        m_target = 0;
+    }
+
+private:
+    static constexpr std::uint8_t RECENT = 0;
+    static constexpr std::uint8_t FREQUENT = 1;
+
+    // Keeps an evicted entry's hash in its own hash hook
+    struct Ghost : List_hook<>, Hash_hook<> {
+        std::size_t weight = 0;
+        bool frequent = false;
+    };
+
+    struct Ghost_hash {
+        std::size_t operator()(const Ghost &ghost) const noexcept { return ghost.hash; }
+    };
+
+    struct Ghost_equal {
+        bool operator()(const std::size_t hash, const Ghost &ghost) const noexcept { return hash == ghost.hash; }
+        bool operator()(const Ghost &lhs, const Ghost &rhs) const noexcept { return lhs.hash == rhs.hash; }
+    };
+
+    using ghost_allocator = mem::rebind<Allocator, Ghost>;
+
+    [[no_unique_address]] ghost_allocator m_ghost_alloc;
+    Intrusive_list<Entry> m_lists[2];  // T1 and T2, oldest first
+    Intrusive_list<Ghost> m_ghosts[2]; // B1 and B2, oldest first
+    Intrusive_list<Ghost> m_spare;
+    Intrusive_hash_set<Ghost, Hash_hook<>, Ghost_hash, Ghost_equal, mem::rebind<Allocator, Hash_links *>> m_ghost_index;
+    std::size_t m_weight[2] = {0, 0};
+    std::size_t m_ghost_weight[2] = {0, 0};
+    std::size_t m_target = 0; // the weight T1 should have
+    std::size_t m_capacity;
+
+    void link(Entry &entry, const std::uint8_t segment) noexcept {
+        entry.segment = segment;
+        m_lists[segment].push_back(entry);
+        m_weight[segment] += entry.weight;
+    }
+
+    void unlink(Entry &entry) noexcept {
+        m_lists[entry.segment].erase(entry);
+        m_weight[entry.segment] -= entry.weight;
+    }
+
+    void drop(Ghost &ghost) noexcept {
+        m_ghost_index.erase(ghost);
+        m_ghosts[ghost.frequent].erase(ghost);
+        m_ghost_weight[ghost.frequent] -= ghost.weight;
+        m_spare.push_back(ghost);
+    }
+
+    // T1 and B1 together stay within the capacity, all four lists within twice that
+    void trim_ghosts() noexcept {
+        while (!m_ghosts[RECENT].empty() && m_weight[RECENT] + m_ghost_weight[RECENT] > m_capacity) {
+            drop(m_ghosts[RECENT].front());
+        }
+        while (!m_ghosts[FREQUENT].empty() && m_weight[RECENT] + m_weight[FREQUENT] + m_ghost_weight[RECENT] +
+                                                  m_ghost_weight[FREQUENT] > 2 * m_capacity) {
+            drop(m_ghosts[FREQUENT].front());
+        }
+    }
+};
+
+// Window TinyLFU (Einziger, Friedman & Manes). New entries enter a small LRU window holding
+// WINDOW_PERCENT of the capacity; entries pushed out of the window join the probation segment
+// of a segmented LRU, and a hit there promotes them to the protected segment, which holds
+// PROTECTED_PERCENT of the main space. When the cache is over capacity, the newest arrival in
+// probation and the oldest entry there compete, and whichever a frequency sketch of recent
+// accesses, misses included, rates lower is evicted. One-hit wonders thus never displace
+// popular entries, while the window still lets bursts of new keys in.
+template<typename Entry, typename Allocator>
+class Tiny_lfu_policy {
+public:
+    explicit Tiny_lfu_policy(const std::size_t capacity, const Allocator &alloc)
+        : m_sketch(mem::rebind<Allocator, std::uint64_t>(alloc)) {
+        m_sketch.ensure_capacity(1);
+        set_capacity(capacity);
+    }
+
+    void set_capacity(const std::size_t capacity) noexcept {
+        m_window_capacity = capacity * WINDOW_PERCENT / 100;
+        m_protected_capacity = (capacity - m_window_capacity) * PROTECTED_PERCENT / 100;
+        drain_window();
+        drain_protected();
+    }
+
+    // The sketch only grows with the number of entries, so a byte capacity costs nothing up front
+    void on_insert(Entry &entry) {
+        m_sketch.ensure_capacity(m_count + 1);
+        m_sketch.increment(entry.hash);
+        ++m_count;
+        link(entry, WINDOW);
+        drain_window();
+    }
+
+    void on_access(Entry &entry) noexcept {
+        m_sketch.increment(entry.hash);
+        unlink(entry);
+        link(entry, entry.segment == WINDOW ? WINDOW : PROTECTED);
+        drain_protected();
+    }
+
+    void on_update(Entry &entry, const std::size_t old_weight) noexcept {
+        m_weight[entry.segment] = m_weight[entry.segment] - old_weight + entry.weight;
+        on_access(entry);
+        drain_window();
+    }
+
+    void on_miss(const std::size_t hash) noexcept {
+        m_sketch.increment(hash);
+    }
+
+    void on_erase(Entry &entry) noexcept {
+        unlink(entry);
+        --m_count;
+    }
+
+    void on_evict(Entry &entry) noexcept {
+        on_erase(entry);
+    }
+
+    Entry *victim() noexcept {
+        if (m_lists[PROBATION].empty()) {
+            if (!m_lists[PROTECTED].empty()) return &m_lists[PROTECTED].front();
+            return m_lists[WINDOW].empty() ? nullptr : &m_lists[WINDOW].front();
+        }
+        Entry &oldest = m_lists[PROBATION].front();
+        Entry &newest = m_lists[PROBATION].back();
+        return m_sketch.frequency(newest.hash) > m_sketch.frequency(oldest.hash) ? &oldest : &newest;
+    }
+
+    void clear() noexcept {
+        for (auto &list : m_lists) list.clear();
+        m_weight[WINDOW] = m_weight[PROBATION] = m_weight[PROTECTED] = 0;
+        m_count = 0;
+        m_sketch.clear();
+    }
+
+private:
+    static constexpr std::uint8_t WINDOW = 0;
+    static constexpr std::uint8_t PROBATION = 1;
+    static constexpr std::uint8_t PROTECTED = 2;
+    static constexpr std::size_t WINDOW_PERCENT = 1;
+    static constexpr std::size_t PROTECTED_PERCENT = 80;
+
+    Frequency_sketch<mem::rebind<Allocator, std::uint64_t>> m_sketch;
+    Intrusive_list<Entry> m_lists[3]; // oldest first
+    std::size_t m_weight[3] = {0, 0, 0};
+    std::size_t m_window_capacity = 0;
+    std::size_t m_protected_capacity = 0;
+    std::size_t m_count = 0;
+
+    void link(Entry &entry, const std::uint8_t segment) noexcept {
+        entry.segment = segment;
+        m_lists[segment].push_back(entry);
+        m_weight[segment] += entry.weight;
+    }
+
+    void unlink(Entry &entry) noexcept {
+        m_lists[entry.segment].erase(entry);
+        m_weight[entry.segment] -= entry.weight;
+    }
+
+    void move(Entry &entry, const std::uint8_t segment) noexcept {
+        unlink(entry);
+        link(entry, segment);
+    }
+
+    void drain_window() noexcept {
+        while (m_weight[WINDOW] > m_window_capacity && !m_lists[WINDOW].empty()) {
+            move(m_lists[WINDOW].front(), PROBATION);
+        }
+    }
+
+    void drain_protected() noexcept {
+        while (m_weight[PROTECTED] > m_protected_capacity && !m_lists[PROTECTED].empty()) {
+            move(m_lists[PROTECTED].front(), PROBATION);
+        }
+    }
+};
@@ -0,0 +1,314 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <utility>
+
+#include "epoch.hpp"
+#include "utils/visitor.hpp"
+
+// Ordered map that many threads may read and modify at once (Herlihy & Shavit's lock-free skip
+// list). Every level of a node's tower is a linked list; a node is removed by setting the low
+// "marked" bit of its own next links, top level first, and whoever walks past a marked node
+// unlinks it with a CAS. find, contains and the visitors never write shared memory.
+// Values are immutable once inserted; to change one, remove the key and insert it again.
+// Nodes are reclaimed through ebr, so no reader can ever touch freed memory.
+template<typename Key, typename Value, typename Compare = std::less<>>
+class Concurrent_skip_list {
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using key_compare = Compare;
+    using size_type = std::size_t;
+
+    // Constructors
+    Concurrent_skip_list() = default;
+
+    explicit Concurrent_skip_list(const Compare &comp) : m_comp(comp) {}
+
+    Concurrent_skip_list(const Concurrent_skip_list &) = delete;
+    Concurrent_skip_list &operator=(const Concurrent_skip_list &) = delete;
+
+    // Destructor; no other thread may use the list any more
+    ~Concurrent_skip_list() {
+        Node *node = Node::pointer(m_head[0].load(std::memory_order_acquire));
+        while (node) {
+            Node *next = Node::pointer(node->link(0).load(std::memory_order_relaxed));
+            Node::destroy(node);
+            node = next;
+        }
+    }
+
+    // Capacity; exact only while no other thread is modifying the list
+    [[nodiscard]] size_type size() const {
+        return m_size.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] bool empty() const {
+        return size() == 0;
+    }
+
+    // Lookup
+    // Copies the value stored under `key` into `value`; returns false if there is none
+    bool find(const key_type &key, mapped_type &value) const {
+        ebr::Guard guard;
+        const Node *node = find_node(key);
+        if (!node) return false;
+        value = node->value;
+        return true;
+    }
+
+    bool contains(const key_type &key) const {
+        ebr::Guard guard;
+        return find_node(key) != nullptr;
+    }
+
+    // Visits every (key, value) in ascending key order. Entries inserted or removed during the
+    // walk may or may not be seen; every entry present throughout is seen exactly once.
+    template<typename F>
+    bool for_each(F &&f) const {
+        ebr::Guard guard;
+        return visit_from(Node::pointer(m_head[0].load(std::memory_order_acquire)), f,
+                          [](const key_type &) { return true; });
+    }
+
+    // Same, restricted to keys in [first, last)
+    template<typename F>
+    bool for_each_in_range(const key_type &first, const key_type &last, F &&f) const {
+        ebr::Guard guard;
+        return visit_from(lower_bound_node(first), f, [this, &last](const key_type &key) {
+            return m_comp(key, last);
+        });
+    }
+
+    // Modifiers
+    // Returns false, leaving the stored value alone, if the key is already present
+    bool insert(const key_type &key, const mapped_type &value) {
+        ebr::Guard guard;
+        Link *preds[MAX_LEVEL];
+        Node *succs[MAX_LEVEL];
+        Node *node = nullptr;
+
+        while (true) {
+            if (find_and_unlink(key, preds, succs)) {
+                if (node) Node::destroy(node);
+                return false;
+            }
+            if (!node) node = Node::create(key, value, random_level());
+
+            for (int level = 0; level < node->height; ++level) {
+                node->link(level).store(Node::bits(succs[level]), std::memory_order_relaxed);
+            }
+            std::uintptr_t expected = Node::bits(succs[0]);
+            if (preds[0][0].compare_exchange_strong(expected, Node::bits(node), std::memory_order_release,
+                                                    std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        m_size.fetch_add(1, std::memory_order_relaxed);
+
+        // Present from here on; the upper levels only speed up searches
+        for (int level = 1; level < node->height; ++level) {
+            if (!link_level(node, level, preds, succs)) break;
+        }
+        finish(node, INSERTED);
+        return true;
+    }
+
+    bool remove(const key_type &key) {
+        ebr::Guard guard;
+        Link *preds[MAX_LEVEL];
+        Node *succs[MAX_LEVEL];
+
+        if (!find_and_unlink(key, preds, succs)) return false;
+        Node *victim = succs[0];
+
+        for (int level = victim->height - 1; level > 0; --level) {
+            victim->link(level).fetch_or(MARK, std::memory_order_acq_rel);
+        }
+        // Marking the bottom level is the linearization point; only one remover can win it
+        const std::uintptr_t old = victim->link(0).fetch_or(MARK, std::memory_order_acq_rel);
+        if (old & MARK) return false;
+
+        m_size.fetch_sub(1, std::memory_order_relaxed);
+        finish(victim, REMOVED);
+        return true;
+    }
+
+private:
+    static constexpr int MAX_LEVEL = 24;
+    static constexpr std::uintptr_t MARK = 1;
+
+    // Inserter and remover each set their bit when done with a node; whoever comes second
+    // unlinks whatever is left of it and retires it.
+    static constexpr unsigned INSERTED = 1;
+    static constexpr unsigned REMOVED = 2;
+
+    using Link = std::atomic<std::uintptr_t>;
+
+    // Allocated together with its tower of `height` links, which directly follow the node
+    struct alignas(Link) Node {
+        Key key;
+        Value value;
+        int height;
+        std::atomic<unsigned> state{0};
+
+        Node(const Key &k, const Value &v, const int h) : key(k), value(v), height(h) {}
+
+        Link &link(const int level) {
+            return reinterpret_cast<Link *>(this + 1)[level];
+        }
+
+        const Link &link(const int level) const {
+            return reinterpret_cast<const Link *>(this + 1)[level];
+        }
+
+        Link *links() {
+            return &link(0);
+        }
+
+        static Node *create(const Key &key, const Value &value, const int height) {
+            void *raw = ::operator new(sizeof(Node) + height * sizeof(Link));
+            Node *node;
+            try {
+                node = new(raw) Node(key, value, height);
+            } catch (...) {
+                ::operator delete(raw);
+                throw;
+            }
+            for (int level = 0; level < height; ++level) new(&node->link(level)) Link(0);
+            return node;
+        }
+
+        static void destroy(Node *node) {
+            node->~Node();
+            ::operator delete(node);
+        }
+
+        static void destroy_erased(void *node) {
+            destroy(static_cast<Node *>(node));
+        }
+
+        static Node *pointer(const std::uintptr_t bits) {
+            return reinterpret_cast<Node *>(bits & ~MARK);
+        }
+
+        static std::uintptr_t bits(const Node *node) {
+            return reinterpret_cast<std::uintptr_t>(node);
+        }
+    };
+
+    Link m_head[MAX_LEVEL] = {};
+    std::atomic<size_type> m_size{0};
+    [[no_unique_address]] Compare m_comp{};
+
+    // Geometric with p = 1/2, from a per-thread xorshift generator
+    static int random_level() {
+        static thread_local std::uint32_t state =
+            (0x9E3779B9u ^ static_cast<std::uint32_t>(reinterpret_cast<std::uintptr_t>(&state))) | 1u;
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return std::countr_zero(state | (1u << (MAX_LEVEL - 1))) + 1;
+    }
+
+    // Fills preds/succs with the neighbours of `key` on every level, unlinking marked nodes met on
+    // the way. Returns whether succs[0] holds `key`.
+    bool find_and_unlink(const key_type &key, Link **preds, Node **succs) {
+    retry:
+        Link *pred = m_head;
+        for (int level = MAX_LEVEL - 1; level >= 0; --level) {
+            Node *curr = Node::pointer(pred[level].load(std::memory_order_acquire));
+            while (curr) {
+                std::uintptr_t succ = curr->link(level).load(std::memory_order_acquire);
+                while (succ & MARK) {
+                    std::uintptr_t expected = Node::bits(curr);
+                    if (!pred[level].compare_exchange_strong(expected, succ & ~MARK, std::memory_order_acq_rel,
+                                                             std::memory_order_acquire)) {
+                        goto retry;
+                    }
+                    curr = Node::pointer(succ);
+                    if (!curr) break;
+                    succ = curr->link(level).load(std::memory_order_acquire);
+                }
+                if (!curr || !m_comp(curr->key, key)) break;
+                pred = curr->links();
+                curr = Node::pointer(succ);
+            }
+            preds[level] = pred;
+            succs[level] = curr;
+        }
+        return succs[0] && !m_comp(key, succs[0]->key);
+    }
+
+    // Read-only search: steps over marked nodes instead of unlinking them
+    const Node *lower_bound_node(const key_type &key) const {
+        const Link *pred = m_head;
+        Node *curr = nullptr;
+        for (int level = MAX_LEVEL - 1; level >= 0; --level) {
+            curr = Node::pointer(pred[level].load(std::memory_order_acquire));
+            while (curr) {
+                const std::uintptr_t succ = curr->link(level).load(std::memory_order_acquire);
+                if (succ & MARK) {
+                    curr = Node::pointer(succ);
+                } else if (m_comp(curr->key, key)) {
+                    pred = &curr->link(0);
+                    curr = Node::pointer(succ);
+                } else {
+                    break;
+                }
+            }
+        }
+        return curr;
+    }
+
+    const Node *find_node(const key_type &key) const {
+        const Node *node = lower_bound_node(key);
+        return node && !m_comp(key, node->key) ? node : nullptr;
+    }
+
+    template<typename F, typename InRange>
+    static bool visit_from(const Node *node, F &f, InRange in_range) {
+        while (node && in_range(node->key)) {
+            const std::uintptr_t next = node->link(0).load(std::memory_order_acquire);
+            if (!(next & MARK) && !invoke_visitor(f, std::as_const(node->key), std::as_const(node->value))) {
+                return false;
+            }
+            node = Node::pointer(next);
+        }
+        return true;
+    }
+
+    // Links an upper level; gives up once a remover has marked the node
+    bool link_level(Node *node, const int level, Link **preds, Node **succs) {
+        while (true) {
+            std::uintptr_t next = node->link(level).load(std::memory_order_acquire);
+            if (next & MARK) return false;
+            if (next != Node::bits(succs[level]) &&
+                !node->link(level).compare_exchange_strong(next, Node::bits(succs[level]),
+                                                           std::memory_order_acq_rel)) {
+                return false;
+            }
+            std::uintptr_t expected = Node::bits(succs[level]);
+            if (preds[level][level].compare_exchange_strong(expected, Node::bits(node), std::memory_order_release,
+                                                            std::memory_order_relaxed)) {
+                return true;
+            }
+            if (!find_and_unlink(node->key, preds, succs) || succs[0] != node) return false;
+        }
+    }
+
+    void finish(Node *node, const unsigned done) {
+        const unsigned old = node->state.fetch_or(done, std::memory_order_acq_rel);
+        if ((old | done) != (INSERTED | REMOVED)) return;
+
+        Link *preds[MAX_LEVEL];
+        Node *succs[MAX_LEVEL];
+        find_and_unlink(node->key, preds, succs);
+        ebr::retire(node, &Node::destroy_erased);
+    }
+};
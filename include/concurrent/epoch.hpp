@@ -0,0 +1,195 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "sequence/vector.hpp"
+
+// Epoch-based memory reclamation for the concurrent containers.
+// A thread pins itself (ebr::Guard) for the duration of every operation that reads shared
+// nodes. Unlinked nodes are handed to ebr::retire and freed once the global epoch has advanced
+// twice, at which point no pinned thread can still hold a pointer to them. The epoch advances
+// only when every pinned thread has observed the current one.
+namespace ebr {
+    class Domain {
+    public:
+        static Domain &global() {
+            static Domain domain;
+            return domain;
+        }
+
+        Domain(const Domain &) = delete;
+        Domain &operator=(const Domain &) = delete;
+
+        // Nothing may be pinned any more when the domain goes away
+        ~Domain() {
+            Record *record = m_records.load(std::memory_order_acquire);
+            while (record) {
+                Record *next = record->next;
+                for (auto &bucket : record->limbo) free_all(bucket);
+                delete record;
+                record = next;
+            }
+        }
+
+        void enter() {
+            Record &record = local();
+            if (record.nesting++ == 0) {
+                const std::uint64_t epoch = m_epoch.load(std::memory_order_relaxed);
+                record.state.store(epoch << 1 | ACTIVE, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+            }
+        }
+
+        void leave() {
+            Record &record = local();
+            if (--record.nesting == 0) {
+                record.state.store(0, std::memory_order_release);
+            }
+        }
+
+        // `deleter(object)` runs once no thread pinned now can reach `object` any more
+        void retire(void *object, void (*deleter)(void *)) {
+            Record &record = local();
+            const std::uint64_t epoch = m_epoch.load(std::memory_order_acquire);
+            const std::size_t index = epoch % BUCKETS;
+
+            // A bucket tagged with an older epoch of the same residue is at least three epochs old
+            if (record.limbo_epoch[index] != epoch) {
+                free_all(record.limbo[index]);
+                record.limbo_epoch[index] = epoch;
+            }
+            record.limbo[index].push_back(Retired{object, deleter});
+
+            if (++record.retired_since_collect >= COLLECT_THRESHOLD) {
+                record.retired_since_collect = 0;
+                collect(record);
+            }
+        }
+
+        // Tries to advance the epoch and frees whatever the calling thread may free
+        void collect() {
+            collect(local());
+        }
+
+        [[nodiscard]] std::uint64_t epoch() const {
+            return m_epoch.load(std::memory_order_acquire);
+        }
+
+    private:
+        static constexpr std::uint64_t ACTIVE = 1;
+        static constexpr std::size_t BUCKETS = 3;
+        static constexpr std::size_t COLLECT_THRESHOLD = 64;
+
+        struct Retired {
+            void *object = nullptr;
+            void (*deleter)(void *) = nullptr;
+        };
+
+        // One per thread; records are recycled when threads exit, together with their garbage
+        struct Record {
+            std::atomic<std::uint64_t> state{0}; // epoch << 1 | ACTIVE while pinned
+            std::atomic<bool> in_use{true};
+            Record *next = nullptr;
+            std::size_t nesting = 0;
+            std::size_t retired_since_collect = 0;
+            Vector<Retired> limbo[BUCKETS];
+            std::uint64_t limbo_epoch[BUCKETS] = {};
+        };
+
+        struct Binding {
+            Record *record = nullptr;
+
+            ~Binding() {
+                if (record) record->in_use.store(false, std::memory_order_release);
+            }
+        };
+
+        std::atomic<std::uint64_t> m_epoch{0};
+        std::atomic<Record *> m_records{nullptr};
+
+        Domain() = default;
+
+        Record &local() {
+            static thread_local Binding binding;
+            if (!binding.record) binding.record = acquire_record();
+            return *binding.record;
+        }
+
+        Record *acquire_record() {
+            for (Record *record = m_records.load(std::memory_order_acquire); record; record = record->next) {
+                bool expected = false;
+                if (!record->in_use.load(std::memory_order_relaxed) &&
+                    record->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                    return record;
+                }
+            }
+
+            auto *record = new Record;
+            Record *head = m_records.load(std::memory_order_relaxed);
+            do {
+                record->next = head;
+            } while (!m_records.compare_exchange_weak(head, record, std::memory_order_release,
+                                                      std::memory_order_relaxed));
+            return record;
+        }
+
+        bool try_advance() {
+            // Pairs with the fence in enter(): either this scan sees a thread's announcement, or
+            // that thread's loads see everything retired before the epoch moves on
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            std::uint64_t epoch = m_epoch.load(std::memory_order_acquire);
+            for (Record *record = m_records.load(std::memory_order_acquire); record; record = record->next) {
+                const std::uint64_t state = record->state.load(std::memory_order_acquire);
+                if ((state & ACTIVE) && (state >> 1) != epoch) return false;
+            }
+            m_epoch.compare_exchange_strong(epoch, epoch + 1, std::memory_order_acq_rel);
+            return true;
+        }
+
+        void collect(Record &record) {
+            try_advance();
+            const std::uint64_t epoch = m_epoch.load(std::memory_order_acquire);
+            for (std::size_t i = 0; i < BUCKETS; ++i) {
+                if (record.limbo_epoch[i] + 2 <= epoch) free_all(record.limbo[i]);
+            }
+        }
+
+        static void free_all(Vector<Retired> &bucket) {
+            for (auto &retired : bucket) retired.deleter(retired.object);
+            bucket.clear();
+        }
+    };
+
+    // Pins the calling thread for its lifetime; guards nest
+    class Guard {
+    public:
+        Guard() : m_domain(Domain::global()) {
+            m_domain.enter();
+        }
+
+        ~Guard() {
+            m_domain.leave();
+        }
+
+        Guard(const Guard &) = delete;
+        Guard &operator=(const Guard &) = delete;
+
+    private:
+        Domain &m_domain;
+    };
+
+    inline void retire(void *object, void (*deleter)(void *)) {
+        Domain::global().retire(object, deleter);
+    }
+
+    template<typename T>
+    void retire(T *object) {
+        retire(object, [](void *p) { delete static_cast<T *>(p); });
+    }
+
+    inline void collect() {
+        Domain::global().collect();
+    }
+}
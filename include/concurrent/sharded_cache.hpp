@@ -0,0 +1,180 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "cache/cache.hpp"
+#include "utils/allocator.hpp"
+
+// Cache that many threads may use at once: keys are spread by hash over independent Cache
+// shards, each behind its own mutex and on its own cache line, so threads contend only when
+// they hit the same shard. Each shard gets an equal share of the capacity and evicts on its
+// own, which makes the policy exact per shard and approximate overall.
+// Values are copied out under the lock, since another thread may evict an entry at any time.
+template<typename Key, typename Value, template<typename, typename> class Policy = Lru_policy,
+         typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>, typename Weigher = Unit_weigher,
+         typename Allocator = std::allocator<Cache_entry<Key, Value>>>
+class Sharded_cache {
+    using cache_type = Cache<Key, Value, Policy, Hash, KeyEqual, Weigher, Allocator>;
+
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using allocator_type = Allocator;
+    using size_type = std::size_t;
+    using eviction_callback = typename cache_type::eviction_callback;
+
+    // Constructors
+    // The shard count is rounded up to a power of two; by default there are four per core
+    explicit Sharded_cache(const size_type capacity, const size_type shard_count = 0, const Hash &hash = Hash(),
+                           const KeyEqual &equal = KeyEqual(), const Weigher &weigher = Weigher(),
+                           const allocator_type &alloc = allocator_type())
+        : m_alloc(alloc), m_shard_count(std::bit_ceil(std::max<size_type>(1, shard_count ? shard_count : default_shards()))),
+          m_shift(64 - std::countr_zero(m_shard_count)), m_hash(hash) {
+        m_shards = std::to_address(std::allocator_traits<shard_allocator>::allocate(m_alloc, m_shard_count));
+        size_type built = 0;
+        try {
+            for (; built < m_shard_count; ++built) {
+                std::allocator_traits<shard_allocator>::construct(m_alloc, m_shards + built, share(capacity), hash,
+                                                                  equal, weigher, alloc);
+            }
+        } catch (...) {
+            while (built) std::allocator_traits<shard_allocator>::destroy(m_alloc, m_shards + --built);
+            std::allocator_traits<shard_allocator>::deallocate(m_alloc, m_shards, m_shard_count);
+            throw;
+        }
+    }
+
+    Sharded_cache(const Sharded_cache &) = delete;
+    Sharded_cache &operator=(const Sharded_cache &) = delete;
+
+    // Destructor; no other thread may use the cache any more
+    ~Sharded_cache() {
+        mem::destroy_array(m_alloc, m_shards, m_shard_count);
+    }
+
+    // Capacity; exact only while no other thread is modifying the cache
+    [[nodiscard]] size_type size() const {
+        size_type total = 0;
+        for (size_type i = 0; i < m_shard_count; ++i) {
+            std::lock_guard lock(m_shards[i].mutex);
+            total += m_shards[i].cache.size();
+        }
+        return total;
+    }
+
+    [[nodiscard]] bool empty() const {
+        return size() == 0;
+    }
+
+    [[nodiscard]] size_type weight() const {
+        size_type total = 0;
+        for (size_type i = 0; i < m_shard_count; ++i) {
+            std::lock_guard lock(m_shards[i].mutex);
+            total += m_shards[i].cache.weight();
+        }
+        return total;
+    }
+
+    [[nodiscard]] size_type shard_count() const noexcept {
+        return m_shard_count;
+    }
+
+    void set_capacity(const size_type capacity) {
+        for (size_type i = 0; i < m_shard_count; ++i) {
+            std::lock_guard lock(m_shards[i].mutex);
+            m_shards[i].cache.set_capacity(share(capacity));
+        }
+    }
+
+    // The callback runs on the thread that caused the eviction, with that shard locked
+    void set_eviction_callback(const eviction_callback &callback) {
+        for (size_type i = 0; i < m_shard_count; ++i) {
+            std::lock_guard lock(m_shards[i].mutex);
+            m_shards[i].cache.set_eviction_callback(callback);
+        }
+    }
+
+    // Lookup
+    // Copies the value stored under `key` into `value`; returns false if there is none
+    bool get(const key_type &key, mapped_type &value) {
+        Shard &shard = shard_of(key);
+        std::lock_guard lock(shard.mutex);
+        const mapped_type *found = shard.cache.get(key);
+        if (!found) return false;
+        value = *found;
+        return true;
+    }
+
+    bool contains(const key_type &key) const {
+        const Shard &shard = shard_of(key);
+        std::lock_guard lock(shard.mutex);
+        return shard.cache.contains(key);
+    }
+
+    // Modifiers
+    bool put(key_type key, mapped_type value) {
+        Shard &shard = shard_of(key);
+        std::lock_guard lock(shard.mutex);
+        return shard.cache.put(std::move(key), std::move(value));
+    }
+
+    bool erase(const key_type &key) {
+        Shard &shard = shard_of(key);
+        std::lock_guard lock(shard.mutex);
+        return shard.cache.erase(key);
+    }
+
+    void clear() {
+        for (size_type i = 0; i < m_shard_count; ++i) {
+            std::lock_guard lock(m_shards[i].mutex);
+            m_shards[i].cache.clear();
+        }
+    }
+
+private:
+    struct alignas(64) Shard {
+        mutable std::mutex mutex;
+        cache_type cache;
+
+        Shard(const size_type capacity, const Hash &hash, const KeyEqual &equal, const Weigher &weigher,
+              const allocator_type &alloc)
+            : cache(capacity, hash, equal, weigher, alloc) {}
+    };
+
+    using shard_allocator = mem::rebind<Allocator, Shard>;
+
+    [[no_unique_address]] shard_allocator m_alloc;
+    Shard *m_shards = nullptr;
+    size_type m_shard_count;
+    unsigned m_shift;
+    [[no_unique_address]] Hash m_hash;
+
+    static size_type default_shards() {
+        return 4 * std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    size_type share(const size_type capacity) const noexcept {
+        return (capacity + m_shard_count - 1) / m_shard_count;
+    }
+
+    // The top bits of a multiplicative mix pick the shard, leaving the low bits that the
+    // shard's own index buckets by uncorrelated with the choice
+    size_type index_of(const key_type &key) const {
+        if (m_shard_count == 1) return 0;
+        return static_cast<size_type>((static_cast<std::uint64_t>(m_hash(key)) * 0x9e3779b97f4a7c15ULL) >> m_shift);
+    }
+
+    Shard &shard_of(const key_type &key) {
+        return m_shards[index_of(key)];
+    }
+
+    const Shard &shard_of(const key_type &key) const {
+        return m_shards[index_of(key)];
+    }
+};
@@ -0,0 +1,185 @@
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+
+#include "hooks.hpp"
+#include "internal/iterators.hpp"
+
+// Singly linked list of objects that derive from Hook. Like Intrusive_list it only links the
+// objects, so insert_after and erase_after are O(1) and allocate nothing. The list is circular
+// through its own sentinel, which is both before_begin() and end(); moving the list walks it to
+// repoint the last object at the new sentinel.
+template<typename T, typename Hook = Slist_hook<>>
+class Intrusive_forward_list {
+    static_assert(std::is_base_of_v<Hook, T>, "T must derive from the list's hook");
+
+public:
+    using value_type = T;
+    using pointer = T *;
+    using const_pointer = const T *;
+    using reference = T &;
+    using const_reference = const T &;
+    using size_type = std::size_t;
+    using iterator = Intrusive_iterator<T, Hook, Slist_walk>;
+    using const_iterator = Intrusive_iterator<const T, Hook, Slist_walk>;
+
+    // Constructors
+    Intrusive_forward_list() noexcept {
+        m_root.next = &m_root;
+    }
+
+    Intrusive_forward_list(const Intrusive_forward_list &) = delete;
+
+    Intrusive_forward_list(Intrusive_forward_list &&other) noexcept : Intrusive_forward_list() {
+        take(other);
+    }
+
+    // Assignment operator
+    Intrusive_forward_list &operator=(const Intrusive_forward_list &) = delete;
+
+    Intrusive_forward_list &operator=(Intrusive_forward_list &&other) noexcept {
+        if (this != &other) {
+            clear();
+            take(other);
+        }
+        return *this;
+    }
+
+    // Destructor: the objects stay alive and are left unlinked
+    ~Intrusive_forward_list() {
+        clear();
+    }
+
+    // Element access
+    reference front() {
+        if (empty()) throw std::out_of_range("Intrusive_forward_list is empty");
+        return *begin();
+    }
+
+    const_reference front() const {
+        if (empty()) throw std::out_of_range("Intrusive_forward_list is empty");
+        return *begin();
+    }
+
+    // Size
+    [[nodiscard]] size_type size() const noexcept {
+        return m_size;
+    }
+
+    [[nodiscard]] bool empty() const noexcept {
+        return m_root.next == &m_root;
+    }
+
+    // Modifiers. `value` must not already be in a list through this hook.
+    void push_front(reference value) noexcept {
+        insert_after(before_begin(), value);
+    }
+
+    void pop_front() {
+        if (empty()) throw std::out_of_range("Intrusive_forward_list is empty");
+        erase_after(before_begin());
+    }
+
+    iterator insert_after(const_iterator pos, reference value) noexcept {
+        Slist_links *node = static_cast<Hook *>(&value);
+        node->next = pos.node()->next;
+        pos.node()->next = node;
+        ++m_size;
+        return iterator(node);
+    }
+
+    // Unlinks the object after `pos` and returns the position after it
+    iterator erase_after(const_iterator pos) noexcept {
+        Slist_links *node = pos.node()->next;
+        pos.node()->next = node->next;
+        node->next = nullptr;
+        --m_size;
+        return iterator(pos.node()->next);
+    }
+
+    // Unlinks the objects strictly between `first` and `last`
+    iterator erase_after(const_iterator first, const_iterator last) noexcept {
+        while (first.node()->next != last.node()) erase_after(first);
+        return iterator(last.node());
+    }
+
+    // Unlinks every object, then hands each to `disposer`, e.g. to delete the ones it owns
+    template<typename Disposer>
+    void clear_and_dispose(Disposer disposer) {
+        Slist_links *node = m_root.next;
+        m_root.next = &m_root;
+        m_size = 0;
+        while (node != &m_root) {
+            Slist_links *next = node->next;
+            node->next = nullptr;
+            disposer(static_cast<reference>(*static_cast<Hook *>(node)));
+            node = next;
+        }
+    }
+
+    void clear() noexcept {
+        clear_and_dispose([](reference) {});
+    }
+
+    void swap(Intrusive_forward_list &other) noexcept {
+        Intrusive_forward_list tmp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(tmp);
+    }
+
+    // Position of an object known to be in this list
+    iterator iterator_to(reference value) noexcept {
+        return iterator(static_cast<Hook *>(&value));
+    }
+
+    // Iterators
+    iterator before_begin() noexcept {
+        return iterator(&m_root);
+    }
+
+    const_iterator before_begin() const noexcept {
+        return const_iterator(const_cast<Slist_links *>(&m_root));
+    }
+
+    iterator begin() noexcept {
+        return iterator(m_root.next);
+    }
+
+    const_iterator begin() const noexcept {
+        return const_iterator(m_root.next);
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    iterator end() noexcept {
+        return before_begin();
+    }
+
+    const_iterator end() const noexcept {
+        return before_begin();
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+private:
+    Slist_links m_root;
+    size_type m_size = 0;
+
+    // The last object points back at the sentinel, so it has to be found and repointed
+    void take(Intrusive_forward_list &other) noexcept {
+        if (other.empty()) return;
+        Slist_links *last = other.m_root.next;
+        while (last->next != &other.m_root) last = last->next;
+        m_root.next = other.m_root.next;
+        last->next = &m_root;
+        m_size = other.m_size;
+        other.m_root.next = &other.m_root;
+        other.m_size = 0;
+    }
+};
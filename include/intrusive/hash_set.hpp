@@ -0,0 +1,290 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+
+#include "hooks.hpp"
+#include "internal/iterators.hpp"
+#include "sequence/vector.hpp"
+
+// Hash set of objects that derive from Hook, chained through the hooks themselves. Inserting and
+// erasing an object link and unlink it in O(1) without allocating; only growing the bucket
+// array allocates, so a set reserve()d up front never does. Each hook caches its object's hash,
+// which makes rehashing a relink pass that never calls Hash.
+// Lookups take anything Hash and KeyEqual accept next to T, e.g. a key with a transparent hash.
+// With auto-unlink hooks objects may leave on their own, so size() counts them, and so does
+// insert before it grows the buckets.
+template<typename T, typename Hook = Hash_hook<>, typename Hash = std::hash<T>, typename KeyEqual = std::equal_to<>,
+         typename Allocator = std::allocator<Hash_links *>>
+class Intrusive_hash_set {
+    static_assert(std::is_base_of_v<Hook, T>, "T must derive from the set's hook");
+
+    static constexpr bool auto_unlink = Hook::mode == Link_mode::auto_unlink;
+
+public:
+    using value_type = T;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using allocator_type = Allocator;
+    using pointer = T *;
+    using reference = T &;
+    using const_reference = const T &;
+    using size_type = std::size_t;
+    using bucket_vector = Vector<Hash_links *, mem::rebind<Allocator, Hash_links *>>;
+    using iterator = Intrusive_hash_iterator<T, Hook>;
+    using const_iterator = Intrusive_hash_iterator<const T, Hook>;
+
+    // Constructors
+    // Buckets are allocated on the first insertion
+    Intrusive_hash_set() : Intrusive_hash_set(0) {}
+
+    explicit Intrusive_hash_set(const size_type bucket_count, const Hash &hash = Hash(),
+                                const KeyEqual &equal = KeyEqual(), const allocator_type &alloc = allocator_type())
+        : m_buckets(bucket_count, alloc), m_hash(hash), m_equal(equal) {}
+
+    Intrusive_hash_set(const Intrusive_hash_set &) = delete;
+
+    // Bucket heads are what the first node of each chain points back at, so they move with the
+    // array and the chains stay valid
+    Intrusive_hash_set(Intrusive_hash_set &&other) noexcept
+        : m_buckets(std::move(other.m_buckets)), m_size(std::exchange(other.m_size, 0)),
+          m_max_load_factor(other.m_max_load_factor), m_hash(std::move(other.m_hash)),
+          m_equal(std::move(other.m_equal)) {}
+
+    // Assignment operator
+    Intrusive_hash_set &operator=(const Intrusive_hash_set &) = delete;
+
+    Intrusive_hash_set &operator=(Intrusive_hash_set &&other) noexcept(mem::nothrow_move_assign<Allocator>) {
+        if (this != &other) {
+            clear();
+            Intrusive_hash_set tmp(std::move(other));
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    // Destructor: the objects stay alive and are left unlinked
+    ~Intrusive_hash_set() {
+        clear();
+    }
+
+    [[nodiscard]] allocator_type get_allocator() const noexcept {
+        return allocator_type(m_buckets.get_allocator());
+    }
+
+    // Capacity
+    [[nodiscard]] size_type size() const noexcept {
+        if constexpr (auto_unlink) {
+            size_type count = 0;
+            for (auto it = begin(); it != end(); ++it) ++count;
+            return count;
+        } else {
+            return m_size;
+        }
+    }
+
+    [[nodiscard]] bool empty() const noexcept {
+        return begin() == end();
+    }
+
+    [[nodiscard]] size_type bucket_count() const noexcept {
+        return m_buckets.size();
+    }
+
+    void set_max_load_factor(double factor) { m_max_load_factor = factor; }
+    [[nodiscard]] double max_load_factor() const { return m_max_load_factor; }
+    [[nodiscard]] double load_factor() const {
+        return bucket_count() ? static_cast<double>(size()) / bucket_count() : 0.0;
+    }
+
+    // Modifiers
+    // Links `value` unless an equal object is already in the set
+    bool insert(reference value) {
+        const size_type hash = m_hash(value);
+        if (find_node(value, hash)) return false;
+
+        if (m_size + 1 > bucket_count() * m_max_load_factor) {
+            // Objects that unlinked themselves never told the set, so with auto-unlink hooks
+            // m_size is only an upper bound: recount, and grow only when at least half full, so
+            // that the next recount is as many inserts away as this one cost
+            if constexpr (auto_unlink) m_size = size();
+            if (!auto_unlink || m_size + 1 > bucket_count() * m_max_load_factor / 2) {
+                rehash(std::max(bucket_count() * 2, MIN_BUCKETS));
+            }
+        }
+
+        Hash_links *node = links(value);
+        node->hash = hash;
+        intr::link_front(m_buckets[hash % bucket_count()], node);
+        ++m_size;
+        return true;
+    }
+
+    // Unlinks the object at `pos` and returns the position after it
+    iterator erase(const_iterator pos) noexcept {
+        iterator next(pos.node(), pos.buckets(), pos.bucket_count());
+        ++next;
+        intr::unlink(pos.node());
+        --m_size;
+        return next;
+    }
+
+    void erase(reference value) noexcept {
+        intr::unlink(links(value));
+        --m_size;
+    }
+
+    // Unlinks the object equal to `key` and returns it, or null when there is none
+    template<typename K>
+    pointer remove(const K &key) {
+        Hash_links *node = bucket_count() ? find_node(key, m_hash(key)) : nullptr;
+        if (!node) return nullptr;
+        intr::unlink(node);
+        --m_size;
+        return &to_value(node);
+    }
+
+    // Unlinks every object, then hands each to `disposer`, e.g. to delete the ones it owns
+    template<typename Disposer>
+    void clear_and_dispose(Disposer disposer) {
+        for (auto &head : m_buckets) {
+            while (Hash_links *node = head) {
+                intr::unlink(node);
+                disposer(to_value(node));
+            }
+        }
+        m_size = 0;
+    }
+
+    void clear() noexcept {
+        clear_and_dispose([](reference) {});
+    }
+
+    void swap(Intrusive_hash_set &other) noexcept {
+        using std::swap;
+        m_buckets.swap(other.m_buckets);
+        swap(m_size, other.m_size);
+        swap(m_max_load_factor, other.m_max_load_factor);
+        swap(m_hash, other.m_hash);
+        swap(m_equal, other.m_equal);
+    }
+
+    // Relinks every object into `count` buckets; only the bucket array is allocated
+    void rehash(const size_type count) {
+        bucket_vector buckets(std::max(count, MIN_BUCKETS), m_buckets.get_allocator());
+        for (auto &head : m_buckets) {
+            while (Hash_links *node = head) {
+                intr::unlink(node);
+                intr::link_front(buckets[node->hash % buckets.size()], node);
+            }
+        }
+        m_buckets.swap(buckets);
+    }
+
+    // Sizes the buckets so that `count` objects fit without another rehash. Growth is at least
+    // geometric, so reserving one more before each insert stays amortized constant.
+    void reserve(const size_type count) {
+        const auto needed = static_cast<size_type>(static_cast<double>(count) / m_max_load_factor) + 1;
+        if (needed > bucket_count()) rehash(std::max(needed, bucket_count() * 2));
+    }
+
+    // Lookup
+    template<typename K>
+    iterator find(const K &key) {
+        if (!bucket_count()) return end();
+        return make_iterator(find_node(key, m_hash(key)));
+    }
+
+    template<typename K>
+    const_iterator find(const K &key) const {
+        if (!bucket_count()) return end();
+        return const_iterator(find_node(key, m_hash(key)), bucket_data(), bucket_count());
+    }
+
+    // Same, with the key's hash already computed by the caller, e.g. one that stores it as well
+    template<typename K>
+    iterator find(const K &key, const size_type hash) {
+        return make_iterator(find_node(key, hash));
+    }
+
+    template<typename K>
+    const_iterator find(const K &key, const size_type hash) const {
+        return const_iterator(find_node(key, hash), bucket_data(), bucket_count());
+    }
+
+    template<typename K>
+    bool contains(const K &key) const {
+        return bucket_count() && find_node(key, m_hash(key));
+    }
+
+    // Position of an object known to be in this set
+    iterator iterator_to(reference value) noexcept {
+        return make_iterator(links(value));
+    }
+
+    // Iterators
+    iterator begin() noexcept {
+        return make_iterator(first_node());
+    }
+
+    const_iterator begin() const noexcept {
+        return const_iterator(first_node(), bucket_data(), bucket_count());
+    }
+
+    iterator end() noexcept {
+        return iterator();
+    }
+
+    const_iterator end() const noexcept {
+        return const_iterator();
+    }
+
+private:
+    bucket_vector m_buckets;
+    size_type m_size = 0;
+    double m_max_load_factor = 0.75;
+    [[no_unique_address]] Hash m_hash;
+    [[no_unique_address]] KeyEqual m_equal;
+
+    static constexpr size_type MIN_BUCKETS = 4;
+
+    static Hash_links *links(reference value) noexcept {
+        return static_cast<Hook *>(&value);
+    }
+
+    static reference to_value(Hash_links *node) noexcept {
+        return static_cast<reference>(*static_cast<Hook *>(node));
+    }
+
+    Hash_links *const *bucket_data() const noexcept {
+        return bucket_count() ? &m_buckets[0] : nullptr;
+    }
+
+    iterator make_iterator(Hash_links *node) noexcept {
+        return iterator(node, bucket_data(), bucket_count());
+    }
+
+    Hash_links *first_node() const noexcept {
+        for (Hash_links *head : m_buckets) {
+            if (head) return head;
+        }
+        return nullptr;
+    }
+
+    template<typename K>
+    Hash_links *find_node(const K &key, const size_type hash) const {
+        if (!bucket_count()) return nullptr;
+        for (Hash_links *node = m_buckets[hash % bucket_count()]; node; node = node->next) {
+            if (node->hash == hash && m_equal(key, to_value(node))) return node;
+        }
+        return nullptr;
+    }
+};
+
+template<typename T, typename Hook, typename Hash, typename KeyEqual, typename Allocator>
+void swap(Intrusive_hash_set<T, Hook, Hash, KeyEqual, Allocator> &lhs,
+          Intrusive_hash_set<T, Hook, Hash, KeyEqual, Allocator> &rhs) noexcept {
+    lhs.swap(rhs);
+}
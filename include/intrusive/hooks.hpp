@@ -0,0 +1,105 @@
+#pragma once
+
+#include "internal/links.hpp"
+
+// Hooks are base classes that put the links of an intrusive container inside the user's own
+// type, so one object can sit in several containers at once without any node allocation:
+//
+//     struct Lru {};
+//     struct Entry : List_hook<Lru>, Hash_hook<>, Tree_hook<> { ... };
+//
+// The tag tells apart two hooks of the same kind. Copying an object never copies its
+// membership: a copy starts unlinked and assignment leaves both sides where they were.
+
+enum class Link_mode {
+    safe,       // the object must be erased before it is destroyed; is_linked() says whether it is in
+    auto_unlink // destroying the object, or calling unlink(), takes it out of its container
+};
+
+struct Default_tag {};
+
+template<typename Tag = Default_tag, Link_mode Mode = Link_mode::safe>
+class List_hook : public List_links {
+public:
+    using tag = Tag;
+    static constexpr Link_mode mode = Mode;
+
+    List_hook() noexcept = default;
+    List_hook(const List_hook &) noexcept {}
+    List_hook &operator=(const List_hook &) noexcept { return *this; }
+
+    ~List_hook() {
+        if constexpr (Mode == Link_mode::auto_unlink) unlink();
+    }
+
+    [[nodiscard]] bool is_linked() const noexcept {
+        return next != nullptr;
+    }
+
+    void unlink() noexcept requires (Mode == Link_mode::auto_unlink) {
+        if (is_linked()) intr::unlink(this);
+    }
+};
+
+// A singly linked node cannot find its predecessor, so these hooks have no auto-unlink mode
+template<typename Tag = Default_tag>
+class Slist_hook : public Slist_links {
+public:
+    using tag = Tag;
+    static constexpr Link_mode mode = Link_mode::safe;
+
+    Slist_hook() noexcept = default;
+    Slist_hook(const Slist_hook &) noexcept {}
+    Slist_hook &operator=(const Slist_hook &) noexcept { return *this; }
+
+    [[nodiscard]] bool is_linked() const noexcept {
+        return next != nullptr;
+    }
+};
+
+template<typename Tag = Default_tag, Link_mode Mode = Link_mode::safe>
+class Hash_hook : public Hash_links {
+public:
+    using tag = Tag;
+    static constexpr Link_mode mode = Mode;
+
+    Hash_hook() noexcept = default;
+    Hash_hook(const Hash_hook &) noexcept {}
+    Hash_hook &operator=(const Hash_hook &) noexcept { return *this; }
+
+    ~Hash_hook() {
+        if constexpr (Mode == Link_mode::auto_unlink) unlink();
+    }
+
+    [[nodiscard]] bool is_linked() const noexcept {
+        return pprev != nullptr;
+    }
+
+    void unlink() noexcept requires (Mode == Link_mode::auto_unlink) {
+        if (is_linked()) intr::unlink(this);
+    }
+};
+
+// Auto-unlinking walks up to the tree's header first, so it costs O(log n) rather than O(1)
+template<typename Tag = Default_tag, Link_mode Mode = Link_mode::safe>
+class Tree_hook : public Tree_links {
+public:
+    using tag = Tag;
+    static constexpr Link_mode mode = Mode;
+
+    Tree_hook() noexcept = default;
+    Tree_hook(const Tree_hook &) noexcept {}
+    Tree_hook &operator=(const Tree_hook &) noexcept { return *this; }
+
+    ~Tree_hook() {
+        if constexpr (Mode == Link_mode::auto_unlink) unlink();
+    }
+
+    [[nodiscard]] bool is_linked() const noexcept {
+        return parent != nullptr;
+    }
+
+    void unlink() noexcept requires (Mode == Link_mode::auto_unlink) {
+        if (is_linked()) intr::erase_and_rebalance(this, *intr::header_of(this));
+    }
+};
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+#include "iterator/iterator_tags.hpp"
+#include "links.hpp"
+
+// How each intrusive container steps between its links
+struct List_walk {
+    using links_type = List_links;
+    using iterator_category = bidirectional_iterator_tag;
+
+    static List_links *next(List_links *node) { return node->next; }
+    static List_links *prev(List_links *node) { return node->prev; }
+};
+
+struct Slist_walk {
+    using links_type = Slist_links;
+    using iterator_category = forward_iterator_tag;
+
+    static Slist_links *next(Slist_links *node) { return node->next; }
+};
+
+struct Tree_walk {
+    using links_type = Tree_links;
+    using iterator_category = bidirectional_iterator_tag;
+
+    static Tree_links *next(Tree_links *node) { return intr::increment(node); }
+    static Tree_links *prev(Tree_links *node) { return intr::decrement(node); }
+};
+
+// Iterator over the objects whose Hook links are chained as Walk describes. T may be const.
+template<typename T, typename Hook, typename Walk>
+class Intrusive_iterator {
+public:
+    using value_type = T;
+    using pointer = T *;
+    using reference = T &;
+    using difference_type = std::ptrdiff_t;
+    using iterator_category = typename Walk::iterator_category;
+    using links_type = typename Walk::links_type;
+
+    explicit Intrusive_iterator(links_type *node = nullptr) : m_node(node) {}
+
+    template<typename U, typename = std::enable_if_t<std::is_convertible_v<U *, T *>>>
+    Intrusive_iterator(const Intrusive_iterator<U, Hook, Walk> &other) : m_node(other.node()) {}
+
+    links_type *node() const { return m_node; }
+
+    reference operator*() const { return *operator->(); }
+    pointer operator->() const { return static_cast<pointer>(static_cast<Hook *>(m_node)); }
+
+    Intrusive_iterator &operator++() {
+        m_node = Walk::next(m_node);
+        return *this;
+    }
+
+    Intrusive_iterator operator++(int) {
+        Intrusive_iterator tmp = *this;
+        ++(*this);
+        return tmp;
+    }
+
+    Intrusive_iterator &operator--() requires requires(links_type *node) { Walk::prev(node); } {
+        m_node = Walk::prev(m_node);
+        return *this;
+    }
+
+    Intrusive_iterator operator--(int) requires requires(links_type *node) { Walk::prev(node); } {
+        Intrusive_iterator tmp = *this;
+        --(*this);
+        return tmp;
+    }
+
+    bool operator==(const Intrusive_iterator &other) const { return m_node == other.m_node; }
+    bool operator!=(const Intrusive_iterator &other) const { return m_node != other.m_node; }
+
+private:
+    links_type *m_node;
+};
+
+// Walks the chains of a bucket array in order; the end iterator has no node
+template<typename T, typename Hook>
+class Intrusive_hash_iterator {
+public:
+    using value_type = T;
+    using pointer = T *;
+    using reference = T &;
+    using difference_type = std::ptrdiff_t;
+    using iterator_category = forward_iterator_tag;
+
+    Intrusive_hash_iterator() = default;
+
+    Intrusive_hash_iterator(Hash_links *node, Hash_links *const *buckets, const std::size_t bucket_count)
+        : m_node(node), m_buckets(buckets), m_bucket_count(bucket_count) {}
+
+    template<typename U, typename = std::enable_if_t<std::is_convertible_v<U *, T *>>>
+    Intrusive_hash_iterator(const Intrusive_hash_iterator<U, Hook> &other)
+        : m_node(other.node()), m_buckets(other.buckets()), m_bucket_count(other.bucket_count()) {}
+
+    Hash_links *node() const { return m_node; }
+    Hash_links *const *buckets() const { return m_buckets; }
+    std::size_t bucket_count() const { return m_bucket_count; }
+
+    reference operator*() const { return *operator->(); }
+    pointer operator->() const { return static_cast<pointer>(static_cast<Hook *>(m_node)); }
+
+    Intrusive_hash_iterator &operator++() {
+        if (m_node->next) {
+            m_node = m_node->next;
+            return *this;
+        }
+        std::size_t bucket = m_node->hash % m_bucket_count;
+        m_node = nullptr;
+        while (!m_node && ++bucket < m_bucket_count) m_node = m_buckets[bucket];
+        return *this;
+    }
+
+    Intrusive_hash_iterator operator++(int) {
+        Intrusive_hash_iterator tmp = *this;
+        ++(*this);
+        return tmp;
+    }
+
+    bool operator==(const Intrusive_hash_iterator &other) const { return m_node == other.m_node; }
+    bool operator!=(const Intrusive_hash_iterator &other) const { return m_node != other.m_node; }
+
+private:
+    Hash_links *m_node = nullptr;
+    Hash_links *const *m_buckets = nullptr;
+    std::size_t m_bucket_count = 0;
+};
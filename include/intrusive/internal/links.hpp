@@ -0,0 +1,340 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+
+#include "tree/internal/nodes/red_black_node.hpp"
+
+// Raw links embedded in the hooks, and the relinking algorithms the intrusive containers and
+// auto-unlink hooks share. A null link always means "not in a container".
+
+// Doubly linked, circular through the list's own sentinel
+struct List_links {
+    List_links *next = nullptr;
+    List_links *prev = nullptr;
+};
+
+// Singly linked, circular through the list's own before-begin sentinel
+struct Slist_links {
+    Slist_links *next = nullptr;
+};
+
+// Hash bucket chain in the style of hlist: `pprev` points at whatever points at this node, the
+// bucket head or the previous node's `next`, so a node unlinks itself without knowing its
+// bucket. The full hash is cached for rehashing and cheap mismatches.
+struct Hash_links {
+    Hash_links *next = nullptr;
+    Hash_links **pprev = nullptr;
+    std::size_t hash = 0;
+};
+
+// Tree node. The tree owns a header node whose parent is the root, whose left and right are the
+// leftmost and rightmost nodes, and which is the root's parent; it is told apart by being red
+// with a parent whose parent is itself.
+struct Tree_links {
+    Tree_links *parent = nullptr;
+    Tree_links *left = nullptr;
+    Tree_links *right = nullptr;
+    Color color = Color::RED;
+};
+
+namespace intr {
+    // List
+
+    inline void link_before(List_links *pos, List_links *node) noexcept {
+        node->next = pos;
+        node->prev = pos->prev;
+        pos->prev->next = node;
+        pos->prev = node;
+    }
+
+    inline void unlink(List_links *node) noexcept {
+        node->prev->next = node->next;
+        node->next->prev = node->prev;
+        node->next = node->prev = nullptr;
+    }
+
+    // Points the neighbours of a moved sentinel at its new address
+    inline void adopt(List_links &to, List_links &from) noexcept {
+        if (from.next == &from) {
+            to.next = to.prev = &to;
+            return;
+        }
+        to.next = std::exchange(from.next, &from);
+        to.prev = std::exchange(from.prev, &from);
+        to.next->prev = &to;
+        to.prev->next = &to;
+    }
+
+    // Hash chains
+
+    inline void link_front(Hash_links *&head, Hash_links *node) noexcept {
+        node->next = head;
+        node->pprev = &head;
+        if (head) head->pprev = &node->next;
+        head = node;
+    }
+
+    inline void unlink(Hash_links *node) noexcept {
+        *node->pprev = node->next;
+        if (node->next) node->next->pprev = node->pprev;
+        node->next = nullptr;
+        node->pprev = nullptr;
+    }
+
+    // Trees
+
+    inline bool is_header(const Tree_links *node) noexcept {
+        return node->color == Color::RED && node->parent && node->parent->parent == node;
+    }
+
+    inline Tree_links *header_of(Tree_links *node) noexcept {
+        do node = node->parent;
+        while (!is_header(node));
+        return node;
+    }
+
+    inline Tree_links *minimum(Tree_links *node) noexcept {
+        while (node->left) node = node->left;
+        return node;
+    }
+
+    inline Tree_links *maximum(Tree_links *node) noexcept {
+        while (node->right) node = node->right;
+        return node;
+    }
+
+    // In-order successor; the rightmost node's successor is the header
+    inline Tree_links *increment(Tree_links *node) noexcept {
+        if (node->right) return minimum(node->right);
+        Tree_links *parent = node->parent;
+        while (node == parent->right) {
+            node = parent;
+            parent = parent->parent;
+        }
+        // Only differs when stepping off the root of a tree without a right subtree
+        return node->right != parent ? parent : node;
+    }
+
+    // In-order predecessor; the header's predecessor is the rightmost node
+    inline Tree_links *decrement(Tree_links *node) noexcept {
+        if (is_header(node)) return node->right;
+        if (node->left) return maximum(node->left);
+        Tree_links *parent = node->parent;
+        while (node == parent->left) {
+            node = parent;
+            parent = parent->parent;
+        }
+        return parent;
+    }
+
+    inline void rotate_left(Tree_links *x, Tree_links *&root) noexcept {
+        Tree_links *y = x->right;
+        x->right = y->left;
+        if (y->left) y->left->parent = x;
+        y->parent = x->parent;
+
+        if (x == root) root = y;
+        else if (x == x->parent->left) x->parent->left = y;
+        else x->parent->right = y;
+
+        y->left = x;
+        x->parent = y;
+    }
+
+    inline void rotate_right(Tree_links *x, Tree_links *&root) noexcept {
+        Tree_links *y = x->left;
+        x->left = y->right;
+        if (y->right) y->right->parent = x;
+        y->parent = x->parent;
+
+        if (x == root) root = y;
+        else if (x == x->parent->right) x->parent->right = y;
+        else x->parent->left = y;
+
+        y->right = x;
+        x->parent = y;
+    }
+
+    // Links `node` as the left or right child of `parent` (the header for an empty tree) and
+    // restores the red-black properties
+    inline void insert_and_rebalance(const bool left, Tree_links *node, Tree_links *parent,
+                                     Tree_links &header) noexcept {
+        Tree_links *&root = header.parent;
+        node->parent = parent;
+        node->left = node->right = nullptr;
+        node->color = Color::RED;
+
+        if (left) {
+            parent->left = node;
+            if (parent == &header) {
+                header.parent = node;
+                header.right = node;
+            } else if (parent == header.left) {
+                header.left = node;
+            }
+        } else {
+            parent->right = node;
+            if (parent == header.right) header.right = node;
+        }
+
+        while (node != root && node->parent->color == Color::RED) {
+            Tree_links *grandparent = node->parent->parent;
+            if (node->parent == grandparent->left) {
+                Tree_links *uncle = grandparent->right;
+                if (uncle && uncle->color == Color::RED) {
+                    node->parent->color = Color::BLACK;
+                    uncle->color = Color::BLACK;
+                    grandparent->color = Color::RED;
+                    node = grandparent;
+                } else {
+                    if (node == node->parent->right) {
+                        node = node->parent;
+                        rotate_left(node, root);
+                    }
+                    node->parent->color = Color::BLACK;
+                    grandparent->color = Color::RED;
+                    rotate_right(grandparent, root);
+                }
+            } else {
+                Tree_links *uncle = grandparent->left;
+                if (uncle && uncle->color == Color::RED) {
+                    node->parent->color = Color::BLACK;
+                    uncle->color = Color::BLACK;
+                    grandparent->color = Color::RED;
+                    node = grandparent;
+                } else {
+                    if (node == node->parent->left) {
+                        node = node->parent;
+                        rotate_right(node, root);
+                    }
+                    node->parent->color = Color::BLACK;
+                    grandparent->color = Color::RED;
+                    rotate_left(grandparent, root);
+                }
+            }
+        }
+        root->color = Color::BLACK;
+    }
+
+    // Unlinks `z` from the tree headed by `header` and restores the red-black properties. A node
+    // with two children is replaced by its successor node itself, never by a copy of its value,
+    // since the values belong to the user.
+    inline void erase_and_rebalance(Tree_links *z, Tree_links &header) noexcept {
+        Tree_links *&root = header.parent;
+        Tree_links *&leftmost = header.left;
+        Tree_links *&rightmost = header.right;
+
+        Tree_links *y = z;
+        Tree_links *x;
+        Tree_links *x_parent;
+
+        if (!y->left) {
+            x = y->right;
+        } else if (!y->right) {
+            x = y->left;
+        } else {
+            y = minimum(y->right);
+            x = y->right;
+        }
+
+        if (y != z) {
+            // Relink the successor y in place of z
+            z->left->parent = y;
+            y->left = z->left;
+            if (y != z->right) {
+                x_parent = y->parent;
+                if (x) x->parent = y->parent;
+                y->parent->left = x;
+                y->right = z->right;
+                z->right->parent = y;
+            } else {
+                x_parent = y;
+            }
+
+            if (root == z) root = y;
+            else if (z->parent->left == z) z->parent->left = y;
+            else z->parent->right = y;
+            y->parent = z->parent;
+            std::swap(y->color, z->color);
+            y = z; // the color that left the tree is now z's
+        } else {
+            x_parent = y->parent;
+            if (x) x->parent = y->parent;
+
+            if (root == z) root = x;
+            else if (z->parent->left == z) z->parent->left = x;
+            else z->parent->right = x;
+
+            if (leftmost == z) leftmost = z->right ? minimum(x) : z->parent;
+            if (rightmost == z) rightmost = z->left ? maximum(x) : z->parent;
+        }
+
+        if (y->color == Color::BLACK) {
+            while (x != root && (!x || x->color == Color::BLACK)) {
+                if (x == x_parent->left) {
+                    Tree_links *w = x_parent->right;
+                    if (w->color == Color::RED) {
+                        w->color = Color::BLACK;
+                        x_parent->color = Color::RED;
+                        rotate_left(x_parent, root);
+                        w = x_parent->right;
+                    }
+                    if ((!w->left || w->left->color == Color::BLACK) &&
+                        (!w->right || w->right->color == Color::BLACK)) {
+                        w->color = Color::RED;
+                        x = x_parent;
+                        x_parent = x_parent->parent;
+                    } else {
+                        if (!w->right || w->right->color == Color::BLACK) {
+                            w->left->color = Color::BLACK;
+                            w->color = Color::RED;
+                            rotate_right(w, root);
+                            w = x_parent->right;
+                        }
+                        w->color = x_parent->color;
+                        x_parent->color = Color::BLACK;
+                        if (w->right) w->right->color = Color::BLACK;
+                        rotate_left(x_parent, root);
+                        break;
+                    }
+                } else {
+                    Tree_links *w = x_parent->left;
+                    if (w->color == Color::RED) {
+                        w->color = Color::BLACK;
+                        x_parent->color = Color::RED;
+                        rotate_right(x_parent, root);
+                        w = x_parent->left;
+                    }
+                    if ((!w->right || w->right->color == Color::BLACK) &&
+                        (!w->left || w->left->color == Color::BLACK)) {
+                        w->color = Color::RED;
+                        x = x_parent;
+                        x_parent = x_parent->parent;
+                    } else {
+                        if (!w->left || w->left->color == Color::BLACK) {
+                            w->right->color = Color::BLACK;
+                            w->color = Color::RED;
+                            rotate_left(w, root);
+                            w = x_parent->left;
+                        }
+                        w->color = x_parent->color;
+                        x_parent->color = Color::BLACK;
+                        if (w->left) w->left->color = Color::BLACK;
+                        rotate_right(x_parent, root);
+                        break;
+                    }
+                }
+            }
+            if (x) x->color = Color::BLACK;
+        }
+
+        z->parent = z->left = z->right = nullptr;
+    }
+
+    inline void reset(Tree_links &header) noexcept {
+        header.parent = nullptr;
+        header.left = header.right = &header;
+        header.color = Color::RED;
+    }
+}
@@ -0,0 +1,253 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+
+#include "hooks.hpp"
+#include "internal/iterators.hpp"
+
+// Doubly linked list of objects that derive from Hook. The list never allocates, copies or
+// destroys its objects; it only links them, so every insert and erase is O(1) and an object's
+// address is its position. The objects must outlive their membership, unless the hook is
+// auto-unlink, in which case size() counts the list because members may leave on their own.
+template<typename T, typename Hook = List_hook<>>
+class Intrusive_list {
+    static_assert(std::is_base_of_v<Hook, T>, "T must derive from the list's hook");
+
+    static constexpr bool auto_unlink = Hook::mode == Link_mode::auto_unlink;
+
+public:
+    using value_type = T;
+    using pointer = T *;
+    using const_pointer = const T *;
+    using reference = T &;
+    using const_reference = const T &;
+    using size_type = std::size_t;
+    using iterator = Intrusive_iterator<T, Hook, List_walk>;
+    using const_iterator = Intrusive_iterator<const T, Hook, List_walk>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    // Constructors
+    Intrusive_list() noexcept {
+        m_root.next = m_root.prev = &m_root;
+    }
+
+    Intrusive_list(const Intrusive_list &) = delete;
+
+    Intrusive_list(Intrusive_list &&other) noexcept : m_size(other.m_size) {
+        intr::adopt(m_root, other.m_root);
+        other.m_size = 0;
+    }
+
+    // Assignment operator
+    Intrusive_list &operator=(const Intrusive_list &) = delete;
+
+    Intrusive_list &operator=(Intrusive_list &&other) noexcept {
+        if (this != &other) {
+            clear();
+            intr::adopt(m_root, other.m_root);
+            m_size = other.m_size;
+            other.m_size = 0;
+        }
+        return *this;
+    }
+
+    // Destructor: the objects stay alive and are left unlinked
+    ~Intrusive_list() {
+        clear();
+    }
+
+    // Element access
+    reference front() {
+        if (empty()) throw std::out_of_range("Intrusive_list is empty");
+        return *begin();
+    }
+
+    const_reference front() const {
+        if (empty()) throw std::out_of_range("Intrusive_list is empty");
+        return *begin();
+    }
+
+    reference back() {
+        if (empty()) throw std::out_of_range("Intrusive_list is empty");
+        return *iterator(m_root.prev);
+    }
+
+    const_reference back() const {
+        if (empty()) throw std::out_of_range("Intrusive_list is empty");
+        return *const_iterator(m_root.prev);
+    }
+
+    // Size
+    [[nodiscard]] size_type size() const noexcept {
+        if constexpr (auto_unlink) {
+            size_type count = 0;
+            for (auto node = m_root.next; node != &m_root; node = node->next) ++count;
+            return count;
+        } else {
+            return m_size;
+        }
+    }
+
+    [[nodiscard]] bool empty() const noexcept {
+        return m_root.next == &m_root;
+    }
+
+    // Modifiers. `value` must not already be in a list through this hook.
+    void push_front(reference value) noexcept {
+        insert(begin(), value);
+    }
+
+    void push_back(reference value) noexcept {
+        insert(end(), value);
+    }
+
+    void pop_front() {
+        if (empty()) throw std::out_of_range("Intrusive_list is empty");
+        erase(begin());
+    }
+
+    void pop_back() {
+        if (empty()) throw std::out_of_range("Intrusive_list is empty");
+        erase(iterator(m_root.prev));
+    }
+
+    // Links `value` before `pos`
+    iterator insert(const_iterator pos, reference value) noexcept {
+        List_links *node = links(value);
+        intr::link_before(pos.node(), node);
+        ++m_size;
+        return iterator(node);
+    }
+
+    // Unlinks the object at `pos` and returns the position after it
+    iterator erase(const_iterator pos) noexcept {
+        List_links *next = pos.node()->next;
+        intr::unlink(pos.node());
+        --m_size;
+        return iterator(next);
+    }
+
+    iterator erase(const_iterator first, const_iterator last) noexcept {
+        while (first != last) first = erase(first);
+        return iterator(last.node());
+    }
+
+    void erase(reference value) noexcept {
+        erase(iterator_to(value));
+    }
+
+    // Unlinks every object, then hands each to `disposer`, e.g. to delete the ones it owns
+    template<typename Disposer>
+    void clear_and_dispose(Disposer disposer) {
+        List_links *node = m_root.next;
+        m_root.next = m_root.prev = &m_root;
+        m_size = 0;
+        while (node != &m_root) {
+            List_links *next = node->next;
+            node->next = node->prev = nullptr;
+            disposer(to_value(node));
+            node = next;
+        }
+    }
+
+    void clear() noexcept {
+        clear_and_dispose([](reference) {});
+    }
+
+    // Moves every object of `other` before `pos`
+    void splice(const_iterator pos, Intrusive_list &other) noexcept {
+        if (&other == this || other.empty()) return;
+        List_links *first = other.m_root.next;
+        List_links *last = other.m_root.prev;
+        other.m_root.next = other.m_root.prev = &other.m_root;
+
+        first->prev = pos.node()->prev;
+        last->next = pos.node();
+        pos.node()->prev->next = first;
+        pos.node()->prev = last;
+
+        m_size += other.m_size;
+        other.m_size = 0;
+    }
+
+    // Moves the object at `it` in `other` before `pos`
+    void splice(const_iterator pos, Intrusive_list &other, const_iterator it) noexcept {
+        if (it == pos || it.node()->next == pos.node()) return;
+        intr::unlink(it.node());
+        intr::link_before(pos.node(), it.node());
+        --other.m_size;
+        ++m_size;
+    }
+
+    void swap(Intrusive_list &other) noexcept {
+        Intrusive_list tmp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(tmp);
+    }
+
+    // Position of an object known to be in this list
+    iterator iterator_to(reference value) noexcept {
+        return iterator(links(value));
+    }
+
+    const_iterator iterator_to(const_reference value) const noexcept {
+        return const_iterator(links(const_cast<reference>(value)));
+    }
+
+    // Iterators
+    iterator begin() noexcept {
+        return iterator(m_root.next);
+    }
+
+    const_iterator begin() const noexcept {
+        return const_iterator(m_root.next);
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    iterator end() noexcept {
+        return iterator(&m_root);
+    }
+
+    const_iterator end() const noexcept {
+        return const_iterator(const_cast<List_links *>(&m_root));
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    reverse_iterator rbegin() noexcept {
+        return reverse_iterator(end());
+    }
+
+    reverse_iterator rend() noexcept {
+        return reverse_iterator(begin());
+    }
+
+    const_reverse_iterator rbegin() const noexcept {
+        return const_reverse_iterator(end());
+    }
+
+    const_reverse_iterator rend() const noexcept {
+        return const_reverse_iterator(begin());
+    }
+
+private:
+    List_links m_root; // sentinel: end() and the neighbour of the first and last objects
+    size_type m_size = 0;
+
+    static List_links *links(reference value) noexcept {
+        return static_cast<Hook *>(&value);
+    }
+
+    static reference to_value(List_links *node) noexcept {
+        return static_cast<reference>(*static_cast<Hook *>(node));
+    }
+};
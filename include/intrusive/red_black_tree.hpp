@@ -0,0 +1,318 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "hooks.hpp"
+#include "internal/iterators.hpp"
+
+// Red-black tree of objects that derive from Hook, ordered by Compare. Equal objects are kept in
+// insertion order, which suits timer queues. The tree links the objects it is given and never
+// allocates; the first and last objects are reached in O(1) through the header node.
+// Lookups take anything Compare accepts next to T, e.g. a key with a transparent comparator.
+// With auto-unlink hooks objects may leave on their own, so size() counts them.
+template<typename T, typename Hook = Tree_hook<>, typename Compare = std::less<>>
+class Intrusive_red_black_tree {
+    static_assert(std::is_base_of_v<Hook, T>, "T must derive from the tree's hook");
+
+    static constexpr bool auto_unlink = Hook::mode == Link_mode::auto_unlink;
+
+public:
+    using value_type = T;
+    using value_compare = Compare;
+    using pointer = T *;
+    using const_pointer = const T *;
+    using reference = T &;
+    using const_reference = const T &;
+    using size_type = std::size_t;
+    using iterator = Intrusive_iterator<T, Hook, Tree_walk>;
+    using const_iterator = Intrusive_iterator<const T, Hook, Tree_walk>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    // Constructors
+    explicit Intrusive_red_black_tree(const Compare &comp = Compare()) noexcept : m_comp(comp) {
+        intr::reset(m_header);
+    }
+
+    Intrusive_red_black_tree(const Intrusive_red_black_tree &) = delete;
+
+    Intrusive_red_black_tree(Intrusive_red_black_tree &&other) noexcept : m_comp(other.m_comp) {
+        intr::reset(m_header);
+        take(other);
+    }
+
+    // Assignment operator
+    Intrusive_red_black_tree &operator=(const Intrusive_red_black_tree &) = delete;
+
+    Intrusive_red_black_tree &operator=(Intrusive_red_black_tree &&other) noexcept {
+        if (this != &other) {
+            clear();
+            m_comp = other.m_comp;
+            take(other);
+        }
+        return *this;
+    }
+
+    // Destructor: the objects stay alive and are left unlinked
+    ~Intrusive_red_black_tree() {
+        clear();
+    }
+
+    // Element access
+    reference front() {
+        if (empty()) throw std::out_of_range("Intrusive_red_black_tree is empty");
+        return to_value(m_header.left);
+    }
+
+    const_reference front() const {
+        if (empty()) throw std::out_of_range("Intrusive_red_black_tree is empty");
+        return to_value(m_header.left);
+    }
+
+    reference back() {
+        if (empty()) throw std::out_of_range("Intrusive_red_black_tree is empty");
+        return to_value(m_header.right);
+    }
+
+    const_reference back() const {
+        if (empty()) throw std::out_of_range("Intrusive_red_black_tree is empty");
+        return to_value(m_header.right);
+    }
+
+    // Size
+    [[nodiscard]] size_type size() const noexcept {
+        if constexpr (auto_unlink) {
+            size_type count = 0;
+            for (auto it = begin(); it != end(); ++it) ++count;
+            return count;
+        } else {
+            return m_size;
+        }
+    }
+
+    [[nodiscard]] bool empty() const noexcept {
+        return m_header.parent == nullptr;
+    }
+
+    // Modifiers. `value` must not already be in a tree through this hook.
+    // Links `value` after any equal objects
+    iterator insert(reference value) {
+        Tree_links *parent = &m_header;
+        bool left = true;
+        for (Tree_links *node = m_header.parent; node;) {
+            parent = node;
+            left = m_comp(value, to_value(node));
+            node = left ? node->left : node->right;
+        }
+        return link(left, parent, value);
+    }
+
+    // Links `value` unless an equal object is already in the tree
+    std::pair<iterator, bool> insert_unique(reference value) {
+        Tree_links *parent = &m_header;
+        bool left = true;
+        for (Tree_links *node = m_header.parent; node;) {
+            parent = node;
+            left = m_comp(value, to_value(node));
+            node = left ? node->left : node->right;
+        }
+
+        // The only candidate for an equal object is the in-order predecessor of the new slot
+        iterator prev(parent);
+        if (left) {
+            if (parent == m_header.left) return {link(left, parent, value), true};
+            --prev;
+        }
+        if (!m_comp(*prev, value)) return {prev, false};
+        return {link(left, parent, value), true};
+    }
+
+    // Unlinks the object at `pos` and returns the position after it
+    iterator erase(const_iterator pos) noexcept {
+        iterator next(pos.node());
+        ++next;
+        intr::erase_and_rebalance(pos.node(), m_header);
+        --m_size;
+        return next;
+    }
+
+    void erase(reference value) noexcept {
+        erase(iterator_to(value));
+    }
+
+    void pop_front() {
+        if (empty()) throw std::out_of_range("Intrusive_red_black_tree is empty");
+        erase(begin());
+    }
+
+    // Unlinks every object, then hands each to `disposer`, e.g. to delete the ones it owns
+    template<typename Disposer>
+    void clear_and_dispose(Disposer disposer) {
+        Tree_links *root = m_header.parent;
+        intr::reset(m_header);
+        m_size = 0;
+        dispose_subtree(root, disposer);
+    }
+
+    void clear() noexcept {
+        clear_and_dispose([](reference) {});
+    }
+
+    void swap(Intrusive_red_black_tree &other) noexcept {
+        Intrusive_red_black_tree tmp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(tmp);
+    }
+
+    // Lookup
+    template<typename K>
+    iterator find(const K &key) {
+        iterator it = lower_bound(key);
+        return it != end() && !m_comp(key, *it) ? it : end();
+    }
+
+    template<typename K>
+    const_iterator find(const K &key) const {
+        const_iterator it = lower_bound(key);
+        return it != end() && !m_comp(key, *it) ? it : end();
+    }
+
+    template<typename K>
+    bool contains(const K &key) const {
+        return find(key) != end();
+    }
+
+    // First object not ordered before `key`
+    template<typename K>
+    iterator lower_bound(const K &key) {
+        return iterator(bound(key, [this](const T &value, const K &k) { return m_comp(value, k); }));
+    }
+
+    template<typename K>
+    const_iterator lower_bound(const K &key) const {
+        return const_iterator(bound(key, [this](const T &value, const K &k) { return m_comp(value, k); }));
+    }
+
+    // First object ordered after `key`
+    template<typename K>
+    iterator upper_bound(const K &key) {
+        return iterator(bound(key, [this](const T &value, const K &k) { return !m_comp(k, value); }));
+    }
+
+    template<typename K>
+    const_iterator upper_bound(const K &key) const {
+        return const_iterator(bound(key, [this](const T &value, const K &k) { return !m_comp(k, value); }));
+    }
+
+    // Position of an object known to be in this tree
+    iterator iterator_to(reference value) noexcept {
+        return iterator(links(value));
+    }
+
+    // Iterators
+    iterator begin() noexcept {
+        return iterator(m_header.left);
+    }
+
+    const_iterator begin() const noexcept {
+        return const_iterator(m_header.left);
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    iterator end() noexcept {
+        return iterator(&m_header);
+    }
+
+    const_iterator end() const noexcept {
+        return const_iterator(const_cast<Tree_links *>(&m_header));
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    reverse_iterator rbegin() noexcept {
+        return reverse_iterator(end());
+    }
+
+    reverse_iterator rend() noexcept {
+        return reverse_iterator(begin());
+    }
+
+    const_reverse_iterator rbegin() const noexcept {
+        return const_reverse_iterator(end());
+    }
+
+    const_reverse_iterator rend() const noexcept {
+        return const_reverse_iterator(begin());
+    }
+
+private:
+    Tree_links m_header;
+    size_type m_size = 0;
+    [[no_unique_address]] Compare m_comp;
+
+    static Tree_links *links(reference value) noexcept {
+        return static_cast<Hook *>(&value);
+    }
+
+    static reference to_value(Tree_links *node) noexcept {
+        return static_cast<reference>(*static_cast<Hook *>(node));
+    }
+
+    static const_reference to_value(const Tree_links *node) noexcept {
+        return to_value(const_cast<Tree_links *>(node));
+    }
+
+    iterator link(const bool left, Tree_links *parent, reference value) noexcept {
+        Tree_links *node = links(value);
+        intr::insert_and_rebalance(left, node, parent, m_header);
+        ++m_size;
+        return iterator(node);
+    }
+
+    // First node for which `before(value, key)` is false
+    template<typename K, typename Before>
+    Tree_links *bound(const K &key, Before before) const {
+        Tree_links *result = const_cast<Tree_links *>(&m_header);
+        for (Tree_links *node = m_header.parent; node;) {
+            if (before(to_value(node), key)) {
+                node = node->right;
+            } else {
+                result = node;
+                node = node->left;
+            }
+        }
+        return result;
+    }
+
+    template<typename Disposer>
+    static void dispose_subtree(Tree_links *node, Disposer &disposer) {
+        while (node) {
+            dispose_subtree(node->right, disposer);
+            Tree_links *left = node->left;
+            node->parent = node->left = node->right = nullptr;
+            disposer(to_value(node));
+            node = left;
+        }
+    }
+
+    // Re-homes other's nodes under this header; only the root points back at it
+    void take(Intrusive_red_black_tree &other) noexcept {
+        if (other.empty()) return;
+        m_header.parent = other.m_header.parent;
+        m_header.left = other.m_header.left;
+        m_header.right = other.m_header.right;
+        m_header.parent->parent = &m_header;
+        m_size = std::exchange(other.m_size, 0);
+        intr::reset(other.m_header);
+    }
+};
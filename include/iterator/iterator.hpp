@@ -1,5 +1,7 @@
 #pragma once
 
+#include <type_traits>
+
 #include "iterator_tags.hpp"
 #include "iterator_base.hpp"
 #include "../sequence/internal/node.hpp"
@@ -80,16 +82,17 @@ public:
     using iterator_category = forward_iterator_tag;
     using node_type = Node<std::remove_const_t<T>>;
 
-    explicit Forward_iterator(node_type* node = nullptr) : m_ptr(node) {}
+    // The before-begin position is a bare Node_base, so that is what the iterator holds
+    explicit Forward_iterator(Node_base* node = nullptr) : m_ptr(node) {}
 
     template<typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
     explicit Forward_iterator(const Forward_iterator<U>& other)
         : m_ptr(other.node()) {}
 
-    node_type* node() const { return m_ptr; }
+    Node_base* node() const { return m_ptr; }
 
-    reference operator*() const { return m_ptr->value; }
-    pointer operator->() const { return &(m_ptr->value); }
+    reference operator*() const { return static_cast<node_type*>(m_ptr)->value; }
+    pointer operator->() const { return &static_cast<node_type*>(m_ptr)->value; }
 
     Forward_iterator& operator++() {
         m_ptr = m_ptr->next;
@@ -106,7 +109,7 @@ public:
     bool operator!=(const Forward_iterator& other) const { return m_ptr != other.m_ptr; }
 
 private:
-    node_type* m_ptr;
+    Node_base* m_ptr;
 };
 
 // Bidirectional iterator
@@ -169,72 +172,76 @@ private:
 template<typename T>
 class Random_access_iterator : public Iterator<random_access_iterator_tag, T> {
 public:
-    explicit Random_access_iterator(T *p = nullptr) : m_ptr(p) {
+    constexpr explicit Random_access_iterator(T *p = nullptr) : m_ptr(p) {
     }
 
-    T &operator*() const {
+    constexpr T &operator*() const {
         return *m_ptr;
     }
 
-    Random_access_iterator &operator++() {
+    constexpr T *operator->() const {
+        return m_ptr;
+    }
+
+    constexpr Random_access_iterator &operator++() {
         ++m_ptr;
         return *this;
     }
 
-    Random_access_iterator operator++(int) {
+    constexpr Random_access_iterator operator++(int) {
         Random_access_iterator tmp = *this;
         ++(*this);
         return tmp;
     }
 
-    Random_access_iterator &operator--() {
+    constexpr Random_access_iterator &operator--() {
         --m_ptr;
         return *this;
     }
 
-    Random_access_iterator operator--(int) {
+    constexpr Random_access_iterator operator--(int) {
         Random_access_iterator tmp = *this;
         --(*this);
         return tmp;
     }
 
-    Random_access_iterator operator+(std::ptrdiff_t n) const {
+    constexpr Random_access_iterator operator+(std::ptrdiff_t n) const {
         return Random_access_iterator(m_ptr + n);
     }
 
-    Random_access_iterator operator-(std::ptrdiff_t n) const {
+    constexpr Random_access_iterator operator-(std::ptrdiff_t n) const {
         return Random_access_iterator(m_ptr - n);
     }
 
-    std::ptrdiff_t operator-(const Random_access_iterator &other) const {
+    constexpr std::ptrdiff_t operator-(const Random_access_iterator &other) const {
         return m_ptr - other.m_ptr;
     }
 
-    T &operator[](std::ptrdiff_t n) const {
+    constexpr T &operator[](std::ptrdiff_t n) const {
         return m_ptr[n];
     }
 
-    bool operator<(const Random_access_iterator &other) const {
+    constexpr bool operator<(const Random_access_iterator &other) const {
         return m_ptr < other.m_ptr;
     }
 
-    bool operator<=(const Random_access_iterator &other) const {
+    constexpr bool operator<=(const Random_access_iterator &other) const {
         return m_ptr <= other.m_ptr;
     }
 
-    bool operator>(const Random_access_iterator &other) const {
+    constexpr bool operator>(const Random_access_iterator &other) const {
         return m_ptr > other.m_ptr;
     }
 
-    bool operator>=(const Random_access_iterator &other) const {
+    constexpr bool operator>=(const Random_access_iterator &other) const {
         return m_ptr >= other.m_ptr;
     }
 
-    bool operator==(const Random_access_iterator &other) const {
+    constexpr bool operator==(const Random_access_iterator &other) const {
         return m_ptr == other.m_ptr;
     }
 
-    bool operator!=(const Random_access_iterator &other) const {
+    constexpr bool operator!=(const Random_access_iterator &other) const {
         return m_ptr != other.m_ptr;
     }
 
@@ -299,73 +306,73 @@ private:
 template <typename T>
 class Reverse_random_access_iterator {
 public:
-    explicit Reverse_random_access_iterator(T *p = nullptr) : m_ptr(p) {}
+    constexpr explicit Reverse_random_access_iterator(T *p = nullptr) : m_ptr(p) {}
 
-    T &operator*() const {
+    constexpr T &operator*() const {
         return *(m_ptr - 1);
     }
 
-    Reverse_random_access_iterator &operator++() {
+    constexpr Reverse_random_access_iterator &operator++() {
         --m_ptr;
         return *this;
     }
 
-    Reverse_random_access_iterator operator++(int) {
+    constexpr Reverse_random_access_iterator operator++(int) {
         Reverse_random_access_iterator tmp = *this;
-        --(*this);
+        ++(*this);
         return tmp;
     }
 
-    Reverse_random_access_iterator &operator--() {
+    constexpr Reverse_random_access_iterator &operator--() {
         ++m_ptr;
         return *this;
     }
 
-    Reverse_random_access_iterator operator--(int) {
+    constexpr Reverse_random_access_iterator operator--(int) {
         Reverse_random_access_iterator tmp = *this;
         --(*this);
         return tmp;
     }
 
-    Reverse_random_access_iterator operator+(std::ptrdiff_t n) const {
+    constexpr Reverse_random_access_iterator operator+(std::ptrdiff_t n) const {
         return Reverse_random_access_iterator(m_ptr - n);
     }
 
-    Reverse_random_access_iterator operator-(std::ptrdiff_t n) const {
+    constexpr Reverse_random_access_iterator operator-(std::ptrdiff_t n) const {
         return Reverse_random_access_iterator(m_ptr + n);
     }
 
-    std::ptrdiff_t operator-(const Reverse_random_access_iterator &other) const {
+    constexpr std::ptrdiff_t operator-(const Reverse_random_access_iterator &other) const {
         return other.m_ptr - m_ptr;
     }
 
-    T& operator[](std::ptrdiff_t n) const {
+    constexpr T& operator[](std::ptrdiff_t n) const {
         return *(*this + n);
     }
 
-    T* operator->() const { return m_ptr - 1; }
+    constexpr T* operator->() const { return m_ptr - 1; }
 
-    bool operator<(const Reverse_random_access_iterator &other) const {
+    constexpr bool operator<(const Reverse_random_access_iterator &other) const {
         return m_ptr > other.m_ptr;
     }
 
-    bool operator<=(const Reverse_random_access_iterator &other) const {
+    constexpr bool operator<=(const Reverse_random_access_iterator &other) const {
         return m_ptr >= other.m_ptr;
     }
 
-    bool operator>(const Reverse_random_access_iterator &other) const {
+    constexpr bool operator>(const Reverse_random_access_iterator &other) const {
         return m_ptr < other.m_ptr;
     }
 
-    bool operator>=(const Reverse_random_access_iterator &other) const {
+    constexpr bool operator>=(const Reverse_random_access_iterator &other) const {
         return m_ptr <= other.m_ptr;
     }
 
-    bool operator==(const Reverse_random_access_iterator &other) const {
+    constexpr bool operator==(const Reverse_random_access_iterator &other) const {
         return m_ptr == other.m_ptr;
     }
 
-    bool operator!=(const Reverse_random_access_iterator &other) const {
+    constexpr bool operator!=(const Reverse_random_access_iterator &other) const {
         return m_ptr != other.m_ptr;
     }
 
@@ -373,3 +380,66 @@ public:
 private:
     T* m_ptr;
 };
+
+// Walks any bidirectional iterator backwards. Like the pointer-based reverse iterators it holds
+// the position one past the element it refers to, so rbegin() wraps end().
+template<typename It>
+class Reverse_iterator {
+public:
+    using value_type = typename It::value_type;
+    using pointer = typename It::pointer;
+    using reference = typename It::reference;
+    using difference_type = typename It::difference_type;
+    using iterator_category = typename It::iterator_category;
+
+    explicit Reverse_iterator(It base = It()) : m_base(base) {}
+
+    template<typename U, typename = std::enable_if_t<std::is_convertible_v<U, It>>>
+    Reverse_iterator(const Reverse_iterator<U> &other) : m_base(other.base()) {}
+
+    It base() const { return m_base; }
+
+    reference operator*() const {
+        It tmp = m_base;
+        return *--tmp;
+    }
+
+    pointer operator->() const { return &**this; }
+    reference operator[](const difference_type n) const { return *(*this + n); }
+
+    Reverse_iterator &operator++() {
+        --m_base;
+        return *this;
+    }
+
+    Reverse_iterator operator++(int) {
+        Reverse_iterator tmp = *this;
+        --m_base;
+        return tmp;
+    }
+
+    Reverse_iterator &operator--() {
+        ++m_base;
+        return *this;
+    }
+
+    Reverse_iterator operator--(int) {
+        Reverse_iterator tmp = *this;
+        ++m_base;
+        return tmp;
+    }
+
+    Reverse_iterator operator+(const difference_type n) const { return Reverse_iterator(m_base - n); }
+    Reverse_iterator operator-(const difference_type n) const { return Reverse_iterator(m_base + n); }
+    difference_type operator-(const Reverse_iterator &other) const { return other.m_base - m_base; }
+
+    bool operator==(const Reverse_iterator &other) const { return m_base == other.m_base; }
+    bool operator!=(const Reverse_iterator &other) const { return m_base != other.m_base; }
+    bool operator<(const Reverse_iterator &other) const { return other.m_base < m_base; }
+    bool operator<=(const Reverse_iterator &other) const { return other.m_base <= m_base; }
+    bool operator>(const Reverse_iterator &other) const { return other.m_base > m_base; }
+    bool operator>=(const Reverse_iterator &other) const { return other.m_base >= m_base; }
+
+private:
+    It m_base;
+};
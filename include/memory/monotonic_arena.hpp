@@ -0,0 +1,150 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+// Bump-pointer memory resource for per-request allocation. Allocation is a pointer bump inside the
+// current chunk; when it runs out, a chunk twice the size of the previous one is chained in from
+// the upstream resource. Deallocation does nothing, except that freeing the most recent block
+// hands its bytes back, which lets a growing Vector reuse its old buffer. Everything is freed at
+// once by release(), or by reset(), which keeps the largest chunk so the next request starts warm.
+// Use it through the pmr:: container aliases; it is not thread-safe.
+class Monotonic_arena : public std::pmr::memory_resource {
+public:
+    static constexpr std::size_t DEFAULT_CHUNK_SIZE = 4096;
+
+    explicit Monotonic_arena(const std::size_t initial_chunk_size = DEFAULT_CHUNK_SIZE,
+                             std::pmr::memory_resource *upstream = std::pmr::get_default_resource())
+        : m_upstream(upstream), m_next_chunk_size(std::max(initial_chunk_size, MIN_CHUNK_SIZE)) {
+    }
+
+    // Serves the first requests from `buffer`, which the caller owns and must outlive the arena
+    Monotonic_arena(void *buffer, const std::size_t size,
+                    std::pmr::memory_resource *upstream = std::pmr::get_default_resource())
+        : m_upstream(upstream), m_next_chunk_size(std::max(size * 2, MIN_CHUNK_SIZE)),
+          m_buffer(static_cast<std::byte *>(buffer)), m_buffer_size(size) {
+        m_cursor = m_buffer;
+        m_end = m_buffer + size;
+    }
+
+    Monotonic_arena(const Monotonic_arena &) = delete;
+    Monotonic_arena &operator=(const Monotonic_arena &) = delete;
+
+    ~Monotonic_arena() override {
+        release();
+    }
+
+    // Gives every chunk back upstream; memory obtained from the arena must no longer be used
+    void release() noexcept {
+        free_chunks(nullptr);
+        m_cursor = m_buffer;
+        m_end = m_buffer + m_buffer_size;
+        m_bytes_used = 0;
+    }
+
+    // Like release, but keeps the newest (and largest) chunk for the next round of allocations
+    void reset() noexcept {
+        if (!m_chunks) {
+            release();
+            return;
+        }
+        free_chunks(m_chunks);
+        m_chunks->prev = nullptr;
+        m_cursor = m_chunks->data();
+        m_end = reinterpret_cast<std::byte *>(m_chunks) + m_chunks->size;
+        m_bytes_used = 0;
+    }
+
+    // Bytes handed out since the last release or reset
+    [[nodiscard]] std::size_t bytes_used() const noexcept {
+        return m_bytes_used;
+    }
+
+    // Bytes currently held from upstream, chunk headers included
+    [[nodiscard]] std::size_t bytes_reserved() const noexcept {
+        std::size_t total = 0;
+        for (const Chunk *chunk = m_chunks; chunk; chunk = chunk->prev) total += chunk->size;
+        return total;
+    }
+
+    [[nodiscard]] std::pmr::memory_resource *upstream() const noexcept {
+        return m_upstream;
+    }
+
+protected:
+    void *do_allocate(const std::size_t bytes, const std::size_t alignment) override {
+        std::byte *block = align(m_cursor, alignment);
+        if (!block || block > m_end || bytes > static_cast<std::size_t>(m_end - block)) {
+            add_chunk(bytes, alignment);
+            block = align(m_cursor, alignment);
+        }
+        m_cursor = block + bytes;
+        m_bytes_used += bytes;
+        return block;
+    }
+
+    void do_deallocate(void *p, const std::size_t bytes, std::size_t) override {
+        auto *block = static_cast<std::byte *>(p);
+        if (block + bytes == m_cursor) {
+            m_cursor = block;
+            m_bytes_used -= bytes;
+        }
+    }
+
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+        return this == &other;
+    }
+
+private:
+    // Header at the start of every upstream chunk; chunks are chained newest first
+    struct alignas(std::max_align_t) Chunk {
+        Chunk *prev;
+        std::size_t size;
+
+        std::byte *data() {
+            return reinterpret_cast<std::byte *>(this + 1);
+        }
+    };
+
+    static constexpr std::size_t MIN_CHUNK_SIZE = 256;
+
+    std::pmr::memory_resource *m_upstream;
+    std::size_t m_next_chunk_size;
+    std::byte *m_buffer = nullptr;
+    std::size_t m_buffer_size = 0;
+    std::byte *m_cursor = nullptr;
+    std::byte *m_end = nullptr;
+    Chunk *m_chunks = nullptr;
+    std::size_t m_bytes_used = 0;
+
+    static std::byte *align(std::byte *p, const std::size_t alignment) {
+        if (!p) return nullptr;
+        const auto address = reinterpret_cast<std::uintptr_t>(p);
+        return p + ((alignment - address % alignment) % alignment);
+    }
+
+    void add_chunk(const std::size_t bytes, const std::size_t alignment) {
+        const std::size_t needed = sizeof(Chunk) + bytes + alignment;
+        const std::size_t size = std::max(m_next_chunk_size, needed);
+        auto *chunk = static_cast<Chunk *>(m_upstream->allocate(size, alignof(Chunk)));
+        chunk->prev = m_chunks;
+        chunk->size = size;
+        m_chunks = chunk;
+        m_cursor = chunk->data();
+        m_end = reinterpret_cast<std::byte *>(chunk) + size;
+        m_next_chunk_size = size * 2;
+    }
+
+    // Frees the chunks older than `keep`, or all of them for nullptr
+    void free_chunks(Chunk *keep) noexcept {
+        Chunk *chunk = keep ? keep->prev : m_chunks;
+        while (chunk) {
+            Chunk *prev = chunk->prev;
+            m_upstream->deallocate(chunk, chunk->size, alignof(Chunk));
+            chunk = prev;
+        }
+        if (!keep) m_chunks = nullptr;
+    }
+};
@@ -0,0 +1,258 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <mutex>
+
+#include "associative/flat_set.hpp"
+#include "sequence/vector.hpp"
+
+// Size-class memory resource for node-based containers. Requests of up to MAX_BLOCK bytes are
+// rounded up to a multiple of GRANULE and served from per-class free lists. Each thread works
+// on its own cache of free blocks and only takes the class lock to move a batch of BATCH blocks
+// to or from the shared lists, so steady churn never contends. Slabs are carved from the
+// upstream resource and only given back when the allocator is destroyed. Larger or over-aligned
+// requests go straight upstream.
+// Use it through the pmr:: container aliases. Blocks may be freed on any thread; the allocator
+// must outlive every thread's use of it.
+class Slab_allocator : public std::pmr::memory_resource {
+public:
+    static constexpr std::size_t GRANULE = 16;
+    static constexpr std::size_t MAX_BLOCK = 256;
+    static constexpr std::size_t CLASSES = MAX_BLOCK / GRANULE;
+    static constexpr std::size_t BATCH = 32;
+    static constexpr std::size_t DEFAULT_SLAB_SIZE = 64 * 1024;
+
+    explicit Slab_allocator(std::pmr::memory_resource *upstream = std::pmr::get_default_resource(),
+                            const std::size_t slab_size = DEFAULT_SLAB_SIZE)
+        : m_upstream(upstream), m_slab_size(std::max(slab_size, MAX_BLOCK * BATCH)), m_id(next_id()) {
+        std::lock_guard lock(registry_mutex());
+        live_ids().insert(m_id);
+    }
+
+    Slab_allocator(const Slab_allocator &) = delete;
+    Slab_allocator &operator=(const Slab_allocator &) = delete;
+
+    ~Slab_allocator() override {
+        {
+            // Threads that exit from now on no longer touch this allocator's records
+            std::lock_guard lock(registry_mutex());
+            live_ids().remove(m_id);
+        }
+        Record *record = m_records.load(std::memory_order_acquire);
+        while (record) {
+            Record *next = record->next;
+            delete record;
+            record = next;
+        }
+        for (void *slab : m_slabs) m_upstream->deallocate(slab, m_slab_size, alignof(std::max_align_t));
+    }
+
+    [[nodiscard]] std::size_t slab_count() const {
+        std::lock_guard lock(m_slab_mutex);
+        return m_slabs.size();
+    }
+
+    [[nodiscard]] std::pmr::memory_resource *upstream() const noexcept {
+        return m_upstream;
+    }
+
+protected:
+    void *do_allocate(const std::size_t bytes, const std::size_t alignment) override {
+        if (bytes > MAX_BLOCK || alignment > GRANULE) return m_upstream->allocate(bytes, alignment);
+
+        const std::size_t index = size_class(bytes);
+        Cache &cache = local().cache[index];
+        if (!cache.head) refill(index, cache);
+
+        Block *block = cache.head;
+        cache.head = block->next;
+        --cache.count;
+        return block;
+    }
+
+    void do_deallocate(void *p, const std::size_t bytes, const std::size_t alignment) override {
+        if (bytes > MAX_BLOCK || alignment > GRANULE) {
+            m_upstream->deallocate(p, bytes, alignment);
+            return;
+        }
+
+        const std::size_t index = size_class(bytes);
+        Cache &cache = local().cache[index];
+        auto *block = static_cast<Block *>(p);
+        block->next = cache.head;
+        cache.head = block;
+        if (++cache.count >= 2 * BATCH) drain(index, cache);
+    }
+
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+        return this == &other;
+    }
+
+private:
+    struct Block {
+        Block *next;
+    };
+
+    struct Cache {
+        Block *head = nullptr;
+        std::size_t count = 0;
+    };
+
+    struct alignas(64) Central {
+        std::mutex mutex;
+        Block *head = nullptr;
+    };
+
+    // One per thread that used the allocator; recycled, cached blocks included, when threads exit
+    struct Record {
+        std::atomic<bool> in_use{true};
+        Record *next = nullptr;
+        std::array<Cache, CLASSES> cache{};
+    };
+
+    // The calling thread's records, keyed by allocator id since allocators come and go
+    struct Binding {
+        std::uint64_t id;
+        Record *record;
+    };
+
+    struct Thread_bindings {
+        Vector<Binding> bindings;
+
+        ~Thread_bindings() {
+            std::lock_guard lock(registry_mutex());
+            for (const auto &binding : bindings) {
+                if (live_ids().contains(binding.id)) binding.record->in_use.store(false, std::memory_order_release);
+            }
+        }
+    };
+
+    std::pmr::memory_resource *m_upstream;
+    std::size_t m_slab_size;
+    std::uint64_t m_id;
+    std::array<Central, CLASSES> m_central;
+    std::atomic<Record *> m_records{nullptr};
+    mutable std::mutex m_slab_mutex;
+    Vector<void *> m_slabs;
+
+    static constexpr std::size_t size_class(const std::size_t bytes) {
+        return bytes ? (bytes - 1) / GRANULE : 0;
+    }
+
+    static std::uint64_t next_id() {
+        static std::atomic<std::uint64_t> counter{0};
+        return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    static std::mutex &registry_mutex() {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    static Flat_set<std::uint64_t> &live_ids() {
+        static Flat_set<std::uint64_t> ids;
+        return ids;
+    }
+
+    static Thread_bindings &thread_bindings() {
+        static thread_local Thread_bindings bindings;
+        return bindings;
+    }
+
+    Record &local() {
+        Vector<Binding> &bindings = thread_bindings().bindings;
+        for (const auto &binding : bindings) {
+            if (binding.id == m_id) return *binding.record;
+        }
+        forget_dead(bindings);
+        Record *record = acquire_record();
+        bindings.push_back(Binding{m_id, record});
+        return *record;
+    }
+
+    // Drops bindings to destroyed allocators so short-lived allocators do not pile up
+    static void forget_dead(Vector<Binding> &bindings) {
+        std::lock_guard lock(registry_mutex());
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < bindings.size(); ++i) {
+            if (live_ids().contains(bindings[i].id)) bindings[kept++] = bindings[i];
+        }
+        bindings.resize(kept);
+    }
+
+    Record *acquire_record() {
+        for (Record *record = m_records.load(std::memory_order_acquire); record; record = record->next) {
+            bool expected = false;
+            if (!record->in_use.load(std::memory_order_relaxed) &&
+                record->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                return record;
+            }
+        }
+
+        auto *record = new Record;
+        Record *head = m_records.load(std::memory_order_relaxed);
+        do {
+            record->next = head;
+        } while (!m_records.compare_exchange_weak(head, record, std::memory_order_release,
+                                                  std::memory_order_relaxed));
+        return record;
+    }
+
+    // Moves up to BATCH blocks from the shared list into the cache, carving a new slab if needed
+    void refill(const std::size_t index, Cache &cache) {
+        Central &central = m_central[index];
+        std::lock_guard lock(central.mutex);
+        if (!central.head) central.head = carve(index);
+
+        while (central.head && cache.count < BATCH) {
+            Block *block = central.head;
+            central.head = block->next;
+            block->next = cache.head;
+            cache.head = block;
+            ++cache.count;
+        }
+    }
+
+    // Hands BATCH blocks back so a thread that only frees does not hoard memory
+    void drain(const std::size_t index, Cache &cache) {
+        Block *first = cache.head;
+        Block *last = first;
+        for (std::size_t i = 1; i < BATCH; ++i) last = last->next;
+        cache.head = last->next;
+        cache.count -= BATCH;
+
+        Central &central = m_central[index];
+        std::lock_guard lock(central.mutex);
+        last->next = central.head;
+        central.head = first;
+    }
+
+    // Splits a fresh slab into blocks of class `index` and returns them as a list
+    Block *carve(const std::size_t index) {
+        const std::size_t block_size = (index + 1) * GRANULE;
+        auto *slab = static_cast<std::byte *>(m_upstream->allocate(m_slab_size, alignof(std::max_align_t)));
+        {
+            std::lock_guard lock(m_slab_mutex);
+            try {
+                m_slabs.push_back(slab);
+            } catch (...) {
+                m_upstream->deallocate(slab, m_slab_size, alignof(std::max_align_t));
+                throw;
+            }
+        }
+
+        const std::size_t count = m_slab_size / block_size;
+        Block *head = nullptr;
+        for (std::size_t i = count; i-- > 0;) {
+            auto *block = reinterpret_cast<Block *>(slab + i * block_size);
+            block->next = head;
+            head = block;
+        }
+        return head;
+    }
+};
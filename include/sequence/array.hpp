@@ -1,7 +1,11 @@
 #pragma once
 
-#include <iostream>
-#include <random>
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <initializer_list>
+#include <stdexcept>
+#include <utility>
 
 #include "iterator/iterator.hpp"
 
@@ -34,7 +38,7 @@ public:
         }
     }
 
-    Array(std::initializer_list<T> init) {
+    constexpr Array(std::initializer_list<T> init) {
         if (N != init.size()) {
             throw std::invalid_argument("Initializer list size does not match array size");
         }
@@ -43,86 +47,70 @@ public:
         }
     }
 
-    explicit Array(T min, T max) {
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        if constexpr (std::is_integral_v<T>) {
-            std::uniform_int_distribution<T> dist(min, max);
-            for (size_type i = 0; i < N; ++i) {
-                m_data[i] = dist(gen);
-            }
-        } else if constexpr(std::is_floating_point_v<T>) {
-            std::uniform_real_distribution<T> dist(min, max);
-            for (size_type i = 0; i < N; ++i) {
-                m_data[i] = dist(gen);
-            }
-        } else {
-            throw std::invalid_argument("Invalid array type");
-        }
+    // Deprecated: the fill lives in sequence/random.hpp so that this header doesn't pull in
+    // <random>, and this constructor only compiles where that header is included too
+    [[deprecated("use random_array from sequence/random.hpp, which this constructor needs included")]] explicit Array(T min, T max) {
+        fill_uniform(*this, min, max);
     }
 
     // Assignment operator
-    Array& operator=(const Array& other) {
-        if (this != &other) {
-            for (size_type i = 0; i < N; ++i) {
-                m_data[i] = other.m_data[i];
-            }
+    constexpr Array& operator=(const Array& other) {
+        for (size_type i = 0; i < N; ++i) {
+            m_data[i] = other.m_data[i];
         }
         return *this;
     }
 
-    Array& operator=(Array&& other) noexcept {
-        if (this != &other) {
-            for (size_type i = 0; i < N; ++i) {
-                m_data[i] = std::move(other.m_data[i]);
-            }
+    constexpr Array& operator=(Array&& other) noexcept {
+        for (size_type i = 0; i < N; ++i) {
+            m_data[i] = std::move(other.m_data[i]);
         }
         return *this;
     }
 
     // Destructor
-    ~Array() = default;
+    constexpr ~Array() = default;
 
     // Element access
-    reference operator[](size_type index) {
+    constexpr reference operator[](size_type index) {
         return m_data[index];
     }
 
-    const_reference operator[](size_type index) const {
+    constexpr const_reference operator[](size_type index) const {
         return m_data[index];
     }
 
-    reference at(size_type index) {
+    constexpr reference at(size_type index) {
         if (index >= N) throw std::out_of_range("Array index out of range");
         return m_data[index];
     }
 
-    const_reference at(size_type index) const {
+    constexpr const_reference at(size_type index) const {
         if (index >= N) throw std::out_of_range("Array index out of range");
         return m_data[index];
     }
 
-    reference front() {
+    constexpr reference front() {
         return m_data[0];
     }
 
-    const_reference front() const {
+    constexpr const_reference front() const {
         return m_data[0];
     }
 
-    reference back() {
+    constexpr reference back() {
         return m_data[N - 1];
     }
 
-    const_reference back() const {
+    constexpr const_reference back() const {
         return m_data[N - 1];
     }
 
-    pointer data() noexcept {
+    constexpr pointer data() noexcept {
         return m_data;
     }
 
-    const_pointer data() const noexcept {
+    constexpr const_pointer data() const noexcept {
         return m_data;
     }
 
@@ -140,78 +128,78 @@ public:
     }
 
     // Operations
-    void fill(const_reference value) {
+    constexpr void fill(const_reference value) {
         for (size_type i = 0; i < N; ++i) {
             m_data[i] = value;
         }
     }
 
-    void swap(Array& other) noexcept {
+    constexpr void swap(Array& other) noexcept {
         for (size_type i = 0; i < N; ++i) {
             std::swap(m_data[i], other.m_data[i]);
         }
     }
 
     // Iterators
-    iterator begin() noexcept {
+    constexpr iterator begin() noexcept {
         return iterator(m_data);
     }
 
-    const_iterator begin() const noexcept {
+    constexpr const_iterator begin() const noexcept {
         return const_iterator(m_data);
     }
 
-    const_iterator cbegin() const noexcept {
+    constexpr const_iterator cbegin() const noexcept {
         return const_iterator(m_data);
     }
 
-    iterator end() noexcept {
+    constexpr iterator end() noexcept {
         return iterator(m_data + N);
     }
 
-    const_iterator end() const noexcept {
+    constexpr const_iterator end() const noexcept {
         return const_iterator(m_data + N);
     }
 
-    const_iterator cend() const noexcept {
+    constexpr const_iterator cend() const noexcept {
         return const_iterator(m_data + N);
     }
 
-    reverse_iterator rbegin() noexcept {
+    constexpr reverse_iterator rbegin() noexcept {
         return reverse_iterator(m_data + N);
     }
 
-    const_reverse_iterator rbegin() const noexcept {
+    constexpr const_reverse_iterator rbegin() const noexcept {
         return const_reverse_iterator(m_data + N);
     }
 
-    const_reverse_iterator crbegin() const noexcept {
+    constexpr const_reverse_iterator crbegin() const noexcept {
         return const_reverse_iterator(m_data + N);
     }
 
-    reverse_iterator rend() noexcept {
+    constexpr reverse_iterator rend() noexcept {
         return reverse_iterator(m_data);
     }
 
-    const_reverse_iterator rend() const noexcept {
+    constexpr const_reverse_iterator rend() const noexcept {
         return const_reverse_iterator(m_data);
     }
 
-    const_reverse_iterator crend() const noexcept {
+    constexpr const_reverse_iterator crend() const noexcept {
         return const_reverse_iterator(m_data);
     }
 
     // Relational operators
-    auto operator<=>(const Array &other) const {
+    constexpr auto operator<=>(const Array &other) const {
         return std::lexicographical_compare_three_way(m_data, m_data + N,
                                                       other.m_data, other.m_data + N);
     }
 
-    bool operator==(const Array& other) const {
+    constexpr bool operator==(const Array& other) const {
         return (*this <=> other) == 0;
     }
 
-    bool operator!=(const Array& other) const {
+    constexpr bool operator!=(const Array& other) const {
         return !(*this == other);
     }
 
@@ -220,6 +208,6 @@ private:
 };
 
 template <typename T, std::size_t N>
-void swap(Array<T, N>& lhs, Array<T, N>& rhs) noexcept {
+constexpr void swap(Array<T, N>& lhs, Array<T, N>& rhs) noexcept {
     lhs.swap(rhs);
 }
\ No newline at end of file
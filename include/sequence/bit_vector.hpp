@@ -0,0 +1,326 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <memory_resource>
+#include <stdexcept>
+#include <utility>
+
+#include "internal/bit_ops.hpp"
+#include "internal/set_bit_iterator.hpp"
+#include "vector.hpp"
+
+// Dynamic sequence of bits packed 64 to a word, one bit per flag instead of Vector<bool>'s
+// byte. Whole-vector operations (count, find_first/find_next, &, |, ^, ~, equality) run a
+// word at a time; the bits past size() in the last word are always zero, so none of them has
+// to mask the tail. Rank_select answers rank and select queries over a finished vector.
+template<typename Allocator = std::allocator<std::uint64_t>>
+class Bit_vector {
+public:
+    using word_type = std::uint64_t;
+    using value_type = bool;
+    using allocator_type = Allocator;
+    using size_type = std::size_t;
+    using const_reference = bool;
+
+    static constexpr size_type WORD_BITS = 64;
+    static constexpr size_type npos = static_cast<size_type>(-1);
+
+    // Proxy for one bit of a non-const vector
+    class reference {
+    public:
+        reference(word_type &word, const size_type bit) noexcept : m_word(&word), m_mask(word_type{1} << bit) {}
+
+        operator bool() const noexcept {
+            return (*m_word & m_mask) != 0;
+        }
+
+        reference &operator=(const bool value) noexcept {
+            if (value) *m_word |= m_mask;
+            else *m_word &= ~m_mask;
+            return *this;
+        }
+
+        reference &operator=(const reference &other) noexcept {
+            return *this = static_cast<bool>(other);
+        }
+
+        void flip() noexcept {
+            *m_word ^= m_mask;
+        }
+
+    private:
+        word_type *m_word;
+        word_type m_mask;
+    };
+
+    // Constructors
+    Bit_vector() noexcept(noexcept(allocator_type())) : Bit_vector(allocator_type()) {}
+
+    explicit Bit_vector(const allocator_type &alloc) noexcept : m_words(alloc), m_size(0) {}
+
+    explicit Bit_vector(const size_type count, const bool value = false, const allocator_type &alloc = allocator_type())
+        : m_words(words_for(count), value ? ~word_type{0} : word_type{0}, alloc), m_size(count) {
+        clear_tail();
+    }
+
+    Bit_vector(std::initializer_list<bool> init, const allocator_type &alloc = allocator_type())
+        : Bit_vector(init.size(), false, alloc) {
+        size_type pos = 0;
+        for (const bool bit : init) set(pos++, bit);
+    }
+
+    Bit_vector(const Bit_vector &other) = default;
+
+    Bit_vector(const Bit_vector &other, const allocator_type &alloc) : m_words(other.m_words, alloc), m_size(other.m_size) {}
+
+    Bit_vector(Bit_vector &&other) noexcept : m_words(std::move(other.m_words)), m_size(std::exchange(other.m_size, 0)) {}
+
+    Bit_vector(Bit_vector &&other, const allocator_type &alloc)
+        : m_words(std::move(other.m_words), alloc), m_size(std::exchange(other.m_size, 0)) {}
+
+    // Assignment operator
+    Bit_vector &operator=(const Bit_vector &other) = default;
+
+    Bit_vector &operator=(Bit_vector &&other) noexcept(mem::nothrow_move_assign<Allocator>) {
+        if (this != &other) {
+            m_words = std::move(other.m_words);
+            m_size = std::exchange(other.m_size, 0);
+        }
+        return *this;
+    }
+
+    [[nodiscard]] allocator_type get_allocator() const noexcept {
+        return m_words.get_allocator();
+    }
+
+    // Element access
+    reference operator[](const size_type pos) {
+        return reference(m_words[pos / WORD_BITS], pos % WORD_BITS);
+    }
+
+    const_reference operator[](const size_type pos) const {
+        return (m_words[pos / WORD_BITS] >> (pos % WORD_BITS)) & 1;
+    }
+
+    [[nodiscard]] bool test(const size_type pos) const {
+        if (pos >= m_size) throw std::out_of_range("Index out of range");
+        return (*this)[pos];
+    }
+
+    // The packed words, lowest bits first; bits past size() are zero
+    [[nodiscard]] const word_type *data() const noexcept {
+        return m_words.data();
+    }
+
+    [[nodiscard]] size_type word_count() const noexcept {
+        return m_words.size();
+    }
+
+    // Capacity
+    [[nodiscard]] size_type size() const noexcept {
+        return m_size;
+    }
+
+    [[nodiscard]] bool empty() const noexcept {
+        return m_size == 0;
+    }
+
+    [[nodiscard]] size_type capacity() const noexcept {
+        return m_words.capacity() * WORD_BITS;
+    }
+
+    void reserve(const size_type bits) {
+        m_words.reserve(words_for(bits));
+    }
+
+    // Modifiers
+    void push_back(const bool value) {
+        if (m_size % WORD_BITS == 0) m_words.push_back(word_type{0});
+        if (value) m_words[m_size / WORD_BITS] |= word_type{1} << (m_size % WORD_BITS);
+        ++m_size;
+    }
+
+    void pop_back() {
+        if (m_size == 0) throw std::runtime_error("Bit_vector is empty");
+        resize(m_size - 1);
+    }
+
+    void resize(const size_type count, const bool value = false) {
+        if (count > m_size && value && m_size % WORD_BITS) {
+            m_words[m_size / WORD_BITS] |= ~bits::below(m_size % WORD_BITS);
+        }
+        m_words.resize(words_for(count), value ? ~word_type{0} : word_type{0});
+        m_size = count;
+        clear_tail();
+    }
+
+    void clear() noexcept {
+        m_words.clear();
+        m_size = 0;
+    }
+
+    void swap(Bit_vector &other) noexcept {
+        m_words.swap(other.m_words);
+        std::swap(m_size, other.m_size);
+    }
+
+    Bit_vector &set(const size_type pos, const bool value = true) {
+        (*this)[pos] = value;
+        return *this;
+    }
+
+    Bit_vector &reset(const size_type pos) {
+        return set(pos, false);
+    }
+
+    Bit_vector &flip(const size_type pos) {
+        m_words[pos / WORD_BITS] ^= word_type{1} << (pos % WORD_BITS);
+        return *this;
+    }
+
+    // Sets every bit
+    Bit_vector &set() noexcept {
+        for (auto &word : m_words) word = ~word_type{0};
+        clear_tail();
+        return *this;
+    }
+
+    Bit_vector &reset() noexcept {
+        for (auto &word : m_words) word = 0;
+        return *this;
+    }
+
+    Bit_vector &flip() noexcept {
+        for (auto &word : m_words) word = ~word;
+        clear_tail();
+        return *this;
+    }
+
+    // Bulk operations; both operands must have the same size
+    Bit_vector &operator&=(const Bit_vector &other) {
+        check_size(other);
+        for (size_type i = 0; i < m_words.size(); ++i) m_words[i] &= other.m_words[i];
+        return *this;
+    }
+
+    Bit_vector &operator|=(const Bit_vector &other) {
+        check_size(other);
+        for (size_type i = 0; i < m_words.size(); ++i) m_words[i] |= other.m_words[i];
+        return *this;
+    }
+
+    Bit_vector &operator^=(const Bit_vector &other) {
+        check_size(other);
+        for (size_type i = 0; i < m_words.size(); ++i) m_words[i] ^= other.m_words[i];
+        return *this;
+    }
+
+    Bit_vector operator~() const {
+        Bit_vector result(*this);
+        result.flip();
+        return result;
+    }
+
+    // Queries
+    [[nodiscard]] size_type count() const noexcept {
+        return bits::popcount(m_words.data(), m_words.size());
+    }
+
+    [[nodiscard]] bool any() const noexcept {
+        for (const auto word : m_words) {
+            if (word) return true;
+        }
+        return false;
+    }
+
+    [[nodiscard]] bool none() const noexcept {
+        return !any();
+    }
+
+    [[nodiscard]] bool all() const noexcept {
+        return count() == m_size;
+    }
+
+    // Position of the first set bit, or npos
+    [[nodiscard]] size_type find_first() const noexcept {
+        return find_from(0, m_words.empty() ? 0 : m_words[0]);
+    }
+
+    // Position of the first set bit after `pos`, or npos
+    [[nodiscard]] size_type find_next(const size_type pos) const noexcept {
+        const size_type next = pos + 1;
+        if (next >= m_size) return npos;
+        const size_type index = next / WORD_BITS;
+        return find_from(index, m_words[index] & ~bits::below(next % WORD_BITS));
+    }
+
+    // The positions of the set bits in ascending order
+    [[nodiscard]] Set_bit_range set_bits() const noexcept {
+        return Set_bit_range(m_words.data(), m_words.size());
+    }
+
+    // Relational operators
+    bool operator==(const Bit_vector &other) const {
+        return m_size == other.m_size && m_words == other.m_words;
+    }
+
+    bool operator!=(const Bit_vector &other) const {
+        return !(*this == other);
+    }
+
+private:
+    Vector<word_type, Allocator> m_words;
+    size_type m_size;
+
+    static constexpr size_type words_for(const size_type bits) noexcept {
+        return (bits + WORD_BITS - 1) / WORD_BITS;
+    }
+
+    void clear_tail() noexcept {
+        if (m_size % WORD_BITS) m_words[m_words.size() - 1] &= bits::below(m_size % WORD_BITS);
+    }
+
+    void check_size(const Bit_vector &other) const {
+        if (m_size != other.m_size) throw std::invalid_argument("Bit_vector sizes differ");
+    }
+
+    // First set bit of `word` (the word at `index`, already masked) or of any later word
+    size_type find_from(size_type index, word_type word) const noexcept {
+        while (!word) {
+            if (++index >= m_words.size()) return npos;
+            word = m_words[index];
+        }
+        return index * WORD_BITS + std::countr_zero(word);
+    }
+};
+
+template<typename Allocator>
+Bit_vector<Allocator> operator&(Bit_vector<Allocator> lhs, const Bit_vector<Allocator> &rhs) {
+    lhs &= rhs;
+    return lhs;
+}
+
+template<typename Allocator>
+Bit_vector<Allocator> operator|(Bit_vector<Allocator> lhs, const Bit_vector<Allocator> &rhs) {
+    lhs |= rhs;
+    return lhs;
+}
+
+template<typename Allocator>
+Bit_vector<Allocator> operator^(Bit_vector<Allocator> lhs, const Bit_vector<Allocator> &rhs) {
+    lhs ^= rhs;
+    return lhs;
+}
+
+template<typename Allocator>
+void swap(Bit_vector<Allocator> &lhs, Bit_vector<Allocator> &rhs) noexcept {
+    lhs.swap(rhs);
+}
+
+namespace pmr {
+    using Bit_vector = ::Bit_vector<std::pmr::polymorphic_allocator<std::uint64_t>>;
+}
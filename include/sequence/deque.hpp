@@ -6,44 +6,60 @@
 #include <stdexcept>
 
 #include "../iterator/iterator_utils.hpp"
+#include "internal/deque_iterator.hpp"
+#include "utils/allocator.hpp"
+#include "utils/stats.hpp"
 
+// Elements per block: about 512 bytes' worth, but at least two slots, so that the empty state
+// (back one slot before front) stays inside a block
 template<typename T>
+inline constexpr std::size_t Deque_block_size = std::max(std::size_t{2}, std::size_t{512} / sizeof(T));
+
+template<typename T, typename Allocator = std::allocator<T>, typename Stats = No_stats>
 class Deque {
+    using alloc_traits = std::allocator_traits<Allocator>;
+
 public:
     using value_type = T;
+    using allocator_type = Allocator;
     using pointer = T *;
     using const_pointer = const T *;
     using reference = T &;
     using const_reference = const T &;
     using size_type = std::size_t;
-    using iterator = Random_access_iterator<T>;
-    using const_iterator = Random_access_iterator<const T>;
-    using reverse_iterator = Reverse_random_access_iterator<T>;
-    using const_reverse_iterator = Reverse_random_access_iterator<const T>;
+    using iterator = Deque_iterator<T, Deque_block_size<T>>;
+    using const_iterator = Deque_iterator<const T, Deque_block_size<T>>;
+    using reverse_iterator = Reverse_iterator<iterator>;
+    using const_reverse_iterator = Reverse_iterator<const_iterator>;
 
     // Constructors
-    Deque() : m_map_capacity(4), m_num_blocks(0), m_size(0) {
-        m_map = new pointer[m_map_capacity]();
+    // The map and the first block are allocated on the first insertion
+    Deque() noexcept(noexcept(allocator_type())) : Deque(allocator_type()) {
+    }
 
-        m_front_block = m_back_block = m_map_capacity / 2;
-        m_map[m_front_block] = new value_type[BLOCK_SIZE];
-        ++m_num_blocks;
+    explicit Deque(const allocator_type &alloc) noexcept
+        : m_map(nullptr), m_map_capacity(0), m_num_blocks(0), m_front_block(0), m_back_block(0),
+          m_front_index(0), m_back_index(0), m_size(0), m_alloc(alloc) {
+    }
 
-        m_front_index = BLOCK_SIZE / 2;
-        m_back_index = m_front_index - 1;
+    Deque(const Deque &other) : Deque(other, alloc_traits::select_on_container_copy_construction(other.m_alloc)) {
     }
 
-    Deque(const Deque &other) : m_map_capacity(other.m_map_capacity), m_num_blocks(other.m_num_blocks),
-                                m_front_block(other.m_front_block), m_back_block(other.m_back_block),
-                                m_front_index(other.m_front_index),
-                                m_back_index(other.m_back_index), m_size(other.m_size) {
-        m_map = new pointer[m_map_capacity];
+    Deque(const Deque &other, const allocator_type &alloc) : Deque(alloc) {
+        if (!other.m_map) return;
+
+        m_map_capacity = other.m_map_capacity;
+        m_num_blocks = other.m_num_blocks;
+        m_front_block = other.m_front_block;
+        m_back_block = other.m_back_block;
+        m_front_index = other.m_front_index;
+        m_back_index = other.m_back_index;
+        m_size = other.m_size;
+        m_map = create_map(m_map_capacity);
         for (size_type i = 0; i < m_map_capacity; ++i) {
             if (other.m_map[i]) {
-                m_map[i] = new value_type[BLOCK_SIZE];
+                m_map[i] = create_block();
                 std::copy(other.m_map[i], other.m_map[i] + BLOCK_SIZE, m_map[i]);
-            } else {
-                m_map[i] = nullptr;
             }
         }
     }
@@ -51,7 +67,7 @@ public:
     Deque(Deque &&other) noexcept
         : m_map(other.m_map), m_map_capacity(other.m_map_capacity), m_num_blocks(other.m_num_blocks),
           m_front_block(other.m_front_block), m_back_block(other.m_back_block), m_front_index(other.m_front_index),
-          m_back_index(other.m_back_index), m_size(other.m_size) {
+          m_back_index(other.m_back_index), m_size(other.m_size), m_alloc(std::move(other.m_alloc)) {
         other.m_map = nullptr;
         other.m_map_capacity = 0;
         other.m_num_blocks = 0;
@@ -62,26 +78,36 @@ public:
         other.m_size = 0;
     }
 
-    Deque(std::initializer_list<value_type> i_list) : Deque() {
+    // Blocks from an unequal allocator cannot be adopted, so the elements are moved one by one
+    Deque(Deque &&other, const allocator_type &alloc) : Deque(alloc) {
+        if (mem::equal(m_alloc, other.m_alloc)) {
+            swap_storage(other);
+        } else {
+            move_from(other);
+        }
+    }
+
+    Deque(std::initializer_list<value_type> i_list, const allocator_type &alloc = allocator_type()) : Deque(alloc) {
         for (const auto &value: i_list) {
             push_back(value);
         }
     }
 
-    explicit Deque(const size_type count) : Deque() {
+    explicit Deque(const size_type count, const allocator_type &alloc = allocator_type()) : Deque(alloc) {
         for (size_type i = 0; i < count; ++i) {
             push_back(value_type());
         }
     }
 
-    Deque(const size_type count, const_reference value) : Deque() {
+    Deque(const size_type count, const_reference value, const allocator_type &alloc = allocator_type())
+        : Deque(alloc) {
         for (size_type i = 0; i < count; ++i) {
             push_back(value);
         }
     }
 
     template<typename InputIt, typename = std::enable_if_t<it::is_iterator<InputIt>::value> >
-    Deque(InputIt first, InputIt last) : Deque() {
+    Deque(InputIt first, InputIt last, const allocator_type &alloc = allocator_type()) : Deque(alloc) {
         for (auto it = first; it != last; ++it) {
             push_back(*it);
         }
@@ -90,29 +116,42 @@ public:
     // Assignment operator
     Deque &operator=(const Deque &other) {
         if (this != &other) {
-            Deque temp(other);
-            this->swap(temp);
+            if constexpr (alloc_traits::propagate_on_container_copy_assignment::value) {
+                if (!mem::equal(m_alloc, other.m_alloc)) cleanup();
+            }
+            mem::copy_assign(m_alloc, other.m_alloc);
+            Deque temp(other, m_alloc);
+            swap_storage(temp);
         }
         return *this;
     }
 
-    Deque &operator=(Deque &&other) noexcept {
+    Deque &operator=(Deque &&other) noexcept(mem::nothrow_move_assign<Allocator>) {
         if (this != &other) {
-            this->swap(other);
+            cleanup();
+            if (mem::can_steal(m_alloc, other.m_alloc)) {
+                mem::move_assign(m_alloc, other.m_alloc);
+                swap_storage(other);
+            } else {
+                move_from(other);
+            }
         }
         return *this;
     }
 
     Deque &operator=(std::initializer_list<value_type> i_list) {
-        Deque temp(i_list);
-        this->swap(temp);
+        Deque temp(i_list, m_alloc);
+        swap_storage(temp);
         return *this;
     }
 
     // Destructor
     ~Deque() {
         cleanup();
-        delete[] m_map;
+    }
+
+    [[nodiscard]] allocator_type get_allocator() const noexcept {
+        return m_alloc;
     }
 
     // Element access
@@ -178,21 +217,35 @@ public:
         const size_type used_blocks = m_back_block - m_front_block + 1;
         const size_type new_capacity = std::max(static_cast<size_type>(4), used_blocks);
 
-        value_type **new_map = new pointer[new_capacity]();
+        value_type **new_map = create_map(new_capacity);
         for (size_type i = 0; i < used_blocks; ++i) {
             new_map[i] = m_map[m_front_block + i];
         }
 
-        delete[] m_map;
+        destroy_map(m_map, m_map_capacity);
         m_map = new_map;
         m_map_capacity = new_capacity;
         m_front_block = 0;
         m_back_block = used_blocks - 1;
     }
 
+    // Statistics; walks the block map
+    [[nodiscard]] Sequence_stats stats() const requires Stats::enabled {
+        Sequence_stats out;
+        size_type blocks = 0;
+        for (size_type i = 0; i < m_map_capacity; ++i) blocks += m_map[i] != nullptr;
+        out.size = m_size;
+        out.capacity = blocks * BLOCK_SIZE;
+        out.reallocations = m_stats.get(Stat::reallocation);
+        out.block_allocations = m_stats.get(Stat::block_allocation);
+        out.bytes_allocated = blocks * BLOCK_SIZE * sizeof(value_type) + m_map_capacity * sizeof(pointer);
+        return out;
+    }
+
     // Modifiers
     template<typename U>
     void push_front(U &&value) {
+        if (!m_map) initialize_map();
         if (m_front_index == 0) {
             allocate_block_front();
             m_front_index = BLOCK_SIZE - 1;
@@ -203,6 +256,7 @@ public:
 
     template<typename U>
     void push_back(U &&value) {
+        if (!m_map) initialize_map();
         if (m_back_index == BLOCK_SIZE - 1) {
             allocate_block_back();
             m_back_index = 0;
@@ -213,28 +267,32 @@ public:
 
     void pop_front() {
         if (empty()) throw std::out_of_range("Deque is empty");
+        if (--m_size == 0) {
+            reset_indices();
+            return;
+        }
         if (m_front_index == BLOCK_SIZE - 1) {
-            delete[] m_map[m_front_block];
+            destroy_block(m_map[m_front_block]);
             m_map[m_front_block] = nullptr;
             ++m_front_block;
             --m_num_blocks;
             m_front_index = 0;
         } else { ++m_front_index; }
-        if (m_num_blocks == 0) reset_indices();
-        --m_size;
     }
 
     void pop_back() {
         if (empty()) throw std::out_of_range("Deque is empty");
+        if (--m_size == 0) {
+            reset_indices();
+            return;
+        }
         if (m_back_index == 0) {
-            delete[] m_map[m_back_block];
+            destroy_block(m_map[m_back_block]);
             m_map[m_back_block] = nullptr;
             --m_back_block;
             --m_num_blocks;
             m_back_index = BLOCK_SIZE - 1;
         } else { --m_back_index; }
-        if (m_num_blocks == 0) reset_indices();
-        --m_size;
     }
 
     template<typename... Args>
@@ -263,7 +321,7 @@ public:
         }
     }
 
-    void resize(const size_type new_size, reference value = value_type()) {
+    void resize(const size_type new_size, const_reference value = value_type()) {
         while (new_size > m_size)
             push_back(value);
         while (new_size < m_size)
@@ -271,14 +329,8 @@ public:
     }
 
     void swap(Deque &other) noexcept {
-        std::swap(m_map, other.m_map);
-        std::swap(m_map_capacity, other.m_map_capacity);
-        std::swap(m_num_blocks, other.m_num_blocks);
-        std::swap(m_front_block, other.m_front_block);
-        std::swap(m_back_block, other.m_back_block);
-        std::swap(m_front_index, other.m_front_index);
-        std::swap(m_back_index, other.m_back_index);
-        std::swap(m_size, other.m_size);
+        mem::swap(m_alloc, other.m_alloc);
+        swap_storage(other);
     }
 
     void clear() noexcept {
@@ -307,51 +359,51 @@ public:
 
     // Iterators
     iterator begin() {
-        return iterator(&m_map[m_front_block][m_front_index]);
+        return iterator(m_map, front_slot());
     }
 
     const_iterator begin() const {
-        return const_iterator(&m_map[m_front_block][m_front_index]);
+        return const_iterator(m_map, front_slot());
     }
 
     const_iterator cbegin() const {
-        return const_iterator(&m_map[m_front_block][m_front_index]);
+        return begin();
     }
 
     iterator end() {
-        return iterator(&m_map[m_back_block][m_back_index + 1]);
+        return iterator(m_map, back_slot());
     }
 
     const_iterator end() const {
-        return const_iterator(&m_map[m_back_block][m_back_index + 1]);
+        return const_iterator(m_map, back_slot());
     }
 
     const_iterator cend() const {
-        return const_iterator(&m_map[m_back_block][m_back_index + 1]);
+        return end();
     }
 
     reverse_iterator rbegin() {
-        return reverse_iterator(&m_map[m_back_block][m_back_index + 1]);
+        return reverse_iterator(end());
     }
 
     const_reverse_iterator rbegin() const {
-        return const_reverse_iterator(&m_map[m_back_block][m_back_index + 1]);
+        return const_reverse_iterator(end());
     }
 
     const_reverse_iterator crbegin() const {
-        return const_reverse_iterator(&m_map[m_back_block][m_back_index + 1]);
+        return rbegin();
     }
 
     reverse_iterator rend() {
-        return reverse_iterator(&m_map[m_front_block][m_front_index]);
+        return reverse_iterator(begin());
     }
 
     const_reverse_iterator rend() const {
-        return const_reverse_iterator(&m_map[m_front_block][m_front_index]);
+        return const_reverse_iterator(begin());
     }
 
     const_reverse_iterator crend() const {
-        return const_reverse_iterator(&m_map[m_front_block][m_front_index]);
+        return rend();
     }
 
     // Relational operators
@@ -374,25 +426,28 @@ private:
     size_type m_front_block, m_back_block;
     size_type m_front_index, m_back_index;
     size_type m_size;
+    [[no_unique_address]] allocator_type m_alloc;
+    [[no_unique_address]] Stats m_stats;
+
+    using map_allocator_type = mem::rebind<Allocator, pointer>;
 
-    static constexpr size_t TARGET_BLOCK_BYTES = 512;
-    static constexpr size_t BLOCK_SIZE = std::max(static_cast<size_type>(1), TARGET_BLOCK_BYTES / sizeof(value_type));
+    static constexpr size_t BLOCK_SIZE = Deque_block_size<T>;
 
     void allocate_block_front() {
         if (m_front_block == 0) expand_map();
-        m_map[--m_front_block] = new value_type[BLOCK_SIZE];
+        m_map[--m_front_block] = create_block();
         ++m_num_blocks;
     }
 
     void allocate_block_back() {
         if (m_back_block == m_map_capacity - 1) expand_map();
-        m_map[++m_back_block] = new value_type[BLOCK_SIZE];
+        m_map[++m_back_block] = create_block();
         ++m_num_blocks;
     }
 
     void expand_map() {
         const size_type new_capacity = m_map_capacity * 2;
-        value_type **new_map = new pointer[new_capacity]();
+        value_type **new_map = create_map(new_capacity);
         const size_type shift = new_capacity / 4;
 
         for (size_type i = 0; i < m_map_capacity; ++i) {
@@ -401,35 +456,108 @@ private:
 
         m_front_block += shift;
         m_back_block += shift;
-        delete[] m_map;
+        destroy_map(m_map, m_map_capacity);
         m_map = new_map;
         m_map_capacity = new_capacity;
     }
 
-    void reset_indices() {
+    void initialize_map() {
+        m_map = create_map(4);
+        m_map_capacity = 4;
+        m_front_block = m_back_block = m_map_capacity / 2;
+        m_map[m_front_block] = create_block();
+        m_num_blocks = 1;
         m_front_index = BLOCK_SIZE / 2;
         m_back_index = m_front_index - 1;
-        m_front_block = m_back_block = m_map_capacity / 2;
+    }
 
-        if (m_size == 0) {
-            m_map[m_front_block] = new value_type[BLOCK_SIZE];
-            m_num_blocks = 1;
+    // Once the last element is gone, keep one block and move it to the middle of the map so that
+    // both ends have room to grow again
+    void reset_indices() {
+        pointer block = m_map[m_front_block];
+        m_map[m_front_block] = nullptr;
+        for (size_type i = m_front_block + 1; i <= m_back_block; ++i) {
+            destroy_block(m_map[i]);
+            m_map[i] = nullptr;
         }
+        m_num_blocks = 1;
+        m_front_block = m_back_block = m_map_capacity / 2;
+        m_map[m_front_block] = block;
+        m_front_index = BLOCK_SIZE / 2;
+        m_back_index = m_front_index - 1;
     }
 
+    // Slots are numbered from the start of the map, which is how the iterators address elements
+    size_type front_slot() const {
+        return m_front_block * BLOCK_SIZE + m_front_index;
+    }
+
+    size_type back_slot() const {
+        return front_slot() + m_size;
+    }
+
+    // Releases every block and the map, leaving the allocation-free empty state
     void cleanup() noexcept {
         if (m_map) {
             for (size_type i = 0; i < m_map_capacity; ++i) {
-                delete[] m_map[i];
+                destroy_block(m_map[i]);
             }
-            m_size = 0;
-            m_num_blocks = 0;
-            reset_indices();
+            destroy_map(m_map, m_map_capacity);
         }
+        m_map = nullptr;
+        m_map_capacity = 0;
+        m_num_blocks = 0;
+        m_front_block = m_back_block = 0;
+        m_front_index = m_back_index = 0;
+        m_size = 0;
+    }
+
+    pointer create_block() {
+        m_stats.count(Stat::block_allocation);
+        return mem::create_array(m_alloc, BLOCK_SIZE);
+    }
+
+    void destroy_block(pointer block) noexcept {
+        mem::destroy_array(m_alloc, block, BLOCK_SIZE);
+    }
+
+    pointer *create_map(const size_type capacity) {
+        m_stats.count(Stat::reallocation);
+        map_allocator_type map_alloc(m_alloc);
+        return mem::create_array(map_alloc, capacity);
+    }
+
+    void destroy_map(pointer *map, const size_type capacity) noexcept {
+        map_allocator_type map_alloc(m_alloc);
+        mem::destroy_array(map_alloc, map, capacity);
+    }
+
+    // Exchanges everything but the allocators
+    void swap_storage(Deque &other) noexcept {
+        std::swap(m_map, other.m_map);
+        std::swap(m_map_capacity, other.m_map_capacity);
+        std::swap(m_num_blocks, other.m_num_blocks);
+        std::swap(m_front_block, other.m_front_block);
+        std::swap(m_back_block, other.m_back_block);
+        std::swap(m_front_index, other.m_front_index);
+        std::swap(m_back_index, other.m_back_index);
+        std::swap(m_size, other.m_size);
+    }
+
+    void move_from(Deque &other) {
+        for (size_type i = 0; i < other.m_size; ++i) {
+            push_back(std::move(other[i]));
+        }
+        other.cleanup();
     }
 };
 
-template<typename T>
-void swap(Deque<T> &lhs, Deque<T> &rhs) noexcept {
+template<typename T, typename Allocator, typename Stats>
+void swap(Deque<T, Allocator, Stats> &lhs, Deque<T, Allocator, Stats> &rhs) noexcept {
     lhs.swap(rhs);
+}
+
+namespace pmr {
+    template<typename T>
+    using Deque = ::Deque<T, std::pmr::polymorphic_allocator<T>>;
 }
\ No newline at end of file
@@ -1,16 +1,28 @@
 #pragma once
 
+#include <algorithm>
+#include <functional>
 #include <initializer_list>
 #include <limits>
 #include <ranges>
+#include <stdexcept>
 
 #include "iterator/iterator.hpp"
 #include "iterator/iterator_utils.hpp"
+#include "internal/node_chain.hpp"
+#include "utils/allocator.hpp"
+#include "utils/stats.hpp"
 
-template<typename T>
+// Singly linked list whose before-begin position is a Node_base member rather than a heap
+// dummy node: construction, moves and swaps allocate nothing and cannot throw.
+template<typename T, typename Allocator = std::allocator<T>, typename Stats = No_stats>
 class Forward_list {
+    using alloc_traits = std::allocator_traits<Allocator>;
+    using node_allocator_type = mem::rebind<Allocator, Node<T>>;
+
 public:
     using value_type = T;
+    using allocator_type = Allocator;
     using pointer = T *;
     using const_pointer = const T *;
     using reference = T &;
@@ -20,50 +32,53 @@ public:
     using const_iterator = Forward_iterator<const T>;
 
     // Constructors
-    Forward_list() : m_dummy(new Node<value_type>()), m_size(0) {
+    Forward_list() noexcept(noexcept(allocator_type())) : Forward_list(allocator_type()) {
     }
 
-    Forward_list(const Forward_list &other) : Forward_list() {
-        auto tail = m_dummy;
-        for (auto current = other.m_dummy->next; current != nullptr; current = current->next) {
-            tail->next = new Node<value_type>(current->value);
-            tail = tail->next;
-            ++m_size;
-        }
+    explicit Forward_list(const allocator_type &alloc) noexcept : m_size(0), m_alloc(alloc) {
     }
 
-    Forward_list(Forward_list &&other) noexcept : m_dummy(other.m_dummy), m_size(other.m_size) {
-        other.m_dummy = new Node<value_type>();
-        other.m_dummy->next = nullptr;
-        other.m_size = 0;
+    Forward_list(const Forward_list &other)
+        : Forward_list(other, alloc_traits::select_on_container_copy_construction(other.get_allocator())) {
     }
 
-    template<typename InputIt, typename = std::enable_if_t<it::is_iterator<InputIt>::value> >
-    Forward_list(InputIt first, InputIt last) : Forward_list() {
-        auto tail = m_dummy;
-        for (auto it = first; it != last; ++it) {
-            tail->next = new Node<value_type>(*it);
-            tail = tail->next;
-            ++m_size;
-        }
+    Forward_list(const Forward_list &other, const allocator_type &alloc) : Forward_list(alloc) {
+        append_range(&m_head, other.begin(), other.end());
     }
 
-    Forward_list(std::initializer_list<value_type> i_list) : Forward_list() {
-        auto tail = m_dummy;
-        for (const auto &value: i_list) {
-            tail->next = new Node<value_type>(value);
-            tail = tail->next;
-            ++m_size;
+    Forward_list(Forward_list &&other) noexcept : m_size(0), m_alloc(std::move(other.m_alloc)) {
+        steal(other);
+    }
+
+    // Nodes from an unequal allocator cannot be adopted, so the values are moved one by one
+    Forward_list(Forward_list &&other, const allocator_type &alloc) : Forward_list(alloc) {
+        if (mem::equal(m_alloc, other.m_alloc)) {
+            steal(other);
+        } else {
+            move_from(other);
         }
     }
 
-    explicit Forward_list(const size_type count) : Forward_list() {
+    template<typename InputIt, typename = std::enable_if_t<it::is_iterator<InputIt>::value> >
+    Forward_list(InputIt first, InputIt last, const allocator_type &alloc = allocator_type())
+        : Forward_list(alloc) {
+        append_range(&m_head, first, last);
+    }
+
+    Forward_list(std::initializer_list<value_type> i_list, const allocator_type &alloc = allocator_type())
+        : Forward_list(alloc) {
+        append_range(&m_head, i_list.begin(), i_list.end());
+    }
+
+    explicit Forward_list(const size_type count, const allocator_type &alloc = allocator_type())
+        : Forward_list(alloc) {
         for (size_type i = 0; i < count; ++i) {
             push_front(value_type());
         }
     }
 
-    explicit Forward_list(const size_type count, const_reference value) : Forward_list() {
+    explicit Forward_list(const size_type count, const_reference value, const allocator_type &alloc = allocator_type())
+        : Forward_list(alloc) {
         for (size_type i = 0; i < count; ++i) push_front(value);
     }
 
@@ -71,57 +86,49 @@ public:
     Forward_list &operator=(const Forward_list &other) {
         if (this != &other) {
             clear_data();
-            auto tail = m_dummy;
-            for (auto current = other.m_dummy->next; current != nullptr; current = current->next) {
-                tail->next = new Node<value_type>(current->value);
-                tail = tail->next;
-                ++m_size;
-            }
+            mem::copy_assign(m_alloc, other.m_alloc);
+            append_range(&m_head, other.begin(), other.end());
         }
         return *this;
     }
 
-    Forward_list &operator=(Forward_list &&other) noexcept {
+    Forward_list &operator=(Forward_list &&other) noexcept(mem::nothrow_move_assign<Allocator>) {
         if (this != &other) {
             clear_data();
-            delete m_dummy;
-
-            m_dummy = other.m_dummy;
-            m_size = other.m_size;
-
-            other.m_dummy = new Node<value_type>();
-            other.m_size = 0;
+            if (mem::can_steal(m_alloc, other.m_alloc)) {
+                mem::move_assign(m_alloc, other.m_alloc);
+                steal(other);
+            } else {
+                move_from(other);
+            }
         }
         return *this;
     }
 
     Forward_list &operator=(std::initializer_list<value_type> i_list) {
         clear_data();
-        auto tail = m_dummy;
-        for (const auto &value: i_list) {
-            tail->next = new Node<value_type>(value);
-            tail = tail->next;
-            ++m_size;
-        }
+        append_range(&m_head, i_list.begin(), i_list.end());
         return *this;
     }
 
     // Destructor
     ~Forward_list() {
         clear_data();
-        delete m_dummy;
-        m_dummy = nullptr;
+    }
+
+    [[nodiscard]] allocator_type get_allocator() const noexcept {
+        return allocator_type(m_alloc);
     }
 
     // Element Access
     reference front() {
         if (empty()) throw std::out_of_range("Forward_list is empty");
-        return m_dummy->next->value;
+        return to_node(m_head.next)->value;
     }
 
     const_reference front() const {
         if (empty()) throw std::out_of_range("Forward_list is empty");
-        return m_dummy->next->value;
+        return to_node(m_head.next)->value;
     }
 
     // Size
@@ -137,6 +144,15 @@ public:
         return m_size == 0;
     }
 
+    // Statistics
+    [[nodiscard]] Sequence_stats stats() const requires Stats::enabled {
+        Sequence_stats out;
+        out.size = m_size;
+        out.capacity = m_size;
+        out.bytes_allocated = m_size * sizeof(Node<value_type>);
+        return out;
+    }
+
     // Modifiers
     void clear() noexcept {
         clear_data();
@@ -144,123 +160,79 @@ public:
 
     template<typename U>
     void push_front(U &&value) {
-        auto new_node = new Node<value_type>(std::forward<U>(value));
-        new_node->next = m_dummy->next;
-        m_dummy->next = new_node;
-        ++m_size;
+        link_after(&m_head, create_node(std::forward<U>(value)));
     }
 
     void pop_front() {
-        if (m_dummy->next) {
-            auto temp = m_dummy->next;
-            m_dummy->next = temp->next;
-            delete temp;
-            --m_size;
-        }
+        if (m_head.next) unlink_after(&m_head);
     }
 
     template<typename... Args>
     void emplace_front(Args &&... args) {
-        auto new_node = new Node<value_type>(std::forward<Args>(args)...);
-        new_node->next = m_dummy->next;
-        m_dummy->next = new_node;
-        ++m_size;
+        link_after(&m_head, create_node(std::forward<Args>(args)...));
     }
 
     template<typename U>
     void insert_after(iterator pos, U&& value) {
         if (!pos.node()) throw std::out_of_range("Iterator out of range");
-        auto new_node = new Node<value_type>(value);
-        new_node->next = pos.node()->next;
-        pos.node()->next = new_node;
-        ++m_size;
+        link_after(pos.node(), create_node(std::forward<U>(value)));
     }
 
     void insert_after(iterator pos, const size_type count, const_reference value) {
         if (!pos.node()) throw std::out_of_range("Iterator out of range");
 
+        Node_base *current = pos.node();
         for (size_type i = 0; i < count; ++i) {
-            auto new_node = new Node<value_type>(value);
-            new_node->next = pos.node()->next;
-            pos.node()->next = new_node;
-            pos = iterator(new_node);
+            current = link_after(current, create_node(value));
         }
-        m_size += count;
     }
 
     void insert_after(iterator pos, std::initializer_list<value_type> i_list) {
         if (!pos.node()) throw std::out_of_range("Iterator out of range");
-
-        const size_type count = i_list.size();
-        for (size_type i = 0; i < count; ++i) {
-            auto new_node = new Node<value_type>(i_list.begin()[i]);
-            new_node->next = pos.node()->next;
-            pos.node()->next = new_node;
-            pos = iterator(new_node);
-        }
-        m_size += count;
+        append_range(pos.node(), i_list.begin(), i_list.end());
     }
 
     template<typename InputIt, typename = std::enable_if_t<it::is_iterator<InputIt>::value> >
     void insert_after(iterator pos, InputIt first, InputIt last) {
         if (!pos.node()) throw std::out_of_range("Iterator out of range");
-
-        auto current = pos.node();
-        for (auto it = first; it != last; ++it) {
-            auto new_node = new Node<value_type>(*it);
-            new_node->next = current->next;
-            current->next = new_node;
-            current = new_node;
-            ++m_size;
-        }
+        append_range(pos.node(), first, last);
     }
 
     template<typename... Args>
     void emplace_after(iterator pos, Args &&... args) {
         if (!pos.node()) throw std::out_of_range("Iterator out of range");
-
-        auto new_node = new Node<value_type>(std::forward<Args>(args)...);
-        new_node->next = pos.node()->next;
-        pos.node()->next = new_node;
-        ++m_size;
+        link_after(pos.node(), create_node(std::forward<Args>(args)...));
     }
 
-
     void erase_after(iterator pos) {
         if (!pos.node()) throw std::out_of_range("Iterator out of range");
         if (!pos.node()->next) return;
-
-        auto temp = pos.node()->next;
-        pos.node()->next = temp->next;
-        delete temp;
-        --m_size;
+        unlink_after(pos.node());
     }
 
     void erase_after(iterator first, iterator last) {
         if (!first.node()) throw std::out_of_range("Iterator out of range");
 
-        auto current = first.node()->next;
-        auto stop = last.node();
-
-        while (current != stop) {
-            auto temp = current;
-            current = current->next;
-            delete temp;
-            --m_size;
+        Node_base *stop = last.node();
+        while (first.node()->next != stop) {
+            unlink_after(first.node());
         }
-
-        first.node()->next = stop;
     }
 
     void resize(const size_type count, value_type value = value_type()) {
         if (count == m_size) return;
 
-        while (m_size < count) {
-            push_back(value);
+        Node_base *current = &m_head;
+        for (size_type i = 0; i < std::min(count, m_size); ++i) {
+            current = current->next;
+        }
+
+        while (current->next && m_size > count) {
+            unlink_after(current);
         }
 
-        while (m_size > count) {
-            pop_back();
+        while (m_size < count) {
+            current = link_after(current, create_node(value));
         }
     }
 
@@ -273,33 +245,163 @@ public:
 
     void assign(std::initializer_list<value_type> i_list) {
         clear_data();
-        for (auto i: i_list) push_back(i);
+        append_range(&m_head, i_list.begin(), i_list.end());
     }
 
     template<typename InputIt, typename = std::enable_if_t<it::is_iterator<InputIt>::value> >
     void assign(InputIt first, InputIt last) {
         clear_data();
-        for (auto it = first; it != last; ++it) {
-            push_back(*it);
-        }
+        append_range(&m_head, first, last);
     }
 
     void swap(Forward_list &other) noexcept {
-        std::swap(m_dummy, other.m_dummy);
+        mem::swap(m_alloc, other.m_alloc);
+        std::swap(m_head.next, other.m_head.next);
         std::swap(m_size, other.m_size);
     }
 
+    // Operations. These relink nodes rather than copy values; nodes can only move between lists
+    // whose allocators compare equal.
+
+    // Moves every node of `other` after `pos`. Linear, since other's last node has to be found.
+    void splice_after(iterator pos, Forward_list &other) {
+        if (!pos.node()) throw std::out_of_range("Iterator out of range");
+        if (&other == this || other.empty()) return;
+        check_splice(other);
+
+        Node_base *first = other.m_head.next;
+        chain::last(first)->next = pos.node()->next;
+        pos.node()->next = first;
+        m_size += other.m_size;
+        other.m_head.next = nullptr;
+        other.m_size = 0;
+    }
+
+    // Moves the node following `it` in `other` after `pos`
+    void splice_after(iterator pos, Forward_list &other, iterator it) {
+        if (!pos.node() || !it.node()) throw std::out_of_range("Iterator out of range");
+        Node_base *node = it.node()->next;
+        if (!node || node == pos.node() || it.node() == pos.node()) return;
+        check_splice(other);
+
+        it.node()->next = node->next;
+        node->next = pos.node()->next;
+        pos.node()->next = node;
+        if (&other != this) {
+            ++m_size;
+            --other.m_size;
+        }
+    }
+
+    // Moves the nodes strictly between `first` and `last` in `other` after `pos`. Linear in their
+    // number, which is needed to find the last one and keep the sizes right.
+    void splice_after(iterator pos, Forward_list &other, iterator first, iterator last) {
+        if (!pos.node() || !first.node()) throw std::out_of_range("Iterator out of range");
+        Node_base *head = first.node()->next;
+        if (head == last.node()) return;
+        check_splice(other);
+
+        Node_base *tail = head;
+        size_type count = 1;
+        for (; tail->next != last.node(); tail = tail->next) ++count;
+
+        first.node()->next = last.node();
+        tail->next = pos.node()->next;
+        pos.node()->next = head;
+        if (&other != this) {
+            m_size += count;
+            other.m_size -= count;
+        }
+    }
+
+    // Merges the sorted `other` into this sorted list; on ties this list's values come first
+    template<typename Compare = std::less<>>
+    void merge(Forward_list &other, Compare comp = Compare{}) {
+        if (&other == this) return;
+        check_splice(other);
+
+        auto less = [&comp](Node_base *a, Node_base *b) { return comp(to_node(a)->value, to_node(b)->value); };
+        m_head.next = chain::merge(m_head.next, other.m_head.next, less);
+        m_size += other.m_size;
+        other.m_head.next = nullptr;
+        other.m_size = 0;
+    }
+
+    // Stable merge sort that relinks nodes in place: O(n log n) comparisons, no allocation
+    template<typename Compare = std::less<>>
+    void sort(Compare comp = Compare{}) {
+        m_head.next = chain::sort(m_head.next, [&comp](Node_base *a, Node_base *b) {
+            return comp(to_node(a)->value, to_node(b)->value);
+        });
+    }
+
+    void reverse() noexcept {
+        m_head.next = chain::reverse(m_head.next);
+    }
+
+    // Removes every value after the first of each run of consecutive equal values
+    template<typename BinaryPredicate = std::equal_to<>>
+    size_type unique(BinaryPredicate pred = BinaryPredicate{}) {
+        Node_base *doomed = nullptr;
+        const size_type old_size = m_size;
+        try {
+            for (Node_base *kept = m_head.next; kept && kept->next;) {
+                Node_base *node = kept->next;
+                if (pred(to_node(kept)->value, to_node(node)->value)) {
+                    kept->next = node->next;
+                    doom(node, doomed);
+                } else {
+                    kept = node;
+                }
+            }
+        } catch (...) {
+            destroy_chain(doomed);
+            throw;
+        }
+        destroy_chain(doomed);
+        return old_size - m_size;
+    }
+
+    // Unlinks every matching node first and frees them together once the scan is done, so the
+    // predicate never sees a half-removed list
+    template<typename UnaryPredicate>
+    size_type remove_if(UnaryPredicate pred) {
+        Node_base *doomed = nullptr;
+        const size_type old_size = m_size;
+        try {
+            for (Node_base *pos = &m_head; pos->next;) {
+                Node_base *node = pos->next;
+                if (pred(to_node(node)->value)) {
+                    pos->next = node->next;
+                    doom(node, doomed);
+                } else {
+                    pos = node;
+                }
+            }
+        } catch (...) {
+            destroy_chain(doomed);
+            throw;
+        }
+        destroy_chain(doomed);
+        return old_size - m_size;
+    }
+
+    // `value` may be an element of this list
+    size_type remove(const_reference value) {
+        return remove_if([&value](const_reference element) { return element == value; });
+    }
+
     // Iterators
     iterator begin() noexcept {
-        return iterator(m_dummy->next);
+        return iterator(m_head.next);
     }
 
     const_iterator begin() const noexcept {
-        return const_iterator(m_dummy->next);
+        return const_iterator(m_head.next);
     }
 
     const_iterator cbegin() const noexcept {
-        return const_iterator(m_dummy->next);
+        return const_iterator(m_head.next);
     }
 
     iterator end() noexcept {
@@ -315,15 +417,15 @@ public:
     }
 
     iterator before_begin() noexcept {
-        return iterator(m_dummy);
+        return iterator(&m_head);
     }
 
     const_iterator before_begin() const noexcept {
-        return const_iterator(m_dummy);
+        return const_iterator(const_cast<Node_base *>(&m_head));
     }
 
     const_iterator cbefore_begin() const noexcept {
-        return const_iterator(m_dummy);
+        return before_begin();
     }
 
     // Relational operators
@@ -343,52 +445,100 @@ public:
     }
 
 private:
-    Node<value_type> *m_dummy;
+    Node_base m_head;
     size_type m_size;
+    [[no_unique_address]] node_allocator_type m_alloc;
 
-    void clear_data() noexcept {
-        auto current = m_dummy->next;
-        while (current) {
-            auto temp = current;
-            current = current->next;
-            delete temp;
-        }
-        m_dummy->next = nullptr;
-        m_size = 0;
+    static Node<value_type> *to_node(Node_base *node) {
+        return static_cast<Node<value_type> *>(node);
     }
 
-    void push_back(const_reference value) {
-        auto new_node = new Node<value_type>(value);
-        auto temp = m_dummy;
-        while (temp->next) {
-            temp = temp->next;
+    template<typename... Args>
+    Node<value_type> *create_node(Args &&... args) {
+        return mem::create(m_alloc, std::forward<Args>(args)...);
+    }
+
+    void destroy_node(Node<value_type> *node) noexcept {
+        mem::destroy(m_alloc, node);
+    }
+
+    void steal(Forward_list &other) noexcept {
+        m_head.next = other.m_head.next;
+        m_size = other.m_size;
+        other.m_head.next = nullptr;
+        other.m_size = 0;
+    }
+
+    void move_from(Forward_list &other) {
+        Node_base *pos = &m_head;
+        for (auto &value: other) {
+            pos = link_after(pos, create_node(std::move(value)));
         }
-        temp->next = new_node;
+        other.clear_data();
+    }
+
+    // Links `node` after `pos` and returns it
+    Node_base *link_after(Node_base *pos, Node<value_type> *node) noexcept {
+        node->next = pos->next;
+        pos->next = node;
         ++m_size;
+        return node;
     }
 
-    void pop_back() {
-        if (!m_dummy->next) return;
+    void unlink_after(Node_base *pos) noexcept {
+        Node_base *victim = pos->next;
+        pos->next = victim->next;
+        destroy_node(to_node(victim));
+        --m_size;
+    }
 
-        if (!m_dummy->next->next) {
-            delete m_dummy->next;
-            m_dummy->next = nullptr;
-            m_size = 0;
-            return;
+    void check_splice(const Forward_list &other) const {
+        if (!mem::equal(m_alloc, other.m_alloc)) {
+            throw std::invalid_argument("Cannot move nodes between lists with unequal allocators");
         }
+    }
+
+    // Pushes an unlinked node onto the chain of nodes waiting to be freed
+    void doom(Node_base *node, Node_base *&doomed) noexcept {
+        node->next = doomed;
+        doomed = node;
+        --m_size;
+    }
 
-        auto temp = m_dummy;
-        while (temp->next->next) {
-            temp = temp->next;
+    void destroy_chain(Node_base *node) noexcept {
+        while (node) {
+            Node_base *next = node->next;
+            destroy_node(to_node(node));
+            node = next;
         }
+    }
 
-        delete temp->next;
-        temp->next = nullptr;
-        --m_size;
+    // Inserts copies of [first, last) after `pos`, keeping their order
+    template<typename InputIt>
+    void append_range(Node_base *pos, InputIt first, InputIt last) {
+        for (auto it = first; it != last; ++it) {
+            pos = link_after(pos, create_node(*it));
+        }
+    }
+
+    void clear_data() noexcept {
+        Node_base *current = m_head.next;
+        while (current) {
+            Node_base *temp = current;
+            current = current->next;
+            destroy_node(to_node(temp));
+        }
+        m_head.next = nullptr;
+        m_size = 0;
     }
 };
 
-template<typename T>
-void Swap(Forward_list<T> &lhs, Forward_list<T> &rhs) {
+template<typename T, typename Allocator, typename Stats>
+void Swap(Forward_list<T, Allocator, Stats> &lhs, Forward_list<T, Allocator, Stats> &rhs) {
     lhs.swap(rhs);
 }
+
+namespace pmr {
+    template<typename T>
+    using Forward_list = ::Forward_list<T, std::pmr::polymorphic_allocator<T>>;
+}
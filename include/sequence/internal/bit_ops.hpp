@@ -0,0 +1,91 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+// GCC before 14 cannot put target-specific functions into a module, so code built with modules
+// there keeps to the portable kernels
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__)) && \
+    !(defined(__cpp_modules) && !defined(__clang__) && __GNUC__ < 14)
+#define BITS_X86_DISPATCH 1
+#include <immintrin.h>
+#else
+#define BITS_X86_DISPATCH 0
+#endif
+
+// Word kernels behind Bit_vector and Rank_select. On x86 with GCC or Clang the AVX2 and BMI2
+// kernels are compiled for their instruction sets through target attributes and picked at run
+// time from the CPU's feature bits, so every translation unit, whatever its -m flags, sees the
+// same definitions; elsewhere std::popcount becomes POPCNT wherever the target has it.
+namespace bits {
+    // Set bits in words[0, count), a word at a time
+    inline std::size_t popcount_portable(const std::uint64_t *words, const std::size_t count) noexcept {
+        std::size_t total = 0;
+        for (std::size_t i = 0; i < count; ++i) total += std::popcount(words[i]);
+        return total;
+    }
+
+    // Position of the set bit of `word` that has `rank` set bits below it, a byte at a time
+    inline unsigned select_portable(std::uint64_t word, unsigned rank) noexcept {
+        unsigned offset = 0;
+        for (auto in_byte = static_cast<unsigned>(std::popcount(word & 0xff)); rank >= in_byte;
+             in_byte = static_cast<unsigned>(std::popcount(word & 0xff))) {
+            rank -= in_byte;
+            word >>= 8;
+            offset += 8;
+        }
+        for (; rank; --rank) word &= word - 1;
+        return offset + std::countr_zero(word);
+    }
+
+#if BITS_X86_DISPATCH
+    // Mula's nibble lookup: PSHUFB counts each nibble, PSADBW sums the bytes per 64-bit lane
+    [[gnu::target("avx2")]] inline std::size_t popcount_avx2(const std::uint64_t *words, const std::size_t count) noexcept {
+        const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                                0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+        const __m256i low_nibbles = _mm256_set1_epi8(0x0f);
+        __m256i sums = _mm256_setzero_si256();
+        std::size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(words + i));
+            const __m256i low = _mm256_and_si256(block, low_nibbles);
+            const __m256i high = _mm256_and_si256(_mm256_srli_epi16(block, 4), low_nibbles);
+            const __m256i bytes = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, low), _mm256_shuffle_epi8(lookup, high));
+            sums = _mm256_add_epi64(sums, _mm256_sad_epu8(bytes, _mm256_setzero_si256()));
+        }
+        return static_cast<std::size_t>(_mm256_extract_epi64(sums, 0)) +
+               static_cast<std::size_t>(_mm256_extract_epi64(sums, 1)) +
+               static_cast<std::size_t>(_mm256_extract_epi64(sums, 2)) +
+               static_cast<std::size_t>(_mm256_extract_epi64(sums, 3)) +
+               popcount_portable(words + i, count - i);
+    }
+
+    // PDEP deposits a single bit onto the rank-th set bit of word
+    [[gnu::target("bmi,bmi2")]] inline unsigned select_bmi2(const std::uint64_t word, const unsigned rank) noexcept {
+        return static_cast<unsigned>(_tzcnt_u64(_pdep_u64(std::uint64_t{1} << rank, word)));
+    }
+#endif
+
+    // Set bits in words[0, count)
+    inline std::size_t popcount(const std::uint64_t *words, const std::size_t count) noexcept {
+#if BITS_X86_DISPATCH
+        if (__builtin_cpu_supports("avx2")) return popcount_avx2(words, count);
+#endif
+        return popcount_portable(words, count);
+    }
+
+    // Position of the set bit of `word` that has `rank` set bits below it; `rank` must be less
+    // than the popcount of `word`
+    inline unsigned select(const std::uint64_t word, const unsigned rank) noexcept {
+#if BITS_X86_DISPATCH
+        if (__builtin_cpu_supports("bmi2")) return select_bmi2(word, rank);
+#endif
+        return select_portable(word, rank);
+    }
+
+    // Mask of the bits of a word below `bit`, for 0 <= bit < 64
+    constexpr std::uint64_t below(const std::size_t bit) noexcept {
+        return (std::uint64_t{1} << bit) - 1;
+    }
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <compare>
+#include <cstddef>
+#include <type_traits>
+
+#include "iterator/iterator_tags.hpp"
+
+// Position in a Deque: the block map and a slot number counted from the first slot of the map,
+// so stepping across a block boundary is plain arithmetic. Like the Deque's own indices it stays
+// valid until the map is reallocated.
+template<typename T, std::size_t BLOCK_SIZE>
+class Deque_iterator {
+public:
+    using value_type = std::remove_const_t<T>;
+    using pointer = T*;
+    using reference = T&;
+    using difference_type = std::ptrdiff_t;
+    using iterator_category = random_access_iterator_tag;
+    using block_map = value_type* const*;
+
+    explicit Deque_iterator(block_map map = nullptr, const std::size_t slot = 0) : m_map(map), m_slot(slot) {}
+
+    template<typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+    Deque_iterator(const Deque_iterator<U, BLOCK_SIZE>& other) : m_map(other.map()), m_slot(other.slot()) {}
+
+    block_map map() const { return m_map; }
+    std::size_t slot() const { return m_slot; }
+
+    reference operator*() const { return m_map[m_slot / BLOCK_SIZE][m_slot % BLOCK_SIZE]; }
+    pointer operator->() const { return &**this; }
+    reference operator[](const difference_type n) const { return *(*this + n); }
+
+    Deque_iterator& operator++() {
+        ++m_slot;
+        return *this;
+    }
+
+    Deque_iterator operator++(int) {
+        Deque_iterator tmp = *this;
+        ++m_slot;
+        return tmp;
+    }
+
+    Deque_iterator& operator--() {
+        --m_slot;
+        return *this;
+    }
+
+    Deque_iterator operator--(int) {
+        Deque_iterator tmp = *this;
+        --m_slot;
+        return tmp;
+    }
+
+    Deque_iterator& operator+=(const difference_type n) {
+        m_slot += n;
+        return *this;
+    }
+
+    Deque_iterator& operator-=(const difference_type n) {
+        m_slot -= n;
+        return *this;
+    }
+
+    Deque_iterator operator+(const difference_type n) const { return Deque_iterator(m_map, m_slot + n); }
+    Deque_iterator operator-(const difference_type n) const { return Deque_iterator(m_map, m_slot - n); }
+
+    difference_type operator-(const Deque_iterator& other) const {
+        return static_cast<difference_type>(m_slot) - static_cast<difference_type>(other.m_slot);
+    }
+
+    bool operator==(const Deque_iterator& other) const { return m_slot == other.m_slot; }
+    std::strong_ordering operator<=>(const Deque_iterator& other) const { return m_slot <=> other.m_slot; }
+
+private:
+    block_map m_map;
+    std::size_t m_slot;
+};
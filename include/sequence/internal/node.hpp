@@ -1,9 +1,17 @@
 #pragma once
 
+#include <cstddef>
+#include <new>
 #include <utility>
 
+// Link of a singly linked node. Forward_list embeds one as its before-begin position, so an
+// empty list owns no nodes at all.
+struct Node_base {
+    Node_base* next = nullptr;
+};
+
 template<typename T>
-struct Node {
+struct Node : Node_base {
     Node() = default;
 
     explicit Node(const T& val) : value(val) {}
@@ -13,7 +21,6 @@ struct Node {
     explicit Node(Args&&... args) : value(std::forward<Args>(args)...) {}
 
     T value;
-    Node* next = nullptr;
 };
 
 template<typename T>
@@ -29,4 +36,15 @@ struct DNode {
     T value;
     DNode* next = nullptr;
     DNode* prev = nullptr;
-};
\ No newline at end of file
+};
+// Block of up to K values for Unrolled_list. Only the first `count` slots hold live objects.
+template<typename T, std::size_t K>
+struct Unrolled_node {
+    Unrolled_node* next = nullptr;
+    Unrolled_node* prev = nullptr;
+    std::size_t count = 0;
+    alignas(T) std::byte storage[K * sizeof(T)];
+
+    T* data() { return std::launder(reinterpret_cast<T*>(storage)); }
+    const T* data() const { return std::launder(reinterpret_cast<const T*>(storage)); }
+};
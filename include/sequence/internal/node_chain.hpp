@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+
+// Relinking helpers for null-terminated chains of nodes joined by their `next` links, shared by
+// List and Forward_list. They only rewire links: no node is allocated, copied or destroyed.
+// `less` compares two nodes.
+namespace chain {
+    // Merges two sorted chains; on ties the nodes of `a` come first
+    template<typename Link, typename Less>
+    Link *merge(Link *a, Link *b, Less &less) {
+        Link *head = nullptr;
+        Link **tail = &head;
+        while (a && b) {
+            if (less(b, a)) {
+                *tail = b;
+                tail = &b->next;
+                b = b->next;
+            } else {
+                *tail = a;
+                tail = &a->next;
+                a = a->next;
+            }
+        }
+        *tail = a ? a : b;
+        return head;
+    }
+
+    // Bottom-up merge sort. Bin i holds a sorted run of 2^i nodes; each node is carried through
+    // the bins like a binary counter, older runs always merged in front, so the sort is stable.
+    template<typename Link, typename Less>
+    Link *sort(Link *head, Less less) {
+        Link *bins[64] = {};
+        std::size_t used = 0;
+        while (head) {
+            Link *run = head;
+            head = head->next;
+            run->next = nullptr;
+
+            std::size_t i = 0;
+            for (; i < used && bins[i]; ++i) {
+                run = merge(bins[i], run, less);
+                bins[i] = nullptr;
+            }
+            if (i == used) ++used;
+            bins[i] = run;
+        }
+
+        Link *result = nullptr;
+        for (std::size_t i = 0; i < used; ++i) {
+            if (bins[i]) result = merge(bins[i], result, less);
+        }
+        return result;
+    }
+
+    template<typename Link>
+    Link *reverse(Link *head) {
+        Link *reversed = nullptr;
+        while (head) {
+            Link *next = head->next;
+            head->next = reversed;
+            reversed = head;
+            head = next;
+        }
+        return reversed;
+    }
+
+    template<typename Link>
+    Link *last(Link *head) {
+        while (head && head->next) head = head->next;
+        return head;
+    }
+}
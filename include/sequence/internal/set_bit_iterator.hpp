@@ -0,0 +1,72 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#include "iterator/iterator_tags.hpp"
+
+// Visits the positions of the set bits of a word array in ascending order. It keeps the
+// current word with the visited bits cleared, so each step is a countr_zero and a blsr, and
+// runs of zero words are skipped a word at a time.
+class Set_bit_iterator {
+public:
+    using value_type = std::size_t;
+    using pointer = const std::size_t *;
+    using reference = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using iterator_category = forward_iterator_tag;
+
+    Set_bit_iterator() = default;
+
+    Set_bit_iterator(const std::uint64_t *words, const std::size_t word_count, const std::size_t index)
+        : m_words(words), m_word_count(word_count), m_index(index) {
+        if (m_index < m_word_count) {
+            m_current = m_words[m_index];
+            skip_empty();
+        }
+    }
+
+    reference operator*() const { return m_index * 64 + std::countr_zero(m_current); }
+
+    Set_bit_iterator &operator++() {
+        m_current &= m_current - 1;
+        skip_empty();
+        return *this;
+    }
+
+    Set_bit_iterator operator++(int) {
+        Set_bit_iterator tmp = *this;
+        ++(*this);
+        return tmp;
+    }
+
+    bool operator==(const Set_bit_iterator &other) const {
+        return m_index == other.m_index && m_current == other.m_current;
+    }
+
+    bool operator!=(const Set_bit_iterator &other) const { return !(*this == other); }
+
+private:
+    const std::uint64_t *m_words = nullptr;
+    std::size_t m_word_count = 0;
+    std::size_t m_index = 0;
+    std::uint64_t m_current = 0;
+
+    void skip_empty() {
+        while (!m_current && ++m_index < m_word_count) m_current = m_words[m_index];
+    }
+};
+
+// The set bits of a Bit_vector as a range for range-for and the algorithms
+class Set_bit_range {
+public:
+    Set_bit_range(const std::uint64_t *words, const std::size_t word_count) : m_words(words), m_word_count(word_count) {}
+
+    Set_bit_iterator begin() const { return Set_bit_iterator(m_words, m_word_count, 0); }
+    Set_bit_iterator end() const { return Set_bit_iterator(m_words, m_word_count, m_word_count); }
+
+private:
+    const std::uint64_t *m_words;
+    std::size_t m_word_count;
+};
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+#include "iterator/iterator_tags.hpp"
+#include "node.hpp"
+
+// Position in an Unrolled_list: a node and a slot within it. The end position sits one past the
+// last slot of the tail node, so it can be decremented like any other.
+template<typename T, std::size_t K>
+class Unrolled_list_iterator {
+public:
+    using value_type = T;
+    using pointer = T*;
+    using reference = T&;
+    using difference_type = std::ptrdiff_t;
+    using iterator_category = bidirectional_iterator_tag;
+    using node_type = Unrolled_node<std::remove_const_t<T>, K>;
+
+    explicit Unrolled_list_iterator(node_type* node = nullptr, const std::size_t index = 0)
+        : m_node(node), m_index(index) {}
+
+    template<typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+    Unrolled_list_iterator(const Unrolled_list_iterator<U, K>& other)
+        : m_node(other.node()), m_index(other.index()) {}
+
+    node_type* node() const { return m_node; }
+    std::size_t index() const { return m_index; }
+
+    reference operator*() const { return m_node->data()[m_index]; }
+    pointer operator->() const { return m_node->data() + m_index; }
+
+    Unrolled_list_iterator& operator++() {
+        if (++m_index == m_node->count && m_node->next) {
+            m_node = m_node->next;
+            m_index = 0;
+        }
+        return *this;
+    }
+
+    Unrolled_list_iterator operator++(int) {
+        Unrolled_list_iterator tmp = *this;
+        ++(*this);
+        return tmp;
+    }
+
+    Unrolled_list_iterator& operator--() {
+        if (m_index == 0) {
+            m_node = m_node->prev;
+            m_index = m_node->count;
+        }
+        --m_index;
+        return *this;
+    }
+
+    Unrolled_list_iterator operator--(int) {
+        Unrolled_list_iterator tmp = *this;
+        --(*this);
+        return tmp;
+    }
+
+    bool operator==(const Unrolled_list_iterator& other) const {
+        return m_node == other.m_node && m_index == other.m_index;
+    }
+
+    bool operator!=(const Unrolled_list_iterator& other) const {
+        return !(*this == other);
+    }
+
+private:
+    node_type* m_node;
+    std::size_t m_index;
+};
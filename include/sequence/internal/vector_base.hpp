@@ -0,0 +1,470 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+#include "iterator/iterator.hpp"
+#include "iterator/iterator_utils.hpp"
+#include "utils/allocator.hpp"
+#include "utils/stats.hpp"
+
+// Room for N elements inside the container object. With N == 0 it takes no space and its data()
+// is null, so the same code serves Vector and Small_vector.
+template<typename T, std::size_t N>
+struct Inline_buffer {
+    T slots[N];
+
+    constexpr T *data() noexcept { return slots; }
+};
+
+template<typename T>
+struct Inline_buffer<T, 0> {
+    constexpr T *data() noexcept { return nullptr; }
+};
+
+// Contiguous storage shared by Vector and Small_vector: the elements live in the inline buffer
+// until they outgrow it and in an allocator buffer after that, and every growth, insertion and
+// erasure is written once here. The derived classes only add their constructors and assignments,
+// which build on the protected helpers below. Invariant: the heap buffer is in use exactly when
+// the capacity is above N.
+template<typename T, std::size_t N, typename Allocator, typename Stats>
+class Vector_base {
+protected:
+    using alloc_traits = std::allocator_traits<Allocator>;
+
+public:
+    using value_type = T;
+    using allocator_type = Allocator;
+    using pointer = T *;
+    using const_pointer = const T *;
+    using reference = T &;
+    using const_reference = const T &;
+    using size_type = std::size_t;
+    using iterator = Random_access_iterator<T>;
+    using const_iterator = Random_access_iterator<const T>;
+    using reverse_iterator = Reverse_random_access_iterator<T>;
+    using const_reverse_iterator = Reverse_random_access_iterator<const T>;
+
+    [[nodiscard]] constexpr allocator_type get_allocator() const noexcept {
+        return m_alloc;
+    }
+
+    // Element access
+    constexpr reference operator[](size_type index) {
+        return m_data[index];
+    }
+
+    constexpr const_reference operator[](size_type index) const {
+        return m_data[index];
+    }
+
+    constexpr reference at(size_type index) {
+        if (index >= m_size) throw std::out_of_range("Index out of range");
+        return m_data[index];
+    }
+
+    constexpr const_reference at(size_type index) const {
+        if (index >= m_size) throw std::out_of_range("Index out of range");
+        return m_data[index];
+    }
+
+    constexpr reference front() {
+        if (m_size == 0) throw std::runtime_error("Vector is empty");
+        return m_data[0];
+    }
+
+    constexpr const_reference front() const {
+        if (m_size == 0) throw std::runtime_error("Vector is empty");
+        return m_data[0];
+    }
+
+    constexpr reference back() {
+        if (m_size == 0) throw std::runtime_error("Vector is empty");
+        return m_data[m_size - 1];
+    }
+
+    constexpr const_reference back() const {
+        if (m_size == 0) throw std::runtime_error("Vector is empty");
+        return m_data[m_size - 1];
+    }
+
+    [[nodiscard]] constexpr pointer data() {
+        return m_data;
+    }
+
+    [[nodiscard]] constexpr const_pointer data() const {
+        return m_data;
+    }
+
+    // Capacity & size
+    [[nodiscard]] constexpr bool empty() const {
+        return m_size == 0;
+    }
+
+    [[nodiscard]] constexpr size_type size() const {
+        return m_size;
+    }
+
+    [[nodiscard]] constexpr size_type max_size() const {
+        return std::numeric_limits<size_type>::max() / (sizeof(value_type) * 2);
+    }
+
+    [[nodiscard]] constexpr size_type capacity() const {
+        return m_capacity;
+    }
+
+    constexpr void reserve(const size_type new_capacity) {
+        if (new_capacity > m_capacity) relocate(new_capacity);
+    }
+
+    // Moves the elements back into the inline buffer when they fit
+    constexpr void shrink_to_fit() {
+        if (!on_heap() || m_size == m_capacity) return;
+        relocate(m_size);
+    }
+
+    // Statistics; the inline buffer is part of the object, so only a heap buffer counts as allocated
+    [[nodiscard]] constexpr Sequence_stats stats() const requires Stats::enabled {
+        Sequence_stats out;
+        out.size = m_size;
+        out.capacity = m_capacity;
+        out.reallocations = m_stats.get(Stat::reallocation);
+        out.bytes_allocated = on_heap() ? m_capacity * sizeof(value_type) : 0;
+        return out;
+    }
+
+    // Modifiers
+    template<typename U>
+    constexpr void push_back(U &&value) {
+        if (m_size == m_capacity) {
+            // `value` may live in the buffer that is about to be freed
+            value_type copy(std::forward<U>(value));
+            grow(m_size + 1);
+            m_data[m_size++] = std::move(copy);
+            return;
+        }
+        m_data[m_size++] = std::forward<U>(value);
+    }
+
+    constexpr void pop_back() {
+        if (m_size == 0) throw std::runtime_error("Vector is empty");
+        m_size--;
+    }
+
+    constexpr void insert(const_iterator pos, const_reference value) {
+        insert(pos, value_type(value));
+    }
+
+    constexpr void insert(const_iterator pos, value_type &&value) {
+        const size_type index = open_gap(pos, 1);
+        m_data[index] = std::move(value);
+    }
+
+    constexpr void insert(const_iterator pos, const size_type count, const_reference value) {
+        if (count == 0) return;
+
+        const value_type copy(value);
+        const size_type index = open_gap(pos, count);
+        for (size_type i = 0; i < count; ++i) {
+            m_data[index + i] = copy;
+        }
+    }
+
+    template<typename InputIt, typename = std::enable_if_t<it::is_iterator<InputIt>::value> >
+    constexpr void insert(const_iterator pos, InputIt first, InputIt last) {
+        insert_range(pos, first, last);
+    }
+
+    constexpr void insert(const_iterator pos, std::initializer_list<T> i_list) {
+        insert_range(pos, i_list.begin(), i_list.end());
+    }
+
+    constexpr void resize(const size_type count, const_reference value = value_type()) {
+        if (count > m_size) {
+            if (count > m_capacity) reserve(std::max(count, m_capacity * 2));
+            for (size_type i = m_size; i < count; ++i) {
+                m_data[i] = value;
+            }
+        }
+        m_size = count;
+    }
+
+    template<typename... Args>
+    constexpr void emplace(const_iterator pos, Args &&... args) {
+        value_type value(std::forward<Args>(args)...);
+        const size_type index = open_gap(pos, 1);
+        m_data[index] = std::move(value);
+    }
+
+    template<typename... Args>
+    constexpr void emplace_back(Args &&... args) {
+        push_back(value_type(std::forward<Args>(args)...));
+    }
+
+    constexpr iterator erase(const_iterator pos) {
+        return erase(pos, pos + 1);
+    }
+
+    constexpr iterator erase(const_iterator first, const_iterator last) {
+        if (first > last || first < cbegin() || last > cend())
+            throw std::out_of_range("Index out of range");
+
+        const size_type index = first - cbegin();
+        const size_type count = last - first;
+
+        for (size_type i = index; i + count < m_size; ++i) {
+            m_data[i] = std::move(m_data[i + count]);
+        }
+        m_size -= count;
+
+        return iterator(m_data + index);
+    }
+
+    constexpr void clear() {
+        m_size = 0;
+    }
+
+    constexpr void assign(const size_type count, const_reference value) {
+        clear();
+        reserve(count);
+        for (size_type i = 0; i < count; ++i) {
+            m_data[i] = value;
+        }
+        m_size = count;
+    }
+
+    template<typename InputIt, typename = std::enable_if_t<it::is_iterator<InputIt>::value> >
+    constexpr void assign(InputIt first, InputIt last) {
+        assign_range(first, last);
+    }
+
+    constexpr void assign(std::initializer_list<value_type> i_list) {
+        assign_range(i_list.begin(), i_list.end());
+    }
+
+    // Heap buffers are exchanged; elements in an inline buffer have to be moved across
+    constexpr void swap(Vector_base &other) noexcept {
+        if (N == 0 || (on_heap() && other.on_heap())) {
+            mem::swap(m_alloc, other.m_alloc);
+            std::swap(m_data, other.m_data);
+            std::swap(m_size, other.m_size);
+            std::swap(m_capacity, other.m_capacity);
+            return;
+        }
+        Vector_base tmp(other.m_alloc);
+        tmp.take(other);
+        other.move_assign(*this);
+        move_assign(tmp);
+    }
+
+    // Iterators
+    constexpr iterator begin() noexcept {
+        return iterator(m_data);
+    }
+
+    constexpr const_iterator begin() const noexcept {
+        return const_iterator(m_data);
+    }
+
+    constexpr const_iterator cbegin() const noexcept {
+        return const_iterator(m_data);
+    }
+
+    constexpr iterator end() noexcept {
+        return iterator(m_data + m_size);
+    }
+
+    constexpr const_iterator end() const noexcept {
+        return const_iterator(m_data + m_size);
+    }
+
+    constexpr const_iterator cend() const noexcept {
+        return const_iterator(m_data + m_size);
+    }
+
+    constexpr reverse_iterator rbegin() noexcept {
+        return reverse_iterator(m_data + m_size);
+    }
+
+    constexpr const_reverse_iterator rbegin() const noexcept {
+        return const_reverse_iterator(m_data + m_size);
+    }
+
+    constexpr const_reverse_iterator crbegin() const noexcept {
+        return const_reverse_iterator(m_data + m_size);
+    }
+
+    constexpr reverse_iterator rend() noexcept {
+        return reverse_iterator(m_data);
+    }
+
+    constexpr const_reverse_iterator rend() const noexcept {
+        return const_reverse_iterator(m_data);
+    }
+
+    constexpr const_reverse_iterator crend() const noexcept {
+        return const_reverse_iterator(m_data);
+    }
+
+    // Relational operators
+    constexpr auto operator<=>(const Vector_base &other) const {
+        return std::lexicographical_compare_three_way(m_data, m_data + m_size,
+                                                      other.m_data, other.m_data + other.m_size);
+    }
+
+    constexpr bool operator==(const Vector_base &other) const {
+        return (*this <=> other) == 0;
+    }
+
+    constexpr bool operator!=(const Vector_base &other) const {
+        return !(*this == other);
+    }
+
+protected:
+    pointer m_data;
+    size_type m_size;
+    size_type m_capacity;
+    [[no_unique_address]] allocator_type m_alloc;
+    [[no_unique_address]] Stats m_stats;
+    [[no_unique_address]] Inline_buffer<T, N> m_inline;
+
+    // Empty, on the inline buffer; allocates nothing
+    constexpr explicit Vector_base(const allocator_type &alloc) noexcept
+        : m_data(nullptr), m_size(0), m_capacity(N), m_alloc(alloc) {
+        m_data = m_inline.data();
+    }
+
+    // The derived classes copy and move through the helpers below
+    Vector_base(const Vector_base &) = delete;
+    Vector_base &operator=(const Vector_base &) = delete;
+
+    constexpr ~Vector_base() {
+        release();
+    }
+
+    [[nodiscard]] constexpr bool on_heap() const noexcept {
+        return m_capacity > N;
+    }
+
+    // Copies other's elements into this empty container
+    constexpr void copy_from(const Vector_base &other) {
+        reserve(other.m_size);
+        for (size_type i = 0; i < other.m_size; ++i) {
+            m_data[i] = other.m_data[i];
+        }
+        m_size = other.m_size;
+    }
+
+    // Keeps the buffer unless the allocator being propagated could not free it
+    constexpr void copy_assign(const Vector_base &other) {
+        if constexpr (alloc_traits::propagate_on_container_copy_assignment::value) {
+            if (!mem::equal(m_alloc, other.m_alloc)) release();
+        }
+        mem::copy_assign(m_alloc, other.m_alloc);
+        clear();
+        copy_from(other);
+    }
+
+    constexpr void move_assign(Vector_base &other) noexcept(mem::nothrow_move_assign<Allocator>) {
+        release();
+        if (mem::can_steal(m_alloc, other.m_alloc)) {
+            mem::move_assign(m_alloc, other.m_alloc);
+            take(other);
+        } else {
+            move_from(other);
+        }
+    }
+
+    // Takes other's elements, leaving it empty on its inline buffer; *this must be empty and on
+    // its inline buffer. A heap buffer is stolen, inline elements are moved one by one.
+    constexpr void take(Vector_base &other) noexcept {
+        if (other.on_heap()) {
+            m_data = other.m_data;
+            m_capacity = other.m_capacity;
+        } else {
+            for (size_type i = 0; i < other.m_size; ++i) {
+                m_data[i] = std::move(other.m_data[i]);
+            }
+        }
+        m_size = other.m_size;
+        other.m_data = other.m_inline.data();
+        other.m_size = 0;
+        other.m_capacity = N;
+    }
+
+    // Like take, for a heap buffer this allocator cannot free
+    constexpr void move_from(Vector_base &other) {
+        reserve(other.m_size);
+        for (size_type i = 0; i < other.m_size; ++i) {
+            m_data[i] = std::move(other.m_data[i]);
+        }
+        m_size = other.m_size;
+        other.release();
+    }
+
+    // Frees a heap buffer and goes back to the inline one, empty
+    constexpr void release() noexcept {
+        if (on_heap()) mem::destroy_array(m_alloc, m_data, m_capacity);
+        m_data = m_inline.data();
+        m_size = 0;
+        m_capacity = N;
+    }
+
+    // The range overloads without their iterator constraint, which plain pointers don't meet
+    template<typename InputIt>
+    constexpr void insert_range(const_iterator pos, InputIt first, InputIt last) {
+        const size_type count = it::distance(first, last);
+        if (count == 0) return;
+
+        size_type index = open_gap(pos, count);
+        for (auto it = first; it != last; ++it) {
+            m_data[index++] = *it;
+        }
+    }
+
+    template<typename InputIt>
+    constexpr void assign_range(InputIt first, InputIt last) {
+        clear();
+        reserve(it::distance(first, last));
+        for (auto it = first; it != last; ++it) {
+            m_data[m_size++] = *it;
+        }
+    }
+
+private:
+    // Moves the elements into a heap buffer of exactly new_capacity slots, or into the inline
+    // buffer when they fit there
+    constexpr void relocate(const size_type new_capacity) {
+        const bool to_inline = new_capacity <= N;
+        pointer new_data = to_inline ? m_inline.data() : mem::create_array(m_alloc, new_capacity);
+        for (size_type i = 0; i < m_size; ++i) {
+            new_data[i] = std::move(m_data[i]);
+        }
+        if (on_heap()) mem::destroy_array(m_alloc, m_data, m_capacity);
+        m_data = new_data;
+        m_capacity = to_inline ? N : new_capacity;
+        m_stats.count(Stat::reallocation);
+    }
+
+    constexpr void grow(const size_type min_capacity) {
+        size_type new_capacity = m_capacity ? m_capacity * 2 : 4;
+        while (new_capacity < min_capacity) new_capacity *= 2;
+        relocate(new_capacity);
+    }
+
+    // Shifts [pos, end) right by count and returns the index of the gap
+    constexpr size_type open_gap(const_iterator pos, const size_type count) {
+        const size_type index = pos - cbegin();
+        if (index > m_size) throw std::out_of_range("Index out of range");
+        if (m_size + count > m_capacity) grow(m_size + count);
+
+        for (size_type i = m_size; i > index; --i) {
+            m_data[i + count - 1] = std::move(m_data[i - 1]);
+        }
+        m_size += count;
+        return index;
+    }
+};
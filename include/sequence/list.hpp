@@ -1,15 +1,24 @@
 #pragma once
 #include <algorithm>
 #include <cstddef>
+#include <functional>
 #include <limits>
+#include <stdexcept>
 
 #include "../iterator/iterator_utils.hpp"
 #include "internal/node.hpp"
+#include "internal/node_chain.hpp"
+#include "utils/allocator.hpp"
+#include "utils/stats.hpp"
 
-template<typename T>
+template<typename T, typename Allocator = std::allocator<T>, typename Stats = No_stats>
 class List {
+    using alloc_traits = std::allocator_traits<Allocator>;
+    using node_allocator_type = mem::rebind<Allocator, DNode<T>>;
+
 public:
     using value_type = T;
+    using allocator_type = Allocator;
     using pointer = T *;
     using const_pointer = const T *;
     using reference = T &;
@@ -21,43 +30,57 @@ public:
     using const_reverse_iterator = Reverse_bidirectional_iterator<const T>;
 
     // Constructors
-    List() : m_head(nullptr), m_tail(nullptr), m_size(0) {
+    List() noexcept(noexcept(allocator_type())) : List(allocator_type()) {
     }
 
-    List(const List &other) : List() {
-        auto temp = other.m_head;
-        while (temp) {
-            push_back(temp->value);
-            temp = temp->next;
-        }
+    explicit List(const allocator_type &alloc) noexcept
+        : m_head(nullptr), m_tail(nullptr), m_size(0), m_alloc(alloc) {
+    }
+
+    List(const List &other) : List(other, alloc_traits::select_on_container_copy_construction(other.get_allocator())) {
     }
 
-    List(List &&other) noexcept : m_head(other.m_head), m_tail(other.m_tail), m_size(other.m_size) {
+    List(const List &other, const allocator_type &alloc) : List(alloc) {
+        append_copies(other);
+    }
+
+    List(List &&other) noexcept
+        : m_head(other.m_head), m_tail(other.m_tail), m_size(other.m_size), m_alloc(std::move(other.m_alloc)) {
         other.m_head = nullptr;
         other.m_tail = nullptr;
         other.m_size = 0;
     }
 
+    // Nodes from an unequal allocator cannot be adopted, so the values are moved one by one
+    List(List &&other, const allocator_type &alloc) : List(alloc) {
+        if (mem::equal(m_alloc, other.m_alloc)) {
+            steal(other);
+        } else {
+            move_from(other);
+        }
+    }
+
     template<typename InputIt, typename = std::enable_if_t<it::is_iterator<InputIt>::value> >
-    List(InputIt first, InputIt last) : List() {
+    List(InputIt first, InputIt last, const allocator_type &alloc = allocator_type()) : List(alloc) {
         for (auto it = first; it != last; ++it) {
             push_back(*it);
         }
     }
 
-    List(std::initializer_list<value_type> i_list) : List() {
+    List(std::initializer_list<value_type> i_list, const allocator_type &alloc = allocator_type()) : List(alloc) {
         for (auto &value: i_list) {
             push_back(value);
         }
     }
 
-    explicit List(const size_type count) : List() {
+    explicit List(const size_type count, const allocator_type &alloc = allocator_type()) : List(alloc) {
         for (size_type i = 0; i < count; ++i) {
             push_back(value_type());
         }
     }
 
-    List(const size_type count, const_reference value) : List() {
+    List(const size_type count, const_reference value, const allocator_type &alloc = allocator_type())
+        : List(alloc) {
         for (size_type i = 0; i < count; ++i) {
             push_back(value);
         }
@@ -67,24 +90,21 @@ public:
     List &operator=(const List &other) {
         if (this != &other) {
             clear_data();
-            auto temp = other.m_head;
-            while (temp) {
-                push_back(temp->value);
-                temp = temp->next;
-            }
+            mem::copy_assign(m_alloc, other.m_alloc);
+            append_copies(other);
         }
         return *this;
     }
 
-    List &operator=(List &&other) noexcept {
+    List &operator=(List &&other) noexcept(mem::nothrow_move_assign<Allocator>) {
         if (this != &other) {
             clear_data();
-            m_head = other.m_head;
-            m_tail = other.m_tail;
-            m_size = other.m_size;
-            other.m_head = nullptr;
-            other.m_tail = nullptr;
-            other.m_size = 0;
+            if (mem::can_steal(m_alloc, other.m_alloc)) {
+                mem::move_assign(m_alloc, other.m_alloc);
+                steal(other);
+            } else {
+                move_from(other);
+            }
         }
         return *this;
     }
@@ -100,6 +120,10 @@ public:
     // Destructor
     ~List() { clear_data(); }
 
+    [[nodiscard]] allocator_type get_allocator() const noexcept {
+        return allocator_type(m_alloc);
+    }
+
     // Element access
     reference front() {
         if (!m_head) throw std::out_of_range("List is empty");
@@ -134,10 +158,19 @@ public:
         return m_size == 0;
     }
 
+    // Statistics
+    [[nodiscard]] Sequence_stats stats() const requires Stats::enabled {
+        Sequence_stats out;
+        out.size = m_size;
+        out.capacity = m_size;
+        out.bytes_allocated = m_size * sizeof(DNode<value_type>);
+        return out;
+    }
+
     // Modifiers
     template<typename U>
     void push_front(U &&value) {
-        auto new_node = new DNode<value_type>(std::forward<U>(value));
+        auto new_node = create_node(std::forward<U>(value));
         if (!m_head) {
             m_head = m_tail = new_node;
         } else {
@@ -150,7 +183,7 @@ public:
 
     template<typename U>
     void push_back(U &&value) {
-        auto new_node = new DNode<value_type>(std::forward<U>(value));
+        auto new_node = create_node(std::forward<U>(value));
         if (!m_head) {
             m_head = m_tail = new_node;
         } else {
@@ -169,7 +202,7 @@ public:
         if (m_head) m_head->prev = nullptr;
         else m_tail = nullptr;
 
-        delete temp;
+        destroy_node(temp);
         --m_size;
     }
 
@@ -181,7 +214,7 @@ public:
         if (m_tail) m_tail->next = nullptr;
         else m_head = nullptr;
 
-        delete temp;
+        destroy_node(temp);
         --m_size;
     }
 
@@ -190,7 +223,7 @@ public:
         if (pos == end()) push_back(std::forward<U>(value));
         else if (pos == begin()) push_front(std::forward<U>(value));
         else {
-            auto new_node = new DNode<value_type>(std::forward<U>(value));
+            auto new_node = create_node(std::forward<U>(value));
             DNode<value_type> *current = pos.node();
 
             new_node->next = current;
@@ -216,7 +249,7 @@ public:
         DNode<value_type> *prev_node = current->prev;
 
         for (size_type i = 0; i < count; ++i) {
-            auto new_node = new DNode<value_type>(value);
+            auto new_node = create_node(value);
             new_node->prev = prev_node;
             if (prev_node) prev_node->next = new_node;
             prev_node = new_node; // move prev_node forward
@@ -242,7 +275,7 @@ public:
         DNode<value_type> *prev_node = current->prev;
 
         for (auto &value: i_list) {
-            auto new_node = new DNode<value_type>(value);
+            auto new_node = create_node(value);
             new_node->prev = prev_node;
             if (prev_node) prev_node->next = new_node;
             prev_node = new_node;
@@ -268,7 +301,7 @@ public:
         DNode<value_type> *prev_node = current->prev;
 
         for (auto it = first; it != last; ++it) {
-            auto new_node = new DNode<value_type>(*it);
+            auto new_node = create_node(*it);
             new_node->prev = prev_node;
             if (prev_node) prev_node->next = new_node;
             prev_node = new_node;
@@ -314,11 +347,134 @@ public:
     }
 
     void swap(List& other) noexcept {
+        mem::swap(m_alloc, other.m_alloc);
         std::swap(m_head, other.m_head);
         std::swap(m_tail, other.m_tail);
         std::swap(m_size, other.m_size);
     }
 
+    // Operations. These relink nodes rather than copy values; nodes can only move between lists
+    // whose allocators compare equal.
+
+    // Moves every node of `other` before `pos`
+    void splice(iterator pos, List &other) {
+        if (&other == this || other.empty()) return;
+        check_splice(other);
+
+        link_run(pos.node(), other.m_head, other.m_tail);
+        m_size += other.m_size;
+        other.m_head = other.m_tail = nullptr;
+        other.m_size = 0;
+    }
+
+    // Moves the node at `it` in `other` before `pos`
+    void splice(iterator pos, List &other, iterator it) {
+        DNode<value_type> *node = it.node();
+        if (!node) throw std::out_of_range("Iterator out of range");
+        if (&other == this && (node == pos.node() || node->next == pos.node())) return;
+        check_splice(other);
+
+        unlink_run(other, node, node);
+        link_run(pos.node(), node, node);
+        if (&other != this) {
+            ++m_size;
+            --other.m_size;
+        }
+    }
+
+    // Moves [first, last) of `other` before `pos`. Constant time within one list; otherwise linear
+    // in the length of the range, which has to be counted.
+    void splice(iterator pos, List &other, iterator first, iterator last) {
+        if (first == last) return;
+        check_splice(other);
+
+        DNode<value_type> *head = first.node();
+        DNode<value_type> *tail = last.node() ? last.node()->prev : other.m_tail;
+        if (&other != this) {
+            size_type count = 1;
+            for (auto node = head; node != tail; node = node->next) ++count;
+            m_size += count;
+            other.m_size -= count;
+        }
+        unlink_run(other, head, tail);
+        link_run(pos.node(), head, tail);
+    }
+
+    // Merges the sorted `other` into this sorted list; on ties this list's values come first
+    template<typename Compare = std::less<>>
+    void merge(List &other, Compare comp = Compare{}) {
+        if (&other == this) return;
+        check_splice(other);
+
+        auto less = [&comp](DNode<value_type> *a, DNode<value_type> *b) { return comp(a->value, b->value); };
+        m_head = chain::merge(m_head, other.m_head, less);
+        m_size += other.m_size;
+        other.m_head = other.m_tail = nullptr;
+        other.m_size = 0;
+        relink_prev();
+    }
+
+    // Stable merge sort that relinks nodes in place: O(n log n) comparisons, no allocation. The
+    // nodes are sorted through their next links and the prev links rebuilt in one pass.
+    template<typename Compare = std::less<>>
+    void sort(Compare comp = Compare{}) {
+        m_head = chain::sort(m_head, [&comp](DNode<value_type> *a, DNode<value_type> *b) {
+            return comp(a->value, b->value);
+        });
+        relink_prev();
+    }
+
+    void reverse() noexcept {
+        for (auto node = m_head; node; node = node->prev) {
+            std::swap(node->next, node->prev);
+        }
+        std::swap(m_head, m_tail);
+    }
+
+    // Removes every value after the first of each run of consecutive equal values
+    template<typename BinaryPredicate = std::equal_to<>>
+    size_type unique(BinaryPredicate pred = BinaryPredicate{}) {
+        DNode<value_type> *doomed = nullptr;
+        const size_type old_size = m_size;
+        try {
+            for (auto kept = m_head; kept && kept->next;) {
+                auto node = kept->next;
+                if (pred(kept->value, node->value)) doom(node, doomed);
+                else kept = node;
+            }
+        } catch (...) {
+            destroy_chain(doomed);
+            throw;
+        }
+        destroy_chain(doomed);
+        return old_size - m_size;
+    }
+
+    // Unlinks every matching node first and frees them together once the scan is done, so the
+    // predicate never sees a half-removed list
+    template<typename UnaryPredicate>
+    size_type remove_if(UnaryPredicate pred) {
+        DNode<value_type> *doomed = nullptr;
+        const size_type old_size = m_size;
+        try {
+            for (auto node = m_head; node;) {
+                auto next = node->next;
+                if (pred(node->value)) doom(node, doomed);
+                node = next;
+            }
+        } catch (...) {
+            destroy_chain(doomed);
+            throw;
+        }
+        destroy_chain(doomed);
+        return old_size - m_size;
+    }
+
+    // `value` may be an element of this list
+    size_type remove(const_reference value) {
+        return remove_if([&value](const_reference element) { return element == value; });
+    }
+
     // Iterators
     iterator begin() noexcept {
         return iterator(m_head);
@@ -385,12 +541,95 @@ private:
     DNode<value_type> *m_head;
     DNode<value_type> *m_tail;
     size_type m_size;
+    [[no_unique_address]] node_allocator_type m_alloc;
+
+    template<typename... Args>
+    DNode<value_type> *create_node(Args &&... args) {
+        return mem::create(m_alloc, std::forward<Args>(args)...);
+    }
+
+    void destroy_node(DNode<value_type> *node) noexcept {
+        mem::destroy(m_alloc, node);
+    }
+
+    void check_splice(const List &other) const {
+        if (!mem::equal(m_alloc, other.m_alloc)) {
+            throw std::invalid_argument("Cannot move nodes between lists with unequal allocators");
+        }
+    }
+
+    // Detaches the run [first, last] from `from`, which may be this list
+    static void unlink_run(List &from, DNode<value_type> *first, DNode<value_type> *last) noexcept {
+        if (first->prev) first->prev->next = last->next;
+        else from.m_head = last->next;
+        if (last->next) last->next->prev = first->prev;
+        else from.m_tail = first->prev;
+    }
+
+    // Links the detached run [first, last] before `pos`, or at the back when `pos` is null
+    void link_run(DNode<value_type> *pos, DNode<value_type> *first, DNode<value_type> *last) noexcept {
+        DNode<value_type> *prev = pos ? pos->prev : m_tail;
+        first->prev = prev;
+        last->next = pos;
+        if (prev) prev->next = first;
+        else m_head = first;
+        if (pos) pos->prev = last;
+        else m_tail = last;
+    }
+
+    // Restores the prev links and the tail after the next links were rewired
+    void relink_prev() noexcept {
+        DNode<value_type> *prev = nullptr;
+        for (auto node = m_head; node; node = node->next) {
+            node->prev = prev;
+            prev = node;
+        }
+        m_tail = prev;
+    }
+
+    // Unlinks a node and pushes it onto the chain of nodes waiting to be freed
+    void doom(DNode<value_type> *node, DNode<value_type> *&doomed) noexcept {
+        unlink_run(*this, node, node);
+        node->next = doomed;
+        doomed = node;
+        --m_size;
+    }
+
+    void destroy_chain(DNode<value_type> *node) noexcept {
+        while (node) {
+            auto next = node->next;
+            destroy_node(node);
+            node = next;
+        }
+    }
+
+    void append_copies(const List &other) {
+        for (auto temp = other.m_head; temp; temp = temp->next) {
+            push_back(temp->value);
+        }
+    }
+
+    void steal(List &other) noexcept {
+        m_head = other.m_head;
+        m_tail = other.m_tail;
+        m_size = other.m_size;
+        other.m_head = nullptr;
+        other.m_tail = nullptr;
+        other.m_size = 0;
+    }
+
+    void move_from(List &other) {
+        for (auto temp = other.m_head; temp; temp = temp->next) {
+            push_back(std::move(temp->value));
+        }
+        other.clear_data();
+    }
 
     void clear_data() {
         while (m_head) {
             auto temp = m_head;
             m_head = m_head->next;
-            delete temp;
+            destroy_node(temp);
         }
         m_head = m_tail = nullptr;
         m_size = 0;
@@ -398,7 +637,12 @@ private:
 };
 
 
-template<typename T>
-void swap(List<T>& lhs, List<T>& rhs) noexcept {
+template<typename T, typename Allocator, typename Stats>
+void swap(List<T, Allocator, Stats>& lhs, List<T, Allocator, Stats>& rhs) noexcept {
     lhs.swap(rhs);
-}
\ No newline at end of file
+}
+
+namespace pmr {
+    template<typename T>
+    using List = ::List<T, std::pmr::polymorphic_allocator<T>>;
+}
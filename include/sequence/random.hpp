@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <random>
+#include <type_traits>
+#include <utility>
+
+#include "sequence/array.hpp"
+#include "sequence/vector.hpp"
+
+// Containers filled with uniformly distributed values in [min, max]. Kept out of array.hpp and
+// vector.hpp so that only the code that wants random contents pays for <random>.
+namespace rnd {
+    template<typename T, typename Gen>
+    auto uniform(const T min, const T max, Gen &gen) {
+        if constexpr (std::is_integral_v<T>) return [dist = std::uniform_int_distribution<T>(min, max), &gen]() mutable { return dist(gen); };
+        else return [dist = std::uniform_real_distribution<T>(min, max), &gen]() mutable { return dist(gen); };
+    }
+}
+
+// Sets every element of `array` to a value in [min, max]
+template<typename T, std::size_t N>
+    requires std::is_arithmetic_v<T>
+void fill_uniform(Array<T, N> &array, const T min, const T max) {
+    std::mt19937 gen(std::random_device{}());
+    auto next = rnd::uniform(min, max, gen);
+    for (std::size_t i = 0; i < N; ++i) array[i] = next();
+}
+
+// Appends `count` values in [min, max] to `vector`
+template<typename T, typename Allocator, typename Stats>
+    requires std::is_arithmetic_v<T>
+void append_uniform(Vector<T, Allocator, Stats> &vector, const std::size_t count, const T min, const T max) {
+    std::mt19937 gen(std::random_device{}());
+    auto next = rnd::uniform(min, max, gen);
+    vector.reserve(vector.size() + count);
+    for (std::size_t i = 0; i < count; ++i) vector.push_back(next());
+}
+
+template<typename T, std::size_t N>
+    requires std::is_arithmetic_v<T>
+Array<T, N> random_array(const T min, const T max) {
+    Array<T, N> result;
+    fill_uniform(result, min, max);
+    return result;
+}
+
+template<typename T, typename Allocator = std::allocator<T>>
+    requires std::is_arithmetic_v<T>
+Vector<T, Allocator> random_vector(const std::size_t size, const std::pair<T, T> range, const Allocator &alloc = Allocator()) {
+    Vector<T, Allocator> result(alloc);
+    append_uniform(result, size, range.first, range.second);
+    return result;
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "bit_vector.hpp"
+#include "internal/bit_ops.hpp"
+#include "vector.hpp"
+
+// Rank and select over a Bit_vector, after Vigna's rank9. Every 512-bit block gets two words:
+// the number of ones before the block, and seven 9-bit counts of the ones before each of its
+// later words. rank is then two lookups and a popcount. select narrows a binary search over
+// the blocks with a sample taken every SAMPLE_RATE ones, then finishes inside one block.
+// The index costs 25% of the vector and describes it as it was at construction or at the last
+// rebuild(); it must be rebuilt after the vector changes, and must not outlive it.
+template<typename Allocator = std::allocator<std::uint64_t>>
+class Rank_select {
+public:
+    using size_type = std::size_t;
+    using bit_vector = Bit_vector<Allocator>;
+
+    static constexpr size_type npos = bit_vector::npos;
+
+    explicit Rank_select(const bit_vector &bits)
+        : m_bits(&bits), m_counts(bits.get_allocator()), m_samples(bits.get_allocator()) {
+        rebuild();
+    }
+
+    void rebuild() {
+        const std::uint64_t *words = m_bits->data();
+        const size_type word_count = m_bits->word_count();
+        const size_type blocks = word_count / WORDS_PER_BLOCK + 1;
+
+        m_counts = Vector<std::uint64_t, Allocator>(2 * blocks, m_counts.get_allocator());
+        m_samples.clear();
+        size_type ones = 0;
+        for (size_type block = 0; block < blocks; ++block) {
+            m_counts[2 * block] = ones;
+            std::uint64_t packed = 0;
+            size_type in_block = 0;
+            for (size_type j = 0; j < WORDS_PER_BLOCK; ++j) {
+                if (j) packed |= static_cast<std::uint64_t>(in_block) << (9 * (j - 1));
+                const size_type word = block * WORDS_PER_BLOCK + j;
+                if (word < word_count) in_block += std::popcount(words[word]);
+            }
+            m_counts[2 * block + 1] = packed;
+
+            // Sample s names the block holding the one of rank s * SAMPLE_RATE
+            while (m_samples.size() * SAMPLE_RATE < ones + in_block) m_samples.push_back(block);
+            ones += in_block;
+        }
+        m_ones = ones;
+    }
+
+    // Ones in [0, pos), for pos <= size()
+    [[nodiscard]] size_type rank1(const size_type pos) const noexcept {
+        const size_type word = pos / 64;
+        const size_type block = word / WORDS_PER_BLOCK;
+        size_type rank = m_counts[2 * block] + before_word(block, word % WORDS_PER_BLOCK);
+        if (pos % 64) rank += std::popcount(m_bits->data()[word] & bits::below(pos % 64));
+        return rank;
+    }
+
+    [[nodiscard]] size_type rank0(const size_type pos) const noexcept {
+        return pos - rank1(pos);
+    }
+
+    // Position of the one with `rank` ones before it, or npos when there are not that many
+    [[nodiscard]] size_type select1(size_type rank) const noexcept {
+        if (rank >= m_ones) return npos;
+
+        // The last block starting with at most `rank` ones lies between the two samples
+        size_type low = m_samples[rank / SAMPLE_RATE];
+        size_type high = rank / SAMPLE_RATE + 1 < m_samples.size() ? m_samples[rank / SAMPLE_RATE + 1] + 1 : block_count();
+        while (high - low > 1) {
+            const size_type mid = low + (high - low) / 2;
+            if (m_counts[2 * mid] <= rank) low = mid;
+            else high = mid;
+        }
+        rank -= m_counts[2 * low];
+
+        size_type j = 0;
+        while (j + 1 < WORDS_PER_BLOCK && before_word(low, j + 1) <= rank) ++j;
+        rank -= before_word(low, j);
+        const size_type word = low * WORDS_PER_BLOCK + j;
+        return word * 64 + bits::select(m_bits->data()[word], static_cast<unsigned>(rank));
+    }
+
+    // Position of the zero with `rank` zeros before it, or npos when there are not that many
+    [[nodiscard]] size_type select0(size_type rank) const noexcept {
+        if (rank >= m_bits->size() - m_ones) return npos;
+
+        size_type low = 0;
+        size_type high = block_count();
+        while (high - low > 1) {
+            const size_type mid = low + (high - low) / 2;
+            if (zeros_before_block(mid) <= rank) low = mid;
+            else high = mid;
+        }
+        rank -= zeros_before_block(low);
+
+        size_type j = 0;
+        while (j + 1 < WORDS_PER_BLOCK && (j + 1) * 64 - before_word(low, j + 1) <= rank) ++j;
+        rank -= j * 64 - before_word(low, j);
+        const size_type word = low * WORDS_PER_BLOCK + j;
+        return word * 64 + bits::select(~m_bits->data()[word], static_cast<unsigned>(rank));
+    }
+
+    [[nodiscard]] size_type ones() const noexcept {
+        return m_ones;
+    }
+
+private:
+    static constexpr size_type WORDS_PER_BLOCK = 8;
+    static constexpr size_type SAMPLE_RATE = 8192;
+
+    const bit_vector *m_bits;
+    Vector<std::uint64_t, Allocator> m_counts;
+    Vector<size_type, mem::rebind<Allocator, size_type>> m_samples;
+    size_type m_ones = 0;
+
+    size_type block_count() const noexcept {
+        return m_counts.size() / 2;
+    }
+
+    // Ones in the block before its word `j`
+    size_type before_word(const size_type block, const size_type j) const noexcept {
+        return j ? (m_counts[2 * block + 1] >> (9 * (j - 1))) & 511 : 0;
+    }
+
+    size_type zeros_before_block(const size_type block) const noexcept {
+        return block * WORDS_PER_BLOCK * 64 - m_counts[2 * block];
+    }
+};
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+
+#include "internal/vector_base.hpp"
+
+// Vector with room for N elements inside the object itself. It only allocates once it grows
+// past N, so empty and small instances never touch the heap. Same interface and iterators as
+// Vector, whose operations it shares through Vector_base; iterators and references are
+// invalidated when the elements move between the inline buffer and the heap, and by moving an
+// inline Small_vector. Only the heap buffer comes from the allocator.
+template <typename T, std::size_t N = 8, typename Allocator = std::allocator<T>, typename Stats = No_stats>
+class Small_vector : public Vector_base<T, N, Allocator, Stats> {
+    static_assert(N > 0, "Small_vector needs room for at least one inline element");
+
+    using base = Vector_base<T, N, Allocator, Stats>;
+    using typename base::alloc_traits;
+
+public:
+    using typename base::value_type;
+    using typename base::allocator_type;
+    using typename base::size_type;
+    using typename base::const_reference;
+
+    static constexpr size_type inline_capacity = N;
+
+    // Constructors
+    Small_vector() noexcept(noexcept(allocator_type())) : Small_vector(allocator_type()) {
+    }
+
+    explicit Small_vector(const allocator_type &alloc) noexcept : base(alloc) {
+    }
+
+    Small_vector(const Small_vector &other)
+        : Small_vector(other, alloc_traits::select_on_container_copy_construction(other.m_alloc)) {
+    }
+
+    Small_vector(const Small_vector &other, const allocator_type &alloc) : base(alloc) {
+        this->copy_from(other);
+    }
+
+    // Steals a heap buffer; inline elements are moved one by one
+    Small_vector(Small_vector &&other) noexcept : base(other.m_alloc) {
+        this->take(other);
+    }
+
+    Small_vector(Small_vector &&other, const allocator_type &alloc) : base(alloc) {
+        if (mem::equal(this->m_alloc, other.m_alloc)) {
+            this->take(other);
+        } else {
+            this->move_from(other);
+        }
+    }
+
+    Small_vector(std::initializer_list<value_type> init, const allocator_type &alloc = allocator_type())
+        : base(alloc) {
+        this->assign(init);
+    }
+
+    explicit Small_vector(const size_type count, const allocator_type &alloc = allocator_type())
+        : base(alloc) {
+        this->assign(count, value_type());
+    }
+
+    explicit Small_vector(const size_type count, const_reference value, const allocator_type &alloc = allocator_type())
+        : base(alloc) {
+        this->assign(count, value);
+    }
+
+    template<typename InputIt, typename = std::enable_if_t<std::is_base_of_v<std::input_iterator_tag,
+        typename std::iterator_traits<InputIt>::iterator_category> > >
+    explicit Small_vector(InputIt begin, InputIt end, const allocator_type &alloc = allocator_type())
+        : base(alloc) {
+        this->assign_range(begin, end);
+    }
+
+    // Assignment operator
+    Small_vector &operator=(const Small_vector &other) {
+        if (this != &other) this->copy_assign(other);
+        return *this;
+    }
+
+    Small_vector &operator=(Small_vector &&other) noexcept(mem::nothrow_move_assign<Allocator>) {
+        if (this != &other) this->move_assign(other);
+        return *this;
+    }
+
+    Small_vector &operator=(const std::initializer_list<value_type> &init) {
+        this->assign(init);
+        return *this;
+    }
+
+    // Whether the elements live in the inline buffer
+    [[nodiscard]] bool is_inline() const {
+        return !this->on_heap();
+    }
+};
+
+template<typename T, std::size_t N, typename Allocator, typename Stats>
+void swap(Small_vector<T, N, Allocator, Stats> &lhs, Small_vector<T, N, Allocator, Stats> &rhs) noexcept {
+    lhs.swap(rhs);
+}
+
+namespace pmr {
+    template<typename T, std::size_t N = 8>
+    using Small_vector = ::Small_vector<T, N, std::pmr::polymorphic_allocator<T>>;
+}
@@ -0,0 +1,558 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+
+#include "../iterator/iterator_utils.hpp"
+#include "internal/node.hpp"
+#include "internal/unrolled_list_iterator.hpp"
+#include "utils/allocator.hpp"
+#include "utils/stats.hpp"
+
+// Default number of values per Unrolled_list node: about 512 bytes of payload, at least 4 slots
+template<typename T>
+inline constexpr std::size_t UNROLLED_NODE_CAPACITY = std::max<std::size_t>(4, 512 / sizeof(T));
+
+// Doubly linked list of nodes holding up to K values each, so traversal touches one node per K
+// elements and the link overhead is shared. Same interface as List plus erase. A full node is
+// split in half to make room, and a node that drops below half full after an erase takes values
+// from its successor or is merged into it. Inserting or erasing invalidates iterators into the
+// nodes involved and end(); references elsewhere stay valid.
+template<typename T, std::size_t K = UNROLLED_NODE_CAPACITY<T>, typename Allocator = std::allocator<T>,
+         typename Stats = No_stats>
+class Unrolled_list {
+    static_assert(K >= 2, "Unrolled_list nodes need room for at least two values");
+
+    using alloc_traits = std::allocator_traits<Allocator>;
+    using node_type = Unrolled_node<T, K>;
+    using node_allocator_type = mem::rebind<Allocator, node_type>;
+
+public:
+    using value_type = T;
+    using allocator_type = Allocator;
+    using pointer = T *;
+    using const_pointer = const T *;
+    using reference = T &;
+    using const_reference = const T &;
+    using size_type = std::size_t;
+    using iterator = Unrolled_list_iterator<T, K>;
+    using const_iterator = Unrolled_list_iterator<const T, K>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    static constexpr size_type node_capacity = K;
+
+    // Constructors
+    Unrolled_list() noexcept(noexcept(allocator_type())) : Unrolled_list(allocator_type()) {
+    }
+
+    explicit Unrolled_list(const allocator_type &alloc) noexcept
+        : m_head(nullptr), m_tail(nullptr), m_size(0), m_alloc(alloc) {
+    }
+
+    Unrolled_list(const Unrolled_list &other)
+        : Unrolled_list(other, alloc_traits::select_on_container_copy_construction(other.get_allocator())) {
+    }
+
+    Unrolled_list(const Unrolled_list &other, const allocator_type &alloc) : Unrolled_list(alloc) {
+        append_copies(other);
+    }
+
+    Unrolled_list(Unrolled_list &&other) noexcept
+        : m_head(other.m_head), m_tail(other.m_tail), m_size(other.m_size), m_alloc(std::move(other.m_alloc)) {
+        other.m_head = nullptr;
+        other.m_tail = nullptr;
+        other.m_size = 0;
+    }
+
+    // Nodes from an unequal allocator cannot be adopted, so the values are moved one by one
+    Unrolled_list(Unrolled_list &&other, const allocator_type &alloc) : Unrolled_list(alloc) {
+        if (mem::equal(m_alloc, other.m_alloc)) {
+            steal(other);
+        } else {
+            move_from(other);
+        }
+    }
+
+    template<typename InputIt, typename = std::enable_if_t<it::is_iterator<InputIt>::value> >
+    Unrolled_list(InputIt first, InputIt last, const allocator_type &alloc = allocator_type())
+        : Unrolled_list(alloc) {
+        for (auto it = first; it != last; ++it) {
+            push_back(*it);
+        }
+    }
+
+    Unrolled_list(std::initializer_list<value_type> i_list, const allocator_type &alloc = allocator_type())
+        : Unrolled_list(alloc) {
+        for (auto &value: i_list) {
+            push_back(value);
+        }
+    }
+
+    explicit Unrolled_list(const size_type count, const allocator_type &alloc = allocator_type())
+        : Unrolled_list(alloc) {
+        for (size_type i = 0; i < count; ++i) {
+            emplace_back();
+        }
+    }
+
+    Unrolled_list(const size_type count, const_reference value, const allocator_type &alloc = allocator_type())
+        : Unrolled_list(alloc) {
+        for (size_type i = 0; i < count; ++i) {
+            push_back(value);
+        }
+    }
+
+    // Assignment operator
+    Unrolled_list &operator=(const Unrolled_list &other) {
+        if (this != &other) {
+            clear_data();
+            mem::copy_assign(m_alloc, other.m_alloc);
+            append_copies(other);
+        }
+        return *this;
+    }
+
+    Unrolled_list &operator=(Unrolled_list &&other) noexcept(mem::nothrow_move_assign<Allocator>) {
+        if (this != &other) {
+            clear_data();
+            if (mem::can_steal(m_alloc, other.m_alloc)) {
+                mem::move_assign(m_alloc, other.m_alloc);
+                steal(other);
+            } else {
+                move_from(other);
+            }
+        }
+        return *this;
+    }
+
+    Unrolled_list &operator=(std::initializer_list<value_type> i_list) {
+        assign(i_list);
+        return *this;
+    }
+
+    // Destructor
+    ~Unrolled_list() { clear_data(); }
+
+    [[nodiscard]] allocator_type get_allocator() const noexcept {
+        return allocator_type(m_alloc);
+    }
+
+    // Element access
+    reference front() {
+        if (!m_head) throw std::out_of_range("Unrolled_list is empty");
+        return m_head->data()[0];
+    }
+
+    const_reference front() const {
+        if (!m_head) throw std::out_of_range("Unrolled_list is empty");
+        return m_head->data()[0];
+    }
+
+    reference back() {
+        if (!m_head) throw std::out_of_range("Unrolled_list is empty");
+        return m_tail->data()[m_tail->count - 1];
+    }
+
+    const_reference back() const {
+        if (!m_head) throw std::out_of_range("Unrolled_list is empty");
+        return m_tail->data()[m_tail->count - 1];
+    }
+
+    // Size
+    [[nodiscard]] size_type size() const noexcept {
+        return m_size;
+    }
+
+    [[nodiscard]] size_type max_size() const noexcept {
+        return std::numeric_limits<size_type>::max();
+    }
+
+    [[nodiscard]] bool empty() const noexcept {
+        return m_size == 0;
+    }
+
+    // Statistics; walks the nodes
+    [[nodiscard]] Sequence_stats stats() const requires Stats::enabled {
+        Sequence_stats out;
+        size_type nodes = 0;
+        for (const node_type *node = m_head; node; node = node->next) ++nodes;
+        out.size = m_size;
+        out.capacity = nodes * K;
+        out.block_allocations = m_stats.get(Stat::block_allocation);
+        out.bytes_allocated = nodes * sizeof(node_type);
+        return out;
+    }
+
+    // Modifiers
+    template<typename... Args>
+    iterator emplace(const_iterator pos, Args &&... args) {
+        node_type *node = pos.node();
+        size_type index = pos.index();
+
+        if (!node) {
+            node = link_after(nullptr, create_node());
+            index = 0;
+        } else if (node->count == K) {
+            // Spill into a neighbour with room before splitting, so growing at either end packs
+            // nodes full
+            if (index == 0) {
+                if (node->prev && node->prev->count < K) {
+                    node = node->prev;
+                    index = node->count;
+                } else {
+                    node = link_after(node->prev, create_node());
+                }
+            } else if (index == K) {
+                if (node->next && node->next->count < K) {
+                    node = node->next;
+                } else {
+                    node = link_after(node, create_node());
+                }
+                index = 0;
+            } else {
+                split(node);
+                if (index > K / 2) {
+                    node = node->next;
+                    index -= K / 2;
+                }
+            }
+        }
+
+        construct_at(node, index, std::forward<Args>(args)...);
+        ++m_size;
+        return iterator(node, index);
+    }
+
+    template<typename... Args>
+    reference emplace_front(Args &&... args) {
+        return *emplace(begin(), std::forward<Args>(args)...);
+    }
+
+    template<typename... Args>
+    reference emplace_back(Args &&... args) {
+        return *emplace(end(), std::forward<Args>(args)...);
+    }
+
+    template<typename U>
+    void push_front(U &&value) {
+        emplace(begin(), std::forward<U>(value));
+    }
+
+    template<typename U>
+    void push_back(U &&value) {
+        emplace(end(), std::forward<U>(value));
+    }
+
+    void pop_front() {
+        if (!m_head) throw std::out_of_range("Unrolled_list is empty");
+        erase(begin());
+    }
+
+    // The tail is allowed to run low, so this never moves other values
+    void pop_back() {
+        if (!m_head) throw std::out_of_range("Unrolled_list is empty");
+        std::destroy_at(m_tail->data() + --m_tail->count);
+        --m_size;
+        if (m_tail->count == 0) unlink_and_destroy(m_tail);
+    }
+
+    template<typename U>
+    iterator insert(const_iterator pos, U &&value) {
+        return emplace(pos, std::forward<U>(value));
+    }
+
+    iterator insert(const_iterator pos, const size_type count, const_reference value) {
+        iterator next(pos.node(), pos.index());
+        for (size_type i = 0; i < count; ++i) {
+            next = ++emplace(next, value);
+        }
+        return back_up(next, count);
+    }
+
+    iterator insert(const_iterator pos, std::initializer_list<value_type> i_list) {
+        return insert_range(pos, i_list.begin(), i_list.end());
+    }
+
+    template<typename InputIt, typename = std::enable_if_t<it::is_iterator<InputIt>::value> >
+    iterator insert(const_iterator pos, InputIt first, InputIt last) {
+        return insert_range(pos, first, last);
+    }
+
+    // Returns the position of the value that followed the erased one
+    iterator erase(const_iterator pos) {
+        node_type *node = pos.node();
+        const size_type index = pos.index();
+        T *data = node->data();
+
+        std::move(data + index + 1, data + node->count, data + index);
+        std::destroy_at(data + --node->count);
+        --m_size;
+
+        if (node->count == 0) {
+            node_type *next = node->next;
+            unlink_and_destroy(node);
+            return next ? iterator(next, 0) : end();
+        }
+        if (node->count < K / 2 && node->next) refill(node);
+
+        if (index < node->count || !node->next) return iterator(node, index);
+        return iterator(node->next, 0);
+    }
+
+    iterator erase(const_iterator first, const_iterator last) {
+        // Erasing shifts values within a node, so count first rather than chase `last`
+        auto count = it::distance(first, last);
+        iterator pos(first.node(), first.index());
+        while (count-- > 0) pos = erase(pos);
+        return pos;
+    }
+
+    template<typename U = value_type>
+    void resize(const size_type count, U &&value = U()) {
+        while (m_size < count)
+            push_back(std::forward<U>(value));
+        while (m_size > count)
+            pop_back();
+    }
+
+    void assign(const size_type count, const_reference value) {
+        clear_data();
+        for (size_type i = 0; i < count; ++i) {
+            push_back(value);
+        }
+    }
+
+    void assign(std::initializer_list<value_type> i_list) {
+        clear_data();
+        for (auto &value: i_list) {
+            push_back(value);
+        }
+    }
+
+    template<typename InputIt, typename = std::enable_if_t<it::is_iterator<InputIt>::value> >
+    void assign(InputIt first, InputIt last) {
+        clear_data();
+        for (auto it = first; it != last; ++it) {
+            push_back(*it);
+        }
+    }
+
+    void clear() {
+        clear_data();
+    }
+
+    void swap(Unrolled_list &other) noexcept {
+        mem::swap(m_alloc, other.m_alloc);
+        std::swap(m_head, other.m_head);
+        std::swap(m_tail, other.m_tail);
+        std::swap(m_size, other.m_size);
+    }
+
+    // Iterators
+    iterator begin() noexcept {
+        return iterator(m_head, 0);
+    }
+
+    const_iterator begin() const noexcept {
+        return const_iterator(m_head, 0);
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    iterator end() noexcept {
+        return iterator(m_tail, m_tail ? m_tail->count : 0);
+    }
+
+    const_iterator end() const noexcept {
+        return const_iterator(m_tail, m_tail ? m_tail->count : 0);
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    reverse_iterator rbegin() noexcept {
+        return reverse_iterator(end());
+    }
+
+    reverse_iterator rend() noexcept {
+        return reverse_iterator(begin());
+    }
+
+    const_reverse_iterator rbegin() const noexcept {
+        return const_reverse_iterator(end());
+    }
+
+    const_reverse_iterator rend() const noexcept {
+        return const_reverse_iterator(begin());
+    }
+
+    const_reverse_iterator crbegin() const noexcept {
+        return rbegin();
+    }
+
+    const_reverse_iterator crend() const noexcept {
+        return rend();
+    }
+
+    // Relational operators
+    auto operator<=>(const Unrolled_list &other) const {
+        return std::lexicographical_compare_three_way(begin(), end(), other.begin(), other.end());
+    }
+
+    bool operator==(const Unrolled_list &other) const {
+        return m_size == other.m_size && (*this <=> other) == 0;
+    }
+
+    bool operator!=(const Unrolled_list &other) const {
+        return !(*this == other);
+    }
+
+private:
+    node_type *m_head;
+    node_type *m_tail;
+    size_type m_size;
+    [[no_unique_address]] node_allocator_type m_alloc;
+    [[no_unique_address]] Stats m_stats;
+
+    node_type *create_node() {
+        node_type *node = mem::create(m_alloc);
+        m_stats.count(Stat::block_allocation);
+        return node;
+    }
+
+    void destroy_node(node_type *node) noexcept {
+        std::destroy_n(node->data(), node->count);
+        mem::destroy(m_alloc, node);
+    }
+
+    // Links `node` after `pos`, or at the front when `pos` is null
+    node_type *link_after(node_type *pos, node_type *node) noexcept {
+        node_type *next = pos ? pos->next : m_head;
+        node->prev = pos;
+        node->next = next;
+        if (pos) pos->next = node;
+        else m_head = node;
+        if (next) next->prev = node;
+        else m_tail = node;
+        return node;
+    }
+
+    void unlink_and_destroy(node_type *node) noexcept {
+        if (node->prev) node->prev->next = node->next;
+        else m_head = node->next;
+        if (node->next) node->next->prev = node->prev;
+        else m_tail = node->prev;
+        destroy_node(node);
+    }
+
+    // Builds a value in slot `index` of a node with room, shifting the slots after it up by one
+    template<typename... Args>
+    void construct_at(node_type *node, const size_type index, Args &&... args) {
+        T *data = node->data();
+        if (index == node->count) {
+            std::construct_at(data + index, std::forward<Args>(args)...);
+        } else {
+            // Built first: args may refer to a value that is about to shift
+            value_type value(std::forward<Args>(args)...);
+            std::construct_at(data + node->count, std::move(data[node->count - 1]));
+            std::move_backward(data + index, data + node->count - 1, data + node->count);
+            data[index] = std::move(value);
+        }
+        ++node->count;
+    }
+
+    // Moves the upper half of a full node into a new node after it
+    void split(node_type *node) {
+        node_type *upper = link_after(node, create_node());
+        T *data = node->data() + K / 2;
+        std::uninitialized_move(data, data + (K - K / 2), upper->data());
+        std::destroy_n(data, K - K / 2);
+        node->count = K / 2;
+        upper->count = K - K / 2;
+    }
+
+    // Tops up a node below half full from its successor, merging the two when they fit in one
+    void refill(node_type *node) {
+        node_type *next = node->next;
+        T *data = node->data();
+        T *next_data = next->data();
+        const size_type take = node->count + next->count <= K
+                                   ? next->count
+                                   : (next->count - node->count) / 2;
+
+        std::uninitialized_move(next_data, next_data + take, data + node->count);
+        node->count += take;
+        std::move(next_data + take, next_data + next->count, next_data);
+        std::destroy_n(next_data + next->count - take, take);
+        next->count -= take;
+
+        if (next->count == 0) unlink_and_destroy(next);
+    }
+
+    // Each value is placed right after the previous one. Later splits may move earlier values,
+    // so the first one is found by stepping back from the last.
+    template<typename InputIt>
+    iterator insert_range(const_iterator pos, InputIt first, InputIt last) {
+        iterator next(pos.node(), pos.index());
+        size_type count = 0;
+        for (auto it = first; it != last; ++it, ++count) {
+            next = ++emplace(next, *it);
+        }
+        return back_up(next, count);
+    }
+
+    static iterator back_up(iterator pos, size_type count) {
+        while (count--) --pos;
+        return pos;
+    }
+
+    void append_copies(const Unrolled_list &other) {
+        for (const auto &value: other) {
+            push_back(value);
+        }
+    }
+
+    void steal(Unrolled_list &other) noexcept {
+        m_head = other.m_head;
+        m_tail = other.m_tail;
+        m_size = other.m_size;
+        other.m_head = nullptr;
+        other.m_tail = nullptr;
+        other.m_size = 0;
+    }
+
+    void move_from(Unrolled_list &other) {
+        for (auto &value: other) {
+            push_back(std::move(value));
+        }
+        other.clear_data();
+    }
+
+    void clear_data() {
+        while (m_head) {
+            auto temp = m_head;
+            m_head = m_head->next;
+            destroy_node(temp);
+        }
+        m_head = m_tail = nullptr;
+        m_size = 0;
+    }
+};
+
+
+template<typename T, std::size_t K, typename Allocator, typename Stats>
+void swap(Unrolled_list<T, K, Allocator, Stats>& lhs, Unrolled_list<T, K, Allocator, Stats>& rhs) noexcept {
+    lhs.swap(rhs);
+}
+
+namespace pmr {
+    template<typename T, std::size_t K = UNROLLED_NODE_CAPACITY<T>>
+    using Unrolled_list = ::Unrolled_list<T, K, std::pmr::polymorphic_allocator<T>>;
+}
@@ -1,517 +1,104 @@
 #pragma once
 
-#include <algorithm>
 #include <cstddef>
-#include <limits>
-#include <random>
-#include <stdexcept>
+#include <utility>
 
-#include "iterator/iterator.hpp"
-#include "iterator/iterator_utils.hpp"
+#include "internal/vector_base.hpp"
+
+// Growable array. The storage, growth and element operations live in Vector_base, which
+// Small_vector shares; a Vector has no inline buffer and allocates nothing until the first
+// insertion.
+template <typename T, typename Allocator = std::allocator<T>, typename Stats = No_stats>
+class Vector : public Vector_base<T, 0, Allocator, Stats> {
+    using base = Vector_base<T, 0, Allocator, Stats>;
+    using typename base::alloc_traits;
 
-template <typename T>
-class Vector {
 public:
-    using value_type = T;
-    using pointer = T *;
-    using const_pointer = const T *;
-    using reference = T &;
-    using const_reference = const T &;
-    using size_type = std::size_t;
-    using iterator = Random_access_iterator<T>;
-    using const_iterator = Random_access_iterator<const T>;
-    using reverse_iterator = Reverse_random_access_iterator<T>;
-    using const_reverse_iterator = Reverse_random_access_iterator<const T>;
+    using typename base::value_type;
+    using typename base::allocator_type;
+    using typename base::size_type;
+    using typename base::const_reference;
 
     // Constructors
-    Vector() : m_size(0), m_capacity(4) {
-        m_data = new value_type[m_capacity];
-    }
-
-    Vector(const Vector &other) : m_size(other.m_size), m_capacity(other.m_capacity) {
-        m_data = new value_type[m_capacity];
-        for (size_type i = 0; i < m_size; ++i) {
-            m_data[i] = other.m_data[i];
-        }
+    // Allocates nothing until the first insertion
+    constexpr Vector() noexcept(noexcept(allocator_type())) : Vector(allocator_type()) {
     }
 
-    Vector(Vector &&other) noexcept : m_size(other.m_size), m_capacity(other.m_capacity) {
-        m_data = other.m_data;
-        other.m_size = 0;
-        other.m_capacity = 0;
-        other.m_data = nullptr;
+    constexpr explicit Vector(const allocator_type &alloc) noexcept : base(alloc) {
     }
 
-    Vector(std::initializer_list<value_type> init) {
-        m_size = init.size();
-        m_capacity = m_size * 2;
-        m_data = new value_type[m_capacity];
-        for (size_type i = 0; i < m_size; ++i) {
-            m_data[i] = init.begin()[i];
-        }
+    constexpr Vector(const Vector &other)
+        : Vector(other, alloc_traits::select_on_container_copy_construction(other.m_alloc)) {
     }
 
-    explicit Vector(const size_type count) : m_size(count), m_capacity(count) {
-        m_data = new value_type[m_capacity]();
+    constexpr Vector(const Vector &other, const allocator_type &alloc) : base(alloc) {
+        this->copy_from(other);
     }
 
-    explicit Vector(const size_type count, const_reference value) : m_size(count), m_capacity(count) {
-        m_data = new value_type[m_capacity];
-        for (size_type i = 0; i < m_size; ++i) {
-            m_data[i] = value;
-        }
-    }
-
-    template<typename InputIt, typename = std::enable_if_t<std::is_base_of_v<std::input_iterator_tag,
-        typename std::iterator_traits<InputIt>::iterator_category> > >
-    explicit Vector(InputIt begin, InputIt end) {
-        m_size = 0;
-        m_capacity = it::distance(begin, end) * 2;
-        m_data = new value_type[m_capacity];
-        for (auto it = begin; it != end; ++it) {
-            m_data[m_size++] = *it;
-        }
+    constexpr Vector(Vector &&other) noexcept : base(other.m_alloc) {
+        this->take(other);
     }
 
-    Vector(const size_type size, std::pair<T, T> range) : m_size(size), m_capacity(size * 2) {
-        m_data = new value_type[m_capacity];
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        if constexpr (std::is_integral_v<T>) {
-            std::uniform_int_distribution<T> dis(range.first, range.second);
-            for (size_type i = 0; i < m_size; ++i) {
-                m_data[i] = dis(gen);
-            }
-        } else if constexpr (std::is_floating_point_v<T>) {
-            std::uniform_real_distribution<T> dis(range.first, range.second);
-            for (size_type i = 0; i < m_size; ++i) {
-                m_data[i] = dis(gen);
-            }
+    // Storage from an unequal allocator cannot be adopted, so the elements are moved one by one
+    constexpr Vector(Vector &&other, const allocator_type &alloc) : base(alloc) {
+        if (mem::equal(this->m_alloc, other.m_alloc)) {
+            this->take(other);
         } else {
-            throw std::invalid_argument("Vector size must be integer or floating point type");
-        }
-    }
-
-    // Assignment operator
-    Vector &operator=(const Vector &other) {
-        if (this != &other) {
-            delete[] m_data;
-            m_size = other.m_size;
-            m_capacity = other.m_capacity;
-            m_data = new value_type[m_capacity];
-            for (size_type i = 0; i < m_size; ++i) {
-                m_data[i] = other.m_data[i];
-            }
-        }
-        return *this;
-    }
-
-    Vector &operator=(Vector &&other) noexcept {
-        if (this != &other) {
-            delete[] m_data;
-            m_size = other.m_size;
-            m_capacity = other.m_capacity;
-            m_data = other.m_data;
-            other.m_size = 0;
-            other.m_capacity = 0;
-            other.m_data = nullptr;
-        }
-        return *this;
-    }
-
-    Vector &operator=(const std::initializer_list<value_type> &init) {
-        delete[] m_data;
-        m_size = init.size();
-        m_capacity = m_size * 2;
-        m_data = new value_type[m_capacity];
-        for (size_type i = 0; i < m_size; ++i) {
-            m_data[i] = init.begin()[i];
-        }
-        return *this;
-    }
-
-    // Destructor
-    ~Vector() {
-        delete[] m_data;
-    }
-
-    // Element access
-    reference operator[](size_type index) {
-        return m_data[index];
-    }
-
-    const_reference operator[](size_type index) const {
-        return m_data[index];
-    }
-
-    reference at(size_type index) {
-        if (index >= m_size) throw std::out_of_range("Index out of range");
-        return m_data[index];
-    }
-
-    const_reference at(size_type index) const {
-        if (index >= m_size) throw std::out_of_range("Index out of range");
-        return m_data[index];
-    }
-
-    reference front() {
-        if (m_size == 0) throw std::runtime_error("Vector is empty");
-        return m_data[0];
-    }
-
-    const_reference front() const {
-        if (m_size == 0) throw std::runtime_error("Vector is empty");
-        return m_data[0];
-    }
-
-    reference back() {
-        if (m_size == 0) throw std::runtime_error("Vector is empty");
-        return m_data[m_size - 1];
-    }
-
-    const_reference back() const {
-        if (m_size == 0) throw std::runtime_error("Vector is empty");
-        return m_data[m_size - 1];
-    }
-
-    [[nodiscard]] pointer data() {
-        return m_data;
-    }
-
-    [[nodiscard]] const_pointer data() const {
-        return m_data;
-    }
-
-    // Capacity & size
-    [[nodiscard]] bool empty() const {
-        return m_size == 0;
-    }
-
-    [[nodiscard]] size_type size() const {
-        return m_size;
-    }
-
-    [[nodiscard]] size_type max_size() const {
-        return std::numeric_limits<size_type>::max() / (sizeof(value_type) * 2);
-    }
-
-    [[nodiscard]] size_type capacity() const {
-        return m_capacity;
-    }
-
-    void reserve(const size_type new_capacity) {
-        if (new_capacity > m_capacity) {
-            auto new_data = new value_type[new_capacity];
-            for (size_type i = 0; i < m_size; ++i) {
-                new_data[i] = m_data[i];
-            }
-            delete[] m_data;
-            m_data = new_data;
-            m_capacity = new_capacity;
-        }
-    }
-
-    void shrink_to_fit() {
-        if (m_size == m_capacity) return;
-
-        auto new_data = new value_type[m_size];
-        for (size_type i = 0; i < m_size; ++i) {
-            new_data[i] = std::move(m_data[i]);
-        }
-        delete[] m_data;
-        m_data = new_data;
-        m_capacity = m_size;
-    }
-
-    // Modifiers
-    template<typename U>
-    void push_back(U &&value) {
-        if (m_size == m_capacity) resize_data(m_size * 2);
-        m_data[m_size++] = std::forward<U>(value);
-    }
-
-    void pop_back() {
-        if (m_size == 0) throw std::runtime_error("Vector is empty");
-        m_size--;
-    }
-
-    void insert(const_iterator pos, const_reference value) {
-        const size_type index = pos - cbegin();
-        if (index > m_size) throw std::out_of_range("Index out of range");
-        if (m_size == m_capacity) resize_data(m_size * 2);
-
-        for (size_type i = m_size; i > index; --i) {
-            m_data[i] = std::move(m_data[i - 1]);
-        }
-
-        m_data[index] = value;
-        ++m_size;
-    }
-
-    void insert(const_iterator pos, value_type &&value) {
-        const size_type index = pos - cbegin();
-        if (index > m_size) throw std::out_of_range("Index out of range");
-        if (m_size == m_capacity) resize_data(m_size * 2);
-
-        for (size_type i = m_size; i > index; --i) {
-            m_data[i] = std::move(m_data[i - 1]);
-        }
-
-        m_data[index] = std::move(value);
-        ++m_size;
-    }
-
-    void insert(const_iterator pos, const size_type count, const_reference value) {
-        if (count == 0) return;
-
-        const size_type index = pos - cbegin();
-        if (index > m_size) throw std::out_of_range("Index out of range");
-        if (m_size + count > m_capacity) resize_data(m_size + count);
-
-        for (size_type i = m_size; i > index; --i) {
-            m_data[i + count - 1] = std::move(m_data[i - 1]);
-        }
-
-        for (size_type i = 0; i < count; ++i) {
-            m_data[index + i] = value;
+            this->move_from(other);
         }
-        m_size += count;
     }
 
-    template<typename InputIt, typename = std::enable_if_t<it::is_iterator<InputIt>::value> >
-    void insert(const_iterator pos, InputIt first, InputIt last) {
-        const size_type count = it::distance(first, last);
-        if (count == 0) return;
-
-        const size_type index = pos - cbegin();
-        if (index > m_size) throw std::out_of_range("Index out of range");
-        if (m_size + count > m_capacity) resize_data(m_size + count);
-
-        for (size_type i = m_size; i > index; --i) {
-            m_data[i + count - 1] = std::move(m_data[i - 1]);
-        }
-
-        size_type j = 0;
-        for (auto it = first; it != last; ++it) {
-            m_data[index + j++] = *it;
-        }
-        m_size += count;
-    }
-
-    void insert(const_iterator pos, std::initializer_list<T> i_list) {
-        const size_type count = i_list.size();
-        if (count == 0) return;
-
-        const size_type index = pos - cbegin();
-        if (index > m_size) throw std::out_of_range("Index out of range");
-        if (m_size + count > m_capacity) resize_data(m_size + count);
-
-        for (size_type i = m_size; i > index; --i) {
-            m_data[i + count - 1] = std::move(m_data[i - 1]);
-        }
-
-        size_type j = 0;
-        for (size_type i = 0; i < count; ++i) {
-            m_data[index + i] = i_list.begin()[j++];
-        }
-        m_size += count;
-    }
-
-    void resize(const size_type count, const_reference value = value_type()) {
-        if (count < m_size) {
-            m_size = count;
-        } else if (count > m_size) {
-            if (count > m_capacity) {
-                const size_type new_capacity = std::max(count, m_capacity * 2 + 1);
-                auto new_data = new value_type[new_capacity];
-
-                for (size_type i = 0; i < m_size; ++i) {
-                    new_data[i] = std::move(m_data[i]);
-                }
-
-                delete[] m_data;
-                m_data = new_data;
-                m_capacity = new_capacity;
-            }
-
-            for (size_type i = m_size; i < count; ++i) {
-                m_data[i] = value;
-            }
-            m_size = count;
-        }
-    }
-
-    template<typename... Args>
-    void emplace(const_iterator pos, Args &&... args) {
-        const size_type index = pos - cbegin();
-        if (index > m_size) throw std::out_of_range("Index out of range");
-        if (m_size == m_capacity) resize_data(m_size * 2);
-
-        for (size_type i = m_size; i > index; --i) {
-            m_data[i] = std::move(m_data[i - 1]);
-        }
-
-        m_data[index] = value_type(std::forward<Args>(args)...);
-        ++m_size;
-    }
-
-    template<typename... Args>
-    void emplace_back(Args &&... args) {
-        if (m_size == m_capacity) resize_data(m_size * 2);
-        push_back(value_type(std::forward<Args>(args)...));
-    }
-
-    iterator erase(const_iterator pos) {
-        size_type index = pos - cbegin();
-        if (index > m_size) throw std::out_of_range("Index out of range");
-
-        for (size_type i = index; i < m_size - 1; ++i) {
-            m_data[i] = std::move(m_data[i + 1]);
-        }
-
-        --m_size;
-        return iterator(m_data + index);
-    }
-
-    iterator erase(const_iterator first, const_iterator last) {
-        if (first > last || first < cbegin() || last > cend())
-            throw std::out_of_range("Index out of range");
-
-        size_type index = first - cbegin();
-        const size_type count = last - first;
-
-        if (!count) return iterator(m_data + index);
-
-        for (size_type i = index; i + count < m_size; ++i) {
-            m_data[i] = std::move(m_data[i + count]);
-        }
-        m_size -= count;
-
-        return iterator(m_data + index);
-    }
-
-    void clear() {
-        m_size = 0;
-    }
-
-    void assign(const size_type count, const_reference value) {
-        clear();
-        if (count > m_size) resize_data(count);
-
-        for (size_type i = 0; i < count; ++i) {
-            m_data[i] = value;
-        }
-        m_size = count;
-    }
-
-    template<typename InputIt, typename = std::enable_if_t<it::is_iterator<InputIt>::value> >
-    void assign(InputIt first, InputIt last) {
-        clear();
-        auto count = std::distance(first, last);
-        if (count > m_size) resize_data(count);
-
-        for (auto it = first; it != last; ++it) {
-            m_data[m_size++] = *it;
-        }
+    constexpr Vector(std::initializer_list<value_type> init, const allocator_type &alloc = allocator_type())
+        : base(alloc) {
+        this->assign(init);
     }
 
-    void assign(std::initializer_list<value_type> i_list) {
-        assign(i_list.begin(), i_list.end());
+    constexpr explicit Vector(const size_type count, const allocator_type &alloc = allocator_type())
+        : base(alloc) {
+        this->assign(count, value_type());
     }
 
-    void swap(Vector &other) noexcept {
-        std::swap(m_data, other.m_data);
-        std::swap(m_size, other.m_size);
-        std::swap(m_capacity, other.m_capacity);
+    constexpr explicit Vector(const size_type count, const_reference value, const allocator_type &alloc = allocator_type())
+        : base(alloc) {
+        this->assign(count, value);
     }
 
-    // Iterators
-    iterator begin() noexcept {
-        return iterator(m_data);
-    }
-
-    const_iterator begin() const noexcept {
-        return const_iterator(m_data);
-    }
-
-    const_iterator cbegin() const noexcept {
-        return const_iterator(m_data);
-    }
-
-    iterator end() noexcept {
-        return iterator(m_data + m_size);
-    }
-
-    const_iterator end() const noexcept {
-        return const_iterator(m_data + m_size);
-    }
-
-    const_iterator cend() const noexcept {
-        return const_iterator(m_data + m_size);
-    }
-
-    reverse_iterator rbegin() noexcept {
-        return reverse_iterator(m_data + m_size);
-    }
-
-    const_reverse_iterator rbegin() const noexcept {
-        return const_reverse_iterator(m_data + m_size);
-    }
-
-    const_reverse_iterator crbegin() const noexcept {
-        return const_reverse_iterator(m_data + m_size);
-    }
-
-    reverse_iterator rend() noexcept {
-        return reverse_iterator(m_data);
-    }
-
-    const_reverse_iterator rend() const noexcept {
-        return const_reverse_iterator(m_data);
-    }
-
-    const_reverse_iterator crend() const noexcept {
-        return const_reverse_iterator(m_data);
+    template<typename InputIt, typename = std::enable_if_t<std::is_base_of_v<std::input_iterator_tag,
+        typename std::iterator_traits<InputIt>::iterator_category> > >
+    constexpr explicit Vector(InputIt begin, InputIt end, const allocator_type &alloc = allocator_type()) : base(alloc) {
+        this->assign_range(begin, end);
     }
 
-    // Relational operators
-    auto operator<=>(const Vector &other) const {
-        return std::lexicographical_compare_three_way(m_data, m_data + m_size,
-                                                      other.m_data, other.m_data + other.m_size);
+    // Deprecated: the fill lives in sequence/random.hpp so that this header doesn't pull in
+    // <random>, and this constructor only compiles where that header is included too
+    [[deprecated("use random_vector from sequence/random.hpp, which this constructor needs included")]]
+    Vector(const size_type size, std::pair<T, T> range, const allocator_type &alloc = allocator_type()) : Vector(alloc) {
+        append_uniform(*this, size, range.first, range.second);
     }
 
-    bool operator==(const Vector &other) const {
-        return (*this <=> other) == 0;
+    // Assignment operator
+    constexpr Vector &operator=(const Vector &other) {
+        if (this != &other) this->copy_assign(other);
+        return *this;
     }
 
-    bool operator!=(const Vector &other) const {
-        return !(*this == other);
+    constexpr Vector &operator=(Vector &&other) noexcept(mem::nothrow_move_assign<Allocator>) {
+        if (this != &other) this->move_assign(other);
+        return *this;
     }
 
-private:
-    pointer m_data;
-    size_type m_size;
-    size_type m_capacity;
-
-    // Helper function to resize internal storage
-    void resize_data(const size_type min_capacity = 0) {
-        if (m_capacity == 0) m_capacity = 4;
-
-        while (m_capacity < min_capacity) {
-            m_capacity *= 2;
-        }
-
-        auto new_data = new value_type[m_capacity];
-
-        for (size_type i = 0; i < m_size; ++i)
-            new_data[i] = std::move(m_data[i]);
-
-        delete[] m_data;
-        m_data = new_data;
+    constexpr Vector &operator=(const std::initializer_list<value_type> &init) {
+        this->assign(init);
+        return *this;
     }
 };
 
-template<typename T>
-void swap(Vector<T> &lhs, Vector<T> &rhs) noexcept {
+template<typename T, typename Allocator, typename Stats>
+constexpr void swap(Vector<T, Allocator, Stats> &lhs, Vector<T, Allocator, Stats> &rhs) noexcept {
     lhs.swap(rhs);
-}
\ No newline at end of file
+}
+
+namespace pmr {
+    template<typename T>
+    using Vector = ::Vector<T, std::pmr::polymorphic_allocator<T>>;
+}
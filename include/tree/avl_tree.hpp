@@ -1,14 +1,22 @@
 #pragma once
 
-#include <iostream>
+#include <algorithm>
+#include <iosfwd>
+#include <stdexcept>
 
 #include "internal/nodes/avl_node.hpp"
-#include "adaptors/queue.hpp"
+#include "internal/traversal.hpp"
+#include "utils/allocator.hpp"
+#include "utils/stats.hpp"
 
-template<typename T>
+template<typename T, typename Allocator = std::allocator<T>, typename Stats = No_stats>
 class AVL_tree {
+    using alloc_traits = std::allocator_traits<Allocator>;
+    using node_allocator_type = mem::rebind<Allocator, AVLNode<T>>;
+
 public:
     using value_type = T;
+    using allocator_type = Allocator;
     using pointer = T *;
     using const_pointer = const T *;
     using reference = T &;
@@ -16,15 +24,23 @@ public:
     using size_type = size_t;
 
     // Constructors
-    AVL_tree() : m_root(nullptr), m_size(0) {
+    AVL_tree() noexcept(noexcept(allocator_type())) : AVL_tree(allocator_type()) {
+    }
+
+    explicit AVL_tree(const allocator_type &alloc) noexcept : m_root(nullptr), m_size(0), m_alloc(alloc) {
     }
 
-    AVL_tree(const AVL_tree &other) : AVL_tree() {
+    AVL_tree(const AVL_tree &other)
+        : AVL_tree(other, alloc_traits::select_on_container_copy_construction(other.get_allocator())) {
+    }
+
+    AVL_tree(const AVL_tree &other, const allocator_type &alloc) : AVL_tree(alloc) {
         m_root = copy_nodes(other.m_root);
         m_size = other.m_size;
     }
 
-    AVL_tree(AVL_tree &&other) noexcept : m_root(other.m_root), m_size(other.m_size) {
+    AVL_tree(AVL_tree &&other) noexcept
+        : m_root(other.m_root), m_size(other.m_size), m_alloc(std::move(other.m_alloc)) {
         other.m_root = nullptr;
         other.m_size = 0;
     }
@@ -32,19 +48,29 @@ public:
     // Assignment operator
     AVL_tree &operator=(const AVL_tree &other) {
         if (this != &other) {
-            clear_data();
+            clear();
+            mem::copy_assign(m_alloc, other.m_alloc);
             m_root = copy_nodes(other.m_root);
             m_size = other.m_size;
         }
         return *this;
     }
 
-    AVL_tree &operator=(AVL_tree &&other) noexcept {
+    // Nodes from an unequal allocator cannot be adopted, so they are copied and the source cleared
+    AVL_tree &operator=(AVL_tree &&other) noexcept(mem::nothrow_move_assign<Allocator>) {
         if (this != &other) {
-            m_root = other.m_root;
-            m_size = other.m_size;
-            other.m_root = nullptr;
-            other.m_size = 0;
+            clear();
+            if (mem::can_steal(m_alloc, other.m_alloc)) {
+                mem::move_assign(m_alloc, other.m_alloc);
+                m_root = other.m_root;
+                m_size = other.m_size;
+                other.m_root = nullptr;
+                other.m_size = 0;
+            } else {
+                m_root = copy_nodes(other.m_root);
+                m_size = other.m_size;
+                other.clear();
+            }
         }
         return *this;
     }
@@ -54,6 +80,10 @@ public:
         clear_data(m_root);
     }
 
+    [[nodiscard]] allocator_type get_allocator() const noexcept {
+        return allocator_type(m_alloc);
+    }
+
     // Modifiers
     void insert(const_reference value) {
         m_root = insert_node(m_root, value);
@@ -113,78 +143,105 @@ public:
         return leaf_count_helper(m_root);
     }
 
+    // Checks every invariant: strict search order, the stored heights, balance factors within
+    // one and the size. Throws std::logic_error at the first violation. Linear time, for tests
+    // and fuzzing.
+    void validate() const {
+        size_type count = 0;
+        validate_helper(m_root, nullptr, nullptr, count);
+        if (count != m_size) throw std::logic_error("AVL tree: size does not match the node count");
+    }
+
+    // Statistics
+    [[nodiscard]] Tree_stats stats() const requires Stats::enabled {
+        Tree_stats out;
+        out.size = m_size;
+        out.height = height();
+        out.rotations = m_stats.get(Stat::rotation);
+        out.bytes_allocated = m_size * sizeof(AVLNode<value_type>);
+        return out;
+    }
+
     // Traversals
-    void inorder() const {
-        inorder_helper(m_root);
-        std::cout << std::endl;
+    template<typename F>
+    bool for_each_inorder(F &&f) const {
+        return tr::inorder(m_root, f);
     }
 
-    void preorder() const {
-        preorder_helper(m_root);
-        std::cout << std::endl;
+    template<typename F>
+    bool for_each_preorder(F &&f) const {
+        return tr::preorder(m_root, f);
     }
 
-    void postorder() const {
-        postorder_helper(m_root);
-        std::cout << std::endl;
+    template<typename F>
+    bool for_each_postorder(F &&f) const {
+        return tr::postorder(m_root, f);
     }
 
-    void level_order() const {
-        level_order_helper(m_root);
-        std::cout << std::endl;
+    template<typename F>
+    bool for_each_level_order(F &&f) const {
+        return tr::balanced_level_order(m_root, f);
     }
 
-private:
-    AVLNode<value_type> *m_root;
-    size_type m_size;
+    // Deprecated printers, forwarding to the print_* helpers of tree/tree_print.hpp, which
+    // callers now include so that this header doesn't pull in <iostream>
+    [[deprecated("use print_inorder from tree/tree_print.hpp")]] void inorder() const {
+        print_inorder(*this);
+    }
 
-    void clear_data(AVLNode<value_type> *node) {
-        if (!node) return;
-        clear_data(node->left);
-        clear_data(node->right);
-        delete node;
+    [[deprecated("use print_inorder from tree/tree_print.hpp")]] void inorder(std::ostream &os) const {
+        print_inorder(*this, os);
     }
 
-    void inorder_helper(AVLNode<value_type> *node) const {
-        if (!node) return;
-        inorder_helper(node->left);
-        std::cout << node->value << " ";
-        inorder_helper(node->right);
+    [[deprecated("use print_preorder from tree/tree_print.hpp")]] void preorder() const {
+        print_preorder(*this);
     }
 
-    void preorder_helper(AVLNode<value_type> *node) const {
-        if (!node) return;
-        std::cout << node->value << " ";
-        preorder_helper(node->left);
-        preorder_helper(node->right);
+    [[deprecated("use print_preorder from tree/tree_print.hpp")]] void preorder(std::ostream &os) const {
+        print_preorder(*this, os);
     }
 
-    void postorder_helper(AVLNode<value_type> *node) const {
-        if (!node) return;
-        postorder_helper(node->left);
-        postorder_helper(node->right);
-        std::cout << node->value << " ";
+    [[deprecated("use print_postorder from tree/tree_print.hpp")]] void postorder() const {
+        print_postorder(*this);
     }
 
-    void level_order_helper(AVLNode<value_type> *node) const {
-        if (!node) return;
+    [[deprecated("use print_postorder from tree/tree_print.hpp")]] void postorder(std::ostream &os) const {
+        print_postorder(*this, os);
+    }
 
-        Queue<AVLNode<value_type> *> q;
-        q.push(node);
-        while (!q.empty()) {
-            auto current = q.front();
-            q.pop();
-            std::cout << current->value << " ";
+    [[deprecated("use print_level_order from tree/tree_print.hpp")]] void level_order() const {
+        print_level_order(*this);
+    }
 
-            if (current->left) q.push(current->left);
-            if (current->right) q.push(current->right);
-        }
+    [[deprecated("use print_level_order from tree/tree_print.hpp")]] void level_order(std::ostream &os) const {
+        print_level_order(*this, os);
+    }
+
+private:
+    AVLNode<value_type> *m_root;
+    size_type m_size;
+    [[no_unique_address]] node_allocator_type m_alloc;
+    [[no_unique_address]] Stats m_stats;
+
+    AVLNode<value_type> *create_node(const_reference value) {
+        return mem::create(m_alloc, value);
+    }
+
+    void destroy_node(AVLNode<value_type> *node) noexcept {
+        mem::destroy(m_alloc, node);
+    }
+
+    void clear_data(AVLNode<value_type> *node) {
+        if (!node) return;
+        clear_data(node->left);
+        clear_data(node->right);
+        destroy_node(node);
     }
 
     AVLNode<value_type> *copy_nodes(AVLNode<value_type> *node) {
         if (!node) return nullptr;
 
-        auto new_node = new AVLNode<value_type>(node->value);
+        auto new_node = create_node(node->value);
         new_node->height = node->height;
         new_node->left = copy_nodes(node->left);
         new_node->right = copy_nodes(node->right);
@@ -194,7 +251,7 @@ private:
     AVLNode<value_type> *insert_node(AVLNode<value_type> *node, const_reference value) {
         if (!node) {
             ++m_size;
-            return new AVLNode<value_type>(value);
+            return create_node(value);
         }
 
         if (value < node->value) {
@@ -227,7 +284,7 @@ private:
 
         // RL case
         if (balance < -1 && value < node->right->value) {
-            node->right = rotate_right(node);
+            node->right = rotate_right(node->right);
             return rotate_left(node);
         }
 
@@ -244,13 +301,13 @@ private:
         } else {
             if (!node->left) {
                 auto rightChild = node->right;
-                delete node;
+                destroy_node(node);
                 --m_size;
                 return rightChild;
             }
             if (!node->right) {
                 auto leftChild = node->left;
-                delete node;
+                destroy_node(node);
                 --m_size;
                 return leftChild;
             }
@@ -296,6 +353,26 @@ private:
         return node ? get_height(node->left) - get_height(node->right) : 0;
     }
 
+    // Returns the height of the subtree, whose values must lie strictly between low and high
+    int validate_helper(const AVLNode<value_type> *node, const_pointer low, const_pointer high, size_type &count) const {
+        if (!node) return 0;
+        ++count;
+
+        if ((low && !(*low < node->value)) || (high && !(node->value < *high))) {
+            throw std::logic_error("AVL tree: values out of search order");
+        }
+
+        const int left_height = validate_helper(node->left, low, &node->value, count);
+        const int right_height = validate_helper(node->right, &node->value, high, count);
+        if (node->height != 1 + std::max(left_height, right_height)) {
+            throw std::logic_error("AVL tree: stored height is stale");
+        }
+        if (left_height - right_height > 1 || right_height - left_height > 1) {
+            throw std::logic_error("AVL tree property violation: unbalanced node");
+        }
+        return node->height;
+    }
+
     size_type leaf_count_helper(AVLNode<value_type> *node) const {
         if (!node) return 0;
         if (!node->left && !node->right) return 1;
@@ -303,6 +380,7 @@ private:
     }
 
     AVLNode<value_type> *rotate_left(AVLNode<value_type> *x) {
+        m_stats.count(Stat::rotation);
         auto y = x->right;
         auto T2 = y->left;
 
@@ -316,6 +394,7 @@ private:
     }
 
     AVLNode<value_type> *rotate_right(AVLNode<value_type> *y) {
+        m_stats.count(Stat::rotation);
         AVLNode<value_type> *x = y->left;
         AVLNode<value_type> *T2 = x->right;
 
@@ -328,3 +407,8 @@ private:
         return x;
     }
 };
+
+namespace pmr {
+    template<typename T>
+    using AVL_tree = ::AVL_tree<T, std::pmr::polymorphic_allocator<T>>;
+}
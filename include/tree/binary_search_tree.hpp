@@ -1,14 +1,20 @@
 #pragma once
 
-#include <iostream>
+#include <iosfwd>
 
 #include "internal/nodes/t_node.hpp"
-#include "adaptors/queue.hpp"
+#include "internal/traversal.hpp"
+#include "utils/allocator.hpp"
+#include "utils/stats.hpp"
 
-template<typename T>
+template<typename T, typename Allocator = std::allocator<T>, typename Stats = No_stats>
 class Binary_search_tree {
+    using alloc_traits = std::allocator_traits<Allocator>;
+    using node_allocator_type = mem::rebind<Allocator, TNode<T>>;
+
 public:
     using value_type = T;
+    using allocator_type = Allocator;
     using pointer = T *;
     using const_pointer = const T *;
     using reference = T &;
@@ -16,14 +22,23 @@ public:
     using size_type = size_t;
 
     // Constructors
-    Binary_search_tree() : m_root(nullptr), m_size(0) {}
+    Binary_search_tree() noexcept(noexcept(allocator_type())) : Binary_search_tree(allocator_type()) {
+    }
+
+    explicit Binary_search_tree(const allocator_type &alloc) noexcept : m_root(nullptr), m_size(0), m_alloc(alloc) {
+    }
+
+    Binary_search_tree(const Binary_search_tree &other)
+        : Binary_search_tree(other, alloc_traits::select_on_container_copy_construction(other.get_allocator())) {
+    }
 
-    Binary_search_tree(const Binary_search_tree &other) : Binary_search_tree() {
+    Binary_search_tree(const Binary_search_tree &other, const allocator_type &alloc) : Binary_search_tree(alloc) {
         m_root = copy_nodes(other.m_root);
         m_size = other.m_size;
     }
 
-    Binary_search_tree(Binary_search_tree &&other) noexcept : m_root(other.m_root), m_size(other.m_size) {
+    Binary_search_tree(Binary_search_tree &&other) noexcept
+        : m_root(other.m_root), m_size(other.m_size), m_alloc(std::move(other.m_alloc)) {
         other.m_root = nullptr;
         other.m_size = 0;
     }
@@ -31,20 +46,29 @@ public:
     // Assignment operator
     Binary_search_tree &operator=(const Binary_search_tree &other) {
         if (this != &other) {
-            clear_data();
+            clear();
+            mem::copy_assign(m_alloc, other.m_alloc);
             m_root = copy_nodes(other.m_root);
             m_size = other.m_size;
         }
         return *this;
     }
 
-    Binary_search_tree &operator=(Binary_search_tree &&other) noexcept {
+    // Nodes from an unequal allocator cannot be adopted, so they are copied and the source cleared
+    Binary_search_tree &operator=(Binary_search_tree &&other) noexcept(mem::nothrow_move_assign<Allocator>) {
         if (this != &other) {
-            clear_data();
-            m_root = other.m_root;
-            m_size = other.m_size;
-            other.m_root = nullptr;
-            other.m_size = 0;
+            clear();
+            if (mem::can_steal(m_alloc, other.m_alloc)) {
+                mem::move_assign(m_alloc, other.m_alloc);
+                m_root = other.m_root;
+                m_size = other.m_size;
+                other.m_root = nullptr;
+                other.m_size = 0;
+            } else {
+                m_root = copy_nodes(other.m_root);
+                m_size = other.m_size;
+                other.clear();
+            }
         }
         return *this;
     }
@@ -54,9 +78,13 @@ public:
         clear_data(m_root);
     }
 
+    [[nodiscard]] allocator_type get_allocator() const noexcept {
+        return allocator_type(m_alloc);
+    }
+
     // Modifiers
     void insert(const_reference value) {
-        auto new_node = new TNode<value_type>(value);
+        auto new_node = create_node(value);
         if (!m_root) {
             m_root = new_node;
             ++m_size;
@@ -83,8 +111,8 @@ public:
         ++m_size;
     }
 
-    auto remove(const_reference value) {
-        return remove_node(m_root, value);
+    void remove(const_reference value) {
+        m_root = remove_node(m_root, value);
     }
 
     void clear() {
@@ -141,72 +169,90 @@ public:
         return leaf_count_helper(m_root);
     }
 
+    // Statistics
+    [[nodiscard]] Tree_stats stats() const requires Stats::enabled {
+        Tree_stats out;
+        out.size = m_size;
+        out.height = height();
+        out.bytes_allocated = m_size * sizeof(TNode<value_type>);
+        return out;
+    }
+
     // Traversals
-    void inorder() const {
-        inorder_helper(m_root);
-        std::cout << std::endl;
+    template<typename F>
+    bool for_each_inorder(F &&f) const {
+        return tr::inorder(m_root, f);
     }
 
-    void preorder() const {
-        preorder_helper(m_root);
-        std::cout << std::endl;
+    template<typename F>
+    bool for_each_preorder(F &&f) const {
+        return tr::preorder(m_root, f);
     }
 
-    void postorder() const {
-        postorder_helper(m_root);
-        std::cout << std::endl;
+    template<typename F>
+    bool for_each_postorder(F &&f) const {
+        return tr::postorder(m_root, f);
     }
 
-    void level_order() const {
-        level_order_helper(m_root);
-        std::cout << std::endl;
+    // The tree may be degenerate, so this keeps to the breadth-first walk, which allocates once a
+    // level holds more than tr::STACK_CAPACITY nodes
+    template<typename F>
+    bool for_each_level_order(F &&f) const {
+        return tr::level_order(m_root, f);
     }
 
-private:
-    TNode<value_type> *m_root;
-    size_type m_size;
+    // Deprecated printers, forwarding to the print_* helpers of tree/tree_print.hpp, which
+    // callers now include so that this header doesn't pull in <iostream>
+    [[deprecated("use print_inorder from tree/tree_print.hpp")]] void inorder() const {
+        print_inorder(*this);
+    }
 
-    void clear_data(TNode<value_type> *node) {
-        if (!node) return;
-        clear_data(node->left);
-        clear_data(node->right);
-        delete node;
+    [[deprecated("use print_inorder from tree/tree_print.hpp")]] void inorder(std::ostream &os) const {
+        print_inorder(*this, os);
     }
 
-    void inorder_helper(TNode<value_type> *node) const {
-        if (!node) return;
-        inorder_helper(node->left);
-        std::cout << node->value << " ";
-        inorder_helper(node->right);
+    [[deprecated("use print_preorder from tree/tree_print.hpp")]] void preorder() const {
+        print_preorder(*this);
     }
 
-    void preorder_helper(TNode<value_type> *node) const {
-        if (!node) return;
-        std::cout << node->value << " ";
-        preorder_helper(node->left);
-        preorder_helper(node->right);
+    [[deprecated("use print_preorder from tree/tree_print.hpp")]] void preorder(std::ostream &os) const {
+        print_preorder(*this, os);
     }
 
-    void postorder_helper(TNode<value_type> *node) const {
-        if (!node) return;
-        postorder_helper(node->left);
-        postorder_helper(node->right);
-        std::cout << node->value << " ";
+    [[deprecated("use print_postorder from tree/tree_print.hpp")]] void postorder() const {
+        print_postorder(*this);
     }
 
-    void level_order_helper(TNode<value_type> *node) const {
-        if (!node) return;
+    [[deprecated("use print_postorder from tree/tree_print.hpp")]] void postorder(std::ostream &os) const {
+        print_postorder(*this, os);
+    }
 
-        Queue<TNode<value_type> *> q;
-        q.push(node);
-        while (!q.empty()) {
-            auto current = q.front();
-            q.pop();
-            std::cout << current->value << " ";
+    [[deprecated("use print_level_order from tree/tree_print.hpp")]] void level_order() const {
+        print_level_order(*this);
+    }
 
-            if (current->left) q.push(current->left);
-            if (current->right) q.push(current->right);
-        }
+    [[deprecated("use print_level_order from tree/tree_print.hpp")]] void level_order(std::ostream &os) const {
+        print_level_order(*this, os);
+    }
+
+private:
+    TNode<value_type> *m_root;
+    size_type m_size;
+    [[no_unique_address]] node_allocator_type m_alloc;
+
+    TNode<value_type> *create_node(const_reference value) {
+        return mem::create(m_alloc, value);
+    }
+
+    void destroy_node(TNode<value_type> *node) noexcept {
+        mem::destroy(m_alloc, node);
+    }
+
+    void clear_data(TNode<value_type> *node) {
+        if (!node) return;
+        clear_data(node->left);
+        clear_data(node->right);
+        destroy_node(node);
     }
 
     size_type height_helper(TNode<value_type> *node) const {
@@ -222,9 +268,9 @@ private:
         return leaf_count_helper(node->left) + leaf_count_helper(node->right);
     }
 
-    auto copy_nodes(TNode<value_type> *node) {
+    TNode<value_type> *copy_nodes(TNode<value_type> *node) {
         if (!node) return nullptr;
-        auto new_node = new TNode<value_type>(node->value);
+        auto new_node = create_node(node->value);
         new_node->left = copy_nodes(node->left);
         new_node->right = copy_nodes(node->right);
         return new_node;
@@ -240,13 +286,13 @@ private:
         } else {
             if (!node->left) {
                 auto rightChild = node->right;
-                delete node;
+                destroy_node(node);
                 --m_size;
                 return rightChild;
             }
             if (!node->right) {
                 auto leftChild = node->left;
-                delete node;
+                destroy_node(node);
                 --m_size;
                 return leftChild;
             }
@@ -259,3 +305,8 @@ private:
         return node;
     }
 };
+
+namespace pmr {
+    template<typename T>
+    using Binary_search_tree = ::Binary_search_tree<T, std::pmr::polymorphic_allocator<T>>;
+}
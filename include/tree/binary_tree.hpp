@@ -1,13 +1,21 @@
 #pragma once
 
-#include <iostream>
+#include <bit>
+#include <iosfwd>
+
 #include "internal/nodes/t_node.hpp"
-#include "adaptors/queue.hpp"
+#include "internal/traversal.hpp"
+#include "utils/allocator.hpp"
+#include "utils/stats.hpp"
 
-template<typename T>
+template<typename T, typename Allocator = std::allocator<T>, typename Stats = No_stats>
 class Binary_tree {
+    using alloc_traits = std::allocator_traits<Allocator>;
+    using node_allocator_type = mem::rebind<Allocator, TNode<T>>;
+
 public:
     using value_type = T;
+    using allocator_type = Allocator;
     using pointer = T *;
     using const_pointer = const T *;
     using reference = T &;
@@ -15,15 +23,23 @@ public:
     using size_type = size_t;
 
     // Constructors
-    Binary_tree() : m_root(nullptr), m_size(0) {
+    Binary_tree() noexcept(noexcept(allocator_type())) : Binary_tree(allocator_type()) {
+    }
+
+    explicit Binary_tree(const allocator_type &alloc) noexcept : m_root(nullptr), m_size(0), m_alloc(alloc) {
     }
 
-    Binary_tree(const Binary_tree &other) : Binary_tree() {
+    Binary_tree(const Binary_tree &other)
+        : Binary_tree(other, alloc_traits::select_on_container_copy_construction(other.get_allocator())) {
+    }
+
+    Binary_tree(const Binary_tree &other, const allocator_type &alloc) : Binary_tree(alloc) {
         m_root = copy_nodes(other.m_root);
         m_size = other.m_size;
     }
 
-    Binary_tree(Binary_tree &&other) noexcept : m_root(other.m_root), m_size(other.m_size) {
+    Binary_tree(Binary_tree &&other) noexcept
+        : m_root(other.m_root), m_size(other.m_size), m_alloc(std::move(other.m_alloc)) {
         other.m_root = nullptr;
         other.m_size = 0;
     }
@@ -32,19 +48,28 @@ public:
     Binary_tree &operator=(const Binary_tree &other) {
         if (this != &other) {
             clear();
+            mem::copy_assign(m_alloc, other.m_alloc);
             m_root = copy_nodes(other.m_root);
             m_size = other.m_size;
         }
         return *this;
     }
 
-    Binary_tree &operator=(Binary_tree &&other) noexcept {
+    // Nodes from an unequal allocator cannot be adopted, so they are copied and the source cleared
+    Binary_tree &operator=(Binary_tree &&other) noexcept(mem::nothrow_move_assign<Allocator>) {
         if (this != &other) {
             clear();
-            m_root = other.m_root;
-            m_size = other.m_size;
-            other.m_root = nullptr;
-            other.m_size = 0;
+            if (mem::can_steal(m_alloc, other.m_alloc)) {
+                mem::move_assign(m_alloc, other.m_alloc);
+                m_root = other.m_root;
+                m_size = other.m_size;
+                other.m_root = nullptr;
+                other.m_size = 0;
+            } else {
+                m_root = copy_nodes(other.m_root);
+                m_size = other.m_size;
+                other.clear();
+            }
         }
         return *this;
     }
@@ -52,80 +77,38 @@ public:
     // Destructor
     ~Binary_tree() { clear(); }
 
-    // Modifiers
+    [[nodiscard]] allocator_type get_allocator() const noexcept {
+        return allocator_type(m_alloc);
+    }
+
+    // Modifiers. Insertion fills the first free slot in level order and removal moves the last
+    // node into the gap, so the tree stays complete and neither needs more than a walk down one
+    // path
     void insert(const_reference value) {
-        auto new_node = new TNode<value_type>(value);
         if (!m_root) {
-            m_root = new_node;
+            m_root = create_node(value);
             ++m_size;
             return;
         }
-
-        Queue<TNode<value_type> *> q;
-        q.push(m_root);
-        while (!q.empty()) {
-            auto current = q.front();
-            q.pop();
-
-            if (!current->left) {
-                current->left = new_node;
-                ++m_size;
-                return;
-            }
-            q.push(current->left);
-
-            if (!current->right) {
-                current->right = new_node;
-                ++m_size;
-                return;
-            }
-            q.push(current->right);
-        }
+        const size_type position = m_size + 1;
+        TNode<value_type> *parent = node_at(position / 2);
+        (position % 2 ? parent->right : parent->left) = create_node(value);
+        ++m_size;
     }
 
     bool remove(const_reference value) {
-        if (!m_root) return false;
+        TNode<value_type> *found = find_node(value);
+        if (!found) return false;
 
-        if (m_root->value == value && m_size == 1) {
-            delete m_root;
+        TNode<value_type> *last = node_at(m_size);
+        if (found != last) found->value = std::move(last->value);
+        if (m_size == 1) {
             m_root = nullptr;
-            m_size = 0;
-            return true;
-        }
-
-        Queue<TNode<value_type> *> q;
-        q.push(m_root);
-
-        TNode<value_type> *node_to_delete = nullptr;
-        TNode<value_type> *last_node = nullptr;
-        TNode<value_type> *last_node_parent = nullptr;
-
-        while (!q.empty()) {
-            auto current = q.front();
-            q.pop();
-            if (current->value == value) node_to_delete = current;
-
-            if (current->left) {
-                last_node_parent = current;
-                q.push(current->left);
-            }
-            if (current->right) {
-                last_node_parent = current;
-                q.push(current->right);
-            }
-
-            last_node = current;
-        }
-
-        if (!node_to_delete) return false;
-        node_to_delete->value = last_node->value;
-        if (last_node_parent) {
-            if (last_node_parent->right == last_node)
-                last_node_parent->right = nullptr;
-            else if (last_node_parent->left == last_node)
-                last_node_parent->left = nullptr;
+        } else {
+            TNode<value_type> *parent = node_at(m_size / 2);
+            (m_size % 2 ? parent->right : parent->left) = nullptr;
         }
-        delete last_node;
+        destroy_node(last);
         --m_size;
         return true;
     }
@@ -154,83 +137,113 @@ public:
     }
 
     bool contains(const_reference value) const {
-        if (!m_root) return false;
-        Queue<TNode<value_type> *> q;
-        q.push(m_root);
-        while (!q.empty()) {
-            auto current = q.front();
-            q.pop();
-            if (current->value == value) return true;
-            if (current->left) q.push(current->left);
-            if (current->right) q.push(current->right);
-        }
-        return false;
+        return find_node(value) != nullptr;
+    }
+
+    // Statistics
+    [[nodiscard]] Tree_stats stats() const requires Stats::enabled {
+        Tree_stats out;
+        out.size = m_size;
+        out.height = height();
+        out.bytes_allocated = m_size * sizeof(TNode<value_type>);
+        return out;
     }
 
     // Traversals
-    void inorder() const {
-        inorder_helper(m_root);
-        std::cout << std::endl;
+    template<typename F>
+    bool for_each_inorder(F &&f) const {
+        return tr::inorder(m_root, f);
     }
 
-    void preorder() const {
-        preorder_helper(m_root);
-        std::cout << std::endl;
+    template<typename F>
+    bool for_each_preorder(F &&f) const {
+        return tr::preorder(m_root, f);
     }
 
-    void postorder() const {
-        postorder_helper(m_root);
-        std::cout << std::endl;
+    template<typename F>
+    bool for_each_postorder(F &&f) const {
+        return tr::postorder(m_root, f);
     }
 
-    void level_order() const {
-        level_order_helper(m_root);
-        std::cout << std::endl;
+    // The tree is complete, so the deepening walk costs O(n) and allocates nothing
+    template<typename F>
+    bool for_each_level_order(F &&f) const {
+        return tr::balanced_level_order(m_root, f);
+    }
+
+    // Deprecated printers, forwarding to the print_* helpers of tree/tree_print.hpp, which
+    // callers now include so that this header doesn't pull in <iostream>
+    [[deprecated("use print_inorder from tree/tree_print.hpp")]] void inorder() const {
+        print_inorder(*this);
+    }
+
+    [[deprecated("use print_inorder from tree/tree_print.hpp")]] void inorder(std::ostream &os) const {
+        print_inorder(*this, os);
+    }
+
+    [[deprecated("use print_preorder from tree/tree_print.hpp")]] void preorder() const {
+        print_preorder(*this);
+    }
+
+    [[deprecated("use print_preorder from tree/tree_print.hpp")]] void preorder(std::ostream &os) const {
+        print_preorder(*this, os);
+    }
+
+    [[deprecated("use print_postorder from tree/tree_print.hpp")]] void postorder() const {
+        print_postorder(*this);
+    }
+
+    [[deprecated("use print_postorder from tree/tree_print.hpp")]] void postorder(std::ostream &os) const {
+        print_postorder(*this, os);
+    }
+
+    [[deprecated("use print_level_order from tree/tree_print.hpp")]] void level_order() const {
+        print_level_order(*this);
+    }
+
+    [[deprecated("use print_level_order from tree/tree_print.hpp")]] void level_order(std::ostream &os) const {
+        print_level_order(*this, os);
     }
 
 private:
     TNode<value_type> *m_root;
     size_type m_size;
+    [[no_unique_address]] node_allocator_type m_alloc;
 
-    void clear_data(TNode<value_type> *node) {
-        if (!node) return;
-        clear_data(node->left);
-        clear_data(node->right);
-        delete node;
+    TNode<value_type> *create_node(const_reference value) {
+        return mem::create(m_alloc, value);
     }
 
-    void inorder_helper(TNode<value_type> *node) const {
-        if (!node) return;
-        inorder_helper(node->left);
-        std::cout << node->value << " ";
-        inorder_helper(node->right);
+    void destroy_node(TNode<value_type> *node) noexcept {
+        mem::destroy(m_alloc, node);
     }
 
-    void preorder_helper(TNode<value_type> *node) const {
+    void clear_data(TNode<value_type> *node) {
         if (!node) return;
-        std::cout << node->value << " ";
-        preorder_helper(node->left);
-        preorder_helper(node->right);
+        clear_data(node->left);
+        clear_data(node->right);
+        destroy_node(node);
     }
 
-    void postorder_helper(TNode<value_type> *node) const {
-        if (!node) return;
-        postorder_helper(node->left);
-        postorder_helper(node->right);
-        std::cout << node->value << " ";
+    // The node at level-order position `position`, counting the root as 1: the bits of position
+    // below its leading one spell the path from the root, 0 for left and 1 for right
+    TNode<value_type> *node_at(const size_type position) const {
+        TNode<value_type> *node = m_root;
+        for (int bit = std::bit_width(position) - 2; bit >= 0; --bit) {
+            node = (position >> bit) & 1 ? node->right : node->left;
+        }
+        return node;
     }
 
-    void level_order_helper(TNode<value_type> *node) const {
-        if (!node) return;
-        Queue<TNode<value_type> *> q;
-        q.push(node);
-        while (!q.empty()) {
-            auto current = q.front();
-            q.pop();
-            std::cout << current->value << " ";
-            if (current->left) q.push(current->left);
-            if (current->right) q.push(current->right);
-        }
+    // A complete tree is at most 64 levels deep, so the walk stays within its inline path stack
+    TNode<value_type> *find_node(const_reference value) const {
+        TNode<value_type> *found = nullptr;
+        tr::preorder_with_depth(m_root, static_cast<std::size_t>(-1), [&](TNode<value_type> *node, std::size_t) {
+            if (!(node->value == value)) return true;
+            found = node;
+            return false;
+        });
+        return found;
     }
 
     size_type height_helper(TNode<value_type> *node) const {
@@ -246,9 +259,14 @@ private:
 
     TNode<value_type> *copy_nodes(TNode<value_type> *node) {
         if (!node) return nullptr;
-        auto new_node = new TNode<value_type>(node->value);
+        auto new_node = create_node(node->value);
         new_node->left = copy_nodes(node->left);
         new_node->right = copy_nodes(node->right);
         return new_node;
     }
-};
\ No newline at end of file
+};
+
+namespace pmr {
+    template<typename T>
+    using Binary_tree = ::Binary_tree<T, std::pmr::polymorphic_allocator<T>>;
+}
@@ -1,28 +1,71 @@
 #pragma once
 
+#include <cstdint>
+
 enum class Color { RED, BLACK };
 
+// The color lives in the low bit of the parent pointer; nodes are at least pointer-aligned,
+// so that bit is always zero in a real address.
 template<typename T>
 struct RBNode {
+    explicit RBNode(const T &val) : value(val) {}
+
+    RBNode *parent() const {
+        return reinterpret_cast<RBNode *>(m_parent_color & ~COLOR_BIT);
+    }
+
+    void set_parent(RBNode *node) {
+        m_parent_color = reinterpret_cast<std::uintptr_t>(node) | (m_parent_color & COLOR_BIT);
+    }
 
-    // Constructor for NIL node
-    RBNode()
-        : color(Color::BLACK),
-          parent(this),
-          left(this),
-          right(this) {}
-
-    // Constructor for regular nodes
-    explicit RBNode(const T &val, RBNode *nil)
-        : value(val),
-          color(Color::RED),
-          parent(nil),
-          left(nil),
-          right(nil) {}
+    Color color() const {
+        return static_cast<Color>(m_parent_color & COLOR_BIT);
+    }
+
+    void set_color(Color color) {
+        m_parent_color = (m_parent_color & ~COLOR_BIT) | static_cast<std::uintptr_t>(color);
+    }
 
     T value;
-    Color color;
-    RBNode *parent;
-    RBNode *left;
-    RBNode *right;
+    RBNode *left = nullptr;
+    RBNode *right = nullptr;
+
+private:
+    static constexpr std::uintptr_t COLOR_BIT = 1;
+
+    std::uintptr_t m_parent_color = 0; // parent | color, new nodes are red
+};
+
+// Pool-resident node with 32-bit links: indices into the pool, NO_INDEX for none.
+// The parent index is stored shifted left by one to make room for the color bit.
+template<typename T>
+struct RBIndexNode {
+    static constexpr std::uint32_t NO_INDEX = 0x7FFFFFFF;
+
+    RBIndexNode() = default;
+
+    explicit RBIndexNode(const T &val) : value(val) {}
+
+    std::uint32_t parent() const {
+        return m_parent_color >> 1;
+    }
+
+    void set_parent(std::uint32_t index) {
+        m_parent_color = (index << 1) | (m_parent_color & 1u);
+    }
+
+    Color color() const {
+        return static_cast<Color>(m_parent_color & 1u);
+    }
+
+    void set_color(Color color) {
+        m_parent_color = (m_parent_color & ~1u) | static_cast<std::uint32_t>(color);
+    }
+
+    T value{};
+    std::uint32_t left = NO_INDEX;
+    std::uint32_t right = NO_INDEX;
+
+private:
+    std::uint32_t m_parent_color = NO_INDEX << 1;
 };
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+
+#include "nodes/red_black_node.hpp"
+#include "sequence/vector.hpp"
+#include "utils/allocator.hpp"
+
+// Link modes for Red_black_tree
+struct Pointer_links {}; // one heap node per element, children are pointers
+struct Index_links {};   // nodes live in a contiguous pool, children are 32-bit indices
+
+// Owns the nodes of a Red_black_tree and gives the tree uniform access to them through handles.
+// The empty handle `nil` is always black. Moving a store assumes the allocators allow it; the tree
+// checks that before it adopts another tree's nodes.
+template<typename T, typename Links, typename Allocator = std::allocator<T>>
+class RB_node_store;
+
+template<typename T, typename Allocator>
+class RB_node_store<T, Pointer_links, Allocator> {
+public:
+    using node_type = RBNode<T>;
+    using handle = node_type *;
+
+    static constexpr bool pooled = false;
+    static constexpr handle nil = nullptr;
+
+    explicit RB_node_store(const Allocator &alloc) noexcept : m_alloc(alloc) {
+    }
+
+    RB_node_store(const RB_node_store &) = default;
+    RB_node_store(RB_node_store &&) noexcept = default;
+
+    // The nodes belong to the tree, so assignment only hands over the allocator when it propagates
+    RB_node_store &operator=(const RB_node_store &other) noexcept {
+        mem::copy_assign(m_alloc, other.m_alloc);
+        return *this;
+    }
+
+    RB_node_store &operator=(RB_node_store &&other) noexcept {
+        mem::move_assign(m_alloc, other.m_alloc);
+        return *this;
+    }
+
+    [[nodiscard]] Allocator get_allocator() const noexcept {
+        return Allocator(m_alloc);
+    }
+
+    handle create(const T &value) {
+        return mem::create(m_alloc, value);
+    }
+
+    void destroy(handle node) {
+        mem::destroy(m_alloc, node);
+    }
+
+    void clear() noexcept {}
+
+    void swap(RB_node_store &other) noexcept {
+        mem::swap(m_alloc, other.m_alloc);
+    }
+
+    // One node per live element
+    [[nodiscard]] std::size_t bytes_allocated(const std::size_t live) const {
+        return live * sizeof(node_type);
+    }
+
+    const T &value(handle node) const { return node->value; }
+
+    handle left(handle node) const { return node->left; }
+    handle right(handle node) const { return node->right; }
+    handle parent(handle node) const { return node->parent(); }
+    Color color(handle node) const { return node == nil ? Color::BLACK : node->color(); }
+
+    void set_left(handle node, handle child) { node->left = child; }
+    void set_right(handle node, handle child) { node->right = child; }
+    void set_parent(handle node, handle parent) { node->set_parent(parent); }
+    void set_color(handle node, Color color) { node->set_color(color); }
+
+private:
+    [[no_unique_address]] mem::rebind<Allocator, node_type> m_alloc;
+};
+
+template<typename T, typename Allocator>
+class RB_node_store<T, Index_links, Allocator> {
+public:
+    using node_type = RBIndexNode<T>;
+    using handle = std::uint32_t;
+    using size_type = std::size_t;
+
+    static constexpr bool pooled = true;
+    static constexpr handle nil = node_type::NO_INDEX;
+
+    explicit RB_node_store(const Allocator &alloc) noexcept : m_pool(alloc) {
+    }
+
+    RB_node_store(const RB_node_store &) = default;
+
+    RB_node_store(RB_node_store &&other) noexcept
+        : m_pool(std::move(other.m_pool)), m_free(std::exchange(other.m_free, nil)) {
+    }
+
+    RB_node_store &operator=(const RB_node_store &) = default;
+
+    RB_node_store &operator=(RB_node_store &&other) noexcept(mem::nothrow_move_assign<Allocator>) {
+        m_pool = std::move(other.m_pool);
+        m_free = std::exchange(other.m_free, nil);
+        return *this;
+    }
+
+    [[nodiscard]] Allocator get_allocator() const noexcept {
+        return Allocator(m_pool.get_allocator());
+    }
+
+    // Freed slots are chained through their left link and reused before the pool grows
+    handle create(const T &value) {
+        if (m_free != nil) {
+            const handle node = m_free;
+            m_free = m_pool[node].left;
+            m_pool[node] = node_type(value);
+            return node;
+        }
+        if (m_pool.size() >= nil) throw std::length_error("Red_black_tree node pool is full");
+        m_pool.push_back(node_type(value));
+        return static_cast<handle>(m_pool.size() - 1);
+    }
+
+    // The value is reset so that a free slot doesn't keep the erased value's resources alive
+    void destroy(handle node) {
+        m_pool[node].value = T{};
+        m_pool[node].left = m_free;
+        m_free = node;
+    }
+
+    void clear() noexcept {
+        m_pool.clear();
+        m_free = nil;
+    }
+
+    void swap(RB_node_store &other) noexcept {
+        m_pool.swap(other.m_pool);
+        std::swap(m_free, other.m_free);
+    }
+
+    [[nodiscard]] size_type capacity() const {
+        return m_pool.capacity();
+    }
+
+    // The whole pool, free slots included
+    [[nodiscard]] size_type bytes_allocated(size_type) const {
+        return m_pool.capacity() * sizeof(node_type);
+    }
+
+    void reserve(const size_type count) {
+        m_pool.reserve(count);
+    }
+
+    const T &value(handle node) const { return m_pool[node].value; }
+
+    handle left(handle node) const { return m_pool[node].left; }
+    handle right(handle node) const { return m_pool[node].right; }
+    handle parent(handle node) const { return m_pool[node].parent(); }
+    Color color(handle node) const { return node == nil ? Color::BLACK : m_pool[node].color(); }
+
+    void set_left(handle node, handle child) { m_pool[node].left = child; }
+    void set_right(handle node, handle child) { m_pool[node].right = child; }
+    void set_parent(handle node, handle parent) { m_pool[node].set_parent(parent); }
+    void set_color(handle node, Color color) { m_pool[node].set_color(color); }
+
+private:
+    Vector<node_type, mem::rebind<Allocator, node_type>> m_pool;
+    handle m_free = nil;
+};
@@ -0,0 +1,273 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "sequence/small_vector.hpp"
+#include "utils/visitor.hpp"
+
+// Iterative traversals shared by the trees. None of them modifies the tree, so they are safe to
+// use from const members: a visitor may throw, call back into the tree's const members, or run
+// alongside other readers.
+// Trees without parent links keep the path from the root on an explicit stack instead. It holds
+// one node per level inside the walker's frame and only spills to the heap past
+// STACK_CAPACITY levels, which an AVL tree reaches only beyond 2^44 nodes.
+// Visitors receive each value as a const reference and may return false to stop early; the
+// traversals return false when that happened.
+namespace tr {
+    inline constexpr std::size_t STACK_CAPACITY = 64;
+
+    template<typename Node>
+    using Node_stack = Small_vector<Node *, STACK_CAPACITY>;
+
+    // Preorder walk that does not descend below max_depth and reports the depth of every node
+    // (root has depth 0). f(node, depth) returns false to stop.
+    template<typename Node, typename F>
+    bool preorder_with_depth(Node *root, const std::size_t max_depth, F &&f) {
+        if (!root) return true;
+        Node_stack<Node> path; // the ancestors of node, so its size is node's depth
+        Node *node = root;
+
+        while (true) {
+            if (!f(node, path.size())) return false;
+
+            if (path.size() < max_depth && node->left) {
+                path.push_back(node);
+                node = node->left;
+                continue;
+            }
+            if (path.size() < max_depth && node->right) {
+                path.push_back(node);
+                node = node->right;
+                continue;
+            }
+
+            // Climb to the closest ancestor with an unvisited right subtree
+            while (true) {
+                if (path.empty()) return true;
+                Node *parent = path.back();
+                if (node == parent->left && parent->right) {
+                    node = parent->right;
+                    break;
+                }
+                node = parent;
+                path.pop_back();
+            }
+        }
+    }
+
+    template<typename Node, typename F>
+    bool preorder(Node *root, F &&f) {
+        return preorder_with_depth(root, static_cast<std::size_t>(-1), [&f](Node *node, std::size_t) {
+            return invoke_visitor(f, std::as_const(node->value));
+        });
+    }
+
+    template<typename Node, typename F>
+    bool inorder(Node *root, F &&f) {
+        Node_stack<Node> stack;
+        Node *node = root;
+
+        while (node || !stack.empty()) {
+            for (; node; node = node->left) stack.push_back(node);
+            node = stack.back();
+            stack.pop_back();
+            if (!invoke_visitor(f, std::as_const(node->value))) return false;
+            node = node->right;
+        }
+        return true;
+    }
+
+    template<typename Node, typename F>
+    bool postorder(Node *root, F &&f) {
+        if (!root) return true;
+        Node_stack<Node> path;
+
+        // First node in postorder below `node`: keep descending, preferring the left child
+        const auto deepest = [&path](Node *node) {
+            while (true) {
+                if (node->left) {
+                    path.push_back(node);
+                    node = node->left;
+                } else if (node->right) {
+                    path.push_back(node);
+                    node = node->right;
+                } else {
+                    return node;
+                }
+            }
+        };
+
+        Node *node = deepest(root);
+        while (true) {
+            if (!invoke_visitor(f, std::as_const(node->value))) return false;
+
+            if (path.empty()) return true;
+            Node *parent = path.back();
+            if (node == parent->left && parent->right) {
+                node = deepest(parent->right);
+            } else {
+                node = parent;
+                path.pop_back();
+            }
+        }
+    }
+
+    // Breadth-first, one level at a time: O(n) time on any shape, and memory for the two widest
+    // adjacent levels. Each level is kept in a Node_stack, so unlike the other walks this one
+    // allocates from the global heap once a level is wider than STACK_CAPACITY nodes; trees
+    // that are known to be balanced use balanced_level_order, which never allocates
+    template<typename Node, typename F>
+    bool level_order(Node *root, F &&f) {
+        if (!root) return true;
+        Node_stack<Node> levels[2];
+        levels[0].push_back(root);
+
+        for (std::size_t depth = 0; !levels[depth % 2].empty(); ++depth) {
+            Node_stack<Node> &current = levels[depth % 2];
+            Node_stack<Node> &next = levels[(depth + 1) % 2];
+            for (Node *node : current) {
+                if (!invoke_visitor(f, std::as_const(node->value))) return false;
+                if (node->left) next.push_back(node->left);
+                if (node->right) next.push_back(node->right);
+            }
+            current.clear();
+        }
+        return true;
+    }
+
+    // Level order by iterative deepening, for balanced trees only: each pass stops at the level
+    // it emits, so the passes cost O(n) in total and need no more than the path stack, but on a
+    // degenerate tree they would cost O(n * height)
+    template<typename Node, typename F>
+    bool balanced_level_order(Node *root, F &&f) {
+        for (std::size_t level = 0;; ++level) {
+            bool reached = false;
+            const bool running = preorder_with_depth(root, level, [&](Node *node, std::size_t depth) {
+                if (depth != level) return true;
+                reached = true;
+                return invoke_visitor(f, std::as_const(node->value));
+            });
+            if (!running) return false;
+            if (!reached) return true;
+        }
+    }
+
+    // Traversals for trees whose nodes link back to their parent. `links` exposes the empty
+    // handle `nil` and left/right/parent/value for a handle. Nothing is modified while walking.
+
+    // Preorder walk that does not descend below max_depth; f(handle, depth) returns false to stop
+    template<typename Links, typename Handle, typename F>
+    bool linked_preorder_with_depth(const Links &links, Handle root, std::size_t max_depth, F &&f) {
+        constexpr Handle nil = Links::nil;
+        Handle node = root;
+        std::size_t depth = 0;
+
+        while (node != nil) {
+            if (!f(node, depth)) return false;
+
+            if (depth < max_depth && links.left(node) != nil) {
+                node = links.left(node);
+                ++depth;
+                continue;
+            }
+            if (depth < max_depth && links.right(node) != nil) {
+                node = links.right(node);
+                ++depth;
+                continue;
+            }
+
+            // Climb to the closest ancestor with an unvisited right subtree
+            while (true) {
+                const Handle parent = links.parent(node);
+                if (parent == nil) return true;
+                --depth;
+                if (node == links.left(parent) && links.right(parent) != nil) {
+                    node = links.right(parent);
+                    ++depth;
+                    break;
+                }
+                node = parent;
+            }
+        }
+        return true;
+    }
+
+    template<typename Links, typename Handle, typename F>
+    bool linked_preorder(const Links &links, Handle root, F &&f) {
+        return linked_preorder_with_depth(links, root, static_cast<std::size_t>(-1), [&](Handle node, std::size_t) {
+            return invoke_visitor(f, links.value(node));
+        });
+    }
+
+    template<typename Links, typename Handle, typename F>
+    bool linked_inorder(const Links &links, Handle root, F &&f) {
+        constexpr Handle nil = Links::nil;
+        if (root == nil) return true;
+
+        Handle node = root;
+        while (links.left(node) != nil) node = links.left(node);
+
+        while (node != nil) {
+            if (!invoke_visitor(f, links.value(node))) return false;
+
+            if (links.right(node) != nil) {
+                node = links.right(node);
+                while (links.left(node) != nil) node = links.left(node);
+            } else {
+                Handle parent = links.parent(node);
+                while (parent != nil && node == links.right(parent)) {
+                    node = parent;
+                    parent = links.parent(parent);
+                }
+                node = parent;
+            }
+        }
+        return true;
+    }
+
+    template<typename Links, typename Handle, typename F>
+    bool linked_postorder(const Links &links, Handle root, F &&f) {
+        constexpr Handle nil = Links::nil;
+        if (root == nil) return true;
+
+        // First node in postorder below `node`: keep descending, preferring the left child
+        const auto deepest = [&links](Handle node) {
+            while (true) {
+                if (links.left(node) != nil) node = links.left(node);
+                else if (links.right(node) != nil) node = links.right(node);
+                else return node;
+            }
+        };
+
+        Handle node = deepest(root);
+        while (true) {
+            if (!invoke_visitor(f, links.value(node))) return false;
+
+            const Handle parent = links.parent(node);
+            if (parent == nil) return true;
+            if (node == links.left(parent) && links.right(parent) != nil) {
+                node = deepest(links.right(parent));
+            } else {
+                node = parent;
+            }
+        }
+    }
+
+    // Level order by iterative deepening; each pass stops at the level it emits, so a
+    // balanced tree costs O(n) in total.
+    template<typename Links, typename Handle, typename F>
+    bool linked_level_order(const Links &links, Handle root, F &&f) {
+        for (std::size_t level = 0;; ++level) {
+            bool reached = false;
+            const bool running = linked_preorder_with_depth(links, root, level, [&](Handle node, std::size_t depth) {
+                if (depth != level) return true;
+                reached = true;
+                return invoke_visitor(f, links.value(node));
+            });
+            if (!running) return false;
+            if (!reached) return true;
+        }
+    }
+}
@@ -1,15 +1,24 @@
 #pragma once
 
-#include <cmath>
-#include <iostream>
-
-#include "internal/nodes/red_black_node.hpp"
-#include "adaptors/queue.hpp"
-
-template<typename T>
+#include <algorithm>
+#include <iosfwd>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "internal/rb_node_store.hpp"
+#include "internal/traversal.hpp"
+#include "utils/stats.hpp"
+
+// Leaves are the store's nil handle rather than a heap-allocated sentinel, so an empty tree
+// owns no memory. With Index_links the nodes are kept in one pool with 32-bit links.
+template<typename T, typename Links = Pointer_links, typename Allocator = std::allocator<T>, typename Stats = No_stats>
 class Red_black_tree {
+    using alloc_traits = std::allocator_traits<Allocator>;
+
 public:
     using value_type = T;
+    using allocator_type = Allocator;
     using pointer = T *;
     using const_pointer = const T *;
     using reference = T &;
@@ -17,82 +26,87 @@ public:
     using size_type = size_t;
 
     // Constructors
-    Red_black_tree() {
-        NIL = new RBNode<value_type>;
-        m_root = NIL;
-        m_size = 0;
+    Red_black_tree() noexcept(noexcept(allocator_type())) : Red_black_tree(allocator_type()) {
     }
 
-    Red_black_tree(const Red_black_tree &other) : Red_black_tree() {
-        m_root = copy_nodes(other.m_root);
-        m_size = other.m_size;
+    explicit Red_black_tree(const allocator_type &alloc) noexcept : m_nodes(alloc), m_root(NIL), m_size(0) {
     }
 
-    Red_black_tree(Red_black_tree&& other) noexcept {
-        NIL = new RBNode<value_type>;
-        m_root = other.m_root == other.NIL ? NIL : other.m_root;
-        m_size = other.m_size;
+    Red_black_tree(const Red_black_tree &other)
+        : Red_black_tree(other, alloc_traits::select_on_container_copy_construction(other.get_allocator())) {
+    }
 
-        if (m_root != NIL) m_root->parent = NIL;
+    Red_black_tree(const Red_black_tree &other, const allocator_type &alloc) : Red_black_tree(alloc) {
+        copy_from(other);
+    }
 
-        other.m_root = other.NIL;
-        other.m_size = 0;
+    Red_black_tree(Red_black_tree &&other) noexcept
+        : m_nodes(std::move(other.m_nodes)), m_root(std::exchange(other.m_root, NIL)),
+          m_size(std::exchange(other.m_size, 0)) {
+    }
+
+    // Nodes from an unequal allocator cannot be adopted, so they are copied and the source cleared
+    Red_black_tree(Red_black_tree &&other, const allocator_type &alloc) : Red_black_tree(alloc) {
+        if (mem::equal(alloc, other.get_allocator())) {
+            take(other);
+        } else {
+            copy_from(other);
+            other.clear();
+        }
     }
 
     // Assignment operator
     Red_black_tree &operator=(const Red_black_tree &other) {
         if (this != &other) {
-            clear_data(m_root);
-            m_root = NIL;
-            m_root = copy_nodes(other.m_root);
-            m_size = other.m_size;
+            clear();
+            if constexpr (!store_type::pooled) m_nodes = other.m_nodes; // propagates the allocator
+            copy_from(other);
         }
         return *this;
     }
 
-    Red_black_tree &operator=(Red_black_tree&& other) noexcept {
+    Red_black_tree &operator=(Red_black_tree &&other) noexcept(mem::nothrow_move_assign<Allocator>) {
         if (this != &other) {
-            clear_data(m_root);
-            m_root = (other.m_root == other.NIL) ? NIL : other.m_root;
-            m_size = other.m_size;
-
-            if (m_root != NIL)
-                m_root->parent = NIL;
-
-            other.m_root = other.NIL;
-            other.m_size = 0;
+            clear();
+            if (mem::can_steal(get_allocator(), other.get_allocator())) {
+                take(other);
+            } else {
+                copy_from(other);
+                other.clear();
+            }
         }
         return *this;
     }
 
     // Destructor
     ~Red_black_tree() {
-        clear_data(m_root);
-        delete NIL;
+        clear();
+    }
+
+    [[nodiscard]] allocator_type get_allocator() const noexcept {
+        return m_nodes.get_allocator();
     }
 
     // Modifiers
     void insert(const_reference value) {
-        auto new_node = new RBNode<value_type>(value, NIL);
         auto parent = NIL;
         auto current = m_root;
+        bool left = false;
 
         while (current != NIL) {
             parent = current;
-            if (new_node->value < current->value) {
-                current = current->left;
-            } else {
-                current = current->right;
-            }
+            left = value < m_nodes.value(current);
+            current = left ? m_nodes.left(current) : m_nodes.right(current);
         }
 
-        new_node->parent = parent;
+        auto new_node = m_nodes.create(value);
+        m_nodes.set_parent(new_node, parent);
         if (parent == NIL) {
             m_root = new_node; // tree was empty
-        } else if (new_node->value < parent->value) {
-            parent->left = new_node;
+        } else if (left) {
+            m_nodes.set_left(parent, new_node);
         } else {
-            parent->right = new_node;
+            m_nodes.set_right(parent, new_node);
         }
 
         ++m_size;
@@ -100,64 +114,70 @@ public:
     }
 
     void remove(const_reference value) {
-        auto z = m_root;
-
-        // Find node
-        while (z != NIL && z->value != value) {
-            if (value < z->value) {
-                z = z->left;
-            } else {
-                z = z->right;
-            }
-        }
-
+        auto z = find_node(value);
         if (z == NIL) {
             return; // value not found
         }
 
         auto y = z;
-        auto y_original_color = y->color;
-        RBNode<value_type> *x;
-
-        if (z->left == NIL) {
-            x = z->right;
-            transplant(z, z->right);
-        } else if (z->right == NIL) {
-            x = z->left;
-            transplant(z, z->left);
+        auto y_original_color = m_nodes.color(y);
+        handle x;
+        handle x_parent;
+
+        if (m_nodes.left(z) == NIL) {
+            x = m_nodes.right(z);
+            x_parent = m_nodes.parent(z);
+            transplant(z, x);
+        } else if (m_nodes.right(z) == NIL) {
+            x = m_nodes.left(z);
+            x_parent = m_nodes.parent(z);
+            transplant(z, x);
         } else {
-            y = minimum(z->right); // successor
-            y_original_color = y->color;
-            x = y->right;
+            y = minimum(m_nodes.right(z)); // successor
+            y_original_color = m_nodes.color(y);
+            x = m_nodes.right(y);
 
-            if (y->parent == z) {
-                x->parent = y;
+            if (m_nodes.parent(y) == z) {
+                x_parent = y;
             } else {
-                transplant(y, y->right);
-                y->right = z->right;
-                y->right->parent = y;
+                x_parent = m_nodes.parent(y);
+                transplant(y, x);
+                m_nodes.set_right(y, m_nodes.right(z));
+                m_nodes.set_parent(m_nodes.right(y), y);
             }
 
             transplant(z, y);
-            y->left = z->left;
-            y->left->parent = y;
-            y->color = z->color;
+            m_nodes.set_left(y, m_nodes.left(z));
+            m_nodes.set_parent(m_nodes.left(y), y);
+            m_nodes.set_color(y, m_nodes.color(z));
         }
 
-        delete z;
+        m_nodes.destroy(z);
         --m_size;
 
         if (y_original_color == Color::BLACK) {
-            delete_fixup(x);
+            delete_fixup(x, x_parent);
         }
     }
 
     void clear() {
-        clear_data(m_root);
+        if constexpr (!store_type::pooled) clear_data(m_root);
+        m_nodes.clear();
         m_root = NIL;
         m_size = 0;
     }
 
+    void swap(Red_black_tree &other) noexcept {
+        m_nodes.swap(other.m_nodes);
+        std::swap(m_root, other.m_root);
+        std::swap(m_size, other.m_size);
+    }
+
+    // Pre-sizes the node pool
+    void reserve(const size_type count) requires std::is_same_v<Links, Index_links> {
+        m_nodes.reserve(count);
+    }
+
     // Observers
     [[nodiscard]] size_type size() const {
         return m_size;
@@ -168,30 +188,21 @@ public:
     }
 
     bool contains(const_reference value) const {
-        auto current = m_root;
-        while (current != NIL) {
-            if (value == current->value) return true;
-            current = value < current->value ? current->left : current->right;
-        }
-        return false;
+        return find_node(value) != NIL;
     }
 
     const_reference max() const {
         if (m_root == NIL) throw std::out_of_range("Tree is empty");
-        RBNode<value_type> *current = m_root;
-        while (current->right) {
-            current = current->right;
+        auto current = m_root;
+        while (m_nodes.right(current) != NIL) {
+            current = m_nodes.right(current);
         }
-        return current->value;
+        return m_nodes.value(current);
     }
 
     const_reference min() const {
         if (m_root == NIL) throw std::out_of_range("Tree is empty");
-        RBNode<value_type> *current = m_root;
-        while (current->left) {
-            current = current->left;
-        }
-        return current->value;
+        return m_nodes.value(minimum(m_root));
     }
 
     size_type height() const {
@@ -206,294 +217,390 @@ public:
         return leaf_count_helper(m_root);
     }
 
+    // Checks every invariant: search order, parent links, a black root, no red node with a red
+    // child, equal black heights and the size. Throws std::logic_error at the first violation.
+    // Linear time, for tests and fuzzing.
+    void validate() const {
+        if (m_nodes.color(m_root) != Color::BLACK) throw std::logic_error("Red-Black tree property violation: red root");
+        if (m_root != NIL && m_nodes.parent(m_root) != NIL) throw std::logic_error("Red-Black tree: root has a parent");
+
+        size_type count = 0;
+        validate_helper(m_root, nullptr, nullptr, count);
+        if (count != m_size) throw std::logic_error("Red-Black tree: size does not match the node count");
+    }
+
+    // Statistics
+    [[nodiscard]] Tree_stats stats() const requires Stats::enabled {
+        Tree_stats out;
+        out.size = m_size;
+        out.height = height();
+        out.rotations = m_stats.get(Stat::rotation);
+        out.bytes_allocated = m_nodes.bytes_allocated(m_size);
+        return out;
+    }
+
     // Traversals
-    void inorder() const {
-        inorder_helper(m_root);
-        std::cout << std::endl;
+    template<typename F>
+    bool for_each_inorder(F &&f) const {
+        return tr::linked_inorder(m_nodes, m_root, f);
     }
 
-    void preorder() const {
-        preorder_helper(m_root);
-        std::cout << std::endl;
+    template<typename F>
+    bool for_each_preorder(F &&f) const {
+        return tr::linked_preorder(m_nodes, m_root, f);
     }
 
-    void postorder() const {
-        postorder_helper(m_root);
-        std::cout << std::endl;
+    template<typename F>
+    bool for_each_postorder(F &&f) const {
+        return tr::linked_postorder(m_nodes, m_root, f);
     }
 
-    void level_order() const {
-        level_order_helper(m_root);
-        std::cout << std::endl;
+    template<typename F>
+    bool for_each_level_order(F &&f) const {
+        return tr::linked_level_order(m_nodes, m_root, f);
     }
-private:
-    RBNode<value_type> *NIL;
-    RBNode<value_type> *m_root;
-    size_type m_size;
 
-    void clear_data(RBNode<value_type> *node) {
-        if (node != NIL) {
-            clear_data(node->left);
-            clear_data(node->right);
-            delete node;
-        }
+    // Deprecated printers, forwarding to the print_* helpers of tree/tree_print.hpp, which
+    // callers now include so that this header doesn't pull in <iostream>
+    [[deprecated("use print_inorder from tree/tree_print.hpp")]] void inorder() const {
+        print_inorder(*this);
     }
 
-    void inorder_helper(RBNode<value_type> *node) const {
-        if (!node) return;
-        inorder_helper(node->left);
-        std::cout << node->value << " ";
-        inorder_helper(node->right);
+    [[deprecated("use print_inorder from tree/tree_print.hpp")]] void inorder(std::ostream &os) const {
+        print_inorder(*this, os);
     }
 
-    void preorder_helper(RBNode<value_type> *node) const {
-        if (!node) return;
-        std::cout << node->value << " ";
-        preorder_helper(node->left);
-        preorder_helper(node->right);
+    [[deprecated("use print_preorder from tree/tree_print.hpp")]] void preorder() const {
+        print_preorder(*this);
     }
 
-    void postorder_helper(RBNode<value_type> *node) const {
-        if (!node) return;
-        postorder_helper(node->left);
-        postorder_helper(node->right);
-        std::cout << node->value << " ";
+    [[deprecated("use print_preorder from tree/tree_print.hpp")]] void preorder(std::ostream &os) const {
+        print_preorder(*this, os);
     }
 
-    void level_order_helper(RBNode<value_type> *node) const {
-        if (!node) return;
+    [[deprecated("use print_postorder from tree/tree_print.hpp")]] void postorder() const {
+        print_postorder(*this);
+    }
 
-        Queue<RBNode<value_type> *> q;
-        q.push(node);
-        while (!q.empty()) {
-            auto current = q.front();
-            q.pop();
-            std::cout << current->value << " ";
+    [[deprecated("use print_postorder from tree/tree_print.hpp")]] void postorder(std::ostream &os) const {
+        print_postorder(*this, os);
+    }
 
-            if (current->left) q.push(current->left);
-            if (current->right) q.push(current->right);
-        }
+    [[deprecated("use print_level_order from tree/tree_print.hpp")]] void level_order() const {
+        print_level_order(*this);
     }
 
-    RBNode<value_type>* copy_nodes(RBNode<value_type>* node) {
-        if (node == nullptr || node == NIL) return NIL;
+    [[deprecated("use print_level_order from tree/tree_print.hpp")]] void level_order(std::ostream &os) const {
+        print_level_order(*this, os);
+    }
 
-        auto new_node = new RBNode<value_type>(node->value, NIL);
-        new_node->color = node->color;
+private:
+    using store_type = RB_node_store<value_type, Links, Allocator>;
+    using handle = typename store_type::handle;
 
-        new_node->left = copy_nodes(node->left);
-        if (new_node->left != NIL)
-            new_node->left->parent = new_node;
+    static constexpr handle NIL = store_type::nil;
 
-        new_node->right = copy_nodes(node->right);
-        if (new_node->right != NIL)
-            new_node->right->parent = new_node;
+    store_type m_nodes;
+    handle m_root;
+    size_type m_size;
+    [[no_unique_address]] Stats m_stats;
 
+    void clear_data(handle node) {
+        if (node != NIL) {
+            clear_data(m_nodes.left(node));
+            clear_data(m_nodes.right(node));
+            m_nodes.destroy(node);
+        }
+    }
+
+    // Adopts other's nodes, and its allocator when that propagates on move assignment
+    void take(Red_black_tree &other) noexcept {
+        m_nodes = std::move(other.m_nodes);
+        m_root = std::exchange(other.m_root, NIL);
+        m_size = std::exchange(other.m_size, 0);
+    }
+
+    void copy_from(const Red_black_tree &other) {
+        if constexpr (store_type::pooled) {
+            m_nodes = other.m_nodes; // handles are indices, so the pool copies as is
+            m_root = other.m_root;
+        } else {
+            m_root = copy_nodes(other, other.m_root, NIL);
+        }
+        m_size = other.m_size;
+    }
+
+    handle copy_nodes(const Red_black_tree &other, handle node, handle parent) {
+        if (node == NIL) return NIL;
+
+        auto new_node = m_nodes.create(other.m_nodes.value(node));
+        m_nodes.set_color(new_node, other.m_nodes.color(node));
+        m_nodes.set_parent(new_node, parent);
+        m_nodes.set_left(new_node, copy_nodes(other, other.m_nodes.left(node), new_node));
+        m_nodes.set_right(new_node, copy_nodes(other, other.m_nodes.right(node), new_node));
         return new_node;
     }
 
-    size_type height_helper(RBNode<value_type> *node) const {
+    handle find_node(const_reference value) const {
+        auto current = m_root;
+        while (current != NIL) {
+            const_reference current_value = m_nodes.value(current);
+            if (value == current_value) return current;
+            current = value < current_value ? m_nodes.left(current) : m_nodes.right(current);
+        }
+        return NIL;
+    }
+
+    size_type height_helper(handle node) const {
         if (node == NIL) return 0;
-        const size_type left_height = height_helper(node->left);
-        const size_type right_height = height_helper(node->right);
+        const size_type left_height = height_helper(m_nodes.left(node));
+        const size_type right_height = height_helper(m_nodes.right(node));
         return std::max(left_height, right_height) + 1;
     }
 
-    size_type black_height_helper(RBNode<value_type>* node) const {
+    size_type black_height_helper(handle node) const {
         if (node == NIL) return 1;
 
-        const size_type left_bh = black_height_helper(node->left);
-        const size_type right_bh = black_height_helper(node->right);
+        const size_type left_bh = black_height_helper(m_nodes.left(node));
+        const size_type right_bh = black_height_helper(m_nodes.right(node));
 
         if (left_bh != right_bh) {
             throw std::logic_error("Red-Black tree property violation: unequal black heights");
         }
 
-        return left_bh + (node->color == Color::BLACK ? 1 : 0);
+        return left_bh + (m_nodes.color(node) == Color::BLACK ? 1 : 0);
     }
 
-    size_type leaf_count_helper(RBNode<value_type> *node) const {
+    // Returns the black height of the subtree, whose values must lie within [low, high]. Equal
+    // values may sit on either side after rotations, so the bounds are inclusive.
+    size_type validate_helper(handle node, const_pointer low, const_pointer high, size_type &count) const {
+        if (node == NIL) return 1;
+        ++count;
+
+        const_reference value = m_nodes.value(node);
+        if ((low && value < *low) || (high && *high < value)) {
+            throw std::logic_error("Red-Black tree: values out of search order");
+        }
+
+        const auto left = m_nodes.left(node);
+        const auto right = m_nodes.right(node);
+        if ((left != NIL && m_nodes.parent(left) != node) || (right != NIL && m_nodes.parent(right) != node)) {
+            throw std::logic_error("Red-Black tree: broken parent link");
+        }
+        if (m_nodes.color(node) == Color::RED &&
+            (m_nodes.color(left) == Color::RED || m_nodes.color(right) == Color::RED)) {
+            throw std::logic_error("Red-Black tree property violation: red node with a red child");
+        }
+
+        const size_type left_bh = validate_helper(left, low, &value, count);
+        const size_type right_bh = validate_helper(right, &value, high, count);
+        if (left_bh != right_bh) {
+            throw std::logic_error("Red-Black tree property violation: unequal black heights");
+        }
+        return left_bh + (m_nodes.color(node) == Color::BLACK ? 1 : 0);
+    }
+
+    size_type leaf_count_helper(handle node) const {
         if (node == NIL) return 0;
-        if (node->left == NIL && node->right == NIL) return 1;
-        return leaf_count_helper(node->left) + leaf_count_helper(node->right);
+        if (m_nodes.left(node) == NIL && m_nodes.right(node) == NIL) return 1;
+        return leaf_count_helper(m_nodes.left(node)) + leaf_count_helper(m_nodes.right(node));
     }
 
-    void insert_fixup(RBNode<value_type> *node) {
-        while (node->parent->color == Color::RED) {
-            if (node->parent == node->parent->parent->left) {
-                auto uncle = node->parent->parent->right;
-                if (uncle->color == Color::RED) {
+    void insert_fixup(handle node) {
+        // The root's parent is NIL, which reads as black and ends the loop
+        while (m_nodes.color(m_nodes.parent(node)) == Color::RED) {
+            auto parent = m_nodes.parent(node);
+            auto grandparent = m_nodes.parent(parent);
+
+            if (parent == m_nodes.left(grandparent)) {
+                auto uncle = m_nodes.right(grandparent);
+                if (m_nodes.color(uncle) == Color::RED) {
                     // Case 1: Uncle red
-                    node->parent->color = Color::BLACK;
-                    uncle->color = Color::BLACK;
-                    node->parent->parent->color = Color::RED;
-                    node = node->parent->parent; // check if the tree is still valid
+                    m_nodes.set_color(parent, Color::BLACK);
+                    m_nodes.set_color(uncle, Color::BLACK);
+                    m_nodes.set_color(grandparent, Color::RED);
+                    node = grandparent; // check if the tree is still valid
                 } else {
-                    if (node == node->parent->right) {
+                    if (node == m_nodes.right(parent)) {
                         // Case 2: Triangle
-                        node = node->parent;
+                        node = parent;
                         rotate_left(node);
+                        parent = m_nodes.parent(node);
                     }
                     // Case 3: line
-                    node->parent->color = Color::BLACK;
-                    node->parent->parent->color = Color::RED;
-                    rotate_right(node->parent->parent);
+                    m_nodes.set_color(parent, Color::BLACK);
+                    m_nodes.set_color(grandparent, Color::RED);
+                    rotate_right(grandparent);
                 }
             } else {
                 // Mirror case: parent is right child
-                auto uncle = node->parent->parent->left;
-                if (uncle->color == Color::RED) {
+                auto uncle = m_nodes.left(grandparent);
+                if (m_nodes.color(uncle) == Color::RED) {
                     // Case 1: Uncle red
-                    node->parent->color = Color::BLACK;
-                    uncle->color = Color::BLACK;
-                    node->parent->parent->color = Color::RED;
-                    node = node->parent->parent;
+                    m_nodes.set_color(parent, Color::BLACK);
+                    m_nodes.set_color(uncle, Color::BLACK);
+                    m_nodes.set_color(grandparent, Color::RED);
+                    node = grandparent;
                 } else {
-                    if (node == node->parent->left) {
+                    if (node == m_nodes.left(parent)) {
                         // Case 2: Triangle
-                        node = node->parent;
+                        node = parent;
                         rotate_right(node);
+                        parent = m_nodes.parent(node);
                     }
                     // Case 3: line
-                    node->parent->color = Color::BLACK;
-                    node->parent->parent->color = Color::RED;
-                    rotate_left(node->parent->parent);
+                    m_nodes.set_color(parent, Color::BLACK);
+                    m_nodes.set_color(grandparent, Color::RED);
+                    rotate_left(grandparent);
                 }
             }
         }
-        m_root->color = Color::BLACK; // root must be black
+        m_nodes.set_color(m_root, Color::BLACK); // root must be black
     }
 
-    void delete_fixup(RBNode<value_type> *x) {
-        while (x != m_root && x->color == Color::BLACK) {
-            if (x == x->parent->left) {
-                auto sibling = x->parent->right;
+    // x may be NIL, so its parent is tracked separately
+    void delete_fixup(handle x, handle x_parent) {
+        while (x != m_root && m_nodes.color(x) == Color::BLACK) {
+            if (x == m_nodes.left(x_parent)) {
+                auto sibling = m_nodes.right(x_parent);
 
-                if (sibling->color == Color::RED) {
-                    sibling->color = Color::BLACK;
-                    x->parent->color = Color::RED;
-                    rotate_left(x->parent);
-                    sibling = x->parent->right;
+                if (m_nodes.color(sibling) == Color::RED) {
+                    m_nodes.set_color(sibling, Color::BLACK);
+                    m_nodes.set_color(x_parent, Color::RED);
+                    rotate_left(x_parent);
+                    sibling = m_nodes.right(x_parent);
                 }
 
-                if (sibling->left->color == Color::BLACK &&
-                    sibling->right->color == Color::BLACK) {
-                    sibling->color = Color::RED;
-                    x = x->parent;
+                if (m_nodes.color(m_nodes.left(sibling)) == Color::BLACK &&
+                    m_nodes.color(m_nodes.right(sibling)) == Color::BLACK) {
+                    m_nodes.set_color(sibling, Color::RED);
+                    x = x_parent;
+                    x_parent = m_nodes.parent(x);
                 } else {
-                    if (sibling->right->color == Color::BLACK) {
-                        sibling->left->color = Color::BLACK;
-                        sibling->color = Color::RED;
+                    if (m_nodes.color(m_nodes.right(sibling)) == Color::BLACK) {
+                        m_nodes.set_color(m_nodes.left(sibling), Color::BLACK);
+                        m_nodes.set_color(sibling, Color::RED);
                         rotate_right(sibling);
-                        sibling = x->parent->right;
+                        sibling = m_nodes.right(x_parent);
                     }
 
-                    sibling->color = x->parent->color;
-                    x->parent->color = Color::BLACK;
-                    sibling->right->color = Color::BLACK;
-                    rotate_left(x->parent);
+                    m_nodes.set_color(sibling, m_nodes.color(x_parent));
+                    m_nodes.set_color(x_parent, Color::BLACK);
+                    m_nodes.set_color(m_nodes.right(sibling), Color::BLACK);
+                    rotate_left(x_parent);
                     x = m_root;
                 }
             } else {
                 // mirror case
-                auto w = x->parent->left;
+                auto w = m_nodes.left(x_parent);
 
-                if (w->color == Color::RED) {
-                    w->color = Color::BLACK;
-                    x->parent->color = Color::RED;
-                    rotate_right(x->parent);
-                    w = x->parent->left;
+                if (m_nodes.color(w) == Color::RED) {
+                    m_nodes.set_color(w, Color::BLACK);
+                    m_nodes.set_color(x_parent, Color::RED);
+                    rotate_right(x_parent);
+                    w = m_nodes.left(x_parent);
                 }
 
-                if (w->right->color == Color::BLACK &&
-                    w->left->color == Color::BLACK) {
-                    w->color = Color::RED;
-                    x = x->parent;
+                if (m_nodes.color(m_nodes.right(w)) == Color::BLACK &&
+                    m_nodes.color(m_nodes.left(w)) == Color::BLACK) {
+                    m_nodes.set_color(w, Color::RED);
+                    x = x_parent;
+                    x_parent = m_nodes.parent(x);
                 } else {
-                    if (w->left->color == Color::BLACK) {
-                        w->right->color = Color::BLACK;
-                        w->color = Color::RED;
+                    if (m_nodes.color(m_nodes.left(w)) == Color::BLACK) {
+                        m_nodes.set_color(m_nodes.right(w), Color::BLACK);
+                        m_nodes.set_color(w, Color::RED);
                         rotate_left(w);
-                        w = x->parent->left;
+                        w = m_nodes.left(x_parent);
                     }
 
-                    w->color = x->parent->color;
-                    x->parent->color = Color::BLACK;
-                    w->left->color = Color::BLACK;
-                    rotate_right(x->parent);
+                    m_nodes.set_color(w, m_nodes.color(x_parent));
+                    m_nodes.set_color(x_parent, Color::BLACK);
+                    m_nodes.set_color(m_nodes.left(w), Color::BLACK);
+                    rotate_right(x_parent);
                     x = m_root;
                 }
             }
         }
-        x->color = Color::BLACK;
+        if (x != NIL) m_nodes.set_color(x, Color::BLACK);
     }
 
-    void transplant(RBNode<value_type> *u, RBNode<value_type> *v) {
-        if (u->parent == NIL) {
+    void transplant(handle u, handle v) {
+        auto parent = m_nodes.parent(u);
+        if (parent == NIL) {
             m_root = v;
-        } else if (u == u->parent->left) {
-            u->parent->left = v;
+        } else if (u == m_nodes.left(parent)) {
+            m_nodes.set_left(parent, v);
         } else {
-            u->parent->right = v;
+            m_nodes.set_right(parent, v);
         }
 
         if (v != NIL) {
-            v->parent = u->parent;
+            m_nodes.set_parent(v, parent);
         }
     }
 
-    RBNode<value_type>* minimum(RBNode<value_type>* node) const {
-        while (node->left != NIL) {
-            node = node->left;
+    handle minimum(handle node) const {
+        while (m_nodes.left(node) != NIL) {
+            node = m_nodes.left(node);
         }
         return node;
     }
 
-    RBNode<value_type> *rotate_left(RBNode<value_type> *x) {
-        auto y = x->right;
-        x->right = y->left;
+    handle rotate_left(handle x) {
+        m_stats.count(Stat::rotation);
+        auto y = m_nodes.right(x);
+        m_nodes.set_right(x, m_nodes.left(y));
 
-        if (y->left != NIL) {
-            y->left->parent = x;
+        if (m_nodes.left(y) != NIL) {
+            m_nodes.set_parent(m_nodes.left(y), x);
         }
 
-        y->parent = x->parent; // Link x's parent to y
+        auto parent = m_nodes.parent(x);
+        m_nodes.set_parent(y, parent); // Link x's parent to y
 
-        if (x->parent == NIL) {
+        if (parent == NIL) {
             m_root = y; // x was root, now y becomes root
-        } else if (x == x->parent->left) {
-            x->parent->left = y;
+        } else if (x == m_nodes.left(parent)) {
+            m_nodes.set_left(parent, y);
         } else {
-            x->parent->right = y;
+            m_nodes.set_right(parent, y);
         }
 
-        y->left = x;
-        x->parent = y;
+        m_nodes.set_left(y, x);
+        m_nodes.set_parent(x, y);
 
         return y;
     }
 
-    RBNode<value_type> *rotate_right(RBNode<value_type> *y) {
-        auto x = y->left;
-        y->left = x->right;
+    handle rotate_right(handle y) {
+        m_stats.count(Stat::rotation);
+        auto x = m_nodes.left(y);
+        m_nodes.set_left(y, m_nodes.right(x));
 
-        if (x->right != NIL) {
-            x->right->parent = y;
+        if (m_nodes.right(x) != NIL) {
+            m_nodes.set_parent(m_nodes.right(x), y);
         }
 
-        x->parent = y->parent; // Link y's parent to x
+        auto parent = m_nodes.parent(y);
+        m_nodes.set_parent(x, parent); // Link y's parent to x
 
-        if (y->parent == NIL) {
+        if (parent == NIL) {
             m_root = x; // y was root, now x becomes root
-        } else if (y == y->parent->left) {
-            y->parent->left = x;
+        } else if (y == m_nodes.left(parent)) {
+            m_nodes.set_left(parent, x);
         } else {
-            y->parent->right = x;
+            m_nodes.set_right(parent, x);
         }
 
-        x->right = y;
-        y->parent = x;
+        m_nodes.set_right(x, y);
+        m_nodes.set_parent(y, x);
 
         return x;
     }
 };
+
+namespace pmr {
+    template<typename T, typename Links = Pointer_links>
+    using Red_black_tree = ::Red_black_tree<T, Links, std::pmr::polymorphic_allocator<T>>;
+}
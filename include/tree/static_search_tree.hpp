@@ -0,0 +1,199 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+
+#include "sequence/array.hpp"
+#include "sequence/vector.hpp"
+
+enum class Search_layout { eytzinger, veb };
+
+// Read-only search tree over a sorted Vector, stored implicitly in one array.
+// Eytzinger keeps the nodes in BFS order, so the next levels of a search sit next to each
+// other and can be prefetched. vEB stores the tree recursively as a top half followed by its
+// bottom subtrees, so a search touches O(log_B n) cache blocks for every block size B.
+// The vEB variant pads the tree to a complete one with copies of the largest value.
+template<typename T, Search_layout Layout = Search_layout::eytzinger, typename Allocator = std::allocator<T>>
+class Static_search_tree {
+public:
+    using value_type = T;
+    using allocator_type = Allocator;
+    using pointer = T *;
+    using const_pointer = const T *;
+    using reference = T &;
+    using const_reference = const T &;
+    using size_type = std::size_t;
+
+    // Constructors
+    Static_search_tree() : Static_search_tree(allocator_type()) {
+    }
+
+    explicit Static_search_tree(const allocator_type &alloc) : m_nodes(alloc), m_size(0), m_height(0) {
+    }
+
+    // `sorted` must be in ascending order
+    template<typename SortedAllocator>
+    explicit Static_search_tree(const Vector<value_type, SortedAllocator> &sorted,
+                                const allocator_type &alloc = allocator_type())
+        : Static_search_tree(alloc) {
+        assign(sorted);
+    }
+
+    [[nodiscard]] allocator_type get_allocator() const noexcept {
+        return m_nodes.get_allocator();
+    }
+
+    // Modifiers
+    template<typename SortedAllocator>
+    void assign(const Vector<value_type, SortedAllocator> &sorted) {
+        m_size = sorted.size();
+        m_height = 0;
+        while ((static_cast<size_type>(1) << m_height) - 1 < m_size) ++m_height;
+
+        if constexpr (Layout == Search_layout::eytzinger) {
+            m_nodes = Vector<value_type, Allocator>(m_size + 1, m_nodes.get_allocator()); // slot 0 is unused
+            size_type next = 0;
+            build_eytzinger(sorted.data(), next, 1);
+        } else {
+            build_veb(sorted.data());
+        }
+    }
+
+    // Observers
+    [[nodiscard]] size_type size() const {
+        return m_size;
+    }
+
+    [[nodiscard]] bool empty() const {
+        return m_size == 0;
+    }
+
+    [[nodiscard]] size_type height() const {
+        return m_height;
+    }
+
+    // Lookup
+    // Smallest stored value not less than `value`, or nullptr
+    const_pointer lower_bound(const_reference value) const {
+        if (m_size == 0) return nullptr;
+        if constexpr (Layout == Search_layout::eytzinger) {
+            return lower_bound_eytzinger(value);
+        } else {
+            return lower_bound_veb(value);
+        }
+    }
+
+    bool contains(const_reference value) const {
+        const_pointer found = lower_bound(value);
+        return found && !(value < *found);
+    }
+
+private:
+    static constexpr size_type MAX_HEIGHT = 64;
+    static constexpr size_type CACHE_LINE = 64;
+
+    // Nodes 2^L levels below k start at k * 2^L and are contiguous; pick L so that they fill
+    // about one cache line.
+    static constexpr size_type PREFETCH_STRIDE = std::bit_floor(std::max<size_type>(1, CACHE_LINE / sizeof(T)));
+
+    Vector<value_type, Allocator> m_nodes;
+    size_type m_size;
+    size_type m_height;
+
+    // vEB recursion, per depth d > 0 at which a bottom tree starts:
+    // size of the top tree above it, size of each bottom tree, depth of the top tree's root.
+    Array<size_type, MAX_HEIGHT> m_top_size{};
+    Array<size_type, MAX_HEIGHT> m_bottom_size{};
+    Array<size_type, MAX_HEIGHT> m_top_depth{};
+
+    static void prefetch(const void *address) {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(address);
+#else
+        (void) address;
+#endif
+    }
+
+    // In-order walk over the implicit BFS tree hands out the sorted values
+    void build_eytzinger(const_pointer sorted, size_type &next, const size_type k) {
+        if (k > m_size) return;
+        build_eytzinger(sorted, next, 2 * k);
+        m_nodes[k] = sorted[next++];
+        build_eytzinger(sorted, next, 2 * k + 1);
+    }
+
+    const_pointer lower_bound_eytzinger(const_reference value) const {
+        const_pointer nodes = m_nodes.data();
+        size_type k = 1;
+        while (k <= m_size) {
+            prefetch(nodes + k * PREFETCH_STRIDE);
+            k = 2 * k + (nodes[k] < value);
+        }
+        // Undo the right turns taken after the last left turn; that node is the answer
+        k >>= std::countr_one(k) + 1;
+        return k ? nodes + k : nullptr;
+    }
+
+    void build_veb_tables(const size_type depth, const size_type height) {
+        if (height <= 1) return;
+        const size_type bottom_height = height / 2;
+        const size_type top_height = height - bottom_height;
+        const size_type split = depth + top_height;
+
+        m_top_size[split] = (static_cast<size_type>(1) << top_height) - 1;
+        m_bottom_size[split] = (static_cast<size_type>(1) << bottom_height) - 1;
+        m_top_depth[split] = depth;
+
+        build_veb_tables(depth, top_height);
+        build_veb_tables(split, bottom_height);
+    }
+
+    // Position in the vEB array of the node reached by BFS index `bfs` at `depth`
+    size_type veb_position(const size_type bfs, const size_type depth) const {
+        size_type pos[MAX_HEIGHT];
+        pos[0] = 0;
+        for (size_type d = 1; d <= depth; ++d) {
+            const size_type index = bfs >> (depth - d);
+            pos[d] = pos[m_top_depth[d]] + m_top_size[d] + (index & m_top_size[d]) * m_bottom_size[d];
+        }
+        return pos[depth];
+    }
+
+    void build_veb(const_pointer sorted) {
+        const size_type count = (static_cast<size_type>(1) << m_height) - 1;
+        m_nodes = Vector<value_type, Allocator>(count, m_nodes.get_allocator());
+        build_veb_tables(0, m_height);
+
+        for (size_type depth = 0; depth < m_height; ++depth) {
+            const size_type first = static_cast<size_type>(1) << depth;
+            for (size_type bfs = first; bfs < 2 * first; ++bfs) {
+                const size_type rank = ((2 * (bfs - first) + 1) << (m_height - 1 - depth)) - 1;
+                m_nodes[veb_position(bfs, depth)] = sorted[std::min(rank, m_size - 1)];
+            }
+        }
+    }
+
+    const_pointer lower_bound_veb(const_reference value) const {
+        const_pointer nodes = m_nodes.data();
+        size_type pos[MAX_HEIGHT];
+        size_type bfs = 1;
+        size_type best = m_nodes.size();
+
+        pos[0] = 0;
+        for (size_type d = 0; d < m_height; ++d) {
+            if (d > 0) {
+                pos[d] = pos[m_top_depth[d]] + m_top_size[d] + (bfs & m_top_size[d]) * m_bottom_size[d];
+            }
+            const bool go_right = nodes[pos[d]] < value;
+            best = go_right ? best : pos[d];
+            bfs = 2 * bfs + go_right;
+        }
+        return best < m_nodes.size() ? nodes + best : nullptr;
+    }
+};
+
+namespace pmr {
+    template<typename T, Search_layout Layout = Search_layout::eytzinger>
+    using Static_search_tree = ::Static_search_tree<T, Layout, std::pmr::polymorphic_allocator<T>>;
+}
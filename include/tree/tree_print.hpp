@@ -0,0 +1,30 @@
+#pragma once
+
+#include <iostream>
+
+// Prints a tree's values separated by spaces, in the named order, followed by a newline. These
+// live apart from the trees so that including a tree doesn't pull in <iostream>; any tree with
+// the for_each_* traversals works.
+template<typename Tree>
+void print_inorder(const Tree &tree, std::ostream &os = std::cout) {
+    tree.for_each_inorder([&os](const auto &value) { os << value << " "; });
+    os << std::endl;
+}
+
+template<typename Tree>
+void print_preorder(const Tree &tree, std::ostream &os = std::cout) {
+    tree.for_each_preorder([&os](const auto &value) { os << value << " "; });
+    os << std::endl;
+}
+
+template<typename Tree>
+void print_postorder(const Tree &tree, std::ostream &os = std::cout) {
+    tree.for_each_postorder([&os](const auto &value) { os << value << " "; });
+    os << std::endl;
+}
+
+template<typename Tree>
+void print_level_order(const Tree &tree, std::ostream &os = std::cout) {
+    tree.for_each_level_order([&os](const auto &value) { os << value << " "; });
+    os << std::endl;
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <utility>
+
+// Shared plumbing for the allocator-aware containers. The propagate_on_container_* traits decide
+// whether an allocator travels with the contents on copy assignment, move assignment and swap,
+// as they do for the standard containers. Allocators are expected to hand out raw pointers.
+namespace mem {
+    template<typename Alloc, typename T>
+    using rebind = typename std::allocator_traits<Alloc>::template rebind_alloc<T>;
+
+    template<typename Alloc>
+    constexpr void copy_assign(Alloc &lhs, const Alloc &rhs) noexcept {
+        if constexpr (std::allocator_traits<Alloc>::propagate_on_container_copy_assignment::value) lhs = rhs;
+    }
+
+    template<typename Alloc>
+    constexpr void move_assign(Alloc &lhs, Alloc &rhs) noexcept {
+        if constexpr (std::allocator_traits<Alloc>::propagate_on_container_move_assignment::value) {
+            lhs = std::move(rhs);
+        }
+    }
+
+    // Swapping two containers whose allocators neither propagate nor compare equal is undefined,
+    // exactly as for the standard containers
+    template<typename Alloc>
+    constexpr void swap(Alloc &lhs, Alloc &rhs) noexcept {
+        if constexpr (std::allocator_traits<Alloc>::propagate_on_container_swap::value) {
+            using std::swap;
+            swap(lhs, rhs);
+        }
+    }
+
+    // Move assignment of a container using Alloc cannot throw: it always adopts the other storage
+    template<typename Alloc>
+    constexpr bool nothrow_move_assign = std::allocator_traits<Alloc>::propagate_on_container_move_assignment::value ||
+                                         std::allocator_traits<Alloc>::is_always_equal::value;
+
+    // True when storage obtained through `rhs` may be released through `lhs`
+    template<typename Alloc>
+    constexpr bool equal(const Alloc &lhs, const Alloc &rhs) noexcept {
+        if constexpr (std::allocator_traits<Alloc>::is_always_equal::value) return true;
+        else return lhs == rhs;
+    }
+
+    // True when a move assignment may steal the other container's storage outright
+    template<typename Alloc>
+    constexpr bool can_steal(const Alloc &lhs, const Alloc &rhs) noexcept {
+        if constexpr (std::allocator_traits<Alloc>::propagate_on_container_move_assignment::value) return true;
+        else return equal(lhs, rhs);
+    }
+
+    // Allocates and constructs one object, giving the storage back if the constructor throws
+    template<typename Alloc, typename... Args>
+    constexpr auto *create(Alloc &alloc, Args &&... args) {
+        using traits = std::allocator_traits<Alloc>;
+        auto *object = std::to_address(traits::allocate(alloc, 1));
+        try {
+            traits::construct(alloc, object, std::forward<Args>(args)...);
+        } catch (...) {
+            traits::deallocate(alloc, object, 1);
+            throw;
+        }
+        return object;
+    }
+
+    template<typename Alloc>
+    constexpr void destroy(Alloc &alloc, typename std::allocator_traits<Alloc>::value_type *object) noexcept {
+        using traits = std::allocator_traits<Alloc>;
+        traits::destroy(alloc, object);
+        traits::deallocate(alloc, object, 1);
+    }
+
+    // Allocates `count` default-constructed slots, the allocator-aware spelling of new T[count]()
+    template<typename Alloc>
+    constexpr auto *create_array(Alloc &alloc, const std::size_t count) {
+        using traits = std::allocator_traits<Alloc>;
+        auto *slots = std::to_address(traits::allocate(alloc, count));
+        std::size_t built = 0;
+        try {
+            for (; built < count; ++built) traits::construct(alloc, slots + built);
+        } catch (...) {
+            while (built) traits::destroy(alloc, slots + --built);
+            traits::deallocate(alloc, slots, count);
+            throw;
+        }
+        return slots;
+    }
+
+    // Counterpart of create_array; a null `slots` is ignored like delete[] would
+    template<typename Alloc>
+    constexpr void destroy_array(Alloc &alloc, typename std::allocator_traits<Alloc>::value_type *slots,
+                       const std::size_t count) noexcept {
+        using traits = std::allocator_traits<Alloc>;
+        if (!slots) return;
+        for (std::size_t i = 0; i < count; ++i) traits::destroy(alloc, slots + i);
+        traits::deallocate(alloc, slots, count);
+    }
+}
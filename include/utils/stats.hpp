@@ -0,0 +1,73 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+// Opt-in instrumentation for the containers. The last template parameter of the sequences, the
+// hash tables, the flat tables and the trees picks a stats policy: No_stats, the default, is an
+// empty member whose hooks compile to nothing; Collect_stats counts events such as rehashes and
+// rotations, and unlocks the container's stats() snapshot. Structural figures
+// (height, chain lengths, bytes held) are not tracked at all but measured when stats() is called.
+//
+//     Hash_map<int, int, std::allocator<Pair<int, int>>, Collect_stats> map;
+//     ...
+//     if (map.stats().max_chain > 8) ...
+enum class Stat { rehash, rotation, reallocation, block_allocation, COUNT };
+
+struct No_stats {
+    static constexpr bool enabled = false;
+
+    constexpr void count(Stat) noexcept {}
+    [[nodiscard]] constexpr std::size_t get(Stat) const noexcept { return 0; }
+};
+
+// Counts belong to one container object: a copy or a move starts its own from zero
+struct Collect_stats {
+    static constexpr bool enabled = true;
+
+    constexpr Collect_stats() = default;
+    constexpr Collect_stats(const Collect_stats &) noexcept {}
+    constexpr Collect_stats &operator=(const Collect_stats &) noexcept { return *this; }
+
+    constexpr void count(const Stat stat) noexcept { ++m_counts[static_cast<std::size_t>(stat)]; }
+    [[nodiscard]] constexpr std::size_t get(const Stat stat) const noexcept {
+        return m_counts[static_cast<std::size_t>(stat)];
+    }
+
+private:
+    std::array<std::size_t, static_cast<std::size_t>(Stat::COUNT)> m_counts{};
+};
+
+// Snapshots returned by stats(). bytes_allocated is what the container holds from its
+// allocator right now, bookkeeping included.
+struct Sequence_stats {
+    std::size_t size = 0;
+    std::size_t capacity = 0;
+    std::size_t reallocations = 0;     // buffers (Vector, Small_vector) or block maps (Deque) replaced
+    std::size_t block_allocations = 0; // Deque blocks and Unrolled_list nodes
+    std::size_t bytes_allocated = 0;
+};
+
+struct Hash_stats {
+    static constexpr std::size_t HISTOGRAM_BINS = 9;
+
+    std::size_t size = 0;
+    std::size_t bucket_count = 0;
+    std::size_t max_chain = 0;
+    std::size_t rehashes = 0;
+    std::size_t bytes_allocated = 0;
+    // chain_histogram[n] buckets hold n entries; the last bin also counts every longer chain
+    std::array<std::size_t, HISTOGRAM_BINS> chain_histogram{};
+
+    constexpr void add_chain(const std::size_t length) noexcept {
+        ++chain_histogram[length < HISTOGRAM_BINS ? length : HISTOGRAM_BINS - 1];
+        if (length > max_chain) max_chain = length;
+    }
+};
+
+struct Tree_stats {
+    std::size_t size = 0;
+    std::size_t height = 0;
+    std::size_t rotations = 0;
+    std::size_t bytes_allocated = 0;
+};
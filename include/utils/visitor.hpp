@@ -0,0 +1,16 @@
+#pragma once
+
+#include <type_traits>
+#include <utility>
+
+// Calls a traversal visitor and reports whether the traversal should go on.
+// A visitor returning void always continues; one returning bool stops the traversal on false.
+template<typename F, typename... Args>
+constexpr bool invoke_visitor(F &f, Args &&... args) {
+    if constexpr (std::is_void_v<std::invoke_result_t<F &, Args...> >) {
+        f(std::forward<Args>(args)...);
+        return true;
+    } else {
+        return static_cast<bool>(f(std::forward<Args>(args)...));
+    }
+}
@@ -0,0 +1,105 @@
+// The whole library as one named module:
+//
+//     import datastructures;
+//
+// The headers remain the library's interface and keep working with #include; this unit compiles
+// them once into a module that importers load instead of parsing them again. Every standard and
+// system header the library uses is included in the global module fragment first, so that the
+// library headers' own includes of them are no-ops inside the module purview; a header that
+// starts using a new one must add it below as well.
+module;
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <compare>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <random>
+#include <ranges>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__)) && \
+    !(defined(__cpp_modules) && !defined(__clang__) && __GNUC__ < 14)
+#include <immintrin.h>
+#endif
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+export module datastructures;
+
+export extern "C++" {
+#include "adaptors/priority_queue.hpp"
+#include "adaptors/queue.hpp"
+#include "adaptors/stack.hpp"
+#include "algorithms/binary_search.hpp"
+#include "algorithms/bubble_sort.hpp"
+#include "algorithms/heap_sort.hpp"
+#include "algorithms/insertion_sort.hpp"
+#include "algorithms/merge_sort.hpp"
+#include "algorithms/quick_sort.hpp"
+#include "algorithms/selection_sort.hpp"
+#include "algorithms/sort.hpp"
+#include "algorithms/sorting_network.hpp"
+#include "associative/fixed_flat_map.hpp"
+#include "associative/fixed_flat_set.hpp"
+#include "associative/flat_map.hpp"
+#include "associative/flat_set.hpp"
+#include "associative/frozen_map.hpp"
+#include "associative/frozen_set.hpp"
+#include "associative/hash_map.hpp"
+#include "associative/hash_set.hpp"
+#include "cache/cache.hpp"
+#include "cache/policies.hpp"
+#include "concurrent/concurrent_skip_list.hpp"
+#include "concurrent/epoch.hpp"
+#include "concurrent/sharded_cache.hpp"
+#include "intrusive/forward_list.hpp"
+#include "intrusive/hash_set.hpp"
+#include "intrusive/hooks.hpp"
+#include "intrusive/list.hpp"
+#include "intrusive/red_black_tree.hpp"
+#include "iterator/iterator.hpp"
+#include "iterator/iterator_base.hpp"
+#include "iterator/iterator_tags.hpp"
+#include "iterator/iterator_utils.hpp"
+#include "memory/huge_page_resource.hpp"
+#include "memory/monotonic_arena.hpp"
+#include "memory/slab_allocator.hpp"
+#include "sequence/array.hpp"
+#include "sequence/bit_vector.hpp"
+#include "sequence/deque.hpp"
+#include "sequence/forward_list.hpp"
+#include "sequence/list.hpp"
+#include "sequence/random.hpp"
+#include "sequence/rank_select.hpp"
+#include "sequence/small_vector.hpp"
+#include "sequence/unrolled_list.hpp"
+#include "sequence/vector.hpp"
+#include "tree/avl_tree.hpp"
+#include "tree/binary_search_tree.hpp"
+#include "tree/binary_tree.hpp"
+#include "tree/red_black_tree.hpp"
+#include "tree/static_search_tree.hpp"
+#include "tree/tree_print.hpp"
+#include "utils/allocator.hpp"
+#include "utils/pair.hpp"
+#include "utils/stats.hpp"
+#include "utils/visitor.hpp"
+}